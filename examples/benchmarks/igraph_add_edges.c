@@ -0,0 +1,43 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+int main() {
+    igraph_t g;
+    igraph_vector_t batch;
+    long int i, j, n;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 5000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    n = igraph_vcount(&g);
+
+    igraph_vector_init(&batch, 200);
+
+    BENCH("1 Add 100 batches of 100 random edges to a graph with 5,000,000 edges.",
+          for (i = 0; i < 100; i++) {
+              for (j = 0; j < 200; j++) {
+                  VECTOR(batch)[j] = RNG_INTEGER(0, n - 1);
+              }
+              igraph_add_edges(&g, &batch, 0);
+          }
+         );
+
+    BENCH("2 Add 100 batches of 100 edges between high vertex ids.",
+          for (i = 0; i < 100; i++) {
+              for (j = 0; j < 200; j++) {
+                  VECTOR(batch)[j] = RNG_INTEGER(n - 1000, n - 1);
+              }
+              igraph_add_edges(&g, &batch, 0);
+          }
+         );
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Number of edges: %ld\n", (long int) igraph_ecount(&g));
+
+    igraph_vector_destroy(&batch);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+/* Adjacency probes at hubs of degree 10^6, with and without the
+   adjacency index, and rewiring a graph with hubs. */
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t edges, pairs;
+    igraph_bool_t conn;
+    igraph_real_t sum = 0;
+    long int i, n = 2000000;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A hundred hubs, spread over the vertex ids, connected to 10^5
+       random vertices each, and a sparse random graph on all vertices */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, 4 * n,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&edges, 0);
+    for (i = 0; i < 100 * 100000; i++) {
+        igraph_vector_push_back(&edges, (i % 100) * (n / 100) + n / 200);
+        igraph_vector_push_back(&edges, RNG_INTEGER(0, n - 1));
+    }
+    igraph_add_edges(&g, &edges, 0);
+    igraph_simplify(&g, 1, 1, 0);
+
+    /* Probes between two hubs search long lists at both ends */
+    igraph_vector_init(&pairs, 0);
+    for (i = 0; i < 10000000; i++) {
+        igraph_vector_push_back(&pairs, RNG_INTEGER(0, 99) * (n / 100) + n / 200);
+        igraph_vector_push_back(&pairs, RNG_INTEGER(0, 99) * (n / 100) + n / 200);
+    }
+
+    BENCH("1 10^7 hub probes, igraph_are_connected, binary search.",
+          for (i = 0; i < 10000000; i++) {
+              igraph_are_connected(&g, VECTOR(pairs)[2 * i], VECTOR(pairs)[2 * i + 1], &conn);
+              sum += conn;
+          }
+         );
+    BENCH("2 10^7 hub probes, igraph_get_eids, binary search.",
+          igraph_get_eids(&g, &edges, &pairs, 0, IGRAPH_UNDIRECTED, /*error=*/ 0);
+          sum += VECTOR(edges)[0];
+         );
+
+    BENCH("3 Build adjacency index.",
+          igraph_adjacency_index_build(&g, 256);
+         );
+
+    BENCH("4 10^7 hub probes, igraph_are_connected, adjacency index.",
+          for (i = 0; i < 10000000; i++) {
+              igraph_are_connected(&g, VECTOR(pairs)[2 * i], VECTOR(pairs)[2 * i + 1], &conn);
+              sum += conn;
+          }
+         );
+    BENCH("5 10^7 hub probes, igraph_get_eids, adjacency index.",
+          igraph_get_eids(&g, &edges, &pairs, 0, IGRAPH_UNDIRECTED, /*error=*/ 0);
+          sum += VECTOR(edges)[0];
+         );
+
+    /* The rewiring keeps the neighbors of the hubs in hash sets */
+    igraph_copy(&g2, &g);
+    BENCH("6 Rewire, 10^6 trials.",
+          igraph_rewire(&g2, 1000000, IGRAPH_REWIRING_SIMPLE);
+         );
+    igraph_destroy(&g2);
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Checksum: %g\n", sum);
+
+    igraph_vector_destroy(&pairs);
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Creating and traversing the internal adjacency lists stored in one
+   memory block, compared to igraph_adjlist_init(), which allocates a
+   separate vector for every vertex. */
+
+int igraph_i_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                               igraph_neimode_t mode);
+
+igraph_real_t traverse(const igraph_adjlist_t *al, long int rounds) {
+    igraph_real_t sum = 0;
+    long int r, i, j;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < al->length; i++) {
+            igraph_vector_int_t *neis = igraph_adjlist_get(al, i);
+            long int n = igraph_vector_int_size(neis);
+            for (j = 0; j < n; j++) {
+                sum += VECTOR(*neis)[j];
+            }
+        }
+    }
+    return sum;
+}
+
+int main() {
+    igraph_t g;
+    igraph_adjlist_t al;
+    igraph_real_t sum = 0;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 5000000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    BENCH("1 Create adjacency list 10x, one memory block.",
+          for (i = 0; i < 10; i++) {
+              igraph_i_adjlist_init_flat(&g, &al, IGRAPH_ALL);
+              igraph_adjlist_destroy(&al);
+          }
+         );
+    BENCH("2 Create adjacency list 10x, separate vectors.",
+          for (i = 0; i < 10; i++) {
+              igraph_adjlist_init(&g, &al, IGRAPH_ALL);
+              igraph_adjlist_destroy(&al);
+          }
+         );
+
+    igraph_i_adjlist_init_flat(&g, &al, IGRAPH_ALL);
+    BENCH("3 Traverse adjacency list 50x, one memory block.",
+          sum += traverse(&al, 50);
+         );
+    igraph_adjlist_destroy(&al);
+
+    igraph_adjlist_init(&g, &al, IGRAPH_ALL);
+    BENCH("4 Traverse adjacency list 50x, separate vectors.",
+          sum += traverse(&al, 50);
+         );
+    igraph_adjlist_destroy(&al);
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Checksum: %g\n", sum);
+
+    igraph_destroy(&g);
+
+    return 0;
+}
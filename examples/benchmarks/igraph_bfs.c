@@ -0,0 +1,103 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Single source searches. igraph_bfs() checks every edge of the reached
+   vertices, igraph_subcomponent() and igraph_shortest_paths() with a
+   few sources find the large middle levels bottom-up and check only a
+   fraction of them on graphs with a small diameter. The number of
+   checked edges from vertex 0 is printed for both searches. */
+
+#define REPS 20
+
+int igraph_i_bfs_edge_checks(const igraph_t *graph, igraph_integer_t source,
+                             igraph_neimode_t mode, igraph_bool_t hybrid,
+                             igraph_real_t *res);
+
+void print_edge_checks(const char *name, const igraph_t *graph,
+                       igraph_neimode_t mode) {
+    igraph_real_t top_down, hybrid;
+    igraph_i_bfs_edge_checks(graph, 0, mode, /*hybrid=*/ 0, &top_down);
+    igraph_i_bfs_edge_checks(graph, 0, mode, /*hybrid=*/ 1, &hybrid);
+    printf("%s edge checks: %.0f top-down, %.0f direction-optimizing.\n",
+           name, top_down, hybrid);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t res, dims;
+    igraph_matrix_t dist;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_vector_init(&res, 0);
+    igraph_matrix_init(&dist, 0, 0);
+
+    igraph_barabasi_game(&g, 200000, /*power=*/ 1, 8, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    print_edge_checks("Skewed,", &g, IGRAPH_ALL);
+    BENCH("1 igraph_bfs(), skewed, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_bfs(&g, (igraph_integer_t) i, 0, IGRAPH_ALL, /*unreachable=*/ 0,
+                         0, 0, 0, 0, 0, 0, &res, 0, 0);
+          }
+         );
+    BENCH("2 igraph_subcomponent(), skewed, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_subcomponent(&g, &res, i, IGRAPH_ALL);
+          }
+         );
+    BENCH("3 igraph_shortest_paths(), skewed, one source, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_shortest_paths(&g, &dist, igraph_vss_1((igraph_integer_t) i),
+                                    igraph_vss_all(), IGRAPH_ALL);
+          }
+         );
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200000, 1600000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    print_edge_checks("GNM undirected,", &g, IGRAPH_ALL);
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200000, 1600000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    print_edge_checks("GNM directed,", &g, IGRAPH_OUT);
+    BENCH("4 igraph_bfs(), GNM directed, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_bfs(&g, (igraph_integer_t) i, 0, IGRAPH_OUT, /*unreachable=*/ 0,
+                         0, 0, 0, 0, 0, 0, &res, 0, 0);
+          }
+         );
+    BENCH("5 igraph_subcomponent(), GNM directed, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_subcomponent(&g, &res, i, IGRAPH_OUT);
+          }
+         );
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 500, 500);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    print_edge_checks("500x500 lattice,", &g, IGRAPH_ALL);
+    BENCH("6 igraph_bfs(), 500x500 lattice, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_bfs(&g, (igraph_integer_t) i, 0, IGRAPH_ALL, /*unreachable=*/ 0,
+                         0, 0, 0, 0, 0, 0, &res, 0, 0);
+          }
+         );
+    BENCH("7 igraph_subcomponent(), 500x500 lattice, 20 times.",
+          for (i = 0; i < REPS; i++) {
+              igraph_subcomponent(&g, &res, i, IGRAPH_ALL);
+          }
+         );
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* The memory used by the edge index of an igraph_t */
+size_t graph_memory(const igraph_t *g) {
+    return (4 * (size_t) igraph_ecount(g) + 2 * (size_t) igraph_vcount(g) + 2) *
+           sizeof(igraph_integer_t);
+}
+
+void run(const igraph_t *g, const char *name) {
+    igraph_compressed_t cg;
+    igraph_vector_t res;
+    igraph_integer_t no;
+
+    igraph_vector_init(&res, 0);
+
+    printf("%s\n", name);
+    BENCH(" 1 Compress the graph.", igraph_compressed_init(g, &cg));
+    printf(" Memory: %.1f MB graph, %.1f MB compressed\n",
+           graph_memory(g) / 1048576.0, igraph_compressed_memory(&cg) / 1048576.0);
+
+    BENCH(" 2 BFS, igraph_t.",
+          igraph_bfs(g, 0, 0, IGRAPH_OUT, /*unreachable=*/ 0, 0, &res, 0, 0, 0, 0, 0, 0, 0));
+    BENCH(" 3 BFS, compressed.", igraph_compressed_bfs(&cg, 0, IGRAPH_OUT, &res, 0, 0));
+    BENCH(" 4 Weakly connected components, igraph_t.",
+          igraph_clusters(g, &res, 0, &no, IGRAPH_WEAK));
+    BENCH(" 5 Weakly connected components, compressed.",
+          igraph_compressed_clusters(&cg, &res, 0, &no));
+    BENCH(" 6 PageRank, igraph_t (PRPACK).",
+          igraph_pagerank(g, IGRAPH_PAGERANK_ALGO_PRPACK, &res, 0, igraph_vss_all(),
+                          1, 0.85, 0, 0));
+    BENCH(" 7 PageRank, compressed.", igraph_compressed_pagerank(&cg, &res, 0, 0.85, 1));
+
+    igraph_compressed_destroy(&cg);
+    igraph_vector_destroy(&res);
+}
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t dim;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 10000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    run(&g, "Random directed graph, 1,000,000 vertices, 10,000,000 edges");
+    igraph_destroy(&g);
+
+    igraph_vector_init(&dim, 2);
+    VECTOR(dim)[0] = 1000; VECTOR(dim)[1] = 1000;
+    igraph_lattice(&g, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_reorder_vertices(&g, &g2, 0, IGRAPH_REORDER_RCM);
+    run(&g2, "1000x1000 lattice, RCM ordering");
+    igraph_destroy(&g2);
+    igraph_destroy(&g);
+    igraph_vector_destroy(&dim);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Repeated distance queries on road-like graphs: a geometric graph with
+   Euclidean edge lengths and a lattice with random weights. After the
+   preprocessing, a contraction hierarchy query settles a few hundred
+   vertices, instead of a large part of the graph. */
+
+#define PAIRS 1000
+
+void run(const igraph_t *g, const igraph_vector_t *weights, const char *name) {
+    igraph_vector_t vertices, edges, from, to, sources;
+    igraph_matrix_t res;
+    igraph_contraction_hierarchy_t ch;
+    igraph_real_t dist;
+    long int i, n = igraph_vcount(g);
+    char msg[100];
+    FILE *file;
+
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_vector_init(&from, PAIRS);
+    igraph_vector_init(&to, 0);
+    for (i = 0; i < PAIRS; i++) {
+        VECTOR(from)[i] = RNG_INTEGER(0, n - 1);
+    }
+    /* distinct targets, for igraph_shortest_paths_dijkstra() */
+    igraph_random_sample(&to, 0, n - 1, PAIRS);
+    igraph_vector_shuffle(&to);
+    igraph_vector_init(&sources, 0);
+    igraph_vector_update(&sources, &from);
+    igraph_vector_resize(&sources, 10);
+    igraph_matrix_init(&res, 0, 0);
+
+    snprintf(msg, sizeof(msg), "%s, bidirectional Dijkstra, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_dijkstra(g, &vertices, &edges, VECTOR(from)[i],
+                                                VECTOR(to)[i], weights, IGRAPH_ALL);
+          }
+         );
+    snprintf(msg, sizeof(msg), "%s, Dijkstra, 10 sources, 1000 targets.", name);
+    BENCH(msg,
+          igraph_shortest_paths_dijkstra(g, &res, igraph_vss_vector(&sources),
+                                         igraph_vss_vector(&to), weights, IGRAPH_ALL);
+         );
+    snprintf(msg, sizeof(msg), "%s, building contraction hierarchy.", name);
+    BENCH(msg,
+          igraph_contraction_hierarchy_init(g, &ch, weights, IGRAPH_ALL);
+         );
+    snprintf(msg, sizeof(msg), "%s, contraction hierarchy distances, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_contraction_hierarchy_distance(&ch, &dist, VECTOR(from)[i],
+                                                    VECTOR(to)[i]);
+          }
+         );
+    snprintf(msg, sizeof(msg), "%s, contraction hierarchy paths, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_contraction_hierarchy_path(&ch, &vertices, &edges, VECTOR(from)[i],
+                                                VECTOR(to)[i]);
+          }
+         );
+    snprintf(msg, sizeof(msg), "%s, contraction hierarchy, 10 sources, 1000 targets.", name);
+    BENCH(msg,
+          igraph_contraction_hierarchy_distances(&ch, &res, &sources, &to);
+         );
+
+    file = tmpfile();
+    snprintf(msg, sizeof(msg), "%s, writing contraction hierarchy.", name);
+    BENCH(msg,
+          igraph_contraction_hierarchy_write(&ch, file);
+         );
+    igraph_contraction_hierarchy_destroy(&ch);
+    rewind(file);
+    snprintf(msg, sizeof(msg), "%s, reading contraction hierarchy.", name);
+    BENCH(msg,
+          igraph_contraction_hierarchy_read(&ch, file);
+         );
+    fclose(file);
+    igraph_contraction_hierarchy_destroy(&ch);
+
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&sources);
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t x, y, weights, dims;
+    long int i, m;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_vector_init(&x, 0);
+    igraph_vector_init(&y, 0);
+    igraph_grg_game(&g, 100000, 0.006, /*torus=*/ 0, &x, &y);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        long int u = IGRAPH_FROM(&g, i), v = IGRAPH_TO(&g, i);
+        VECTOR(weights)[i] = hypot(VECTOR(x)[u] - VECTOR(x)[v],
+                                   VECTOR(y)[u] - VECTOR(y)[v]);
+    }
+    run(&g, &weights, "1 geometric");
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 300, 300);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    m = igraph_ecount(&g);
+    igraph_vector_resize(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 10);
+    }
+    run(&g, &weights, "2 300x300 lattice");
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+/* Copies that are only read, and copies that are modified right
+   away. */
+
+int main() {
+    igraph_t g, copy;
+    igraph_vector_t deg;
+    igraph_real_t sum = 0;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 5000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init_seq(&deg, 0, igraph_ecount(&g) - 1);
+    SETEANV(&g, "weight", &deg);
+
+    BENCH("1 Copy the graph and query a degree, 100 times.",
+          for (i = 0; i < 100; i++) {
+              igraph_copy(&copy, &g);
+              igraph_degree(&copy, &deg, igraph_vss_1(0), IGRAPH_OUT, IGRAPH_LOOPS);
+              sum += VECTOR(deg)[0];
+              igraph_destroy(&copy);
+          }
+         );
+
+    BENCH("2 Copy the graph and add an edge, 10 times.",
+          for (i = 0; i < 10; i++) {
+              igraph_copy(&copy, &g);
+              igraph_add_edge(&copy, 0, 1);
+              sum += igraph_ecount(&copy);
+              igraph_destroy(&copy);
+          }
+         );
+
+    BENCH("3 Copy the graph and set an edge attribute, 10 times.",
+          for (i = 0; i < 10; i++) {
+              igraph_copy(&copy, &g);
+              SETEAN(&copy, "weight", 0, i);
+              sum += EAN(&copy, "weight", 0);
+              igraph_destroy(&copy);
+          }
+         );
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Checksum: %g\n", sum);
+
+    igraph_vector_destroy(&deg);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+/* A sliding window: every step adds a batch of new edges and removes
+   the oldest batch. */
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t batch;
+    long int i, j, n, d, bs = 1000;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 5000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_copy(&g2, &g);
+    n = igraph_vcount(&g);
+
+    igraph_vector_init(&batch, 2 * bs);
+
+    BENCH("1 Sliding window, 50 steps of 1000 edges, igraph_delete_edges().",
+          for (i = 0; i < 50; i++) {
+              for (j = 0; j < 2 * bs; j++) {
+                  VECTOR(batch)[j] = RNG_INTEGER(0, n - 1);
+              }
+              igraph_add_edges(&g, &batch, 0);
+              igraph_delete_edges(&g, igraph_ess_seq(0, bs));
+          }
+         );
+
+    BENCH("2 Sliding window, 50 steps of 1000 edges, igraph_delete_edges_deferred().",
+          for (i = 0; i < 50; i++) {
+              for (j = 0; j < 2 * bs; j++) {
+                  VECTOR(batch)[j] = RNG_INTEGER(0, n - 1);
+              }
+              igraph_add_edges(&g2, &batch, 0);
+              /* the deleted edges are always the ones with the smallest ids */
+              d = igraph_deleted_ecount(&g2);
+              igraph_delete_edges_deferred(&g2, igraph_ess_seq(d, d + bs),
+                                           /*threshold=*/ 0.002);
+          }
+         );
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Number of edges: %ld %ld\n", (long int) igraph_ecount(&g),
+           (long int) (igraph_ecount(&g2) - igraph_deleted_ecount(&g2)));
+
+    igraph_vector_destroy(&batch);
+    igraph_destroy(&g2);
+    igraph_destroy(&g);
+
+    return 0;
+}
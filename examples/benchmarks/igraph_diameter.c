@@ -0,0 +1,55 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* The diameter of undirected graphs needs only a few searches. The
+   same graph with mutual directed edges, with directed paths, still
+   needs a search from every vertex, for comparison. */
+
+void run(const igraph_t *g, const char *title) {
+    igraph_t mutual;
+    igraph_integer_t res;
+    char msg[200];
+
+    igraph_copy(&mutual, g);
+    igraph_to_directed(&mutual, IGRAPH_TO_DIRECTED_MUTUAL);
+
+    snprintf(msg, sizeof(msg), "%s, undirected.", title);
+    BENCH(msg,
+          igraph_diameter(g, &res, 0, 0, 0, IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+         );
+    snprintf(msg, sizeof(msg), "%s, mutual directed edges.", title);
+    BENCH(msg,
+          igraph_diameter(&mutual, &res, 0, 0, 0, IGRAPH_DIRECTED, /*unconn=*/ 1);
+         );
+
+    igraph_destroy(&mutual);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dims;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_barabasi_game(&g, 20000, /*power=*/ 1, 3, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    run(&g, "1 igraph_diameter(), preferential attachment, 20000 vertices");
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 20000, 40000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    run(&g, "2 igraph_diameter(), random, 20000 vertices, not connected");
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 100, 100);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    igraph_vector_destroy(&dims);
+    run(&g, "3 igraph_diameter(), lattice, 100x100");
+    igraph_destroy(&g);
+
+    return 0;
+}
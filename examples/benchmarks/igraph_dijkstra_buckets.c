@@ -0,0 +1,87 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Weighted shortest path based functions with small integer weights,
+   they keep the vertices in buckets instead of a heap. Adding 0.5 to
+   the weights makes them use the heap, for comparison. */
+
+void run(const igraph_t *g, const igraph_t *small, long int max_weight,
+         const char *title) {
+    igraph_vector_t weights, res;
+    igraph_matrix_t dist;
+    igraph_real_t diam;
+    char msg[200];
+    long int i, k;
+
+    igraph_vector_init(&res, 0);
+    igraph_matrix_init(&dist, 0, 0);
+
+    for (k = 0; k < 2; k++) {
+        const char *kind = k == 0 ? "integer weights" : "weights + 0.5";
+
+        igraph_vector_init(&weights, igraph_ecount(g));
+        for (i = 0; i < igraph_ecount(g); i++) {
+            VECTOR(weights)[i] = RNG_INTEGER(1, max_weight) + 0.5 * k;
+        }
+        snprintf(msg, sizeof(msg), "%s, igraph_shortest_paths_dijkstra(), 100 sources, %s.",
+                 title, kind);
+        BENCH(msg,
+              igraph_shortest_paths_dijkstra(g, &dist, igraph_vss_seq(0, 99),
+                                             igraph_vss_all(), &weights, IGRAPH_ALL);
+             );
+        igraph_vector_destroy(&weights);
+
+        igraph_vector_init(&weights, igraph_ecount(small));
+        for (i = 0; i < igraph_ecount(small); i++) {
+            VECTOR(weights)[i] = RNG_INTEGER(1, max_weight) + 0.5 * k;
+        }
+        snprintf(msg, sizeof(msg), "%s, igraph_betweenness(), 3000 vertices, %s.",
+                 title, kind);
+        BENCH(msg,
+              igraph_betweenness(small, &res, igraph_vss_all(), IGRAPH_UNDIRECTED,
+                                 &weights, /*nobigint=*/ 1);
+             );
+        snprintf(msg, sizeof(msg), "%s, igraph_diameter_dijkstra(), 3000 vertices, %s.",
+                 title, kind);
+        BENCH(msg,
+              igraph_diameter_dijkstra(small, &weights, &diam, 0, 0, 0,
+                                       IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+             );
+        igraph_vector_destroy(&weights);
+    }
+
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&res);
+}
+
+int main() {
+    igraph_t g, small;
+    igraph_vector_t dims;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100000, 1000000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_erdos_renyi_game(&small, IGRAPH_ERDOS_RENYI_GNM, 3000, 30000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    run(&g, &small, 10, "1 random, weights 1-10");
+    run(&g, &small, 1000, "2 random, weights 1-1000");
+    igraph_destroy(&small);
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 300, 300);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    igraph_vector_destroy(&dims);
+    igraph_vector_init_int(&dims, 2, 55, 55);
+    igraph_lattice(&small, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    run(&g, &small, 10, "3 lattice, weights 1-10");
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&small);
+    igraph_destroy(&g);
+
+    return 0;
+}
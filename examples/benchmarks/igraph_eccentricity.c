@@ -0,0 +1,68 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* The eccentricity of all vertices, from bounds that need a search
+   from a few vertices only, and the same with a search from every
+   vertex (a vertex sequence instead of all vertices), for
+   comparison. */
+
+void run(const igraph_t *g, const char *title) {
+    igraph_vector_t res;
+    igraph_real_t radius;
+    char msg[200];
+
+    igraph_vector_init(&res, 0);
+
+    snprintf(msg, sizeof(msg), "%s, igraph_eccentricity(), all vertices.", title);
+    BENCH(msg,
+          igraph_eccentricity(g, &res, igraph_vss_all(), IGRAPH_ALL);
+         );
+    snprintf(msg, sizeof(msg), "%s, igraph_eccentricity(), vertex sequence.", title);
+    BENCH(msg,
+          igraph_eccentricity(g, &res, igraph_vss_seq(0, igraph_vcount(g) - 1),
+                              IGRAPH_ALL);
+         );
+    snprintf(msg, sizeof(msg), "%s, igraph_radius().", title);
+    BENCH(msg,
+          igraph_radius(g, &radius, IGRAPH_ALL);
+         );
+    snprintf(msg, sizeof(msg), "%s, igraph_graph_periphery().", title);
+    BENCH(msg,
+          igraph_graph_periphery(g, &res, IGRAPH_ALL);
+         );
+
+    igraph_vector_destroy(&res);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dims;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_barabasi_game(&g, 20000, /*power=*/ 1, 2, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    run(&g, "1 preferential attachment, 20000 vertices");
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 20000, 30000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    run(&g, "2 random, 20000 vertices, not connected");
+    igraph_destroy(&g);
+
+    igraph_tree_game(&g, 20000, IGRAPH_UNDIRECTED, IGRAPH_RANDOM_TREE_LERW);
+    run(&g, "3 random tree, 20000 vertices");
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 100, 100);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    igraph_vector_destroy(&dims);
+    run(&g, "4 lattice, 100x100");
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Single pair shortest paths between random vertices. The searches run
+   from both ends and stop when they meet. */
+
+#define PAIRS 1000
+
+int main() {
+    igraph_t g;
+    igraph_vector_t vertices, edges, weights, dims;
+    long int i, n;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_vector_init(&weights, 0);
+
+    igraph_barabasi_game(&g, 200000, /*power=*/ 1, 5, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    n = igraph_vcount(&g);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 10);
+    }
+    BENCH("1 igraph_get_shortest_path(), skewed, 1000 pairs.",
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path(&g, &vertices, &edges, RNG_INTEGER(0, n - 1),
+                                       RNG_INTEGER(0, n - 1), IGRAPH_ALL);
+          }
+         );
+    BENCH("2 igraph_get_shortest_path_dijkstra(), skewed, 1000 pairs.",
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_dijkstra(&g, &vertices, &edges,
+                                                RNG_INTEGER(0, n - 1),
+                                                RNG_INTEGER(0, n - 1),
+                                                &weights, IGRAPH_ALL);
+          }
+         );
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 300, 300);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    n = igraph_vcount(&g);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 10);
+    }
+    BENCH("3 igraph_get_shortest_path(), 300x300 lattice, 1000 pairs.",
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path(&g, &vertices, &edges, RNG_INTEGER(0, n - 1),
+                                       RNG_INTEGER(0, n - 1), IGRAPH_ALL);
+          }
+         );
+    BENCH("4 igraph_get_shortest_path_dijkstra(), 300x300 lattice, 1000 pairs.",
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_dijkstra(&g, &vertices, &edges,
+                                                RNG_INTEGER(0, n - 1),
+                                                RNG_INTEGER(0, n - 1),
+                                                &weights, IGRAPH_ALL);
+          }
+         );
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Point-to-point queries on road-like graphs: a geometric graph with
+   Euclidean edge lengths and a lattice with random weights. A* with
+   landmark bounds visits a small part of the vertices that Dijkstra's
+   algorithm visits. */
+
+#define PAIRS 1000
+
+typedef struct {
+    igraph_vector_t *x, *y;
+} coords_t;
+
+int euclidean(igraph_real_t *result, igraph_integer_t from,
+              igraph_integer_t to, void *extra) {
+    coords_t *c = extra;
+    igraph_real_t dx = VECTOR(*c->x)[from] - VECTOR(*c->x)[to];
+    igraph_real_t dy = VECTOR(*c->y)[from] - VECTOR(*c->y)[to];
+    *result = sqrt(dx * dx + dy * dy);
+    return 0;
+}
+
+void run(const igraph_t *g, const igraph_vector_t *weights, const char *name,
+         igraph_astar_heuristic_func_t *heuristic, void *extra) {
+    igraph_vector_t vertices, edges, from, to;
+    igraph_landmarks_t landmarks;
+    long int i, n = igraph_vcount(g);
+    char msg[100];
+
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_vector_init(&from, PAIRS);
+    igraph_vector_init(&to, PAIRS);
+    for (i = 0; i < PAIRS; i++) {
+        VECTOR(from)[i] = RNG_INTEGER(0, n - 1);
+        VECTOR(to)[i] = RNG_INTEGER(0, n - 1);
+    }
+
+    snprintf(msg, sizeof(msg), "%s, Dijkstra, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_astar(g, &vertices, &edges, VECTOR(from)[i],
+                                             VECTOR(to)[i], weights, IGRAPH_ALL,
+                                             0, 0);
+          }
+         );
+    snprintf(msg, sizeof(msg), "%s, bidirectional Dijkstra, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_dijkstra(g, &vertices, &edges, VECTOR(from)[i],
+                                                VECTOR(to)[i], weights, IGRAPH_ALL);
+          }
+         );
+    if (heuristic) {
+        snprintf(msg, sizeof(msg), "%s, A* with Euclidean distances, 1000 pairs.", name);
+        BENCH(msg,
+              for (i = 0; i < PAIRS; i++) {
+                  igraph_get_shortest_path_astar(g, &vertices, &edges, VECTOR(from)[i],
+                                                 VECTOR(to)[i], weights, IGRAPH_ALL,
+                                                 heuristic, extra);
+              }
+             );
+    }
+    snprintf(msg, sizeof(msg), "%s, choosing 16 landmarks.", name);
+    BENCH(msg,
+          igraph_landmarks_init(g, &landmarks, weights, IGRAPH_ALL, 16, 0);
+         );
+    snprintf(msg, sizeof(msg), "%s, A* with 16 landmarks, 1000 pairs.", name);
+    BENCH(msg,
+          for (i = 0; i < PAIRS; i++) {
+              igraph_get_shortest_path_astar(g, &vertices, &edges, VECTOR(from)[i],
+                                             VECTOR(to)[i], weights, IGRAPH_ALL,
+                                             igraph_landmarks_heuristic, &landmarks);
+          }
+         );
+    igraph_landmarks_destroy(&landmarks);
+
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t x, y, weights, dims;
+    coords_t coords;
+    long int i, m;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_vector_init(&x, 0);
+    igraph_vector_init(&y, 0);
+    igraph_grg_game(&g, 100000, 0.006, /*torus=*/ 0, &x, &y);
+    m = igraph_ecount(&g);
+    coords.x = &x;
+    coords.y = &y;
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        euclidean(&VECTOR(weights)[i], IGRAPH_FROM(&g, i), IGRAPH_TO(&g, i),
+                  &coords);
+    }
+    run(&g, &weights, "1 geometric", euclidean, &coords);
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 300, 300);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    m = igraph_ecount(&g);
+    igraph_vector_resize(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 10);
+    }
+    run(&g, &weights, "2 300x300 lattice", 0, 0);
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* The approximate neighborhood function, compared to the exact
+   distance histogram, which needs a search from every vertex. */
+
+int main() {
+    igraph_t g;
+    igraph_vector_t nf, hist;
+    igraph_real_t unconn;
+    int threads;
+    char msg[200];
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_vector_init(&nf, 0);
+    igraph_vector_init(&hist, 0);
+
+    igraph_barabasi_game(&g, 50000, /*power=*/ 1, 5, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    BENCH("1 preferential attachment, 50000 vertices, igraph_path_length_hist().",
+          igraph_path_length_hist(&g, &hist, &unconn, IGRAPH_UNDIRECTED);
+         );
+    BENCH("2 preferential attachment, 50000 vertices, igraph_hyperanf(), 2^6 registers.",
+          igraph_hyperanf(&g, &nf, 0, -1, IGRAPH_ALL, 6);
+         );
+    BENCH("3 preferential attachment, 50000 vertices, igraph_hyperanf(), 2^10 registers.",
+          igraph_hyperanf(&g, &nf, 0, -1, IGRAPH_ALL, 10);
+         );
+    igraph_destroy(&g);
+
+    igraph_barabasi_game(&g, 1000000, /*power=*/ 1, 5, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    for (threads = 1; threads <= 4; threads *= 2) {
+        igraph_set_num_threads(threads);
+        snprintf(msg, sizeof(msg),
+                 "4 preferential attachment, 1000000 vertices, igraph_hyperanf(), "
+                 "2^6 registers, %d threads.", threads);
+        BENCH(msg,
+              igraph_hyperanf(&g, &nf, 0, -1, IGRAPH_ALL, 6);
+             );
+    }
+    igraph_set_num_threads(1);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&hist);
+    igraph_vector_destroy(&nf);
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <igraph.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+
+/* Size of the edge index of a graph, in bytes */
+double index_size(const igraph_t *g, size_t elem) {
+    return elem * (4.0 * igraph_ecount(g) + 2.0 * (igraph_vcount(g) + 1));
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t neis, order;
+    long int i, n, sum = 0;
+    struct rusage usage;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    BENCH("1 Create a random graph with 1,000,000 vertices and 10,000,000 edges.",
+          igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 10000000,
+                                  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS)
+         );
+    n = igraph_vcount(&g);
+
+    /* The index used to store real numbers before, report both sizes. */
+    printf("Edge index: %.0f MB, with real vectors it would be %.0f MB.\n",
+           index_size(&g, sizeof(VECTOR(g.from)[0])) / 1048576.0,
+           index_size(&g, sizeof(igraph_real_t)) / 1048576.0);
+
+    igraph_vector_init(&neis, 0);
+    igraph_vector_init(&order, 0);
+
+    BENCH("2 igraph_neighbors() for all vertices, IGRAPH_ALL.",
+          for (i = 0; i < n; i++) {
+              igraph_neighbors(&g, &neis, (igraph_integer_t) i, IGRAPH_ALL);
+              sum += igraph_vector_size(&neis);
+          }
+         );
+
+    BENCH("3 igraph_incident() for all vertices, IGRAPH_OUT.",
+          for (i = 0; i < n; i++) {
+              igraph_incident(&g, &neis, (igraph_integer_t) i, IGRAPH_OUT);
+              sum += igraph_vector_size(&neis);
+          }
+         );
+
+    BENCH("4 igraph_degree() for all vertices, no loops.",
+          igraph_degree(&g, &neis, igraph_vss_all(), IGRAPH_ALL, IGRAPH_NO_LOOPS)
+         );
+
+    BENCH("5 igraph_bfs() from a single vertex.",
+          igraph_bfs(&g, /*root=*/ 0, /*roots=*/ 0, IGRAPH_OUT, /*unreachable=*/ 1,
+                     /*restricted=*/ 0, &order, 0, 0, 0, 0, 0, 0, 0)
+         );
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Total number of neighbors: %ld\n", sum);
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Peak resident set size: %ld MB\n", usage.ru_maxrss / 1024);
+
+    igraph_vector_destroy(&order);
+    igraph_vector_destroy(&neis);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+int main() {
+    igraph_t g, shuffled, rcm, degree, gorder;
+    igraph_vector_t perm, dim, order;
+    int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A 1000 x 1000 lattice with random vertex ids */
+    igraph_vector_init(&dim, 2);
+    VECTOR(dim)[0] = 1000; VECTOR(dim)[1] = 1000;
+    igraph_lattice(&g, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_init_seq(&perm, 0, igraph_vcount(&g) - 1);
+    igraph_vector_shuffle(&perm);
+    igraph_permute_vertices(&g, &shuffled, &perm);
+    igraph_destroy(&g);
+    igraph_vector_init(&order, 0);
+
+    BENCH("1 RCM ordering of a shuffled 1000x1000 lattice.",
+          igraph_reorder_vertices(&shuffled, &rcm, &perm, IGRAPH_REORDER_RCM)
+         );
+    BENCH("2 Degree ordering.",
+          igraph_reorder_vertices(&shuffled, &degree, &perm, IGRAPH_REORDER_DEGREE)
+         );
+    BENCH("3 Gorder ordering.",
+          igraph_reorder_vertices(&shuffled, &gorder, &perm, IGRAPH_REORDER_GORDER)
+         );
+
+#define BFS(g) igraph_bfs((g), /*root=*/ 0, /*roots=*/ 0, IGRAPH_ALL, \
+                          /*unreachable=*/ 1, /*restricted=*/ 0, &order, \
+                          0, 0, 0, 0, 0, 0, 0)
+
+    BENCH("4 igraph_bfs(), shuffled ids, 10x.", for (i = 0; i < 10; i++) BFS(&shuffled));
+    BENCH("5 igraph_bfs(), RCM order, 10x.", for (i = 0; i < 10; i++) BFS(&rcm));
+    BENCH("6 igraph_bfs(), degree order, 10x.", for (i = 0; i < 10; i++) BFS(&degree));
+    BENCH("7 igraph_bfs(), Gorder, 10x.", for (i = 0; i < 10; i++) BFS(&gorder));
+
+    igraph_vector_destroy(&order);
+    igraph_vector_destroy(&perm);
+    igraph_vector_destroy(&dim);
+    igraph_destroy(&gorder);
+    igraph_destroy(&degree);
+    igraph_destroy(&rcm);
+    igraph_destroy(&shuffled);
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Unweighted all-pairs functions, they search from up to 512 sources
+   at once. */
+
+int main() {
+    igraph_t g;
+    igraph_vector_t res, dims;
+    igraph_matrix_t dist;
+    igraph_real_t apl, unconn;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_barabasi_game(&g, 20000, /*power=*/ 1, 5, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    igraph_vector_init(&res, 0);
+    igraph_matrix_init(&dist, 0, 0);
+
+    BENCH("1 igraph_shortest_paths(), 2000 sources, skewed.",
+          igraph_shortest_paths(&g, &dist, igraph_vss_seq(0, 1999),
+                                igraph_vss_all(), IGRAPH_ALL);
+         );
+    BENCH("2 igraph_eccentricity(), all vertices, skewed.",
+          igraph_eccentricity(&g, &res, igraph_vss_all(), IGRAPH_ALL);
+         );
+    BENCH("3 igraph_average_path_length(), skewed.",
+          igraph_average_path_length(&g, &apl, IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+         );
+    BENCH("4 igraph_path_length_hist(), skewed.",
+          igraph_path_length_hist(&g, &res, &unconn, IGRAPH_UNDIRECTED);
+         );
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 100, 100);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    BENCH("5 igraph_average_path_length(), 100x100 lattice.",
+          igraph_average_path_length(&g, &apl, IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+         );
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Weighted single-source distances, Dijkstra's algorithm on one
+   thread, delta-stepping on several. */
+
+void run(const char *title, const igraph_t *g, const igraph_vector_t *weights) {
+    igraph_matrix_t dist;
+    char name[200];
+    int threads[] = { 1, 2, 4, 8 };
+    int i;
+
+    igraph_matrix_init(&dist, 0, 0);
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        igraph_set_num_threads(threads[i]);
+        snprintf(name, sizeof(name), "%s, %d thread(s).", title, threads[i]);
+        BENCH(name,
+              igraph_shortest_paths_dijkstra(g, &dist, igraph_vss_seq(0, 4),
+                                             igraph_vss_all(), weights, IGRAPH_OUT);
+             );
+    }
+    igraph_set_num_threads(1);
+    igraph_matrix_destroy(&dist);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, dims;
+    long int i, m;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 500000, 4000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_UNIF01();
+    }
+    run("1 igraph_shortest_paths_dijkstra(), 5 sources, random graph", &g, &weights);
+    igraph_destroy(&g);
+
+    igraph_vector_init_int(&dims, 2, 700, 700);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_DIRECTED, /*mutual=*/ 1,
+                   /*circular=*/ 0);
+    m = igraph_ecount(&g);
+    igraph_vector_resize(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 100);
+    }
+    run("2 igraph_shortest_paths_dijkstra(), 5 sources, 700x700 lattice", &g, &weights);
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+
+    return 0;
+}
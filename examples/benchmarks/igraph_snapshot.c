@@ -0,0 +1,50 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+int main() {
+    igraph_t g, g2, snap;
+    igraph_vector_t order;
+    FILE *file;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000000, 10000000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&order, 0);
+
+    file = fopen("igraph_snapshot_bench.bin", "wb");
+    BENCH("1 Write a snapshot of a graph with 10,000,000 edges.",
+          igraph_write_graph_snapshot(&g, file)
+         );
+    fclose(file);
+
+    BENCH("2 Copy the graph (for comparison).",
+          igraph_copy(&g2, &g)
+         );
+
+    file = fopen("igraph_snapshot_bench.bin", "rb");
+    BENCH("3 Open the snapshot.",
+          igraph_read_graph_snapshot(&snap, file)
+         );
+    fclose(file);
+
+    BENCH("4 igraph_bfs() on the original graph.",
+          igraph_bfs(&g, /*root=*/ 0, /*roots=*/ 0, IGRAPH_OUT, /*unreachable=*/ 1,
+                     /*restricted=*/ 0, &order, 0, 0, 0, 0, 0, 0, 0)
+         );
+
+    BENCH("5 igraph_bfs() on the snapshot.",
+          igraph_bfs(&snap, /*root=*/ 0, /*roots=*/ 0, IGRAPH_OUT, /*unreachable=*/ 1,
+                     /*restricted=*/ 0, &order, 0, 0, 0, 0, 0, 0, 0)
+         );
+
+    igraph_vector_destroy(&order);
+    igraph_destroy(&snap);
+    igraph_destroy(&g2);
+    igraph_destroy(&g);
+    remove("igraph_snapshot_bench.bin");
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+/* Transitivity and components of the neighborhood of many vertices
+   of a large graph */
+
+int main() {
+    igraph_t g, sub;
+    igraph_subgraph_view_t view;
+    igraph_vector_t neis;
+    igraph_real_t t, sum1 = 0, sum2 = 0;
+    igraph_integer_t no;
+    long int i, n = 20000;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_barabasi_game(&g, 1000000, /*power=*/ 1, /*m=*/ 5, 0, 0, /*A=*/ 1,
+                         IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE, 0);
+    igraph_vector_init(&neis, 0);
+
+    BENCH("1 Neighborhoods of 20000 vertices, igraph_induced_subgraph().",
+          for (i = 0; i < n; i++) {
+              igraph_neighbors(&g, &neis, (igraph_integer_t) i, IGRAPH_ALL);
+              igraph_induced_subgraph(&g, &sub, igraph_vss_vector(&neis),
+                                      IGRAPH_SUBGRAPH_AUTO);
+              igraph_transitivity_undirected(&sub, &t, IGRAPH_TRANSITIVITY_ZERO);
+              igraph_clusters(&sub, 0, 0, &no, IGRAPH_WEAK);
+              sum1 += t + no;
+              igraph_destroy(&sub);
+          }
+         );
+
+    igraph_subgraph_view_init(&g, &view, igraph_vss_none());
+    BENCH("2 Neighborhoods of 20000 vertices, igraph_subgraph_view_select().",
+          for (i = 0; i < n; i++) {
+              igraph_neighbors(&g, &neis, (igraph_integer_t) i, IGRAPH_ALL);
+              igraph_subgraph_view_select(&view, igraph_vss_vector(&neis));
+              igraph_subgraph_view_transitivity(&view, &t, IGRAPH_TRANSITIVITY_ZERO);
+              igraph_subgraph_view_clusters(&view, 0, 0, &no);
+              sum2 += t + no;
+          }
+         );
+
+    /* Use the result to prevent optimizing it away. */
+    printf("Checksums: %g %g\n", sum1, sum2);
+
+    igraph_subgraph_view_destroy(&view);
+    igraph_vector_destroy(&neis);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <igraph.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+/* Weighted shortest path based functions, they read the neighbors and
+   the edge weights from a weighted adjacency list. */
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, res;
+    igraph_matrix_t dist;
+    igraph_real_t diam;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100000, 1000000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 100);
+    }
+    igraph_vector_init(&res, 0);
+    igraph_matrix_init(&dist, 0, 0);
+
+    BENCH("1 igraph_shortest_paths_dijkstra(), 100 sources.",
+          igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_seq(0, 99),
+                                         igraph_vss_all(), &weights, IGRAPH_ALL);
+         );
+    BENCH("2 igraph_closeness(), 100 vertices.",
+          igraph_closeness(&g, &res, igraph_vss_seq(0, 99), IGRAPH_ALL, &weights,
+                           /*normalized=*/ 0);
+         );
+    BENCH("3 igraph_transitivity_barrat(), all vertices.",
+          igraph_transitivity_barrat(&g, &res, igraph_vss_all(), &weights,
+                                     IGRAPH_TRANSITIVITY_ZERO);
+         );
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 3000, 30000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    BENCH("4 igraph_betweenness(), 3000 vertices.",
+          igraph_betweenness(&g, &res, igraph_vss_all(), IGRAPH_UNDIRECTED,
+                             &weights, /*nobigint=*/ 1);
+         );
+    BENCH("5 igraph_edge_betweenness(), 3000 vertices.",
+          igraph_edge_betweenness(&g, &res, IGRAPH_UNDIRECTED, &weights);
+         );
+    BENCH("6 igraph_diameter_dijkstra(), 3000 vertices.",
+          igraph_diameter_dijkstra(&g, &weights, &diam, 0, 0, 0,
+                                   IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+         );
+
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+void print_view(const igraph_incident_view_t *view) {
+    long int i;
+    for (i = 0; i < IGRAPH_VIEW_SIZE(*view); i++) {
+        if (IGRAPH_VIEW_DELETED(*view, i)) {
+            continue;
+        }
+        printf(" %li->%li", (long int) IGRAPH_VIEW_EDGE(*view, i),
+               (long int) IGRAPH_VIEW_NEIGHBOR(*view, i));
+    }
+    printf("\n");
+}
+
+int main() {
+
+    igraph_t g;
+    igraph_incident_view_t view;
+    int ret;
+
+    igraph_small(&g, 0, IGRAPH_DIRECTED,
+                 0, 1, 1, 2, 2, 3, 2, 2, 2, 0, 3, 2, -1);
+
+    /* Edge ids and neighbors, out- and in-edges */
+    igraph_incident_view(&g, &view, 2, IGRAPH_OUT);
+    print_view(&view);
+    igraph_incident_view(&g, &view, 2, IGRAPH_IN);
+    print_view(&view);
+
+    /* Deleted edges are still in the view, but marked */
+    igraph_delete_edges_deferred(&g, igraph_ess_1(2), /*threshold=*/ 1);
+    igraph_incident_view(&g, &view, 2, IGRAPH_OUT);
+    print_view(&view);
+    igraph_destroy(&g);
+
+    /* Undirected graph, the two views together contain all edges */
+    igraph_small(&g, 0, IGRAPH_UNDIRECTED,
+                 0, 1, 1, 2, 2, 3, 2, 2, 2, 0, -1);
+    igraph_incident_view(&g, &view, 2, IGRAPH_OUT);
+    print_view(&view);
+    igraph_incident_view(&g, &view, 2, IGRAPH_IN);
+    print_view(&view);
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_incident_view(&g, &view, 2, IGRAPH_ALL);
+    if (ret != IGRAPH_EINVMODE) {
+        return 1;
+    }
+
+    ret = igraph_incident_view(&g, &view, 4, IGRAPH_OUT);
+    if (ret != IGRAPH_EINVVID) {
+        return 2;
+    }
+
+    igraph_destroy(&g);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* Adds edges in many small batches, this uses the merging code path
+   of igraph_add_edges(), and compares the result to a graph created
+   in one step. The incident edges must be the same, in the same
+   order, for every vertex. */
+
+int check_same_index(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j;
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    for (i = 0; i < igraph_vcount(g1); i++) {
+        for (j = 0; j < 3; j++) {
+            igraph_incident(g1, &v1, (igraph_integer_t) i, modes[j]);
+            igraph_incident(g2, &v2, (igraph_integer_t) i, modes[j]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 1;
+            }
+            igraph_neighbors(g1, &v1, (igraph_integer_t) i, modes[j]);
+            igraph_neighbors(g2, &v2, (igraph_integer_t) i, modes[j]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 2;
+            }
+        }
+    }
+
+    igraph_degree(g1, &v1, igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS);
+    igraph_degree(g2, &v2, igraph_vss_all(), IGRAPH_OUT, IGRAPH_NO_LOOPS);
+    if (!igraph_vector_all_e(&v1, &v2)) {
+        return 3;
+    }
+
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g, g2;
+    igraph_vector_t edges, batch;
+    long int n = 50, m = 1000, first = 300, bs = 7;
+    long int i, j;
+    igraph_integer_t eid;
+    int ret;
+
+    igraph_vector_init(&edges, 2 * m);
+    for (i = 0; i < 2 * m; i++) {
+        /* small number of vertices, so we have multi-edges and loops */
+        VECTOR(edges)[i] = igraph_rng_get_integer(igraph_rng_default(), 0, n - 1);
+    }
+
+    igraph_vector_init(&batch, 2 * first);
+    for (i = 0; i < 2 * first; i++) {
+        VECTOR(batch)[i] = VECTOR(edges)[i];
+    }
+    igraph_create(&g, &batch, (igraph_integer_t) n, directed);
+
+    for (i = first; i < m; i += bs) {
+        long int k = i + bs > m ? m - i : bs;
+        igraph_vector_resize(&batch, 2 * k);
+        for (j = 0; j < 2 * k; j++) {
+            VECTOR(batch)[j] = VECTOR(edges)[2 * i + j];
+        }
+        igraph_add_edges(&g, &batch, 0);
+    }
+
+    igraph_create(&g2, &edges, (igraph_integer_t) n, directed);
+
+    ret = check_same_index(&g, &g2);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* Every edge must be found by igraph_get_eid() */
+    for (i = 0; i < m; i++) {
+        igraph_get_eid(&g, &eid, (igraph_integer_t) VECTOR(edges)[2 * i],
+                       (igraph_integer_t) VECTOR(edges)[2 * i + 1],
+                       IGRAPH_DIRECTED, /*error=*/ 1);
+        if (IGRAPH_FROM(&g, eid) != IGRAPH_FROM(&g, i) ||
+            IGRAPH_TO(&g, eid) != IGRAPH_TO(&g, i)) {
+            return 4;
+        }
+    }
+
+    igraph_vector_destroy(&batch);
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g2);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 10 + ret;
+    }
+
+    return 0;
+}
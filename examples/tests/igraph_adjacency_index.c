@@ -0,0 +1,259 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* Edge lookups must give the same results with and without the
+   adjacency index */
+
+int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mode, igraph_bool_t use_adjlist);
+
+int lookup_all(const igraph_t *g, const igraph_vector_t *pairs,
+               igraph_vector_t *res) {
+    igraph_vector_t eids;
+    igraph_integer_t eid;
+    igraph_bool_t conn;
+    long int i, n = igraph_vector_size(pairs) / 2;
+
+    igraph_vector_clear(res);
+    igraph_vector_init(&eids, 0);
+    for (i = 0; i < n; i++) {
+        igraph_integer_t from = VECTOR(*pairs)[2 * i];
+        igraph_integer_t to = VECTOR(*pairs)[2 * i + 1];
+        igraph_get_eid(g, &eid, from, to, IGRAPH_DIRECTED, /*error=*/ 0);
+        igraph_vector_push_back(res, eid);
+        igraph_get_eid(g, &eid, from, to, IGRAPH_UNDIRECTED, /*error=*/ 0);
+        igraph_vector_push_back(res, eid);
+        igraph_are_connected(g, from, to, &conn);
+        igraph_vector_push_back(res, conn);
+    }
+    igraph_get_eids(g, &eids, pairs, 0, IGRAPH_DIRECTED, /*error=*/ 0);
+    igraph_vector_append(res, &eids);
+    igraph_get_eids_multi(g, &eids, pairs, 0, IGRAPH_DIRECTED, /*error=*/ 0);
+    igraph_vector_append(res, &eids);
+    igraph_get_eids_multi(g, &eids, pairs, 0, IGRAPH_UNDIRECTED, /*error=*/ 0);
+    igraph_vector_append(res, &eids);
+    igraph_vector_destroy(&eids);
+
+    return 0;
+}
+
+int check(igraph_t *g, const igraph_vector_t *pairs, igraph_integer_t min_degree) {
+    igraph_vector_t res1, res2;
+    int ret = 0;
+
+    igraph_vector_init(&res1, 0);
+    igraph_vector_init(&res2, 0);
+    lookup_all(g, pairs, &res1);
+    igraph_adjacency_index_build(g, min_degree);
+    if (!igraph_has_adjacency_index(g)) {
+        ret = 1;
+    }
+    lookup_all(g, pairs, &res2);
+    if (!igraph_vector_all_e(&res1, &res2)) {
+        ret = 2;
+    }
+    igraph_adjacency_index_destroy(g);
+    igraph_vector_destroy(&res1);
+    igraph_vector_destroy(&res2);
+
+    return ret;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g;
+    igraph_vector_t edges, pairs;
+    long int i;
+    int ret;
+
+    /* Two hubs with multi-edges and loops between them and to the
+       other vertices */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 500, 1000, directed,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&edges, 0);
+    for (i = 0; i < 2000; i++) {
+        igraph_vector_push_back(&edges, RNG_INTEGER(0, 1));
+        igraph_vector_push_back(&edges, RNG_INTEGER(0, 499));
+        igraph_vector_push_back(&edges, RNG_INTEGER(0, 499));
+        igraph_vector_push_back(&edges, RNG_INTEGER(0, 1));
+    }
+    igraph_add_edges(&g, &edges, 0);
+
+    /* Pairs involving the hubs, and random pairs */
+    igraph_vector_init(&pairs, 0);
+    for (i = 0; i < 3000; i++) {
+        igraph_vector_push_back(&pairs, i % 3 == 2 ? RNG_INTEGER(0, 499) : i % 2);
+        igraph_vector_push_back(&pairs, RNG_INTEGER(0, 499));
+    }
+    igraph_vector_push_back(&pairs, 0);
+    igraph_vector_push_back(&pairs, 0);
+    igraph_vector_push_back(&pairs, 0);
+    igraph_vector_push_back(&pairs, 1);
+
+    ret = check(&g, &pairs, 1);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = check(&g, &pairs, 20);
+    if (ret != 0) {
+        return 10 + ret;
+    }
+    ret = check(&g, &pairs, 100000);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+
+    /* Deleted edges are skipped */
+    igraph_delete_edges_deferred(&g, igraph_ess_seq(500, 3000), /*threshold=*/ 1);
+    ret = check(&g, &pairs, 10);
+    if (ret != 0) {
+        return 30 + ret;
+    }
+
+    igraph_vector_destroy(&pairs);
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int test_rewire(igraph_bool_t directed) {
+    igraph_t g1, g2;
+    igraph_vector_t el1, el2, deg1, deg2;
+    igraph_bool_t simple;
+
+    /* The hash sets must not change the result of the rewiring */
+    igraph_barabasi_game(&g1, 2000, 1, 3, 0, 0, 1, directed,
+                         IGRAPH_BARABASI_PSUMTREE, 0);
+    igraph_copy(&g2, &g1);
+    igraph_vector_init(&deg1, 0);
+    igraph_vector_init(&deg2, 0);
+    igraph_degree(&g1, &deg1, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+
+    igraph_adjacency_index_build(&g2, 1);
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_rewire_core(&g1, 5000, IGRAPH_REWIRING_SIMPLE, /*use_adjlist=*/ 1);
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_rewire_core(&g2, 5000, IGRAPH_REWIRING_SIMPLE, /*use_adjlist=*/ 1);
+
+    igraph_vector_init(&el1, 0);
+    igraph_vector_init(&el2, 0);
+    igraph_get_edgelist(&g1, &el1, 0);
+    igraph_get_edgelist(&g2, &el2, 0);
+    if (!igraph_vector_all_e(&el1, &el2) || !igraph_has_adjacency_index(&g2)) {
+        return 1;
+    }
+    igraph_degree(&g2, &deg2, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+    igraph_is_simple(&g2, &simple);
+    if (!igraph_vector_all_e(&deg1, &deg2) || !simple) {
+        return 2;
+    }
+
+    /* The rebuilt index is still correct */
+    igraph_rewire(&g2, 5000, IGRAPH_REWIRING_SIMPLE);
+    igraph_adjacency_index_destroy(&g2);
+    igraph_vector_clear(&el1);
+    igraph_vector_push_back(&el1, 0);
+    igraph_vector_push_back(&el1, 1);
+    if (check(&g2, &el1, 1) != 0) {
+        return 3;
+    }
+
+    igraph_vector_destroy(&el1);
+    igraph_vector_destroy(&el2);
+    igraph_vector_destroy(&deg1);
+    igraph_vector_destroy(&deg2);
+    igraph_destroy(&g1);
+    igraph_destroy(&g2);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t edges;
+    igraph_integer_t eid;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 100 + ret;
+    }
+    ret = test_rewire(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return 200 + ret;
+    }
+    ret = test_rewire(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 300 + ret;
+    }
+
+    /* Modifying the graph drops the index, copies do not have one */
+    igraph_star(&g, 100, IGRAPH_STAR_OUT, 0);
+    igraph_adjacency_index_build(&g, 10);
+    igraph_copy(&g2, &g);
+    if (igraph_has_adjacency_index(&g2)) {
+        return 400;
+    }
+    igraph_add_edge(&g2, 5, 6);
+    igraph_adjacency_index_build(&g2, 10);
+    igraph_add_edge(&g2, 0, 1);
+    if (igraph_has_adjacency_index(&g2)) {
+        return 401;
+    }
+    igraph_adjacency_index_build(&g2, 10);
+    igraph_add_vertices(&g2, 1, 0);
+    if (igraph_has_adjacency_index(&g2)) {
+        return 402;
+    }
+    igraph_adjacency_index_build(&g2, 10);
+    igraph_delete_vertices(&g2, igraph_vss_1(99));
+    if (igraph_has_adjacency_index(&g2)) {
+        return 403;
+    }
+    igraph_get_eid(&g, &eid, 0, 50, IGRAPH_DIRECTED, /*error=*/ 0);
+    if (!igraph_has_adjacency_index(&g) || eid != 49) {
+        return 404;
+    }
+    igraph_get_eid(&g, &eid, 50, 0, IGRAPH_DIRECTED, /*error=*/ 0);
+    if (eid != -1) {
+        return 405;
+    }
+    igraph_destroy(&g2);
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_adjacency_index_build(&g, 0) != IGRAPH_EINVAL ||
+        !igraph_has_adjacency_index(&g)) {
+        return 406;
+    }
+
+    /* Invalid modifications keep the index */
+    igraph_vector_init_int(&edges, 3, 0, 1, 2);
+    if (igraph_add_edges(&g, &edges, 0) != IGRAPH_EINVEVECTOR ||
+        !igraph_has_adjacency_index(&g)) {
+        return 407;
+    }
+    VECTOR(edges)[2] = 100;
+    igraph_vector_push_back(&edges, 0);
+    if (igraph_add_edges(&g, &edges, 0) != IGRAPH_EINVVID ||
+        !igraph_has_adjacency_index(&g)) {
+        return 408;
+    }
+    if (igraph_delete_edges(&g, igraph_ess_1(99)) != IGRAPH_EINVVID ||
+        !igraph_has_adjacency_index(&g) || igraph_ecount(&g) != 99) {
+        return 409;
+    }
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 410;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* Adjacency and incidence lists created from a graph must agree with
+   igraph_neighbors() and igraph_incident(), both with a vector for
+   every vertex and with the internal single memory block. The vectors
+   of the public lists can grow without reserving memory first. */
+
+int igraph_i_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                               igraph_neimode_t mode);
+int igraph_i_inclist_init_flat(const igraph_t *graph, igraph_inclist_t *il,
+                               igraph_neimode_t mode);
+
+int check_adjlist(const igraph_t *g, igraph_neimode_t mode, igraph_bool_t flat) {
+    igraph_adjlist_t al;
+    igraph_inclist_t il;
+    igraph_vector_t res;
+    long int i, j, n = igraph_vcount(g);
+
+    igraph_vector_init(&res, 0);
+    if (flat) {
+        igraph_i_adjlist_init_flat(g, &al, mode);
+        igraph_i_inclist_init_flat(g, &il, mode);
+    } else {
+        igraph_adjlist_init(g, &al, mode);
+        igraph_inclist_init(g, &il, mode);
+    }
+    for (i = 0; i < n; i++) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&al, i);
+        igraph_vector_int_t *incs = igraph_inclist_get(&il, i);
+        igraph_neighbors(g, &res, i, mode);
+        if (igraph_vector_int_size(neis) != igraph_vector_size(&res)) {
+            return 1;
+        }
+        for (j = 0; j < igraph_vector_size(&res); j++) {
+            if (VECTOR(*neis)[j] != VECTOR(res)[j]) {
+                return 2;
+            }
+        }
+        igraph_incident(g, &res, i, mode);
+        if (igraph_vector_int_size(incs) != igraph_vector_size(&res)) {
+            return 3;
+        }
+        for (j = 0; j < igraph_vector_size(&res); j++) {
+            if (VECTOR(*incs)[j] != VECTOR(res)[j]) {
+                return 4;
+            }
+        }
+    }
+
+    /* Grow every other vector of the public lists, and shrink them in
+       the flat ones */
+    for (i = 0; i < n; i += 2) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&al, i);
+        igraph_vector_int_t *incs = igraph_inclist_get(&il, i);
+        if (flat) {
+            igraph_vector_int_clear(neis);
+            igraph_vector_int_clear(incs);
+            continue;
+        }
+        for (j = 0; j < 100; j++) {
+            igraph_vector_int_push_back(neis, j);
+            igraph_vector_int_push_back(incs, j);
+        }
+    }
+    /* The neighbors of the next vertex are not affected */
+    for (i = 0; i < n; i += 2) {
+        igraph_neighbors(g, &res, i, mode);
+        if (igraph_vector_int_size(igraph_adjlist_get(&al, i)) !=
+            (flat ? 0 : igraph_vector_size(&res) + 100)) {
+            return 5;
+        }
+        if (i + 1 < n) {
+            igraph_neighbors(g, &res, i + 1, mode);
+            if (igraph_vector_int_size(igraph_adjlist_get(&al, i + 1)) !=
+                igraph_vector_size(&res) ||
+                (igraph_vector_size(&res) > 0 &&
+                 VECTOR(*igraph_adjlist_get(&al, i + 1))[0] != VECTOR(res)[0])) {
+                return 6;
+            }
+        }
+    }
+
+    igraph_inclist_destroy(&il);
+    igraph_adjlist_destroy(&al);
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g;
+    int ret, flat;
+
+    /* With loops, multi-edges, isolated vertices at the end and
+       deleted edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 300, directed,
+                            IGRAPH_LOOPS);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 5, 5);
+    igraph_add_vertices(&g, 5, 0);
+
+    for (flat = 0; flat <= 1; flat++) {
+        ret = check_adjlist(&g, IGRAPH_OUT, flat);
+        if (ret != 0) {
+            return 40 * flat + ret;
+        }
+        ret = check_adjlist(&g, IGRAPH_IN, flat);
+        if (ret != 0) {
+            return 40 * flat + 10 + ret;
+        }
+        ret = check_adjlist(&g, IGRAPH_ALL, flat);
+        if (ret != 0) {
+            return 40 * flat + 20 + ret;
+        }
+    }
+    igraph_delete_edges_deferred(&g, igraph_ess_seq(50, 150), /*threshold=*/ 1);
+    for (flat = 0; flat <= 1; flat++) {
+        ret = check_adjlist(&g, IGRAPH_ALL, flat);
+        if (ret != 0) {
+            return 40 * flat + 30 + ret;
+        }
+    }
+
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_adjlist_t al;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 100 + ret;
+    }
+
+    /* Null graph and graph without edges */
+    igraph_empty(&g, 0, IGRAPH_DIRECTED);
+    igraph_adjlist_init(&g, &al, IGRAPH_OUT);
+    igraph_adjlist_destroy(&al);
+    igraph_i_adjlist_init_flat(&g, &al, IGRAPH_OUT);
+    igraph_adjlist_destroy(&al);
+    igraph_destroy(&g);
+    igraph_empty(&g, 3, IGRAPH_DIRECTED);
+    igraph_adjlist_init(&g, &al, IGRAPH_OUT);
+    igraph_vector_int_push_back(igraph_adjlist_get(&al, 2), 0);
+    if (igraph_vector_int_size(igraph_adjlist_get(&al, 1)) != 0 ||
+        igraph_vector_int_size(igraph_adjlist_get(&al, 2)) != 1) {
+        return 200;
+    }
+    igraph_adjlist_destroy(&al);
+    igraph_i_adjlist_init_flat(&g, &al, IGRAPH_OUT);
+    igraph_adjlist_destroy(&al);
+    igraph_destroy(&g);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 201;
+    }
+
+    return 0;
+}
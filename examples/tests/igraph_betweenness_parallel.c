@@ -0,0 +1,123 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* Betweenness calculated on several threads must be the same as on a
+   single thread, up to rounding, and exactly the same in every run */
+
+int compare(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i;
+    if (igraph_vector_size(v1) != igraph_vector_size(v2)) {
+        return 1;
+    }
+    for (i = 0; i < igraph_vector_size(v1); i++) {
+        igraph_real_t x = VECTOR(*v1)[i], y = VECTOR(*v2)[i];
+        if (fabs(x - y) > 1e-10 * (fabs(x) + 1)) {
+            printf("%li: %g != %g\n", i, x, y);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+/* Runs the calculation of 'which' on 1 thread and twice on 'threads' threads */
+int check(const igraph_t *g, const igraph_vector_t *weights, int which,
+          igraph_bool_t directed, igraph_real_t cutoff, int threads) {
+    igraph_vector_t res[3];
+    int i, ret;
+
+    for (i = 0; i < 3; i++) {
+        igraph_vector_init(&res[i], 0);
+        igraph_set_num_threads(i == 0 ? 1 : threads);
+        switch (which) {
+        case 0:
+            igraph_betweenness_estimate(g, &res[i], igraph_vss_all(), directed,
+                                        cutoff, weights, /*nobigint=*/ 1);
+            break;
+        case 1:
+            igraph_betweenness_estimate(g, &res[i], igraph_vss_seq(5, 20), directed,
+                                        cutoff, weights, /*nobigint=*/ 0);
+            break;
+        default:
+            igraph_edge_betweenness_estimate(g, &res[i], directed, cutoff, weights);
+            break;
+        }
+    }
+
+    ret = compare(&res[0], &res[1]);
+    if (ret == 0 && !igraph_vector_all_e(&res[1], &res[2])) {
+        ret = 3;
+    }
+
+    for (i = 0; i < 3; i++) {
+        igraph_vector_destroy(&res[i]);
+    }
+    return ret;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, res;
+    igraph_bool_t directed;
+    int which, threads, ret;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    for (directed = 0; directed <= 1; directed++) {
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 800, directed,
+                                IGRAPH_LOOPS);
+        igraph_add_edge(&g, 3, 4);
+        igraph_add_edge(&g, 3, 4);
+        igraph_add_vertices(&g, 3, 0);
+        igraph_vector_init(&weights, igraph_ecount(&g));
+        for (i = 0; i < igraph_ecount(&g); i++) {
+            VECTOR(weights)[i] = RNG_INTEGER(1, 3);
+        }
+
+        for (which = 0; which < 3; which++) {
+            for (threads = 2; threads <= 7; threads += 5) {
+                ret = check(&g, 0, which, directed, -1, threads);
+                if (ret != 0) {
+                    return 100 * directed + 10 * which + ret;
+                }
+                ret = check(&g, 0, which, !directed, 3, threads);
+                if (ret != 0) {
+                    return 100 * directed + 10 * which + ret;
+                }
+                ret = check(&g, &weights, which, directed, -1, threads);
+                if (ret != 0) {
+                    return 100 * directed + 10 * which + ret;
+                }
+                ret = check(&g, &weights, which, directed, 4, threads);
+                if (ret != 0) {
+                    return 100 * directed + 10 * which + ret;
+                }
+            }
+        }
+
+        igraph_vector_destroy(&weights);
+        igraph_destroy(&g);
+    }
+
+    /* More threads than vertices */
+    igraph_set_num_threads(8);
+    igraph_star(&g, 3, IGRAPH_STAR_UNDIRECTED, 0);
+    igraph_vector_init(&res, 0);
+    igraph_betweenness(&g, &res, igraph_vss_all(), IGRAPH_UNDIRECTED, 0, 1);
+    if (VECTOR(res)[0] != 1 || VECTOR(res)[1] != 0 || VECTOR(res)[2] != 0) {
+        return 200;
+    }
+    igraph_destroy(&g);
+
+    /* Null graph */
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_edge_betweenness(&g, &res, IGRAPH_UNDIRECTED, 0);
+    if (igraph_vector_size(&res) != 0) {
+        return 201;
+    }
+    igraph_vector_destroy(&res);
+    igraph_destroy(&g);
+
+    return 0;
+}
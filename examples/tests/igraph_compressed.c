@@ -0,0 +1,255 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* Everything queried from the compressed graph must agree with the
+   original graph */
+
+int check_neighbors(const igraph_t *g, const igraph_compressed_t *cg) {
+    igraph_vector_t neis, cneis;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    igraph_compressed_nit_t nit;
+    igraph_integer_t nei, deg;
+    long int i, j;
+
+    if (igraph_compressed_vcount(cg) != igraph_vcount(g) ||
+        igraph_compressed_ecount(cg) != igraph_ecount(g) - igraph_deleted_ecount(g) ||
+        igraph_compressed_is_directed(cg) != igraph_is_directed(g)) {
+        return 1;
+    }
+
+    igraph_vector_init(&neis, 0);
+    igraph_vector_init(&cneis, 0);
+    for (i = 0; i < igraph_vcount(g); i++) {
+        for (j = 0; j < 3; j++) {
+            igraph_neighbors(g, &neis, (igraph_integer_t) i, modes[j]);
+            igraph_vector_clear(&cneis);
+            igraph_compressed_nit_create(cg, &nit, (igraph_integer_t) i, modes[j]);
+            while (igraph_compressed_nit_next(&nit, &nei)) {
+                igraph_vector_push_back(&cneis, nei);
+            }
+            /* out-neighbors first, then in-neighbors */
+            if (modes[j] == IGRAPH_ALL) {
+                igraph_vector_sort(&cneis);
+            }
+            if (!igraph_vector_all_e(&neis, &cneis)) {
+                return 2;
+            }
+            igraph_compressed_degree(cg, &deg, (igraph_integer_t) i, modes[j]);
+            if (deg != igraph_vector_size(&neis)) {
+                return 3;
+            }
+        }
+    }
+    igraph_vector_destroy(&neis);
+    igraph_vector_destroy(&cneis);
+
+    return 0;
+}
+
+int check_algorithms(const igraph_t *g, const igraph_compressed_t *cg) {
+    igraph_vector_t order1, order2, father1, father2, dist1, dist2;
+    igraph_vector_t memb1, memb2, csize1, csize2;
+    igraph_integer_t no1, no2;
+    long int i;
+
+    igraph_vector_init(&order1, 0);
+    igraph_vector_init(&order2, 0);
+    igraph_vector_init(&father1, 0);
+    igraph_vector_init(&father2, 0);
+    igraph_vector_init(&dist1, 0);
+    igraph_vector_init(&dist2, 0);
+
+    /* Sorted neighbor lists, the search must be exactly the same */
+    igraph_bfs(g, 0, 0, IGRAPH_OUT, /*unreachable=*/ 0, 0, &order1, 0,
+               &father1, 0, 0, &dist1, 0, 0);
+    igraph_compressed_bfs(cg, 0, IGRAPH_OUT, &order2, &father2, &dist2);
+    for (i = 0; i < igraph_vcount(g); i++) {
+        if (isnan(VECTOR(order1)[i]) != isnan(VECTOR(order2)[i]) ||
+            isnan(VECTOR(dist1)[i]) != isnan(VECTOR(dist2)[i])) {
+            return 11;
+        }
+        if ((!isnan(VECTOR(order1)[i]) && VECTOR(order1)[i] != VECTOR(order2)[i]) ||
+            (!isnan(VECTOR(dist1)[i]) && (VECTOR(dist1)[i] != VECTOR(dist2)[i] ||
+                                          VECTOR(father1)[i] != VECTOR(father2)[i]))) {
+            return 12;
+        }
+    }
+
+    /* Only the distances are the same if the direction is ignored */
+    igraph_bfs(g, 1, 0, IGRAPH_ALL, /*unreachable=*/ 0, 0, 0, 0,
+               0, 0, 0, &dist1, 0, 0);
+    igraph_compressed_bfs(cg, 1, IGRAPH_ALL, 0, 0, &dist2);
+    for (i = 0; i < igraph_vcount(g); i++) {
+        if (isnan(VECTOR(dist1)[i]) != isnan(VECTOR(dist2)[i]) ||
+            (!isnan(VECTOR(dist1)[i]) && VECTOR(dist1)[i] != VECTOR(dist2)[i])) {
+            return 13;
+        }
+    }
+
+    igraph_vector_init(&memb1, 0);
+    igraph_vector_init(&memb2, 0);
+    igraph_vector_init(&csize1, 0);
+    igraph_vector_init(&csize2, 0);
+    igraph_clusters(g, &memb1, &csize1, &no1, IGRAPH_WEAK);
+    igraph_compressed_clusters(cg, &memb2, &csize2, &no2);
+    if (no1 != no2 || !igraph_vector_all_e(&memb1, &memb2) ||
+        !igraph_vector_all_e(&csize1, &csize2)) {
+        return 14;
+    }
+
+    igraph_vector_destroy(&memb1);
+    igraph_vector_destroy(&memb2);
+    igraph_vector_destroy(&csize1);
+    igraph_vector_destroy(&csize2);
+    igraph_vector_destroy(&order1);
+    igraph_vector_destroy(&order2);
+    igraph_vector_destroy(&father1);
+    igraph_vector_destroy(&father2);
+    igraph_vector_destroy(&dist1);
+    igraph_vector_destroy(&dist2);
+
+    return 0;
+}
+
+int check_pagerank(const igraph_t *g, const igraph_compressed_t *cg,
+                   igraph_bool_t directed) {
+    igraph_vector_t pr1, pr2;
+    igraph_real_t value;
+    long int i;
+
+    igraph_vector_init(&pr1, 0);
+    igraph_vector_init(&pr2, 0);
+    igraph_pagerank(g, IGRAPH_PAGERANK_ALGO_PRPACK, &pr1, 0, igraph_vss_all(),
+                    directed, 0.85, 0, 0);
+    igraph_compressed_pagerank(cg, &pr2, &value, 0.85, directed);
+    if (value != 1) {
+        return 21;
+    }
+    for (i = 0; i < igraph_vcount(g); i++) {
+        if (fabs(VECTOR(pr1)[i] - VECTOR(pr2)[i]) > 1e-8) {
+            return 22;
+        }
+    }
+    igraph_vector_destroy(&pr1);
+    igraph_vector_destroy(&pr2);
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g, g2;
+    igraph_compressed_t cg, cg2;
+    int ret;
+
+    /* Loops and multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 500, directed,
+                            IGRAPH_LOOPS);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 5, 5);
+    igraph_compressed_init(&g, &cg);
+
+    ret = check_neighbors(&g, &cg);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = check_algorithms(&g, &cg);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* Restoring the graph gives the same neighbors */
+    igraph_compressed_get_graph(&cg, &g2);
+    ret = check_neighbors(&g2, &cg);
+    if (ret != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g2);
+    igraph_compressed_destroy(&cg);
+
+    /* Deleted edges and vertices are left out */
+    igraph_delete_edges_deferred(&g, igraph_ess_seq(0, 50), /*threshold=*/ 1);
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(3), /*threshold=*/ 1);
+    igraph_compressed_init(&g, &cg);
+    ret = check_neighbors(&g, &cg);
+    if (ret != 0) {
+        return 40 + ret;
+    }
+    igraph_compressed_destroy(&cg);
+    igraph_destroy(&g);
+
+    /* PageRank, without loops, with a gap in the vertex ids larger than
+       what fits into a single byte */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 3000, directed,
+                            IGRAPH_NO_LOOPS);
+    igraph_add_edge(&g, 0, 999);
+    igraph_compressed_init(&g, &cg);
+    ret = check_pagerank(&g, &cg, 1);
+    if (ret != 0) {
+        return 50 + ret;
+    }
+    ret = check_pagerank(&g, &cg, 0);
+    if (ret != 0) {
+        return 60 + ret;
+    }
+
+    /* The compressed graph does not depend on the original */
+    igraph_copy(&g2, &g);
+    igraph_compressed_init(&g2, &cg2);
+    igraph_destroy(&g2);
+    ret = check_neighbors(&g, &cg2);
+    if (ret != 0) {
+        return 70 + ret;
+    }
+
+    igraph_compressed_destroy(&cg2);
+    igraph_compressed_destroy(&cg);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_compressed_t cg;
+    igraph_compressed_nit_t nit;
+    igraph_vector_t res;
+    igraph_integer_t no;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 100 + ret;
+    }
+
+    /* Null graph */
+    igraph_empty(&g, 0, IGRAPH_DIRECTED);
+    igraph_vector_init(&res, 0);
+    igraph_compressed_init(&g, &cg);
+    igraph_compressed_clusters(&cg, &res, 0, &no);
+    if (no != 0 || igraph_vector_size(&res) != 0) {
+        return 200;
+    }
+    igraph_compressed_pagerank(&cg, &res, 0, 0.85, 1);
+    if (igraph_vector_size(&res) != 0) {
+        return 201;
+    }
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_compressed_nit_create(&cg, &nit, 0, IGRAPH_OUT) != IGRAPH_EINVVID ||
+        igraph_compressed_bfs(&cg, 0, IGRAPH_OUT, 0, 0, 0) != IGRAPH_EINVVID) {
+        return 202;
+    }
+    igraph_compressed_destroy(&cg);
+    igraph_destroy(&g);
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
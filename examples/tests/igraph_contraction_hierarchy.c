@@ -0,0 +1,301 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* Distances and paths from a contraction hierarchy, before and after
+   saving and loading it, must be the same as Dijkstra's */
+
+int check_path(const igraph_t *g, const igraph_vector_t *vertices,
+               const igraph_vector_t *edges, const igraph_vector_t *weights,
+               long int from, long int to, igraph_neimode_t mode,
+               igraph_real_t expected) {
+    long int i, len = igraph_vector_size(edges);
+    igraph_real_t sum = 0;
+
+    if (expected == IGRAPH_INFINITY) {
+        return igraph_vector_size(vertices) != 0 || len != 0;
+    }
+    if (igraph_vector_size(vertices) != len + 1 ||
+        VECTOR(*vertices)[0] != from || VECTOR(*vertices)[len] != to) {
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        long int edge = VECTOR(*edges)[i];
+        long int u = VECTOR(*vertices)[i], v = VECTOR(*vertices)[i + 1];
+        long int head = IGRAPH_TO(g, edge), tail = IGRAPH_FROM(g, edge);
+        if (!igraph_is_directed(g) || mode == IGRAPH_ALL) {
+            if (!((tail == u && head == v) || (tail == v && head == u))) {
+                return 1;
+            }
+        } else if (mode == IGRAPH_OUT && (tail != u || head != v)) {
+            return 1;
+        } else if (mode == IGRAPH_IN && (tail != v || head != u)) {
+            return 1;
+        }
+        sum += weights ? VECTOR(*weights)[edge] : 1;
+    }
+    return fabs(sum - expected) > 1e-9;
+}
+
+int compare(igraph_real_t a, igraph_real_t b) {
+    if (a == IGRAPH_INFINITY || b == IGRAPH_INFINITY) {
+        return a != b;
+    }
+    return fabs(a - b) > 1e-9;
+}
+
+int check_ch(const igraph_t *g, igraph_contraction_hierarchy_t *ch,
+             const igraph_vector_t *weights, igraph_neimode_t mode) {
+    igraph_vector_t vertices, edges, sources, targets;
+    igraph_matrix_t ref, res;
+    long int n = igraph_vcount(g), i, j;
+    igraph_real_t dist;
+
+    if (igraph_contraction_hierarchy_vcount(ch) != n) {
+        return 1;
+    }
+
+    igraph_vector_init(&sources, 10);
+    igraph_vector_init(&targets, 15);
+    for (i = 0; i < 10; i++) {
+        VECTOR(sources)[i] = i * (n / 10);
+    }
+    for (j = 0; j < 15; j++) {
+        VECTOR(targets)[j] = RNG_INTEGER(0, n - 1);
+    }
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_vector(&sources),
+                                   igraph_vss_all(), weights, mode);
+
+    for (i = 0; i < 10; i++) {
+        long int from = VECTOR(sources)[i];
+        for (j = 0; j < n; j++) {
+            igraph_contraction_hierarchy_distance(ch, &dist, from, j);
+            if (compare(dist, MATRIX(ref, i, j))) {
+                return 2;
+            }
+        }
+        for (j = 0; j < 30; j++) {
+            long int to = j < 2 ? from + j : RNG_INTEGER(0, n - 1);
+            igraph_contraction_hierarchy_path(ch, &vertices, &edges, from, to);
+            if (check_path(g, &vertices, &edges, weights, from, to, mode,
+                           MATRIX(ref, i, to))) {
+                return 3;
+            }
+        }
+    }
+
+    igraph_contraction_hierarchy_distances(ch, &res, &sources, &targets);
+    if (igraph_matrix_nrow(&res) != 10 || igraph_matrix_ncol(&res) != 15) {
+        return 4;
+    }
+    for (i = 0; i < 10; i++) {
+        for (j = 0; j < 15; j++) {
+            if (compare(MATRIX(res, i, j),
+                        MATRIX(ref, i, (long int) VECTOR(targets)[j]))) {
+                return 4;
+            }
+        }
+    }
+
+    igraph_matrix_destroy(&res);
+    igraph_matrix_destroy(&ref);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_vector_destroy(&targets);
+    igraph_vector_destroy(&sources);
+
+    return 0;
+}
+
+/* Checks the hierarchy, and its copy written to and read from a file */
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_neimode_t mode) {
+    igraph_contraction_hierarchy_t ch, ch2;
+    FILE *file;
+    int ret;
+
+    igraph_contraction_hierarchy_init(g, &ch, weights, mode);
+    if ((ret = check_ch(g, &ch, weights, mode)) != 0) {
+        return ret;
+    }
+
+    file = tmpfile();
+    if (!file) {
+        return 5;
+    }
+    igraph_contraction_hierarchy_write(&ch, file);
+    rewind(file);
+    if (igraph_contraction_hierarchy_read(&ch2, file) != 0) {
+        return 6;
+    }
+    fclose(file);
+    if (igraph_contraction_hierarchy_shortcut_count(&ch) !=
+        igraph_contraction_hierarchy_shortcut_count(&ch2)) {
+        return 7;
+    }
+    if ((ret = check_ch(g, &ch2, weights, mode)) != 0) {
+        return ret;
+    }
+
+    igraph_contraction_hierarchy_destroy(&ch2);
+    igraph_contraction_hierarchy_destroy(&ch);
+
+    return 0;
+}
+
+/* Writes a hierarchy and reads it back, returns the error code */
+int write_read(const igraph_contraction_hierarchy_t *ch) {
+    igraph_contraction_hierarchy_t ch2;
+    FILE *file = tmpfile();
+    int ret;
+
+    if (!file) {
+        return -1;
+    }
+    igraph_contraction_hierarchy_write(ch, file);
+    rewind(file);
+    ret = igraph_contraction_hierarchy_read(&ch2, file);
+    fclose(file);
+    if (ret == 0) {
+        igraph_contraction_hierarchy_destroy(&ch2);
+    }
+    return ret;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t x, y, weights, dims, edges;
+    igraph_contraction_hierarchy_t ch;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    FILE *file;
+    long int i, m;
+    int ret, k;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    /* Geometric graph, the weights are the lengths of the edges, there
+       are a few small components */
+    igraph_vector_init(&x, 0);
+    igraph_vector_init(&y, 0);
+    igraph_grg_game(&g, 2000, 0.04, /*torus=*/ 0, &x, &y);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        long int u = IGRAPH_FROM(&g, i), v = IGRAPH_TO(&g, i);
+        VECTOR(weights)[i] = hypot(VECTOR(x)[u] - VECTOR(x)[v],
+                                   VECTOR(y)[u] - VECTOR(y)[v]);
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL)) != 0) {
+        return ret;
+    }
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Directed, integer weights with zeros, multi-edges, loops and a
+       few deleted edges, in every mode */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 900,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init_int(&edges, 6, 0, 1, 0, 1, 1, 2);
+    igraph_add_edges(&g, &edges, 0);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 10);
+    }
+    igraph_random_sample(&edges, 0, m - 1, 30);
+    igraph_delete_edges_deferred(&g, igraph_ess_vector(&edges), /*threshold=*/ 1);
+    for (k = 0; k < 3; k++) {
+        if ((ret = check(&g, &weights, modes[k])) != 0) {
+            return 10 + 10 * k + ret;
+        }
+    }
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Unweighted lattice, with many equally short paths */
+    igraph_vector_init_int(&dims, 2, 30, 30);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    if ((ret = check(&g, 0, IGRAPH_ALL)) != 0) {
+        return 40 + ret;
+    }
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    /* Directed cycle, the distances in the two directions differ */
+    igraph_ring(&g, 100, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+    if ((ret = check(&g, 0, IGRAPH_OUT)) != 0) {
+        return 50 + ret;
+    }
+    if ((ret = check(&g, 0, IGRAPH_IN)) != 0) {
+        return 60 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Invalid files */
+    file = tmpfile();
+    fputs("IGRAPHSN and more", file);
+    rewind(file);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_contraction_hierarchy_read(&ch, file) != IGRAPH_PARSEERROR) {
+        return 70;
+    }
+    fclose(file);
+    file = tmpfile();
+    fputs("IGRAPHCH", file);
+    rewind(file);
+    if (igraph_contraction_hierarchy_read(&ch, file) != IGRAPH_PARSEERROR) {
+        return 71;
+    }
+    fclose(file);
+
+    /* Shortcuts that refer to themselves, to later arcs or to arcs
+       that do not form a path, and ranks that are not a permutation */
+    igraph_ring(&g, 100, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+    igraph_contraction_hierarchy_init(&g, &ch, 0, IGRAPH_OUT);
+    m = igraph_vector_int_size(&ch.arc_second);
+    for (i = m - 1; i >= 0 && VECTOR(ch.arc_second)[i] < 0; i--) ;
+    if (i < 0) {
+        return 72;
+    }
+    k = VECTOR(ch.arc_second)[i];
+    VECTOR(ch.arc_second)[i] = (int) i;
+    if (write_read(&ch) != IGRAPH_PARSEERROR) {
+        return 73;
+    }
+    VECTOR(ch.arc_second)[i] = (int) (m - 1);
+    if (i < m - 1 && write_read(&ch) != IGRAPH_PARSEERROR) {
+        return 74;
+    }
+    VECTOR(ch.arc_second)[i] = VECTOR(ch.arc_first)[i];
+    if (write_read(&ch) != IGRAPH_PARSEERROR) {
+        return 75;
+    }
+    VECTOR(ch.arc_second)[i] = k;
+    if (write_read(&ch) != 0) {
+        return 76;
+    }
+    k = VECTOR(ch.rank)[1];
+    VECTOR(ch.rank)[1] = VECTOR(ch.rank)[0];
+    if (write_read(&ch) != IGRAPH_PARSEERROR) {
+        return 77;
+    }
+    VECTOR(ch.rank)[1] = k;
+    igraph_contraction_hierarchy_destroy(&ch);
+    igraph_destroy(&g);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 78;
+    }
+
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+
+    return 0;
+}
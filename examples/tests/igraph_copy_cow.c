@@ -0,0 +1,146 @@
+#include <igraph.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Copies share their data with the original graph, but modifying one
+   of them must not change the others */
+
+int same_edges(const igraph_t *g, const igraph_vector_t *edges) {
+    igraph_vector_t el;
+    int res;
+    igraph_vector_init(&el, 0);
+    igraph_get_edgelist(g, &el, 0);
+    res = igraph_vector_all_e(&el, edges);
+    igraph_vector_destroy(&el);
+    return res;
+}
+
+int same_neighbors(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t n1, n2;
+    long int i;
+    int res = 1;
+    if (igraph_vcount(g1) != igraph_vcount(g2)) {
+        return 0;
+    }
+    igraph_vector_init(&n1, 0);
+    igraph_vector_init(&n2, 0);
+    for (i = 0; res && i < igraph_vcount(g1); i++) {
+        igraph_neighbors(g1, &n1, (igraph_integer_t) i, IGRAPH_ALL);
+        igraph_neighbors(g2, &n2, (igraph_integer_t) i, IGRAPH_ALL);
+        res = igraph_vector_all_e(&n1, &n2);
+    }
+    igraph_vector_destroy(&n1);
+    igraph_vector_destroy(&n2);
+    return res;
+}
+
+int main() {
+    igraph_t g, c1, c2, c3;
+    igraph_vector_t edges, el;
+
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+
+    igraph_ring(&g, 10, IGRAPH_DIRECTED, 0, /*circular=*/ 1);
+    SETGAS(&g, "name", "ring");
+    SETVAN(&g, "weight", 0, 1);
+    SETEAN(&g, "weight", 0, 2);
+    igraph_vector_init(&edges, 0);
+    igraph_get_edgelist(&g, &edges, 0);
+
+    /* Copies of copies, all of them share the same data */
+    igraph_copy(&c1, &g);
+    igraph_copy(&c2, &c1);
+    igraph_copy(&c3, &g);
+    if (!same_edges(&c1, &edges) || !same_edges(&c2, &edges) ||
+        !same_neighbors(&g, &c3) || strcmp(GAS(&c2, "name"), "ring") ||
+        VAN(&c2, "weight", 0) != 1 || EAN(&c3, "weight", 0) != 2) {
+        return 1;
+    }
+
+    /* Modifying the structure of a copy */
+    igraph_add_edge(&c1, 0, 5);
+    if (!same_edges(&g, &edges) || !same_edges(&c2, &edges) ||
+        igraph_ecount(&c1) != 11) {
+        return 2;
+    }
+    igraph_add_vertices(&c2, 3, 0);
+    if (igraph_vcount(&g) != 10 || igraph_vcount(&c3) != 10 ||
+        igraph_vcount(&c2) != 13 || !same_neighbors(&g, &c3)) {
+        return 3;
+    }
+    igraph_delete_edges(&c3, igraph_ess_1(0));
+    if (!same_edges(&g, &edges) || igraph_ecount(&c3) != 9) {
+        return 4;
+    }
+    igraph_delete_vertices(&c3, igraph_vss_1(0));
+    if (!same_edges(&g, &edges) || igraph_vcount(&g) != 10) {
+        return 5;
+    }
+    igraph_destroy(&c3);
+
+    /* Modifying the attributes of a copy */
+    igraph_copy(&c3, &g);
+    SETGAS(&c3, "name", "other");
+    SETVAN(&c3, "weight", 0, 10);
+    SETEAN(&c3, "weight", 0, 20);
+    DELVA(&c3, "weight");
+    if (strcmp(GAS(&g, "name"), "ring") || VAN(&g, "weight", 0) != 1 ||
+        EAN(&g, "weight", 0) != 2 || strcmp(GAS(&c3, "name"), "other") ||
+        EAN(&c3, "weight", 0) != 20 || igraph_cattribute_has_attr(&c3,
+                IGRAPH_ATTRIBUTE_VERTEX, "weight")) {
+        return 6;
+    }
+    igraph_destroy(&c3);
+
+    /* Modifying the original, the copy keeps the old data */
+    igraph_copy(&c3, &g);
+    SETVAN(&g, "weight", 0, 100);
+    igraph_add_edge(&g, 1, 1);
+    if (!same_edges(&c3, &edges) || VAN(&c3, "weight", 0) != 1 ||
+        VAN(&g, "weight", 0) != 100 || igraph_ecount(&g) != 11) {
+        return 7;
+    }
+
+    /* Destroying the original first, the copies still work */
+    igraph_destroy(&g);
+    igraph_destroy(&c1);
+    if (!same_edges(&c3, &edges) || strcmp(GAS(&c3, "name"), "ring")) {
+        return 8;
+    }
+    igraph_destroy(&c3);
+    igraph_destroy(&c2);
+
+    /* Deferred deletion marks are not shared */
+    igraph_ring(&g, 10, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    igraph_copy(&c1, &g);
+    igraph_delete_edges_deferred(&c1, igraph_ess_1(3), /*threshold=*/ 1);
+    if (igraph_deleted_ecount(&g) != 0 || !igraph_is_edge_deleted(&c1, 3)) {
+        return 9;
+    }
+    igraph_copy(&c2, &c1);
+    igraph_compact_deleted(&c2, 0, 0);
+    if (igraph_ecount(&c2) != 9 || igraph_ecount(&c1) != 10 ||
+        !igraph_is_edge_deleted(&c1, 3)) {
+        return 10;
+    }
+    igraph_destroy(&c2);
+    igraph_destroy(&c1);
+
+    /* Copying the only remaining copy after the original is gone */
+    igraph_copy(&c1, &g);
+    igraph_destroy(&g);
+    igraph_add_edge(&c1, 0, 5);
+    igraph_copy(&c2, &c1);
+    igraph_vector_init(&el, 0);
+    igraph_get_edgelist(&c1, &el, 0);
+    if (!same_edges(&c2, &el) || igraph_ecount(&c2) != 11) {
+        return 11;
+    }
+    igraph_vector_destroy(&el);
+    igraph_destroy(&c1);
+    igraph_destroy(&c2);
+
+    igraph_vector_destroy(&edges);
+
+    return 0;
+}
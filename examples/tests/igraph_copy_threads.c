@@ -0,0 +1,76 @@
+#include <igraph.h>
+#include <pthread.h>
+#include <stdio.h>
+
+/* Copies that share their data with other graphs are copied, modified
+   and destroyed in several threads at the same time; every thread
+   must see its own graph, and the shared data must be freed exactly
+   once. The library must be thread-safe for this. */
+
+#define THREADS 8
+#define ROUNDS 200
+
+igraph_t copies[THREADS];
+int results[THREADS];
+
+void *thread_function(void *arg) {
+    long int k = (long int) arg, r;
+    igraph_t *g = &copies[k];
+    igraph_integer_t n = igraph_vcount(g), m = igraph_ecount(g);
+
+    for (r = 0; r < ROUNDS; r++) {
+        igraph_t c;
+        igraph_copy(&c, g);
+        if (r % 2 == 0) {
+            igraph_add_edge(&c, 0, (igraph_integer_t) k);
+            SETEAN(&c, "weight", m, k);
+            if (igraph_ecount(&c) != m + 1 || EAN(&c, "weight", m) != k) {
+                results[k] = 1;
+            }
+        }
+        igraph_destroy(&c);
+        if (igraph_vcount(g) != n || igraph_ecount(g) != m) {
+            results[k] = 2;
+        }
+    }
+    /* the first modification of the copy shared with the others */
+    igraph_add_vertices(g, 1, 0);
+    SETVAN(g, "id", n, k);
+    if (igraph_vcount(g) != n + 1 || VAN(g, "id", n) != k) {
+        results[k] = 3;
+    }
+    igraph_destroy(g);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    pthread_t threads[THREADS];
+    long int k;
+
+#if !IGRAPH_THREAD_SAFE
+    /* skipped */
+    return 77;
+#endif
+
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+    igraph_ring(&g, 1000, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    SETEAN(&g, "weight", 0, -1);
+
+    for (k = 0; k < THREADS; k++) {
+        igraph_copy(&copies[k], &g);
+    }
+    igraph_destroy(&g);
+    for (k = 0; k < THREADS; k++) {
+        pthread_create(&threads[k], 0, thread_function, (void *) k);
+    }
+    for (k = 0; k < THREADS; k++) {
+        pthread_join(threads[k], 0);
+        if (results[k] != 0) {
+            return results[k];
+        }
+    }
+
+    return 0;
+}
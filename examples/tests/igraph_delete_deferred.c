@@ -0,0 +1,264 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* Deferred deletion must give the same results as eager deletion,
+   both before compaction, via the query functions, and after it. */
+
+int check_same(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j;
+
+    if (igraph_vcount(g1) != igraph_vcount(g2) ||
+        igraph_ecount(g1) != igraph_ecount(g2)) {
+        return 1;
+    }
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    for (i = 0; i < igraph_vcount(g1); i++) {
+        for (j = 0; j < 3; j++) {
+            igraph_neighbors(g1, &v1, (igraph_integer_t) i, modes[j]);
+            igraph_neighbors(g2, &v2, (igraph_integer_t) i, modes[j]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 2;
+            }
+        }
+    }
+
+    igraph_get_edgelist(g1, &v1, 0);
+    igraph_get_edgelist(g2, &v2, 0);
+    if (!igraph_vector_all_e(&v1, &v2)) {
+        return 3;
+    }
+
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return 0;
+}
+
+/* Neighbors and degrees in 'g' with marked edges, and in 'eager'
+   that has them removed; vertex ids are the same in the two */
+
+int check_queries(const igraph_t *g, const igraph_t *eager) {
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j;
+    igraph_integer_t size;
+    igraph_es_t es;
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    for (i = 0; i < igraph_vcount(g); i++) {
+        for (j = 0; j < 3; j++) {
+            igraph_neighbors(g, &v1, (igraph_integer_t) i, modes[j]);
+            igraph_neighbors(eager, &v2, (igraph_integer_t) i, modes[j]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 11;
+            }
+            igraph_incident(g, &v1, (igraph_integer_t) i, modes[j]);
+            if (igraph_vector_size(&v1) != igraph_vector_size(&v2)) {
+                return 12;
+            }
+        }
+    }
+
+    for (j = 0; j < 3; j++) {
+        igraph_degree(g, &v1, igraph_vss_all(), modes[j], IGRAPH_LOOPS);
+        igraph_degree(eager, &v2, igraph_vss_all(), modes[j], IGRAPH_LOOPS);
+        if (!igraph_vector_all_e(&v1, &v2)) {
+            return 13;
+        }
+        igraph_degree(g, &v1, igraph_vss_all(), modes[j], IGRAPH_NO_LOOPS);
+        igraph_degree(eager, &v2, igraph_vss_all(), modes[j], IGRAPH_NO_LOOPS);
+        if (!igraph_vector_all_e(&v1, &v2)) {
+            return 14;
+        }
+    }
+
+    /* The live edges must be found, the deleted ones must not */
+    for (i = 0; i < igraph_ecount(g); i++) {
+        igraph_integer_t eid = -1;
+        igraph_get_eid(g, &eid, IGRAPH_FROM(g, i), IGRAPH_TO(g, i),
+                       IGRAPH_DIRECTED, /*error=*/ 0);
+        if (eid >= 0 && igraph_is_edge_deleted(g, eid)) {
+            return 15;
+        }
+        if (!igraph_is_edge_deleted(g, (igraph_integer_t) i) && eid < 0) {
+            return 16;
+        }
+    }
+
+    igraph_es_all(&es, IGRAPH_EDGEORDER_ID);
+    igraph_es_size(g, &es, &size);
+    if (size != igraph_ecount(eager)) {
+        return 17;
+    }
+
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return 0;
+}
+
+int test_edges(igraph_bool_t directed) {
+    igraph_t g, eager;
+    igraph_vector_t del;
+    long int i;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 30, 200, directed,
+                            IGRAPH_LOOPS);
+    igraph_copy(&eager, &g);
+
+    igraph_vector_init(&del, 0);
+    for (i = 0; i < igraph_ecount(&g); i += 3) {
+        igraph_vector_push_back(&del, i);
+    }
+
+    /* In two steps, one edge twice */
+    igraph_vector_resize(&del, 20);
+    igraph_delete_edges_deferred(&g, igraph_ess_vector(&del), /*threshold=*/ 1);
+    for (i = 20; i < igraph_ecount(&g); i += 3) {
+        igraph_vector_push_back(&del, i);
+    }
+    igraph_vector_push_back(&del, 0);
+    igraph_delete_edges_deferred(&g, igraph_ess_vector(&del), /*threshold=*/ 1);
+
+    if (igraph_deleted_ecount(&g) != igraph_vector_size(&del) - 1) {
+        return 1;
+    }
+
+    igraph_delete_edges(&eager, igraph_ess_vector(&del));
+
+    ret = check_queries(&g, &eager);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* New edges are fine, and they are not deleted */
+    igraph_add_edge(&g, 0, 1);
+    igraph_add_edge(&eager, 0, 1);
+    if (igraph_is_edge_deleted(&g, igraph_ecount(&g) - 1)) {
+        return 2;
+    }
+
+    igraph_compact_deleted(&g, 0, 0);
+    if (igraph_deleted_ecount(&g) != 0) {
+        return 3;
+    }
+    ret = check_same(&g, &eager);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+
+    /* Automatic compaction */
+    igraph_delete_edges_deferred(&g, igraph_ess_1(0), /*threshold=*/ 0);
+    igraph_delete_edges(&eager, igraph_ess_1(0));
+    if (igraph_deleted_ecount(&g) != 0) {
+        return 4;
+    }
+    ret = check_same(&g, &eager);
+    if (ret != 0) {
+        return 30 + ret;
+    }
+
+    igraph_vector_destroy(&del);
+    igraph_destroy(&eager);
+    igraph_destroy(&g);
+    return 0;
+}
+
+int test_vertices(igraph_bool_t directed) {
+    igraph_t g, eager, copy;
+    igraph_vector_t idx1, idx2, invidx;
+    igraph_integer_t size;
+    igraph_vs_t vs;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 30, 150, directed,
+                            IGRAPH_LOOPS);
+    igraph_copy(&eager, &g);
+
+    igraph_delete_vertices_deferred(&g, igraph_vss_seq(5, 9), /*threshold=*/ 1);
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(7), /*threshold=*/ 1);
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(20), /*threshold=*/ 1);
+    if (igraph_deleted_vcount(&g) != 6 || !igraph_is_vertex_deleted(&g, 20) ||
+        igraph_is_vertex_deleted(&g, 10)) {
+        return 1;
+    }
+
+    /* Deleted vertices are still selected, as isolated vertices */
+    igraph_vs_all(&vs);
+    igraph_vs_size(&g, &vs, &size);
+    if (size != 30) {
+        return 2;
+    }
+
+    /* Adding edges to deleted vertices is an error */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_add_edge(&g, 1, 20) != IGRAPH_EINVVID) {
+        return 3;
+    }
+    igraph_set_error_handler(igraph_error_handler_abort);
+
+    /* The marks are copied */
+    igraph_copy(&copy, &g);
+
+    igraph_vector_init(&idx1, 0);
+    igraph_vector_init(&idx2, 0);
+    igraph_vector_init(&invidx, 0);
+    igraph_compact_deleted(&g, &idx1, &invidx);
+    igraph_delete_vertices_idx(&eager, igraph_vss_seq(5, 9), 0, 0);
+    igraph_delete_vertices_idx(&eager, igraph_vss_1(15), &idx2, 0);
+
+    ret = check_same(&g, &eager);
+    if (ret != 0) {
+        return 10 + ret;
+    }
+    if (VECTOR(idx1)[21] != VECTOR(idx2)[16] || VECTOR(idx1)[20] != 0 ||
+        VECTOR(invidx)[5] != 10) {
+        return 4;
+    }
+
+    /* Deleted vertices are compacted by igraph_delete_vertices() as well */
+    igraph_delete_vertices(&copy, igraph_vss_none());
+    ret = check_same(&copy, &eager);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+
+    igraph_vector_destroy(&idx1);
+    igraph_vector_destroy(&idx2);
+    igraph_vector_destroy(&invidx);
+    igraph_destroy(&copy);
+    igraph_destroy(&eager);
+    igraph_destroy(&g);
+    return 0;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test_edges(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test_edges(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 40 + ret;
+    }
+    ret = test_vertices(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return 80 + ret;
+    }
+    ret = test_vertices(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 120 + ret;
+    }
+
+    return 0;
+}
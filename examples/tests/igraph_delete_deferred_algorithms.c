@@ -0,0 +1,134 @@
+#include <igraph.h>
+#include <math.h>
+
+/* Whole-graph algorithms on a graph with vertices deleted by
+   igraph_delete_vertices_deferred() must give the same results as on
+   the graph where only the edges of these vertices were removed: the
+   deleted vertices keep their ids, as isolated vertices. */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i, n = igraph_vector_size(v1);
+    if (igraph_vector_size(v2) != n) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t a = VECTOR(*v1)[i], b = VECTOR(*v2)[i];
+        if ((igraph_is_nan(a) || igraph_is_nan(b)) ?
+            !(igraph_is_nan(a) && igraph_is_nan(b)) : fabs(a - b) > 1e-9) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check(const igraph_t *g, const igraph_t *ref) {
+    igraph_vector_t v1, v2;
+    igraph_arpack_options_t options;
+    igraph_real_t t1, t2;
+    igraph_pagerank_algo_t algos[] = { IGRAPH_PAGERANK_ALGO_PRPACK,
+                                       IGRAPH_PAGERANK_ALGO_ARPACK
+                                     };
+    int k, ret = 0;
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+    igraph_arpack_options_init(&options);
+
+    igraph_degree(g, &v1, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+    igraph_degree(ref, &v2, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+    if (igraph_vector_size(&v1) != igraph_vcount(g) || !same(&v1, &v2)) {
+        ret = 1;
+    }
+
+    if (!igraph_is_directed(g)) {
+        igraph_transitivity_local_undirected(g, &v1, igraph_vss_all(),
+                                             IGRAPH_TRANSITIVITY_NAN);
+        igraph_transitivity_local_undirected(ref, &v2, igraph_vss_all(),
+                                             IGRAPH_TRANSITIVITY_NAN);
+        if (!same(&v1, &v2)) {
+            ret = 2;
+        }
+        igraph_transitivity_undirected(g, &t1, IGRAPH_TRANSITIVITY_NAN);
+        igraph_transitivity_undirected(ref, &t2, IGRAPH_TRANSITIVITY_NAN);
+        if (fabs(t1 - t2) > 1e-9) {
+            ret = 3;
+        }
+    }
+
+    for (k = 0; k < 2; k++) {
+        igraph_pagerank(g, algos[k], &v1, 0, igraph_vss_all(), IGRAPH_DIRECTED,
+                        0.85, 0, &options);
+        igraph_pagerank(ref, algos[k], &v2, 0, igraph_vss_all(), IGRAPH_DIRECTED,
+                        0.85, 0, &options);
+        if (igraph_vector_size(&v1) != igraph_vcount(g) || !same(&v1, &v2)) {
+            ret = 4 + k;
+        }
+    }
+
+    igraph_eccentricity(g, &v1, igraph_vss_all(), IGRAPH_ALL);
+    igraph_eccentricity(ref, &v2, igraph_vss_all(), IGRAPH_ALL);
+    if (!same(&v1, &v2)) {
+        ret = 6;
+    }
+    igraph_eccentricity(g, &v2, igraph_vss_seq(0, igraph_vcount(g) - 1),
+                        IGRAPH_ALL);
+    if (!same(&v1, &v2)) {
+        ret = 7;
+    }
+
+    igraph_vector_destroy(&v2);
+    igraph_vector_destroy(&v1);
+
+    return ret;
+}
+
+int test(igraph_integer_t n, igraph_integer_t m, igraph_bool_t directed,
+         const igraph_vs_t vids) {
+    igraph_t g, ref;
+    igraph_es_t es;
+    igraph_vit_t vit;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, m, directed,
+                            IGRAPH_NO_LOOPS);
+    igraph_copy(&ref, &g);
+
+    igraph_delete_vertices_deferred(&g, vids, /*threshold=*/ 1);
+    igraph_vit_create(&ref, vids, &vit);
+    for (; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit)) {
+        igraph_es_incident(&es, IGRAPH_VIT_GET(vit), IGRAPH_ALL);
+        igraph_delete_edges(&ref, es);
+        igraph_es_destroy(&es);
+    }
+    igraph_vit_destroy(&vit);
+
+    ret = check(&g, &ref);
+
+    igraph_destroy(&ref);
+    igraph_destroy(&g);
+
+    return ret;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A full graph without its first vertex */
+    if ((ret = test(5, 10, IGRAPH_UNDIRECTED, igraph_vss_1(0))) != 0) {
+        return ret;
+    }
+    if ((ret = test(100, 400, IGRAPH_UNDIRECTED, igraph_vss_seq(10, 19))) != 0) {
+        return 10 + ret;
+    }
+    if ((ret = test(100, 400, IGRAPH_DIRECTED, igraph_vss_seq(50, 69))) != 0) {
+        return 20 + ret;
+    }
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 30;
+    }
+
+    return 0;
+}
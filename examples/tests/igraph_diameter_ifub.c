@@ -0,0 +1,135 @@
+#include <igraph.h>
+
+/* The diameter of undirected graphs does not need a BFS from every
+   vertex; the result must be the same as with a BFS from each vertex
+   in turn, including the endpoints and the path. */
+
+int brute_force(const igraph_t *g, igraph_bool_t unconn, long int *res,
+                long int *from, long int *to) {
+    long int n = igraph_vcount(g), i, j;
+    igraph_vector_t order, dist;
+
+    igraph_vector_init(&order, 0);
+    igraph_vector_init(&dist, 0);
+    *res = 0;
+    *from = *to = 0;
+    for (i = 0; i < n; i++) {
+        igraph_bfs(g, (igraph_integer_t) i, 0, IGRAPH_ALL, /*unreachable=*/ 0,
+                   0, &order, 0, 0, 0, 0, &dist, 0, 0);
+        for (j = 0; j < n && VECTOR(order)[j] >= 0; j++) {
+            long int v = (long int) VECTOR(order)[j];
+            if (VECTOR(dist)[v] > *res) {
+                *res = (long int) VECTOR(dist)[v];
+                *from = i;
+                *to = v;
+            }
+        }
+        if (j < n && !unconn) {
+            *res = n;
+            *from = *to = -1;
+            break;
+        }
+    }
+    igraph_vector_destroy(&dist);
+    igraph_vector_destroy(&order);
+    return 0;
+}
+
+int check(const igraph_t *g) {
+    igraph_integer_t res, from, to;
+    long int res2, from2, to2;
+    igraph_vector_t path;
+    igraph_bool_t unconn;
+
+    igraph_vector_init(&path, 0);
+    for (unconn = 0; unconn <= 1; unconn++) {
+        brute_force(g, unconn, &res2, &from2, &to2);
+        igraph_diameter(g, &res, &from, &to, igraph_vcount(g) > 0 ? &path : 0,
+                        IGRAPH_UNDIRECTED, unconn);
+        if (res != res2 || from != from2 || to != to2) {
+            printf("%ld %ld %ld, expected %ld %ld %ld\n", (long int) res,
+                   (long int) from, (long int) to, res2, from2, to2);
+            return 1;
+        }
+        if (igraph_vcount(g) == 0) {
+            continue;
+        } else if (from < 0) {
+            if (igraph_vector_size(&path) != 0) {
+                return 2;
+            }
+        } else if (igraph_vector_size(&path) != res + 1 ||
+                   VECTOR(path)[0] != from || VECTOR(path)[res] != to) {
+            return 3;
+        }
+    }
+    igraph_vector_destroy(&path);
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dims;
+    long int i;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Random graphs, connected or not, directed ones as undirected */
+    for (i = 0; i < 50; i++) {
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, RNG_INTEGER(50, 300),
+                                i % 2, IGRAPH_NO_LOOPS);
+        if ((ret = check(&g)) != 0) {
+            return ret;
+        }
+        igraph_destroy(&g);
+    }
+
+    /* Trees have many vertices at the largest distance */
+    for (i = 0; i < 20; i++) {
+        igraph_tree_game(&g, 200, IGRAPH_UNDIRECTED, IGRAPH_RANDOM_TREE_LERW);
+        if ((ret = check(&g)) != 0) {
+            return 10 + ret;
+        }
+        igraph_destroy(&g);
+    }
+
+    /* Many vertices with the same eccentricity */
+    igraph_vector_init_int(&dims, 2, 17, 23);
+    igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    if ((ret = check(&g)) != 0) {
+        return 20 + ret;
+    }
+    igraph_destroy(&g);
+    igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, /*circular=*/ 0);
+    if ((ret = check(&g)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g);
+    igraph_vector_destroy(&dims);
+
+    /* The longest path is not in the first component */
+    igraph_small(&g, 9, IGRAPH_UNDIRECTED, 0, 1, 1, 2, 3, 4, 4, 5, 5, 6, 6, 7,
+                 -1);
+    if ((ret = check(&g)) != 0) {
+        return 40 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* No edges, and no vertices */
+    igraph_empty(&g, 5, IGRAPH_UNDIRECTED);
+    if ((ret = check(&g)) != 0) {
+        return 50 + ret;
+    }
+    igraph_destroy(&g);
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    if ((ret = check(&g)) != 0) {
+        return 60 + ret;
+    }
+    igraph_destroy(&g);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 70;
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include <igraph.h>
+#include <math.h>
+
+/* Small integer weights are handled with buckets instead of a heap;
+   halving the weights makes some of them non-integer, so the results
+   must be the same as with the heap, halved. Betweenness and
+   harmonic centrality need positive weights. The distances of
+   multigraphs are also compared to the Floyd-Warshall algorithm. */
+
+int floyd_warshall(const igraph_t *g, const igraph_vector_t *weights) {
+    long int n = igraph_vcount(g), m = igraph_ecount(g), i, j, k;
+    igraph_matrix_t d, res;
+
+    igraph_matrix_init(&d, n, n);
+    igraph_matrix_fill(&d, IGRAPH_INFINITY);
+    for (i = 0; i < n; i++) {
+        MATRIX(d, i, i) = 0;
+    }
+    for (i = 0; i < m; i++) {
+        long int from = IGRAPH_FROM(g, i), to = IGRAPH_TO(g, i);
+        if (VECTOR(*weights)[i] < MATRIX(d, from, to)) {
+            MATRIX(d, from, to) = VECTOR(*weights)[i];
+        }
+    }
+    for (k = 0; k < n; k++) {
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n; j++) {
+                if (MATRIX(d, i, k) + MATRIX(d, k, j) < MATRIX(d, i, j)) {
+                    MATRIX(d, i, j) = MATRIX(d, i, k) + MATRIX(d, k, j);
+                }
+            }
+        }
+    }
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &res, igraph_vss_all(), igraph_vss_all(),
+                                   weights, IGRAPH_OUT);
+    if (!igraph_matrix_all_e(&d, &res)) {
+        return 1;
+    }
+    igraph_matrix_destroy(&res);
+    igraph_matrix_destroy(&d);
+    return 0;
+}
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_bool_t positive) {
+    igraph_vector_t half, res1, res2;
+    igraph_matrix_t m1, m2;
+    igraph_real_t d1, d2;
+    igraph_integer_t from, to;
+    igraph_vector_t path;
+    long int i, n = igraph_vector_size(weights);
+
+    igraph_vector_copy(&half, weights);
+    igraph_vector_scale(&half, 0.5);
+    igraph_vector_init(&res1, 0);
+    igraph_vector_init(&res2, 0);
+    igraph_matrix_init(&m1, 0, 0);
+    igraph_matrix_init(&m2, 0, 0);
+    igraph_vector_init(&path, 0);
+
+    igraph_shortest_paths_dijkstra(g, &m1, igraph_vss_all(), igraph_vss_all(),
+                                   weights, IGRAPH_OUT);
+    igraph_shortest_paths_dijkstra(g, &m2, igraph_vss_all(), igraph_vss_all(),
+                                   &half, IGRAPH_OUT);
+    igraph_matrix_scale(&m2, 2);
+    if (!igraph_matrix_all_e(&m1, &m2)) {
+        return 1;
+    }
+    igraph_shortest_paths_dijkstra(g, &m1, igraph_vss_1(3),
+                                   igraph_vss_seq(5, 9), weights, IGRAPH_IN);
+    for (i = 0; i < 5; i++) {
+        if (MATRIX(m1, 0, i) != MATRIX(m2, 5 + i, 3)) {
+            return 2;
+        }
+    }
+
+    igraph_diameter_dijkstra(g, weights, &d1, &from, &to, &path,
+                             IGRAPH_DIRECTED, /*unconn=*/ 1);
+    igraph_diameter_dijkstra(g, &half, &d2, 0, 0, 0,
+                             IGRAPH_DIRECTED, /*unconn=*/ 1);
+    if (d1 != 2 * d2 || MATRIX(m2, from, to) != d1 ||
+        VECTOR(path)[0] != from ||
+        VECTOR(path)[igraph_vector_size(&path) - 1] != to) {
+        return 3;
+    }
+
+    if (!positive) {
+        goto done;
+    }
+
+    igraph_betweenness(g, &res1, igraph_vss_all(), IGRAPH_DIRECTED, weights,
+                       /*nobigint=*/ 1);
+    igraph_betweenness(g, &res2, igraph_vss_all(), IGRAPH_DIRECTED, &half,
+                       /*nobigint=*/ 1);
+    for (i = 0; i < igraph_vector_size(&res1); i++) {
+        if (fabs(VECTOR(res1)[i] - VECTOR(res2)[i]) > 1e-9) {
+            return 4;
+        }
+    }
+    igraph_edge_betweenness(g, &res1, IGRAPH_DIRECTED, weights);
+    igraph_edge_betweenness(g, &res2, IGRAPH_DIRECTED, &half);
+    for (i = 0; i < n; i++) {
+        if (fabs(VECTOR(res1)[i] - VECTOR(res2)[i]) > 1e-9) {
+            return 5;
+        }
+    }
+
+    igraph_harmonic_centrality(g, &res1, igraph_vss_all(), IGRAPH_OUT, weights,
+                               /*normalized=*/ 0);
+    igraph_harmonic_centrality(g, &res2, igraph_vss_all(), IGRAPH_OUT, &half,
+                               /*normalized=*/ 0);
+    for (i = 0; i < igraph_vector_size(&res1); i++) {
+        if (fabs(VECTOR(res1)[i] - VECTOR(res2)[i] / 2) > 1e-12) {
+            return 6;
+        }
+    }
+
+done:
+    igraph_vector_destroy(&path);
+    igraph_matrix_destroy(&m2);
+    igraph_matrix_destroy(&m1);
+    igraph_vector_destroy(&res2);
+    igraph_vector_destroy(&res1);
+    igraph_vector_destroy(&half);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, edges;
+    long int i, j, m;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Weights from 0 to 7, many shortest paths of the same length */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 1500,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 7);
+    }
+    if ((ret = check(&g, &weights, 0)) != 0) {
+        return ret;
+    }
+
+    /* Positive weights up to the largest handled with buckets */
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 1024);
+    }
+    if ((ret = check(&g, &weights, 1)) != 0) {
+        return 10 + ret;
+    }
+
+    /* A single weight value */
+    igraph_vector_fill(&weights, 3);
+    if ((ret = check(&g, &weights, 1)) != 0) {
+        return 20 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Unreachable vertices */
+    igraph_ring(&g, 200, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 0);
+    m = igraph_ecount(&g);
+    igraph_vector_resize(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 2);
+    }
+    if ((ret = check(&g, &weights, 0)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Multiple edges with different weights, the shorter one may come
+       after the longer one */
+    igraph_small(&g, 3, IGRAPH_DIRECTED, 1, 0, 1, 0, 1, 2, 0, 2, -1);
+    igraph_vector_resize(&weights, 4);
+    VECTOR(weights)[0] = 2; VECTOR(weights)[1] = 1;
+    VECTOR(weights)[2] = 4; VECTOR(weights)[3] = 1;
+    if (floyd_warshall(&g, &weights)) {
+        return 40;
+    }
+    VECTOR(weights)[0] = 1; VECTOR(weights)[1] = 2;
+    if (floyd_warshall(&g, &weights)) {
+        return 41;
+    }
+    igraph_destroy(&g);
+    igraph_vector_init(&edges, 0);
+    for (i = 0; i < 20; i++) {
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 40, 40,
+                                IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+        igraph_get_edgelist(&g, &edges, /*bycol=*/ 0);
+        igraph_add_edges(&g, &edges, 0);
+        igraph_add_edges(&g, &edges, 0);
+        m = igraph_ecount(&g);
+        igraph_vector_resize(&weights, m);
+        for (j = 0; j < m; j++) {
+            VECTOR(weights)[j] = RNG_INTEGER(1, 9);
+        }
+        if (floyd_warshall(&g, &weights)) {
+            return 42;
+        }
+        if ((ret = check(&g, &weights, 1)) != 0) {
+            return 50 + ret;
+        }
+        igraph_destroy(&g);
+    }
+    igraph_vector_destroy(&edges);
+
+    igraph_vector_destroy(&weights);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 60;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <igraph.h>
+
+/* The eccentricity of all vertices, the radius, the center and the
+   periphery are computed from eccentricity bounds for undirected
+   paths; they must be the same as with a search from every vertex,
+   which is what igraph_eccentricity() does for a vertex sequence. */
+
+int check(const igraph_t *g, igraph_neimode_t mode) {
+    long int n = igraph_vcount(g), i;
+    igraph_vector_t ecc, ref, center, periphery;
+    igraph_real_t radius, min = IGRAPH_INFINITY, max = -1;
+
+    igraph_vector_init(&ecc, 0);
+    igraph_vector_init(&ref, 0);
+    igraph_vector_init(&center, 0);
+    igraph_vector_init(&periphery, 0);
+
+    igraph_eccentricity(g, &ecc, igraph_vss_all(), mode);
+    if (n > 0) {
+        igraph_eccentricity(g, &ref, igraph_vss_seq(0, (igraph_integer_t) n - 1),
+                            mode);
+    }
+    if (!igraph_vector_all_e(&ecc, &ref)) {
+        return 1;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (VECTOR(ref)[i] < min) {
+            min = VECTOR(ref)[i];
+        }
+        if (VECTOR(ref)[i] > max) {
+            max = VECTOR(ref)[i];
+        }
+    }
+
+    igraph_radius(g, &radius, mode);
+    if (n > 0 ? radius != min : !igraph_is_nan(radius)) {
+        return 2;
+    }
+
+    igraph_graph_center(g, &center, mode);
+    igraph_graph_periphery(g, &periphery, mode);
+    igraph_vector_clear(&ecc);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(ref)[i] == min) {
+            igraph_vector_push_back(&ecc, i);
+        }
+    }
+    if (!igraph_vector_all_e(&center, &ecc)) {
+        return 3;
+    }
+    igraph_vector_clear(&ecc);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(ref)[i] == max) {
+            igraph_vector_push_back(&ecc, i);
+        }
+    }
+    if (!igraph_vector_all_e(&periphery, &ecc)) {
+        return 4;
+    }
+
+    igraph_vector_destroy(&periphery);
+    igraph_vector_destroy(&center);
+    igraph_vector_destroy(&ref);
+    igraph_vector_destroy(&ecc);
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dims;
+    long int i;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Random graphs, connected or not, with multiple edges and loops */
+    for (i = 0; i < 40; i++) {
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 150, RNG_INTEGER(80, 400),
+                                IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+        if (i % 4 == 0) {
+            igraph_add_edge(&g, 0, 1);
+            igraph_add_edge(&g, 0, 1);
+        }
+        if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+            return ret;
+        }
+        igraph_destroy(&g);
+    }
+
+    /* Directed graphs: bounds for undirected paths only */
+    for (i = 0; i < 10; i++) {
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 250,
+                                IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+        if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+            return 10 + ret;
+        }
+        if ((ret = check(&g, IGRAPH_OUT)) != 0) {
+            return 20 + ret;
+        }
+        igraph_destroy(&g);
+    }
+
+    /* Trees and stars, many leaves attached to the same vertex */
+    for (i = 0; i < 20; i++) {
+        igraph_tree_game(&g, 200, IGRAPH_UNDIRECTED, IGRAPH_RANDOM_TREE_PRUFER);
+        if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+            return 30 + ret;
+        }
+        igraph_destroy(&g);
+    }
+    igraph_star(&g, 20, IGRAPH_STAR_UNDIRECTED, 3);
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 40 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Many vertices with the same eccentricity */
+    igraph_vector_init_int(&dims, 2, 12, 17);
+    igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, /*circular=*/ 0);
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 50 + ret;
+    }
+    igraph_destroy(&g);
+    igraph_vector_destroy(&dims);
+
+    /* Single edges and isolated vertices */
+    igraph_small(&g, 7, IGRAPH_UNDIRECTED, 0, 1, 3, 4, 4, 5, -1);
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 60 + ret;
+    }
+    igraph_destroy(&g);
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 70 + ret;
+    }
+    igraph_destroy(&g);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 80;
+    }
+
+    return 0;
+}
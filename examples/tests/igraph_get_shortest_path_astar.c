@@ -0,0 +1,273 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* A* with no heuristic, with the Euclidean distance in a geometric
+   graph, with landmarks and with an admissible but inconsistent
+   heuristic; all paths must be as short as the ones found by the
+   Bellman-Ford algorithm, which does not depend on the other
+   shortest path functions */
+
+typedef struct {
+    igraph_vector_t *x, *y;
+} coords_t;
+
+int euclidean(igraph_real_t *result, igraph_integer_t from,
+              igraph_integer_t to, void *extra) {
+    coords_t *c = extra;
+    igraph_real_t dx = VECTOR(*c->x)[from] - VECTOR(*c->x)[to];
+    igraph_real_t dy = VECTOR(*c->y)[from] - VECTOR(*c->y)[to];
+    *result = sqrt(dx * dx + dy * dy);
+    return 0;
+}
+
+/* A random fraction of the landmark bound */
+int inconsistent(igraph_real_t *result, igraph_integer_t from,
+                 igraph_integer_t to, void *extra) {
+    IGRAPH_CHECK(igraph_landmarks_heuristic(result, from, to, extra));
+    if (*result != IGRAPH_INFINITY) {
+        *result *= RNG_UNIF01();
+    }
+    return 0;
+}
+
+int check_path(const igraph_t *g, const igraph_vector_t *vertices,
+               const igraph_vector_t *edges, const igraph_vector_t *weights,
+               long int from, long int to, igraph_neimode_t mode,
+               igraph_real_t expected) {
+    long int i, len = igraph_vector_size(edges);
+    igraph_real_t sum = 0;
+
+    if (expected == IGRAPH_INFINITY) {
+        return igraph_vector_size(vertices) != 0 || len != 0;
+    }
+    if (igraph_vector_size(vertices) != len + 1 ||
+        VECTOR(*vertices)[0] != from || VECTOR(*vertices)[len] != to) {
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        long int edge = VECTOR(*edges)[i];
+        long int u = VECTOR(*vertices)[i], v = VECTOR(*vertices)[i + 1];
+        long int head = IGRAPH_TO(g, edge), tail = IGRAPH_FROM(g, edge);
+        if (!igraph_is_directed(g) || mode == IGRAPH_ALL) {
+            if (!((tail == u && head == v) || (tail == v && head == u))) {
+                return 1;
+            }
+        } else if (mode == IGRAPH_OUT && (tail != u || head != v)) {
+            return 1;
+        } else if (mode == IGRAPH_IN && (tail != v || head != u)) {
+            return 1;
+        }
+        sum += weights ? VECTOR(*weights)[edge] : 1;
+    }
+    return fabs(sum - expected) > 1e-9;
+}
+
+void bellman_ford(const igraph_t *g, const igraph_vector_t *weights,
+                  igraph_neimode_t mode, const igraph_vector_t *sources,
+                  igraph_matrix_t *res) {
+    long int n = igraph_vcount(g), m = igraph_ecount(g), i, e;
+    igraph_bool_t changed = 1;
+
+    igraph_matrix_resize(res, igraph_vector_size(sources), n);
+    igraph_matrix_fill(res, IGRAPH_INFINITY);
+    for (i = 0; i < igraph_vector_size(sources); i++) {
+        MATRIX(*res, i, (long int) VECTOR(*sources)[i]) = 0;
+    }
+    while (changed) {
+        changed = 0;
+        for (i = 0; i < igraph_vector_size(sources); i++) {
+            for (e = 0; e < m; e++) {
+                long int from = IGRAPH_FROM(g, e), to = IGRAPH_TO(g, e);
+                igraph_real_t w = weights ? VECTOR(*weights)[e] : 1;
+                if (mode != IGRAPH_IN || !igraph_is_directed(g)) {
+                    if (MATRIX(*res, i, from) + w < MATRIX(*res, i, to)) {
+                        MATRIX(*res, i, to) = MATRIX(*res, i, from) + w;
+                        changed = 1;
+                    }
+                }
+                if (mode != IGRAPH_OUT || !igraph_is_directed(g)) {
+                    if (MATRIX(*res, i, to) + w < MATRIX(*res, i, from)) {
+                        MATRIX(*res, i, from) = MATRIX(*res, i, to) + w;
+                        changed = 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_neimode_t mode, igraph_astar_heuristic_func_t *heuristic,
+          void *extra, igraph_landmarks_t *landmarks) {
+    igraph_vector_t vertices, edges, sources;
+    igraph_matrix_t ref;
+    long int n = igraph_vcount(g), i, j;
+
+    /* The sources are spread over the graph */
+    igraph_vector_init(&sources, 10);
+    for (i = 0; i < 10; i++) {
+        VECTOR(sources)[i] = i * (n / 10);
+    }
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_matrix_init(&ref, 0, 0);
+    bellman_ford(g, weights, mode, &sources, &ref);
+
+    for (i = 0; i < 10; i++) {
+        long int from = VECTOR(sources)[i];
+        for (j = 0; j < 30; j++) {
+            long int to = j < 2 ? from + j : RNG_INTEGER(0, n - 1);
+            igraph_get_shortest_path_astar(g, &vertices, &edges, from, to,
+                                           weights, mode, heuristic, extra);
+            if (check_path(g, &vertices, &edges, weights, from, to, mode,
+                           MATRIX(ref, i, to))) {
+                return 1;
+            }
+        }
+        /* the bounds must not exceed the distances */
+        for (j = 0; landmarks && j < n; j++) {
+            igraph_real_t bound;
+            igraph_landmarks_heuristic(&bound, from, j, landmarks);
+            if (bound > MATRIX(ref, i, j) + 1e-9) {
+                return 2;
+            }
+        }
+    }
+
+    igraph_matrix_destroy(&ref);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_vector_destroy(&sources);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t x, y, weights, vids, edges;
+    igraph_landmarks_t landmarks;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    coords_t coords;
+    long int i, m;
+    int ret, k;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    /* Geometric graph, the weights are the lengths of the edges, there
+       are a few small components */
+    igraph_vector_init(&x, 0);
+    igraph_vector_init(&y, 0);
+    igraph_grg_game(&g, 2000, 0.04, /*torus=*/ 0, &x, &y);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    coords.x = &x;
+    coords.y = &y;
+    for (i = 0; i < m; i++) {
+        euclidean(&VECTOR(weights)[i], IGRAPH_FROM(&g, i), IGRAPH_TO(&g, i),
+                  &coords);
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL, 0, 0, 0)) != 0) {
+        return ret;
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL, euclidean, &coords, 0)) != 0) {
+        return 10 + ret;
+    }
+    igraph_landmarks_init(&g, &landmarks, &weights, IGRAPH_ALL, 8, 0);
+    if ((ret = check(&g, &weights, IGRAPH_ALL, igraph_landmarks_heuristic,
+                     &landmarks, &landmarks)) != 0) {
+        return 20 + ret;
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL, inconsistent,
+                     &landmarks, 0)) != 0) {
+        return 30 + ret;
+    }
+    igraph_landmarks_destroy(&landmarks);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Directed, integer weights with zeros, the landmarks are given or
+       chosen, in every mode */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 3000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 10);
+    }
+    igraph_vector_init_int(&vids, 3, 5, 500, 999);
+    for (k = 0; k < 3; k++) {
+        igraph_landmarks_init(&g, &landmarks, &weights, modes[k], 0, &vids);
+        if ((ret = check(&g, &weights, modes[k], igraph_landmarks_heuristic,
+                         &landmarks, &landmarks)) != 0) {
+            return 40 + 10 * k + ret;
+        }
+        igraph_landmarks_destroy(&landmarks);
+        igraph_landmarks_init(&g, &landmarks, &weights, modes[k], 6, 0);
+        if ((ret = check(&g, &weights, modes[k], igraph_landmarks_heuristic,
+                         &landmarks, &landmarks)) != 0) {
+            return 45 + 10 * k + ret;
+        }
+        igraph_landmarks_destroy(&landmarks);
+    }
+
+    /* Multiple edges with different integer weights */
+    igraph_vector_init(&edges, 0);
+    igraph_get_edgelist(&g, &edges, /*bycol=*/ 0);
+    igraph_add_edges(&g, &edges, 0);
+    igraph_vector_destroy(&edges);
+    igraph_vector_resize(&weights, 2 * m);
+    for (i = m; i < 2 * m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 10);
+    }
+    for (k = 0; k < 3; k++) {
+        igraph_landmarks_init(&g, &landmarks, &weights, modes[k], 6, 0);
+        if ((ret = check(&g, &weights, modes[k], igraph_landmarks_heuristic,
+                         &landmarks, &landmarks)) != 0) {
+            return 100 + 5 * k + ret;
+        }
+        igraph_landmarks_destroy(&landmarks);
+    }
+    igraph_delete_edges(&g, igraph_ess_seq(m, 2 * m - 1));
+
+    /* Unweighted */
+    igraph_landmarks_init(&g, &landmarks, 0, IGRAPH_OUT, 4, 0);
+    if ((ret = check(&g, 0, IGRAPH_OUT, igraph_landmarks_heuristic,
+                     &landmarks, &landmarks)) != 0) {
+        return 70 + ret;
+    }
+    igraph_landmarks_destroy(&landmarks);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Directed cycle, the distances in the two directions differ */
+    igraph_ring(&g, 100, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+    for (k = 0; k < 2; k++) {
+        igraph_landmarks_init(&g, &landmarks, 0, modes[k], 2, 0);
+        if ((ret = check(&g, 0, modes[k], igraph_landmarks_heuristic,
+                         &landmarks, &landmarks)) != 0) {
+            return 80 + 5 * k + ret;
+        }
+        igraph_landmarks_destroy(&landmarks);
+    }
+    igraph_destroy(&g);
+
+    /* More landmarks than vertices */
+    igraph_small(&g, 3, IGRAPH_UNDIRECTED, 0, 1, -1);
+    igraph_landmarks_init(&g, &landmarks, 0, IGRAPH_ALL, 10, 0);
+    igraph_landmarks_vids(&landmarks, &vids);
+    igraph_vector_sort(&vids);
+    if (igraph_vector_size(&vids) != 3 || VECTOR(vids)[0] != 0 ||
+        VECTOR(vids)[2] != 2) {
+        return 90;
+    }
+    igraph_landmarks_destroy(&landmarks);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&vids);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* igraph_get_shortest_path() and igraph_get_shortest_path_dijkstra()
+   search from both ends; the paths they return must be valid and as
+   short as the distances computed by searching from one end only */
+
+int check_path(const igraph_t *g, const igraph_vector_t *vertices,
+               const igraph_vector_t *edges, const igraph_vector_t *weights,
+               long int from, long int to, igraph_neimode_t mode,
+               igraph_real_t expected) {
+    long int i, len = igraph_vector_size(edges);
+    igraph_real_t sum = 0;
+
+    if (expected == IGRAPH_INFINITY) {
+        return igraph_vector_size(vertices) != 0 || len != 0;
+    }
+    if (igraph_vector_size(vertices) != len + 1 ||
+        VECTOR(*vertices)[0] != from || VECTOR(*vertices)[len] != to) {
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        long int edge = VECTOR(*edges)[i];
+        long int u = VECTOR(*vertices)[i], v = VECTOR(*vertices)[i + 1];
+        long int head = IGRAPH_TO(g, edge), tail = IGRAPH_FROM(g, edge);
+        if (!igraph_is_directed(g) || mode == IGRAPH_ALL) {
+            if (!((tail == u && head == v) || (tail == v && head == u))) {
+                return 1;
+            }
+        } else if (mode == IGRAPH_OUT && (tail != u || head != v)) {
+            return 1;
+        } else if (mode == IGRAPH_IN && (tail != v || head != u)) {
+            return 1;
+        }
+        sum += weights ? VECTOR(*weights)[edge] : 1;
+    }
+    return sum != expected;
+}
+
+int check(const igraph_t *g, const igraph_t *compact,
+          const igraph_vector_t *weights,
+          const igraph_vector_t *compact_weights, igraph_neimode_t mode) {
+    igraph_vector_t vertices, edges, ones;
+    igraph_matrix_t ref, unit;
+    long int n = igraph_vcount(g), i, j;
+
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_vector_init(&ones, igraph_ecount(compact));
+    igraph_vector_fill(&ones, 1);
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_matrix_init(&unit, 0, 0);
+
+    igraph_shortest_paths_dijkstra(compact, &ref, igraph_vss_seq(0, 9),
+                                   igraph_vss_all(), compact_weights, mode);
+    igraph_shortest_paths_dijkstra(compact, &unit, igraph_vss_seq(0, 9),
+                                   igraph_vss_all(), &ones, mode);
+
+    for (i = 0; i < 10; i++) {
+        for (j = 0; j < 30; j++) {
+            long int to = j < 2 ? i + j : RNG_INTEGER(0, n - 1);
+            igraph_get_shortest_path(g, &vertices, &edges, i, to, mode);
+            if (check_path(g, &vertices, &edges, 0, i, to, mode,
+                           MATRIX(unit, i, to))) {
+                return 1;
+            }
+            igraph_get_shortest_path_dijkstra(g, &vertices, &edges, i, to,
+                                              weights, mode);
+            if (check_path(g, &vertices, &edges, weights, i, to, mode,
+                           MATRIX(ref, i, to))) {
+                return 2;
+            }
+        }
+    }
+
+    igraph_matrix_destroy(&unit);
+    igraph_matrix_destroy(&ref);
+    igraph_vector_destroy(&ones);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+
+    return 0;
+}
+
+/* The weights are integers, so that the path lengths are exact */
+
+int run(igraph_t *g, igraph_bool_t all_modes) {
+    igraph_t compact;
+    igraph_vector_t weights, compact_weights, edges;
+    long int m = igraph_ecount(g), i;
+    int ret;
+
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 20);
+    }
+    igraph_vector_init(&edges, 0);
+    igraph_random_sample(&edges, 0, m - 1, m / 20);
+    igraph_copy(&compact, g);
+    igraph_delete_edges(&compact, igraph_ess_vector(&edges));
+    igraph_delete_edges_deferred(g, igraph_ess_vector(&edges), /*threshold=*/ 1);
+    igraph_vector_init(&compact_weights, 0);
+    for (i = 0; i < m; i++) {
+        if (!igraph_vector_binsearch2(&edges, i)) {
+            igraph_vector_push_back(&compact_weights, VECTOR(weights)[i]);
+        }
+    }
+
+    if ((ret = check(g, &compact, &weights, &compact_weights, IGRAPH_OUT)) != 0) {
+        return ret;
+    }
+    if (all_modes && (ret = check(g, &compact, &weights, &compact_weights, IGRAPH_IN)) != 0) {
+        return 10 + ret;
+    }
+    if (all_modes && (ret = check(g, &compact, &weights, &compact_weights, IGRAPH_ALL)) != 0) {
+        return 20 + ret;
+    }
+
+    igraph_vector_destroy(&compact_weights);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&compact);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t vertices, edges, weights;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    /* Undirected, connected */
+    igraph_barabasi_game(&g, 2000, /*power=*/ 1, 3, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    if ((ret = run(&g, 0)) != 0) {
+        return ret;
+    }
+    igraph_destroy(&g);
+
+    /* Directed, with loops, many pairs are not connected */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 3000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    if ((ret = run(&g, 1)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Multi-edges with different weights, and a vertex that can only
+       be reached through a deleted edge */
+    igraph_small(&g, 4, IGRAPH_DIRECTED, 0, 1, 0, 1, 1, 2, 2, 3, -1);
+    igraph_vector_init_int(&weights, 4, 5, 2, 1, 1);
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 0, 2, &weights,
+                                      IGRAPH_OUT);
+    if (igraph_vector_size(&edges) != 2 || VECTOR(edges)[0] != 1 ||
+        VECTOR(edges)[1] != 2) {
+        return 61;
+    }
+    igraph_delete_edges_deferred(&g, igraph_ess_1(3), /*threshold=*/ 1);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 0, 3, &weights,
+                                      IGRAPH_OUT);
+    if (igraph_vector_size(&vertices) != 0 || igraph_vector_size(&edges) != 0) {
+        return 62;
+    }
+    igraph_get_shortest_path(&g, &vertices, &edges, 0, 3, IGRAPH_OUT);
+    if (igraph_vector_size(&vertices) != 0 || igraph_vector_size(&edges) != 0) {
+        return 63;
+    }
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <igraph.h>
+#include <stdio.h>
+#include "test_utilities.inc"
+
+/* Closeness and harmonic centrality on several threads must be exactly
+   the same as on a single thread */
+int check_threads(const igraph_t *g, const igraph_vector_t *weights,
+                  igraph_real_t cutoff) {
+    igraph_vector_t res[4];
+    int i, ret = 0;
+
+    for (i = 0; i < 4; i++) {
+        igraph_vector_init(&res[i], 0);
+        igraph_set_num_threads(i % 2 == 0 ? 1 : 3);
+        if (i < 2) {
+            igraph_closeness_estimate(g, &res[i], igraph_vss_all(), IGRAPH_OUT,
+                                      cutoff, weights, /*normalized=*/ 1);
+        } else {
+            igraph_harmonic_centrality_estimate(g, &res[i], igraph_vss_all(),
+                                                IGRAPH_OUT, cutoff, weights,
+                                                /*normalized=*/ 0);
+        }
+    }
+    igraph_set_num_threads(1);
+
+    if (!igraph_vector_all_e(&res[0], &res[1]) ||
+        !igraph_vector_all_e(&res[2], &res[3])) {
+        ret = 1;
+    }
+
+    for (i = 0; i < 4; i++) {
+        igraph_vector_destroy(&res[i]);
+    }
+    return ret;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t res, weights;
+    long int i;
+
+    igraph_vector_init(&res, 0);
+
+    printf("Path, undirected\n");
+    igraph_ring(&g, 4, IGRAPH_UNDIRECTED, /*mutual=*/ 0, /*circular=*/ 0);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 0);
+    print_vector(&res, stdout);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 1);
+    print_vector(&res, stdout);
+
+    printf("\nPath, cutoff 1\n");
+    igraph_harmonic_centrality_estimate(&g, &res, igraph_vss_all(), IGRAPH_ALL,
+                                        1, 0, 0);
+    print_vector(&res, stdout);
+    igraph_destroy(&g);
+
+    printf("\nOut-star, all modes\n");
+    igraph_star(&g, 4, IGRAPH_STAR_OUT, 0);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_OUT, 0, 0);
+    print_vector(&res, stdout);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_IN, 0, 0);
+    print_vector(&res, stdout);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 0);
+    print_vector(&res, stdout);
+    igraph_destroy(&g);
+
+    printf("\nDisconnected, with an isolated vertex\n");
+    igraph_small(&g, 5, IGRAPH_UNDIRECTED, 0, 1, 1, 2, 3, 3, -1);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 1);
+    print_vector(&res, stdout);
+    igraph_destroy(&g);
+
+    printf("\nWeighted\n");
+    igraph_small(&g, 3, IGRAPH_UNDIRECTED, 0, 1, 1, 2, 0, 2, -1);
+    igraph_vector_init_int(&weights, 3, 1, 1, 4);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL,
+                               &weights, 0);
+    print_vector(&res, stdout);
+    igraph_harmonic_centrality_estimate(&g, &res, igraph_vss_all(), IGRAPH_ALL,
+                                        1.5, &weights, 0);
+    print_vector(&res, stdout);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    printf("\nSingle vertex and null graph\n");
+    igraph_empty(&g, 1, IGRAPH_UNDIRECTED);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 1);
+    print_vector(&res, stdout);
+    igraph_destroy(&g);
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_harmonic_centrality(&g, &res, igraph_vss_all(), IGRAPH_ALL, 0, 1);
+    print_vector(&res, stdout);
+    igraph_destroy(&g);
+
+    /* Same results on several threads */
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 600,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 5);
+    }
+    if (check_threads(&g, 0, -1) || check_threads(&g, 0, 3) ||
+        check_threads(&g, &weights, -1) || check_threads(&g, &weights, 6)) {
+        return 1;
+    }
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <igraph.h>
+#include <math.h>
+
+/* HyperANF estimates compared to the exact neighborhood sizes and
+   distance histogram. Small sets are counted almost exactly with many
+   registers; larger ones must be within a few standard errors. The
+   vertices of a component end up with the same counter, so their
+   errors are not independent. The results must not depend on the
+   number of threads. */
+
+int compare(const igraph_t *g, igraph_integer_t order, igraph_neimode_t mode,
+            igraph_integer_t log2m, double tolerance) {
+    igraph_vector_t sizes, exact;
+    long int i, n = igraph_vcount(g);
+    double err = 0.0;
+
+    igraph_vector_init(&sizes, 0);
+    igraph_vector_init(&exact, 0);
+    igraph_hyperanf(g, 0, &sizes, order, mode, log2m);
+    igraph_neighborhood_size(g, &exact, igraph_vss_all(),
+                             order < 0 ? (igraph_integer_t) n : order, mode,
+                             /*mindist=*/ 0);
+    for (i = 0; i < n; i++) {
+        err += fabs(VECTOR(sizes)[i] - VECTOR(exact)[i]) / VECTOR(exact)[i];
+    }
+    igraph_vector_destroy(&exact);
+    igraph_vector_destroy(&sizes);
+    return n > 0 && err / n > tolerance;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t nf, nf2, sizes, sizes2, hist, exact;
+    igraph_vector_t dims;
+    igraph_real_t apl, apl2, effdiam, unconn;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_vector_init(&nf, 0);
+    igraph_vector_init(&nf2, 0);
+    igraph_vector_init(&sizes, 0);
+    igraph_vector_init(&sizes2, 0);
+    igraph_vector_init(&hist, 0);
+    igraph_vector_init(&exact, 0);
+
+    /* Small neighborhoods with 2^16 registers: almost exact, unless
+       two vertices hash to the same register */
+    igraph_vector_init_int(&dims, 2, 10, 10);
+    igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, /*circular=*/ 0);
+    igraph_vector_destroy(&dims);
+    igraph_hyperanf(&g, &nf, &sizes, 3, IGRAPH_ALL, 16);
+    igraph_neighborhood_size(&g, &exact, igraph_vss_all(), 3, IGRAPH_ALL, 0);
+    for (i = 0; i < igraph_vcount(&g); i++) {
+        if (fabs(VECTOR(sizes)[i] - VECTOR(exact)[i]) > 1.5) {
+            return 1;
+        }
+    }
+    if (igraph_vector_size(&nf) != 4 || floor(VECTOR(nf)[0] + 0.5) != 100) {
+        return 2;
+    }
+    igraph_destroy(&g);
+
+    /* Random graphs, all distances */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 5000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    if (compare(&g, -1, IGRAPH_ALL, 12, 0.065)) {
+        return 3;
+    }
+    if (compare(&g, 2, IGRAPH_ALL, 8, 0.1)) {
+        return 4;
+    }
+
+    /* The distance distribution and the average path length */
+    igraph_hyperanf(&g, &nf, 0, -1, IGRAPH_ALL, 12);
+    igraph_hyperanf_stats(&nf, &hist, &apl, &effdiam, 0.9);
+    igraph_path_length_hist(&g, &exact, &unconn, IGRAPH_UNDIRECTED);
+    igraph_average_path_length(&g, &apl2, IGRAPH_UNDIRECTED, /*unconn=*/ 1);
+    /* The last distances may be missed, if they change no register */
+    if (igraph_vector_size(&hist) > igraph_vector_size(&exact) ||
+        igraph_vector_size(&hist) < igraph_vector_size(&exact) - 2) {
+        return 5;
+    }
+    apl = 2 * igraph_vector_sum(&exact);
+    for (i = 0; i < igraph_vector_size(&hist); i++) {
+        if (fabs(VECTOR(hist)[i] - 2 * VECTOR(exact)[i]) > 0.05 * apl) {
+            return 6;
+        }
+    }
+    igraph_hyperanf_stats(&nf, 0, &apl, 0, 0.9);
+    if (fabs(apl - apl2) / apl2 > 0.05 || effdiam < apl || effdiam > igraph_vector_size(&hist)) {
+        return 7;
+    }
+
+    /* Same results with several threads */
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_hyperanf(&g, &nf, &sizes, -1, IGRAPH_ALL, 8);
+    igraph_set_num_threads(4);
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_hyperanf(&g, &nf2, &sizes2, -1, IGRAPH_ALL, 8);
+    igraph_set_num_threads(1);
+    if (!igraph_vector_all_e(&nf, &nf2) || !igraph_vector_all_e(&sizes, &sizes2)) {
+        return 8;
+    }
+    igraph_destroy(&g);
+
+    /* Directed paths */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 4000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    if (compare(&g, -1, IGRAPH_OUT, 12, 0.065)) {
+        return 9;
+    }
+    if (compare(&g, -1, IGRAPH_IN, 12, 0.065)) {
+        return 10;
+    }
+    igraph_destroy(&g);
+
+    /* No edges and no vertices */
+    igraph_empty(&g, 10, IGRAPH_UNDIRECTED);
+    igraph_hyperanf(&g, &nf, &sizes, -1, IGRAPH_ALL, 6);
+    igraph_hyperanf_stats(&nf, &hist, &apl, &effdiam, 0.9);
+    if (igraph_vector_size(&nf) != 1 || igraph_vector_size(&hist) != 0 ||
+        !igraph_is_nan(apl) || !igraph_is_nan(effdiam)) {
+        return 11;
+    }
+    igraph_destroy(&g);
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_hyperanf(&g, &nf, &sizes, -1, IGRAPH_ALL, 6);
+    if (igraph_vector_size(&sizes) != 0) {
+        return 12;
+    }
+
+    /* Invalid number of registers */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_hyperanf(&g, &nf, &sizes, -1, IGRAPH_ALL, 3) != IGRAPH_EINVAL) {
+        return 13;
+    }
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&exact);
+    igraph_vector_destroy(&hist);
+    igraph_vector_destroy(&sizes2);
+    igraph_vector_destroy(&sizes);
+    igraph_vector_destroy(&nf2);
+    igraph_vector_destroy(&nf);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 14;
+    }
+
+    return 0;
+}
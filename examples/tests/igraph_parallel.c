@@ -0,0 +1,189 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* The thread pool runs every task exactly once, and errors, warnings
+   and interruptions in the tasks are reported on the calling thread */
+
+typedef int igraph_i_parallel_task_t(void *data, long int task, int thread);
+int igraph_i_parallel_threads(long int no_of_tasks);
+int igraph_i_parallel_for(long int no_of_tasks, int no_of_threads,
+                          igraph_i_parallel_task_t *task, void *data);
+
+typedef struct {
+    igraph_vector_long_t count;     /* how many times a task was run */
+    igraph_vector_t sum;            /* per-thread sums */
+    long int fail_at;
+    igraph_bool_t nested;
+} data_t;
+
+int add_task(void *arg, long int task, int thread) {
+    data_t *data = (data_t *) arg;
+    long int i;
+    igraph_real_t x = 0;
+    /* some uneven work */
+    for (i = 0; i < (task % 7) * 1000; i++) {
+        x += i % 3;
+    }
+    VECTOR(data->count)[task] += 1;
+    VECTOR(data->sum)[thread] += task + x * 0;
+    if (task == data->fail_at) {
+        IGRAPH_ERROR("Task failed", IGRAPH_EINVAL);
+    }
+    if (task % 100 == 0) {
+        IGRAPH_WARNING("Warning from a task");
+    }
+    return 0;
+}
+
+int nested_task(void *arg, long int task, int thread) {
+    data_t *data = (data_t *) arg;
+    if (igraph_i_parallel_threads(10) != 1) {
+        data->nested = 1;
+    }
+    return add_task(arg, task, thread);
+}
+
+int interrupt_task(void *arg, long int task, int thread) {
+    long int i;
+    igraph_real_t *x = (igraph_real_t *) arg;
+    for (i = 0; i < 10000; i++) {
+        x[thread] += i % 3;
+    }
+    IGRAPH_UNUSED(task);
+    return igraph_allow_interruption(NULL);
+}
+
+static int no_of_errors = 0, no_of_warnings = 0, no_of_interruptions = 0;
+
+void error_handler(const char *reason, const char *file, int line,
+                   int igraph_errno) {
+    IGRAPH_UNUSED(reason);
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+    no_of_errors++;
+    IGRAPH_FINALLY_FREE();
+}
+
+void warning_handler(const char *reason, const char *file, int line,
+                     int igraph_errno) {
+    IGRAPH_UNUSED(reason);
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+    no_of_warnings++;
+}
+
+int interruption_handler(void *data) {
+    IGRAPH_UNUSED(data);
+    return ++no_of_interruptions >= 10 ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+int run(long int no_of_tasks, igraph_i_parallel_task_t *task, long int fail_at) {
+    data_t data;
+    int threads = igraph_i_parallel_threads(no_of_tasks);
+    long int i;
+    int ret;
+
+    igraph_vector_long_init(&data.count, no_of_tasks);
+    igraph_vector_init(&data.sum, threads);
+    data.fail_at = fail_at;
+    data.nested = 0;
+
+    ret = igraph_i_parallel_for(no_of_tasks, threads, task, &data);
+    if (fail_at < 0) {
+        if (ret != 0 || data.nested) {
+            return 1;
+        }
+        for (i = 0; i < no_of_tasks; i++) {
+            if (VECTOR(data.count)[i] != 1) {
+                return 2;
+            }
+        }
+        if (igraph_vector_sum(&data.sum) != no_of_tasks * (no_of_tasks - 1) / 2.0) {
+            return 3;
+        }
+    } else {
+        if (ret != IGRAPH_EINVAL || VECTOR(data.count)[fail_at] != 1) {
+            return 4;
+        }
+        for (i = 0; i < no_of_tasks; i++) {
+            if (VECTOR(data.count)[i] > 1) {
+                return 5;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&data.sum);
+    igraph_vector_long_destroy(&data.count);
+
+    return 0;
+}
+
+int main() {
+    igraph_real_t x[8] = { 0 };
+    int ret, k;
+
+    igraph_set_error_handler(error_handler);
+    igraph_set_warning_handler(warning_handler);
+
+    if (igraph_set_num_threads(0) != IGRAPH_EINVAL || no_of_errors != 1) {
+        return 1;
+    }
+    no_of_errors = 0;
+
+    for (k = 1; k <= 8; k *= 2) {
+        igraph_set_num_threads(k);
+        if (igraph_get_num_threads() != k && igraph_get_num_threads() != 1) {
+            return 2;
+        }
+
+        /* All tasks are run once; more threads than tasks */
+        ret = run(10000, add_task, -1);
+        if (ret != 0) {
+            return 10 * k + ret;
+        }
+        ret = run(3, add_task, -1);
+        if (ret != 0) {
+            return 10 * k + ret;
+        }
+        ret = run(0, add_task, -1);
+        if (ret != 0) {
+            return 10 * k + ret;
+        }
+        /* Without worker threads every warning is reported, otherwise
+           only the first one of each loop */
+        if (no_of_errors != 0 || no_of_warnings == 0) {
+            return 100 + k;
+        }
+        no_of_warnings = 0;
+
+        /* Loops started from a task run on its thread */
+        ret = run(1000, nested_task, -1);
+        if (ret != 0) {
+            return 200 + 10 * k + ret;
+        }
+        no_of_warnings = 0;
+
+        /* The error is reported once, on the calling thread */
+        ret = run(10000, add_task, 5000);
+        if (ret != 0 || no_of_errors != 1) {
+            return 300 + 10 * k + ret;
+        }
+        no_of_errors = 0;
+        no_of_warnings = 0;
+
+        /* Interruption stops the loop */
+        no_of_interruptions = 0;
+        igraph_set_interruption_handler(interruption_handler);
+        ret = igraph_i_parallel_for(10000, igraph_i_parallel_threads(10000),
+                                    interrupt_task, x);
+        igraph_set_interruption_handler(0);
+        if (ret != IGRAPH_INTERRUPTED || no_of_errors != 0 ||
+            no_of_interruptions != 10) {
+            return 400 + k;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <igraph.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Checks that 'perm' is a permutation, that 'res' is 'g' renumbered
+   by it, and returns the sum of the id differences along the edges */
+
+long int check_perm(const igraph_t *g, const igraph_t *res,
+                    const igraph_vector_t *perm) {
+    long int n = igraph_vcount(g), i, gap = 0;
+    igraph_vector_bool_t seen;
+
+    if (igraph_vector_size(perm) != n || igraph_vcount(res) != n ||
+        igraph_ecount(res) != igraph_ecount(g)) {
+        return -1;
+    }
+
+    igraph_vector_bool_init(&seen, n);
+    for (i = 0; i < n; i++) {
+        long int p = VECTOR(*perm)[i];
+        if (p < 0 || p >= n || VECTOR(seen)[p]) {
+            return -2;
+        }
+        VECTOR(seen)[p] = 1;
+    }
+    igraph_vector_bool_destroy(&seen);
+
+    for (i = 0; i < igraph_ecount(g); i++) {
+        long int from = VECTOR(*perm)[ (long int) IGRAPH_FROM(g, i) ];
+        long int to = VECTOR(*perm)[ (long int) IGRAPH_TO(g, i) ];
+        long int rfrom = IGRAPH_FROM(res, i), rto = IGRAPH_TO(res, i);
+        if (!igraph_is_directed(g) && from < to) {
+            long int tmp = from;
+            from = to;
+            to = tmp;
+        }
+        if (from != rfrom || to != rto) {
+            return -3;
+        }
+        gap += labs(rfrom - rto);
+    }
+
+    return gap;
+}
+
+long int bandwidth(const igraph_t *g) {
+    long int i, bw = 0;
+    for (i = 0; i < igraph_ecount(g); i++) {
+        long int d = labs((long int) IGRAPH_FROM(g, i) - (long int) IGRAPH_TO(g, i));
+        if (d > bw) {
+            bw = d;
+        }
+    }
+    return bw;
+}
+
+int main() {
+    igraph_t g, shuffled, res;
+    igraph_vector_t perm, dim, deg1, deg2;
+    igraph_reorder_t methods[] = { IGRAPH_REORDER_RCM, IGRAPH_REORDER_DEGREE,
+                                   IGRAPH_REORDER_GORDER
+                                 };
+    long int i, j, gap, gap0;
+
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A lattice with randomly shuffled vertex ids */
+    igraph_vector_init(&dim, 2);
+    VECTOR(dim)[0] = 30; VECTOR(dim)[1] = 20;
+    igraph_lattice(&g, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_init_seq(&perm, 0, igraph_vcount(&g) - 1);
+    igraph_vector_shuffle(&perm);
+    igraph_permute_vertices(&g, &shuffled, &perm);
+    for (i = 0; i < igraph_vcount(&shuffled); i++) {
+        SETVAN(&shuffled, "id", i, i);
+    }
+    gap0 = check_perm(&g, &shuffled, &perm);
+    igraph_destroy(&g);
+
+    igraph_vector_init(&deg1, 0);
+    igraph_vector_init(&deg2, 0);
+
+    for (j = 0; j < 3; j++) {
+        igraph_reorder_vertices(&shuffled, &res, &perm, methods[j]);
+        gap = check_perm(&shuffled, &res, &perm);
+        if (gap < 0) {
+            return 1 + 10 * j;
+        }
+        /* Every heuristic brings neighbors closer except for sorting
+           by degree */
+        if (methods[j] != IGRAPH_REORDER_DEGREE && gap >= gap0 / 2) {
+            return 2 + 10 * j;
+        }
+        /* Attributes follow the vertices */
+        for (i = 0; i < igraph_vcount(&shuffled); i++) {
+            if (VAN(&res, "id", VECTOR(perm)[i]) != i) {
+                return 3 + 10 * j;
+            }
+        }
+        /* Results are mapped back with the permutation */
+        igraph_degree(&shuffled, &deg1, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+        igraph_degree(&res, &deg2, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+        for (i = 0; i < igraph_vcount(&shuffled); i++) {
+            if (VECTOR(deg1)[i] != VECTOR(deg2)[ (long int) VECTOR(perm)[i] ]) {
+                return 4 + 10 * j;
+            }
+        }
+        if (methods[j] == IGRAPH_REORDER_RCM && bandwidth(&res) > 21) {
+            return 5 + 10 * j;
+        }
+        if (methods[j] == IGRAPH_REORDER_DEGREE) {
+            for (i = 1; i < igraph_vcount(&res); i++) {
+                if (VECTOR(deg2)[i] > VECTOR(deg2)[i - 1]) {
+                    return 6 + 10 * j;
+                }
+            }
+        }
+        igraph_destroy(&res);
+    }
+    igraph_destroy(&shuffled);
+
+    /* RCM on a path with shuffled ids gives the path back */
+    igraph_ring(&g, 100, IGRAPH_UNDIRECTED, 0, /*circular=*/ 0);
+    igraph_vector_destroy(&perm);
+    igraph_vector_init_seq(&perm, 0, 99);
+    igraph_vector_shuffle(&perm);
+    igraph_permute_vertices(&g, &shuffled, &perm);
+    igraph_reorder_vertices(&shuffled, &res, &perm, IGRAPH_REORDER_RCM);
+    if (check_perm(&shuffled, &res, &perm) < 0 || bandwidth(&res) != 1) {
+        return 40;
+    }
+    igraph_destroy(&res);
+    igraph_destroy(&shuffled);
+    igraph_destroy(&g);
+
+    /* Directed graphs, several components, loops and multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 300,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_add_edge(&g, 0, 1);
+    igraph_add_edge(&g, 0, 1);
+    for (j = 0; j < 3; j++) {
+        igraph_reorder_vertices(&g, &res, &perm, methods[j]);
+        if (check_perm(&g, &res, &perm) < 0) {
+            return 50 + j;
+        }
+        igraph_destroy(&res);
+    }
+    igraph_vertex_order_degree(&g, &perm, IGRAPH_IN);
+    igraph_permute_vertices(&g, &res, &perm);
+    igraph_degree(&res, &deg2, igraph_vss_all(), IGRAPH_IN, IGRAPH_LOOPS);
+    for (i = 1; i < igraph_vcount(&res); i++) {
+        if (VECTOR(deg2)[i] > VECTOR(deg2)[i - 1]) {
+            return 53;
+        }
+    }
+    igraph_destroy(&res);
+
+    /* Deleted vertices and edges stay deleted */
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(3), /*threshold=*/ 1);
+    igraph_delete_edges_deferred(&g, igraph_ess_1(7), /*threshold=*/ 1);
+    igraph_reorder_vertices(&g, &res, &perm, IGRAPH_REORDER_GORDER);
+    if (!igraph_is_vertex_deleted(&res, VECTOR(perm)[3]) ||
+        !igraph_is_edge_deleted(&res, 7) ||
+        igraph_deleted_ecount(&res) != igraph_deleted_ecount(&g)) {
+        return 54;
+    }
+    igraph_destroy(&res);
+    igraph_destroy(&g);
+
+    /* Null graph, and an invalid window */
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    for (j = 0; j < 3; j++) {
+        igraph_reorder_vertices(&g, &res, &perm, methods[j]);
+        if (igraph_vector_size(&perm) != 0) {
+            return 60 + j;
+        }
+        igraph_destroy(&res);
+    }
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_vertex_order_gorder(&g, &perm, 0) != IGRAPH_EINVAL) {
+        return 63;
+    }
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&deg1);
+    igraph_vector_destroy(&deg2);
+    igraph_vector_destroy(&dim);
+    igraph_vector_destroy(&perm);
+
+    return 0;
+}
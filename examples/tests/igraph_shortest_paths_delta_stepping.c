@@ -0,0 +1,197 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* With several threads, the weighted shortest path functions use
+   delta-stepping on large graphs; compare them to the serial Dijkstra
+   searches, and check that the paths are shortest paths */
+
+int check_path(const igraph_t *g, const igraph_vector_t *weights,
+               igraph_neimode_t mode, long int from, long int to,
+               const igraph_vector_t *vertices, const igraph_vector_t *edges,
+               igraph_real_t dist) {
+    long int i, n = igraph_vector_size(edges), v = from;
+    igraph_real_t len = 0;
+
+    if (dist == IGRAPH_INFINITY) {
+        return n != 0 || igraph_vector_size(vertices) != 1;
+    }
+    if (igraph_vector_size(vertices) != n + 1 || VECTOR(*vertices)[0] != from ||
+        VECTOR(*vertices)[n] != to) {
+        return 1;
+    }
+    for (i = 0; i < n; i++) {
+        long int e = VECTOR(*edges)[i];
+        long int next = VECTOR(*vertices)[i + 1];
+        if (mode == IGRAPH_OUT && IGRAPH_FROM(g, e) != v) {
+            return 1;
+        }
+        if (mode == IGRAPH_IN && IGRAPH_TO(g, e) != v) {
+            return 1;
+        }
+        if (IGRAPH_OTHER(g, e, v) != next) {
+            return 1;
+        }
+        len += VECTOR(*weights)[e];
+        v = next;
+    }
+    return fabs(len - dist) > 1e-9 * (1 + dist);
+}
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_neimode_t mode) {
+    igraph_matrix_t res, ref;
+    igraph_vector_t from, to;
+    igraph_vector_ptr_t vertices, edges;
+    igraph_vector_long_t pred, inbound;
+    long int n = igraph_vcount(g), i, j;
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_vector_init(&from, 0);
+    for (i = 0; i < 3; i++) {
+        igraph_vector_push_back(&from, RNG_INTEGER(0, n - 1));
+    }
+    igraph_vector_init_seq(&to, 10, 59);
+
+    /* Distances, all targets and some targets */
+    igraph_set_num_threads(1);
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_vector(&from),
+                                   igraph_vss_all(), weights, mode);
+    igraph_set_num_threads(4);
+    igraph_shortest_paths_dijkstra(g, &res, igraph_vss_vector(&from),
+                                   igraph_vss_all(), weights, mode);
+    if (!igraph_matrix_all_e(&res, &ref)) {
+        return 1;
+    }
+    igraph_shortest_paths_dijkstra(g, &res, igraph_vss_vector(&from),
+                                   igraph_vss_vector(&to), weights, mode);
+    for (i = 0; i < igraph_vector_size(&from); i++) {
+        for (j = 0; j < igraph_vector_size(&to); j++) {
+            if (MATRIX(res, i, j) != MATRIX(ref, i, (long int) VECTOR(to)[j])) {
+                return 2;
+            }
+        }
+    }
+
+    /* Paths, predecessors and inbound edges */
+    igraph_vector_ptr_init(&vertices, igraph_vector_size(&to));
+    igraph_vector_ptr_init(&edges, igraph_vector_size(&to));
+    for (j = 0; j < igraph_vector_size(&to); j++) {
+        VECTOR(vertices)[j] = calloc(1, sizeof(igraph_vector_t));
+        VECTOR(edges)[j] = calloc(1, sizeof(igraph_vector_t));
+        igraph_vector_init(VECTOR(vertices)[j], 0);
+        igraph_vector_init(VECTOR(edges)[j], 0);
+    }
+    igraph_vector_long_init(&pred, 0);
+    igraph_vector_long_init(&inbound, 0);
+    for (i = 0; i < igraph_vector_size(&from); i++) {
+        long int source = VECTOR(from)[i];
+        igraph_get_shortest_paths_dijkstra(g, &vertices, &edges, source,
+                                           igraph_vss_vector(&to), weights, mode,
+                                           &pred, &inbound);
+        for (j = 0; j < igraph_vector_size(&to); j++) {
+            if (check_path(g, weights, mode, source, VECTOR(to)[j],
+                           VECTOR(vertices)[j], VECTOR(edges)[j],
+                           MATRIX(ref, i, (long int) VECTOR(to)[j]))) {
+                return 3;
+            }
+        }
+        /* the whole tree is found */
+        for (j = 0; j < n; j++) {
+            igraph_real_t d = MATRIX(ref, i, j);
+            long int e = VECTOR(inbound)[j];
+            if (j == source) {
+                if (VECTOR(pred)[j] != j || e != -1) {
+                    return 4;
+                }
+            } else if (d == IGRAPH_INFINITY) {
+                if (VECTOR(pred)[j] != -1 || e != -1) {
+                    return 5;
+                }
+            } else if (VECTOR(pred)[j] != IGRAPH_OTHER(g, e, j) ||
+                       fabs(MATRIX(ref, i, VECTOR(pred)[j]) + VECTOR(*weights)[e] - d) >
+                       1e-9 * (1 + d)) {
+                return 6;
+            }
+        }
+    }
+
+    for (j = 0; j < igraph_vector_size(&to); j++) {
+        igraph_vector_destroy(VECTOR(vertices)[j]);
+        igraph_vector_destroy(VECTOR(edges)[j]);
+        free(VECTOR(vertices)[j]);
+        free(VECTOR(edges)[j]);
+    }
+    igraph_vector_ptr_destroy(&vertices);
+    igraph_vector_ptr_destroy(&edges);
+    igraph_vector_long_destroy(&inbound);
+    igraph_vector_long_destroy(&pred);
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_matrix_destroy(&ref);
+    igraph_matrix_destroy(&res);
+    igraph_set_num_threads(1);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, dims;
+    long int i, m;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    /* Random weights, some of them zero, some vertices unreachable */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 30000, 70000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    m = igraph_ecount(&g);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_UNIF01() < 0.1 ? 0 : RNG_UNIF(0, 100);
+    }
+    if ((ret = check(&g, &weights, IGRAPH_OUT)) != 0) {
+        return ret;
+    }
+    if ((ret = check(&g, &weights, IGRAPH_IN)) != 0) {
+        return 10 + ret;
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL)) != 0) {
+        return 20 + ret;
+    }
+
+    /* A few very heavy edges */
+    for (i = 0; i < 10; i++) {
+        VECTOR(weights)[RNG_INTEGER(0, m - 1)] = 1e9;
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Small integer weights, many shortest paths of the same length */
+    igraph_vector_init_int(&dims, 2, 250, 250);
+    igraph_lattice(&g, &dims, /*nei=*/ 1, IGRAPH_UNDIRECTED, /*mutual=*/ 0,
+                   /*circular=*/ 0);
+    m = igraph_ecount(&g);
+    igraph_vector_resize(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 3);
+    }
+    if ((ret = check(&g, &weights, IGRAPH_ALL)) != 0) {
+        return 40 + ret;
+    }
+    igraph_vector_destroy(&dims);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+
+    if (!IGRAPH_FINALLY_STACK_EMPTY) {
+        return 50;
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* The unweighted all-pairs functions search from many sources at once;
+   compare them to Dijkstra's algorithm with unit weights, which
+   searches from one source at a time */
+
+int check(const igraph_t *g, igraph_neimode_t mode) {
+    igraph_matrix_t res, ref;
+    igraph_vector_t weights, from, to, ecc, hist, refhist;
+    igraph_real_t apl, refapl, unconn, refunconn, pairs;
+    long int n = igraph_vcount(g), i, j;
+    igraph_bool_t directed = mode != IGRAPH_ALL;
+
+    igraph_vector_init(&weights, igraph_ecount(g));
+    igraph_vector_fill(&weights, 1);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&ref, 0, 0);
+
+    /* All pairs */
+    igraph_shortest_paths(g, &res, igraph_vss_all(), igraph_vss_all(), mode);
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, mode);
+    if (!igraph_matrix_all_e(&res, &ref)) {
+        return 1;
+    }
+
+    /* Repeated sources and some targets */
+    igraph_vector_init(&from, 0);
+    for (i = 0; i < 150; i++) {
+        igraph_vector_push_back(&from, RNG_INTEGER(0, n - 1));
+    }
+    igraph_vector_push_back(&from, VECTOR(from)[0]);
+    igraph_vector_init_seq(&to, n / 3, n / 3 + 20 < n ? n / 3 + 20 : n - 1);
+    igraph_shortest_paths(g, &res, igraph_vss_vector(&from),
+                          igraph_vss_vector(&to), mode);
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_vector(&from),
+                                   igraph_vss_vector(&to), &weights, mode);
+    if (!igraph_matrix_all_e(&res, &ref)) {
+        return 2;
+    }
+
+    /* Eccentricity */
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_vector(&from),
+                                   igraph_vss_all(), &weights, mode);
+    igraph_vector_init(&ecc, 0);
+    igraph_eccentricity(g, &ecc, igraph_vss_vector(&from), mode);
+    for (i = 0; i < igraph_vector_size(&from); i++) {
+        igraph_real_t max = 0;
+        for (j = 0; j < n; j++) {
+            if (MATRIX(ref, i, j) != IGRAPH_INFINITY && MATRIX(ref, i, j) > max) {
+                max = MATRIX(ref, i, j);
+            }
+        }
+        if (VECTOR(ecc)[i] != max) {
+            return 3;
+        }
+    }
+
+    /* Average path length and histogram */
+    igraph_shortest_paths_dijkstra(g, &ref, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, mode);
+    igraph_vector_init(&refhist, n);
+    refapl = 0;
+    refunconn = 0;
+    pairs = 0;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (i == j) {
+                continue;
+            }
+            if (MATRIX(ref, i, j) == IGRAPH_INFINITY) {
+                refunconn++;
+            } else {
+                refapl += MATRIX(ref, i, j);
+                pairs++;
+                VECTOR(refhist)[(long int) MATRIX(ref, i, j) - 1] += 1;
+            }
+        }
+    }
+    igraph_average_path_length(g, &apl, directed, /*unconn=*/ 1);
+    if (apl != refapl / pairs) {
+        return 4;
+    }
+    igraph_average_path_length(g, &apl, directed, /*unconn=*/ 0);
+    if (apl != (refapl + n * refunconn) / (pairs + refunconn)) {
+        return 5;
+    }
+    igraph_vector_init(&hist, 0);
+    igraph_path_length_hist(g, &hist, &unconn, directed);
+    if (!igraph_is_directed(g) || !directed) {
+        igraph_vector_scale(&refhist, 0.5);
+        refunconn /= 2;
+    }
+    while (igraph_vector_size(&refhist) > 0 && igraph_vector_tail(&refhist) == 0) {
+        igraph_vector_pop_back(&refhist);
+    }
+    if (!igraph_vector_all_e(&hist, &refhist) || unconn != refunconn) {
+        return 6;
+    }
+
+    igraph_vector_destroy(&hist);
+    igraph_vector_destroy(&refhist);
+    igraph_vector_destroy(&ecc);
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_matrix_destroy(&ref);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Several batches of sources, disconnected, with loops and multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 700, 800,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 3, 4);
+    if ((ret = check(&g, IGRAPH_OUT)) != 0) {
+        return ret;
+    }
+    if ((ret = check(&g, IGRAPH_IN)) != 0) {
+        return 10 + ret;
+    }
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 20 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Long paths */
+    igraph_ring(&g, 300, IGRAPH_UNDIRECTED, /*mutual=*/ 0, /*circular=*/ 0);
+    if ((ret = check(&g, IGRAPH_ALL)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&g);
+
+    /* Fewer sources than a word */
+    igraph_small(&g, 4, IGRAPH_DIRECTED, 0, 1, 1, 2, 2, 0, -1);
+    if ((ret = check(&g, IGRAPH_OUT)) != 0) {
+        return 40 + ret;
+    }
+    igraph_destroy(&g);
+
+    return 0;
+}
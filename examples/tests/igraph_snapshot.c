@@ -0,0 +1,162 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* Writes a snapshot, maps it back, and checks that queries give the
+   same results on the snapshot as on the original graph, and that
+   modifying the snapshot fails. */
+
+int check_same(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j;
+
+    if (igraph_vcount(g1) != igraph_vcount(g2) ||
+        igraph_ecount(g1) != igraph_ecount(g2) ||
+        igraph_is_directed(g1) != igraph_is_directed(g2)) {
+        return 1;
+    }
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    for (i = 0; i < igraph_vcount(g1); i++) {
+        for (j = 0; j < 3; j++) {
+            igraph_incident(g1, &v1, (igraph_integer_t) i, modes[j]);
+            igraph_incident(g2, &v2, (igraph_integer_t) i, modes[j]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 2;
+            }
+        }
+    }
+
+    igraph_get_edgelist(g1, &v1, 0);
+    igraph_get_edgelist(g2, &v2, 0);
+    if (!igraph_vector_all_e(&v1, &v2)) {
+        return 3;
+    }
+
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g, snap, copy;
+    igraph_matrix_t res1, res2;
+    FILE *file;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 50, 200, directed,
+                            IGRAPH_LOOPS);
+
+    file = fopen("igraph_snapshot.bin", "wb");
+    igraph_write_graph_snapshot(&g, file);
+    fclose(file);
+
+    file = fopen("igraph_snapshot.bin", "rb");
+    igraph_read_graph_snapshot(&snap, file);
+    fclose(file);
+
+    ret = check_same(&g, &snap);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* Read-only algorithms */
+    igraph_matrix_init(&res1, 0, 0);
+    igraph_matrix_init(&res2, 0, 0);
+    igraph_shortest_paths(&g, &res1, igraph_vss_all(), igraph_vss_all(), IGRAPH_OUT);
+    igraph_shortest_paths(&snap, &res2, igraph_vss_all(), igraph_vss_all(), IGRAPH_OUT);
+    if (!igraph_matrix_all_e(&res1, &res2)) {
+        return 4;
+    }
+    igraph_matrix_destroy(&res1);
+    igraph_matrix_destroy(&res2);
+
+    /* Modifications fail */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_add_edge(&snap, 0, 1) != IGRAPH_EINVAL ||
+        igraph_add_vertices(&snap, 1, 0) != IGRAPH_EINVAL ||
+        igraph_delete_edges(&snap, igraph_ess_1(0)) != IGRAPH_EINVAL ||
+        igraph_delete_vertices(&snap, igraph_vss_1(0)) != IGRAPH_EINVAL ||
+        igraph_delete_edges_deferred(&snap, igraph_ess_1(0), 1) != IGRAPH_EINVAL) {
+        return 5;
+    }
+    igraph_set_error_handler(igraph_error_handler_abort);
+
+    /* But a copy can be modified */
+    igraph_copy(&copy, &snap);
+    igraph_add_edge(&copy, 0, 1);
+    igraph_add_edge(&g, 0, 1);
+    ret = check_same(&g, &copy);
+    if (ret != 0) {
+        return 10 + ret;
+    }
+
+    igraph_destroy(&copy);
+    igraph_destroy(&snap);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+/* Marked edges and vertices are not saved */
+int test_deleted() {
+    igraph_t g, snap;
+    FILE *file;
+    int ret;
+
+    igraph_ring(&g, 10, IGRAPH_UNDIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(3), /*threshold=*/ 1);
+
+    file = fopen("igraph_snapshot.bin", "wb");
+    igraph_write_graph_snapshot(&g, file);
+    fclose(file);
+
+    file = fopen("igraph_snapshot.bin", "rb");
+    igraph_read_graph_snapshot(&snap, file);
+    fclose(file);
+
+    igraph_compact_deleted(&g, 0, 0);
+    ret = check_same(&g, &snap);
+
+    igraph_destroy(&snap);
+    igraph_destroy(&g);
+    return ret;
+}
+
+int main() {
+    int ret;
+    FILE *file;
+    igraph_t g;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+    ret = test_deleted();
+    if (ret != 0) {
+        return 40 + ret;
+    }
+
+    /* Not a snapshot */
+    file = fopen("igraph_snapshot.bin", "wb");
+    fprintf(file, "0 1\n1 2\n");
+    fclose(file);
+    file = fopen("igraph_snapshot.bin", "rb");
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_read_graph_snapshot(&g, file) != IGRAPH_PARSEERROR) {
+        return 50;
+    }
+    fclose(file);
+
+    remove("igraph_snapshot.bin");
+
+    return 0;
+}
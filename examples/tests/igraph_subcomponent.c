@@ -0,0 +1,123 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* igraph_subcomponent() and igraph_shortest_paths() with a few sources
+   switch between top-down and bottom-up search steps; compare them to
+   Dijkstra's algorithm with unit weights */
+
+int check(const igraph_t *g, const igraph_t *compact, igraph_neimode_t mode) {
+    igraph_vector_t weights, comp, from, to;
+    igraph_matrix_t res, ref;
+    long int n = igraph_vcount(g), i, j, s;
+    igraph_real_t sources[] = { 0, 7, 123 };
+
+    igraph_vector_init(&weights, igraph_ecount(compact));
+    igraph_vector_fill(&weights, 1);
+    igraph_vector_init(&comp, 0);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_vector_view(&from, sources, 3);
+    igraph_vector_init_seq(&to, 100, 150);
+
+    igraph_shortest_paths_dijkstra(compact, &ref, igraph_vss_vector(&from),
+                                   igraph_vss_all(), &weights, mode);
+
+    for (s = 0; s < 3; s++) {
+        long int reached = 0;
+        igraph_subcomponent(g, &comp, sources[s], mode);
+        for (j = 0; j < n; j++) {
+            if (MATRIX(ref, s, j) != IGRAPH_INFINITY) {
+                reached++;
+            }
+        }
+        if (igraph_vector_size(&comp) != reached || VECTOR(comp)[0] != sources[s]) {
+            return 1;
+        }
+        for (i = 1; i < igraph_vector_size(&comp); i++) {
+            long int u = VECTOR(comp)[i - 1], v = VECTOR(comp)[i];
+            if (MATRIX(ref, s, v) == IGRAPH_INFINITY ||
+                MATRIX(ref, s, u) > MATRIX(ref, s, v)) {
+                return 2;
+            }
+        }
+
+        igraph_shortest_paths(g, &res, igraph_vss_1(sources[s]), igraph_vss_all(),
+                              mode);
+        for (j = 0; j < n; j++) {
+            if (MATRIX(res, 0, j) != MATRIX(ref, s, j)) {
+                return 3;
+            }
+        }
+    }
+
+    igraph_shortest_paths(g, &res, igraph_vss_vector(&from),
+                          igraph_vss_vector(&to), mode);
+    for (s = 0; s < 3; s++) {
+        for (j = 0; j < igraph_vector_size(&to); j++) {
+            if (MATRIX(res, s, j) != MATRIX(ref, s, (long int) VECTOR(to)[j])) {
+                return 4;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&to);
+    igraph_matrix_destroy(&ref);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&comp);
+    igraph_vector_destroy(&weights);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g, compact;
+    igraph_vector_t edges;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Small diameter, with some deleted edges */
+    igraph_barabasi_game(&g, 20000, /*power=*/ 1, 5, /*outseq=*/ 0,
+                         /*outpref=*/ 0, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+    igraph_vector_init(&edges, 0);
+    igraph_random_sample(&edges, 0, igraph_ecount(&g) - 1, 500);
+    igraph_delete_edges_deferred(&g, igraph_ess_vector(&edges), /*threshold=*/ 1);
+    igraph_copy(&compact, &g);
+    igraph_compact_deleted(&compact, 0, 0);
+    if ((ret = check(&g, &compact, IGRAPH_ALL)) != 0) {
+        return ret;
+    }
+    igraph_destroy(&compact);
+    igraph_destroy(&g);
+
+    /* Directed, some vertices are not reachable */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 20000, 50000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_random_sample(&edges, 0, igraph_ecount(&g) - 1, 500);
+    igraph_delete_edges_deferred(&g, igraph_ess_vector(&edges), /*threshold=*/ 1);
+    igraph_copy(&compact, &g);
+    igraph_compact_deleted(&compact, 0, 0);
+    if ((ret = check(&g, &compact, IGRAPH_OUT)) != 0) {
+        return 10 + ret;
+    }
+    if ((ret = check(&g, &compact, IGRAPH_IN)) != 0) {
+        return 20 + ret;
+    }
+    if ((ret = check(&g, &compact, IGRAPH_ALL)) != 0) {
+        return 30 + ret;
+    }
+    igraph_destroy(&compact);
+    igraph_destroy(&g);
+
+    /* Large diameter */
+    igraph_ring(&g, 1000, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+    if ((ret = check(&g, &g, IGRAPH_OUT)) != 0) {
+        return 40 + ret;
+    }
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&edges);
+
+    return 0;
+}
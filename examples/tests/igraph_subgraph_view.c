@@ -0,0 +1,279 @@
+#include <igraph.h>
+#include <math.h>
+#include <stdio.h>
+
+/* Everything computed on the view must agree with the same computation
+   on the induced subgraph */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i;
+    if (igraph_vector_size(v1) != igraph_vector_size(v2)) {
+        return 0;
+    }
+    for (i = 0; i < igraph_vector_size(v1); i++) {
+        igraph_real_t a = VECTOR(*v1)[i], b = VECTOR(*v2)[i];
+        if (isnan(a) != isnan(b) || (!isnan(a) && fabs(a - b) > 1e-12)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check(const igraph_t *g, const igraph_vector_t *vids) {
+    igraph_t sub;
+    igraph_subgraph_view_t view;
+    igraph_vector_t r1, r2, r3, r4;
+    igraph_real_t t1, t2;
+    igraph_integer_t no1, no2;
+    igraph_bool_t simple;
+    igraph_error_handler_t *handler;
+    int ret;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j;
+
+    /* the vertices are kept in increasing order by the copy and delete
+       implementation */
+    igraph_induced_subgraph(g, &sub, igraph_vss_vector(vids),
+                            IGRAPH_SUBGRAPH_COPY_AND_DELETE);
+    igraph_subgraph_view_init(g, &view, igraph_vss_vector(vids));
+
+    if (igraph_subgraph_view_vcount(&view) != igraph_vcount(&sub) ||
+        igraph_subgraph_view_ecount(&view) != igraph_ecount(&sub)) {
+        return 1;
+    }
+    for (i = 0; i < igraph_vcount(&sub); i++) {
+        if (igraph_subgraph_view_parent_vid(&view, i) != VECTOR(*vids)[i] ||
+            igraph_subgraph_view_vid(&view, VECTOR(*vids)[i]) != i) {
+            return 2;
+        }
+    }
+
+    igraph_vector_init(&r1, 0);
+    igraph_vector_init(&r2, 0);
+    igraph_vector_init(&r3, 0);
+    igraph_vector_init(&r4, 0);
+
+    igraph_subgraph_view_edges(&view, &r1);
+    if (igraph_vector_size(&r1) != igraph_ecount(&sub)) {
+        return 3;
+    }
+    for (i = 0; i < igraph_vector_size(&r1); i++) {
+        igraph_integer_t from, to;
+        igraph_edge(g, VECTOR(r1)[i], &from, &to);
+        if (igraph_subgraph_view_vid(&view, from) < 0 ||
+            igraph_subgraph_view_vid(&view, to) < 0) {
+            return 4;
+        }
+    }
+
+    for (j = 0; j < 3; j++) {
+        for (i = 0; i < igraph_vcount(&sub); i++) {
+            igraph_neighbors(&sub, &r1, i, modes[j]);
+            igraph_subgraph_view_neighbors(&view, &r2, i, modes[j]);
+            if (!same(&r1, &r2)) {
+                return 5;
+            }
+        }
+        igraph_degree(&sub, &r1, igraph_vss_all(), modes[j], IGRAPH_LOOPS);
+        igraph_subgraph_view_degree(&view, &r2, modes[j], IGRAPH_LOOPS);
+        if (!same(&r1, &r2)) {
+            return 6;
+        }
+        igraph_degree(&sub, &r1, igraph_vss_all(), modes[j], IGRAPH_NO_LOOPS);
+        igraph_subgraph_view_degree(&view, &r2, modes[j], IGRAPH_NO_LOOPS);
+        if (!same(&r1, &r2)) {
+            return 7;
+        }
+    }
+
+    /* sorted neighbor lists in both, the search is the same */
+    if (igraph_vcount(&sub) > 0) {
+        for (j = 0; j < 2; j++) {
+            igraph_bfs(&sub, 0, 0, modes[j], /*unreachable=*/ 0, 0, &r1, 0,
+                       &r3, 0, 0, 0, 0, 0);
+            igraph_subgraph_view_bfs(&view, 0, modes[j], &r2, &r4, 0);
+            if (!same(&r1, &r2) || !same(&r3, &r4)) {
+                return 8;
+            }
+        }
+        igraph_bfs(&sub, 0, 0, IGRAPH_ALL, 0, 0, 0, 0, 0, 0, 0, &r1, 0, 0);
+        igraph_subgraph_view_bfs(&view, 0, IGRAPH_ALL, 0, 0, &r2);
+        if (!same(&r1, &r2)) {
+            return 9;
+        }
+    }
+
+    igraph_clusters(&sub, &r1, &r3, &no1, IGRAPH_WEAK);
+    igraph_subgraph_view_clusters(&view, &r2, &r4, &no2);
+    if (no1 != no2 || !same(&r1, &r2) || !same(&r3, &r4)) {
+        return 10;
+    }
+
+    igraph_transitivity_undirected(&sub, &t1, IGRAPH_TRANSITIVITY_NAN);
+    igraph_subgraph_view_transitivity(&view, &t2, IGRAPH_TRANSITIVITY_NAN);
+    if (isnan(t1) != isnan(t2) || (!isnan(t1) && fabs(t1 - t2) > 1e-12)) {
+        return 11;
+    }
+    /* only for simple undirected graphs, the same errors otherwise */
+    igraph_is_simple(&sub, &simple);
+    handler = igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_subgraph_view_transitivity_local(&view, &r2,
+            IGRAPH_TRANSITIVITY_ZERO);
+    if (ret != igraph_transitivity_local_undirected(&sub, &r1, igraph_vss_all(),
+            IGRAPH_TRANSITIVITY_ZERO)) {
+        return 12;
+    }
+    igraph_set_error_handler(handler);
+    if (ret == 0 && (!simple || igraph_is_directed(g) || !same(&r1, &r2))) {
+        return 13;
+    }
+
+    igraph_vector_destroy(&r1);
+    igraph_vector_destroy(&r2);
+    igraph_vector_destroy(&r3);
+    igraph_vector_destroy(&r4);
+    igraph_subgraph_view_destroy(&view);
+    igraph_destroy(&sub);
+
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g;
+    igraph_vector_t vids;
+    long int i, k;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 400, directed,
+                            IGRAPH_LOOPS);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 4, 4);
+    igraph_vector_init(&vids, 0);
+
+    for (k = 0; k <= 100; k += 10) {
+        igraph_vector_clear(&vids);
+        for (i = 0; i < 100; i++) {
+            if (i == 3 || i == 4 || RNG_UNIF01() * 100 < k) {
+                igraph_vector_push_back(&vids, i);
+            }
+        }
+        ret = check(&g, &vids);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    /* The closed neighborhood of a vertex */
+    igraph_neighbors(&g, &vids, 3, IGRAPH_ALL);
+    igraph_vector_push_back(&vids, 3);
+    igraph_vector_sort(&vids);
+    for (i = 1, k = 1; i < igraph_vector_size(&vids); i++) {
+        if (VECTOR(vids)[i] != VECTOR(vids)[k - 1]) {
+            VECTOR(vids)[k++] = VECTOR(vids)[i];
+        }
+    }
+    igraph_vector_resize(&vids, k);
+    ret = check(&g, &vids);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+
+    igraph_vector_destroy(&vids);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_subgraph_view_t view;
+    igraph_vector_t res, vids;
+    igraph_real_t t;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 100 + ret;
+    }
+
+    /* Simple graph, for the local transitivity */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 600,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init_seq(&vids, 0, 99);
+    ret = check(&g, &vids);
+    if (ret != 0) {
+        return 150 + ret;
+    }
+    igraph_random_sample(&vids, 0, 99, 40);
+    ret = check(&g, &vids);
+    if (ret != 0) {
+        return 160 + ret;
+    }
+    igraph_vector_destroy(&vids);
+    igraph_destroy(&g);
+
+    /* Reusing a view, the vertices are numbered in the given order,
+       duplicates are ignored */
+    igraph_ring(&g, 10, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    igraph_vector_init(&res, 0);
+    igraph_vector_init_int(&vids, 3, 5, 4, 5);
+    igraph_subgraph_view_init(&g, &view, igraph_vss_vector(&vids));
+    if (igraph_subgraph_view_vcount(&view) != 2 ||
+        igraph_subgraph_view_parent_vid(&view, 0) != 5 ||
+        igraph_subgraph_view_vid(&view, 4) != 1 ||
+        igraph_subgraph_view_vid(&view, 0) != -1 ||
+        igraph_subgraph_view_ecount(&view) != 1) {
+        return 200;
+    }
+    igraph_subgraph_view_select(&view, igraph_vss_seq(0, 2));
+    igraph_subgraph_view_degree(&view, &res, IGRAPH_ALL, IGRAPH_LOOPS);
+    if (igraph_subgraph_view_vcount(&view) != 3 ||
+        igraph_subgraph_view_vid(&view, 4) != -1 ||
+        igraph_subgraph_view_ecount(&view) != 2 ||
+        VECTOR(res)[0] != 1 || VECTOR(res)[1] != 2 || VECTOR(res)[2] != 1) {
+        return 201;
+    }
+    igraph_subgraph_view_transitivity(&view, &t, IGRAPH_TRANSITIVITY_NAN);
+    if (t != 0) {
+        return 202;
+    }
+
+    /* Deleted vertices and edges are left out */
+    igraph_delete_edges_deferred(&g, igraph_ess_1(0), /*threshold=*/ 1);
+    igraph_delete_vertices_deferred(&g, igraph_vss_1(2), /*threshold=*/ 1);
+    igraph_subgraph_view_select(&view, igraph_vss_all());
+    if (igraph_subgraph_view_vcount(&view) != 9 ||
+        igraph_subgraph_view_ecount(&view) != 7) {
+        return 203;
+    }
+
+    /* Empty view */
+    igraph_subgraph_view_select(&view, igraph_vss_none());
+    igraph_subgraph_view_clusters(&view, &res, 0, 0);
+    igraph_subgraph_view_transitivity(&view, &t, IGRAPH_TRANSITIVITY_ZERO);
+    if (igraph_subgraph_view_vcount(&view) != 0 ||
+        igraph_vector_size(&res) != 0 || t != 0) {
+        return 204;
+    }
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_subgraph_view_bfs(&view, 0, IGRAPH_OUT, 0, 0, 0) != IGRAPH_EINVVID ||
+        igraph_subgraph_view_select(&view, igraph_vss_1(10)) != IGRAPH_EINVVID) {
+        return 205;
+    }
+
+    igraph_subgraph_view_destroy(&view);
+    igraph_vector_destroy(&vids);
+    igraph_vector_destroy(&res);
+    igraph_destroy(&g);
+
+    return 0;
+}
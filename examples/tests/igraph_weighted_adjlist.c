@@ -0,0 +1,117 @@
+#include <igraph.h>
+#include <stdio.h>
+
+/* The weighted adjacency list must contain the same edges, in the same
+   order, as the incidence list */
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_neimode_t mode) {
+    igraph_weighted_adjlist_t wal;
+    igraph_inclist_t il;
+    long int i, j, n = igraph_vcount(g);
+
+    igraph_weighted_adjlist_init(g, &wal, mode, weights);
+    igraph_inclist_init(g, &il, mode);
+    for (i = 0; i < n; i++) {
+        igraph_vector_int_t *incs = igraph_inclist_get(&il, i);
+        igraph_weighted_adjlist_entry_t *neis = igraph_weighted_adjlist_get(&wal, i);
+        if (igraph_weighted_adjlist_size(&wal, i) != igraph_vector_int_size(incs)) {
+            return 1;
+        }
+        for (j = 0; j < igraph_vector_int_size(incs); j++) {
+            igraph_integer_t e = VECTOR(*incs)[j];
+            if (neis[j].edge != e || neis[j].nei != IGRAPH_OTHER(g, e, i) ||
+                neis[j].weight != (weights ? VECTOR(*weights)[e] : 1.0)) {
+                return 2;
+            }
+        }
+    }
+    igraph_inclist_destroy(&il);
+    igraph_weighted_adjlist_destroy(&wal);
+
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g;
+    igraph_vector_t weights;
+    long int i;
+    int ret;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 300, directed,
+                            IGRAPH_LOOPS);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 3, 4);
+    igraph_add_edge(&g, 5, 5);
+    igraph_add_vertices(&g, 3, 0);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 10);
+    }
+
+    ret = check(&g, &weights, IGRAPH_OUT);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = check(&g, &weights, IGRAPH_IN);
+    if (ret != 0) {
+        return 10 + ret;
+    }
+    ret = check(&g, &weights, IGRAPH_ALL);
+    if (ret != 0) {
+        return 20 + ret;
+    }
+    ret = check(&g, 0, IGRAPH_ALL);
+    if (ret != 0) {
+        return 30 + ret;
+    }
+    igraph_delete_edges_deferred(&g, igraph_ess_seq(50, 150), /*threshold=*/ 1);
+    ret = check(&g, &weights, IGRAPH_OUT);
+    if (ret != 0) {
+        return 40 + ret;
+    }
+
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    igraph_weighted_adjlist_t wal;
+    igraph_vector_t weights;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = test(IGRAPH_UNDIRECTED);
+    if (ret != 0) {
+        return 100 + ret;
+    }
+
+    /* Null graph */
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_weighted_adjlist_init(&g, &wal, IGRAPH_ALL, 0);
+    if (wal.length != 0) {
+        return 200;
+    }
+    igraph_weighted_adjlist_destroy(&wal);
+    igraph_destroy(&g);
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_ring(&g, 5, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    igraph_vector_init(&weights, 4);
+    if (igraph_weighted_adjlist_init(&g, &wal, IGRAPH_ALL, &weights) != IGRAPH_EINVAL) {
+        return 201;
+    }
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -106,6 +106,57 @@ DECLDIR int igraph_inclist_fprint(const igraph_inclist_t *il, FILE *outfile);
  */
 #define igraph_inclist_get(il,no) (&(il)->incs[(long int)(no)])
 
+typedef struct igraph_weighted_adjlist_entry_t {
+    igraph_integer_t nei;
+    igraph_integer_t edge;
+    igraph_real_t weight;
+} igraph_weighted_adjlist_entry_t;
+
+typedef struct igraph_weighted_adjlist_t {
+    igraph_integer_t length;
+    /* The entries of vertex i are entries[start[i]] ... entries[start[i+1]-1] */
+    igraph_vector_int_t start;
+    igraph_weighted_adjlist_entry_t *entries;
+} igraph_weighted_adjlist_t;
+
+DECLDIR int igraph_weighted_adjlist_init(const igraph_t *graph,
+        igraph_weighted_adjlist_t *wal,
+        igraph_neimode_t mode,
+        const igraph_vector_t *weights);
+DECLDIR void igraph_weighted_adjlist_destroy(igraph_weighted_adjlist_t *wal);
+
+/**
+ * \define igraph_weighted_adjlist_get
+ * Query the neighbors of a vertex in a weighted adjacency list
+ *
+ * Returns a pointer to the first entry of a vertex in a weighted
+ * adjacency list, the number of its entries is given by \ref
+ * igraph_weighted_adjlist_size(). Each entry contains a neighbor
+ * (<code>nei</code>), the id of the edge leading to it
+ * (<code>edge</code>) and the weight of that edge
+ * (<code>weight</code>).
+ * \param wal Pointer to the weighted adjacency list.
+ * \param no The vertex of which the neighbors are returned.
+ * \return Pointer to an <type>igraph_weighted_adjlist_entry_t</type>.
+ *
+ * Time complexity: O(1).
+ */
+#define igraph_weighted_adjlist_get(wal,no) \
+    ((wal)->entries + VECTOR((wal)->start)[(long int)(no)])
+
+/**
+ * \define igraph_weighted_adjlist_size
+ * The number of neighbors of a vertex in a weighted adjacency list
+ *
+ * \param wal Pointer to the weighted adjacency list.
+ * \param no The vertex id.
+ * \return The number of entries of the vertex.
+ *
+ * Time complexity: O(1).
+ */
+#define igraph_weighted_adjlist_size(wal,no) \
+    (VECTOR((wal)->start)[(long int)(no)+1] - VECTOR((wal)->start)[(long int)(no)])
+
 typedef struct igraph_lazy_adjlist_t {
     const igraph_t *graph;
     igraph_integer_t length;
@@ -179,6 +230,72 @@ DECLDIR void igraph_lazy_inclist_clear(igraph_lazy_inclist_t *il);
 DECLDIR igraph_vector_t *igraph_lazy_inclist_get_real(igraph_lazy_inclist_t *al,
         igraph_integer_t no);
 
+typedef struct igraph_compressed_adj_t {
+    igraph_vector_char_t data;
+    igraph_vector_long_t base;
+    igraph_vector_int_t offset;
+} igraph_compressed_adj_t;
+
+typedef struct igraph_compressed_t {
+    igraph_integer_t n;
+    igraph_integer_t m;
+    igraph_bool_t directed;
+    igraph_compressed_adj_t out;
+    igraph_compressed_adj_t in;
+} igraph_compressed_t;
+
+/**
+ * \typedef igraph_compressed_nit_t
+ * Iterator over the neighbors of a vertex in a compressed graph
+ *
+ * Create it with \ref igraph_compressed_nit_create() and step it with
+ * \ref igraph_compressed_nit_next(). It needs no destruction. The
+ * fields are internal, they should not be used directly.
+ */
+typedef struct igraph_compressed_nit_t {
+    const unsigned char *pos;
+    long int remaining;
+    long int last;
+    const unsigned char *pos2;
+    long int remaining2;
+    long int vid;
+} igraph_compressed_nit_t;
+
+DECLDIR int igraph_compressed_init(const igraph_t *graph,
+                                   igraph_compressed_t *cg);
+DECLDIR void igraph_compressed_destroy(igraph_compressed_t *cg);
+DECLDIR igraph_integer_t igraph_compressed_vcount(const igraph_compressed_t *cg);
+DECLDIR igraph_integer_t igraph_compressed_ecount(const igraph_compressed_t *cg);
+DECLDIR igraph_bool_t igraph_compressed_is_directed(const igraph_compressed_t *cg);
+DECLDIR size_t igraph_compressed_memory(const igraph_compressed_t *cg);
+DECLDIR int igraph_compressed_degree(const igraph_compressed_t *cg,
+                                     igraph_integer_t *res,
+                                     igraph_integer_t vid,
+                                     igraph_neimode_t mode);
+DECLDIR int igraph_compressed_nit_create(const igraph_compressed_t *cg,
+        igraph_compressed_nit_t *nit,
+        igraph_integer_t vid,
+        igraph_neimode_t mode);
+DECLDIR igraph_bool_t igraph_compressed_nit_next(igraph_compressed_nit_t *nit,
+        igraph_integer_t *nei);
+DECLDIR int igraph_compressed_get_graph(const igraph_compressed_t *cg,
+                                        igraph_t *graph);
+DECLDIR int igraph_compressed_bfs(const igraph_compressed_t *cg,
+                                  igraph_integer_t root,
+                                  igraph_neimode_t mode,
+                                  igraph_vector_t *order,
+                                  igraph_vector_t *father,
+                                  igraph_vector_t *dist);
+DECLDIR int igraph_compressed_clusters(const igraph_compressed_t *cg,
+                                       igraph_vector_t *membership,
+                                       igraph_vector_t *csize,
+                                       igraph_integer_t *no);
+DECLDIR int igraph_compressed_pagerank(const igraph_compressed_t *cg,
+                                       igraph_vector_t *vector,
+                                       igraph_real_t *value,
+                                       igraph_real_t damping,
+                                       igraph_bool_t directed);
+
 /*************************************************************************
  * DEPRECATED TYPES AND FUNCTIONS
  */
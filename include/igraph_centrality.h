@@ -45,6 +45,15 @@ DECLDIR int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *re
                                       igraph_real_t cutoff,
                                       const igraph_vector_t *weights,
                                       igraph_bool_t normalized);
+DECLDIR int igraph_harmonic_centrality(const igraph_t *graph, igraph_vector_t *res,
+                                       const igraph_vs_t vids, igraph_neimode_t mode,
+                                       const igraph_vector_t *weights,
+                                       igraph_bool_t normalized);
+DECLDIR int igraph_harmonic_centrality_estimate(const igraph_t *graph, igraph_vector_t *res,
+                                                const igraph_vs_t vids, igraph_neimode_t mode,
+                                                igraph_real_t cutoff,
+                                                const igraph_vector_t *weights,
+                                                igraph_bool_t normalized);
 
 DECLDIR int igraph_betweenness(const igraph_t *graph, igraph_vector_t *res,
                                const igraph_vs_t vids, igraph_bool_t directed,
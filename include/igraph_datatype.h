@@ -30,6 +30,88 @@
 
 __BEGIN_DECLS
 
+/**
+ * \ingroup internal
+ * \struct igraph_i_deleted_t
+ * \brief Edges and vertices marked as deleted.
+ *
+ * Deferred deletion only marks edges and vertices as deleted, they
+ * are removed from the edge list when the graph is compacted. Its
+ * members:
+ * - <b>edges</b> Non-zero for the deleted edges, its length is the
+ *   number of edges.
+ * - <b>vertices</b> Non-zero for the deleted vertices, its length is
+ *   the number of vertices. All edges incident on a deleted vertex
+ *   are deleted as well.
+ * - <b>ecount</b> The number of deleted edges.
+ * - <b>vcount</b> The number of deleted vertices.
+ */
+typedef struct igraph_i_deleted_t {
+    igraph_vector_char_t edges;
+    igraph_vector_char_t vertices;
+    igraph_integer_t ecount;
+    igraph_integer_t vcount;
+} igraph_i_deleted_t;
+
+/**
+ * \ingroup internal
+ * \struct igraph_i_snapshot_t
+ * \brief A memory mapped graph snapshot.
+ *
+ * The edge index of a graph read by \ref igraph_read_graph_snapshot()
+ * points into a read-only memory mapping of the snapshot file. Its
+ * members:
+ * - <b>addr</b> The start of the mapping.
+ * - <b>size</b> The length of the mapping in bytes.
+ */
+typedef struct igraph_i_snapshot_t {
+    void *addr;
+    size_t size;
+} igraph_i_snapshot_t;
+
+/**
+ * \ingroup internal
+ * \struct igraph_i_shared_t
+ * \brief Reference count of an edge index shared by several graphs.
+ *
+ * \ref igraph_copy() does not copy the edge index, the copy shares
+ * the six index vectors of the original graph. The first modification
+ * of any of these graphs gives it its own copy. Its members:
+ * - <b>refcount</b> The number of graphs using the index.
+ */
+typedef struct igraph_i_shared_t {
+    long int refcount;
+} igraph_i_shared_t;
+
+/**
+ * \ingroup internal
+ * \struct igraph_i_adjindex_t
+ * \brief Hash tables for the adjacency lookups of high degree vertices.
+ *
+ * Built by \ref igraph_adjacency_index_build(). Every vertex with at
+ * least \c min_degree out-edges (in-edges) has an open addressing
+ * hash table that maps each of its out-neighbors (in-neighbors) to
+ * the position of the first edge to that neighbor in \c oi
+ * (\c ii). The lists of the other vertices are binary searched, as
+ * without the index. Its members:
+ * - <b>min_degree</b> Vertices with shorter lists have no table.
+ * - <b>ostart</b> The table of the out-neighbors of vertex \c v
+ *   consists of the slots from \c ostart[v] to \c ostart[v+1]-1,
+ *   their number is zero or a power of two. Its length is the number
+ *   of vertices plus one.
+ * - <b>otable</b> Two integers per slot, the neighbor, or -1 for an
+ *   empty slot, and its position in \c oi.
+ * - <b>istart</b> The same as \c ostart, for the in-neighbors.
+ * - <b>itable</b> The same as \c otable, with positions in \c ii.
+ */
+typedef struct igraph_i_adjindex_t {
+    igraph_integer_t min_degree;
+    igraph_vector_int_t ostart;
+    igraph_vector_int_t otable;
+    igraph_vector_int_t istart;
+    igraph_vector_int_t itable;
+} igraph_i_adjindex_t;
+
 /**
  * \ingroup internal
  * \struct igraph_t
@@ -63,19 +145,43 @@ __BEGIN_DECLS
  * should search for both \c from=v1, \c to=v2 and
  * \c from=v2, \c to=v1.
  *
+ * All six vectors hold integers (\type igraph_vector_int_t), not
+ * real numbers, since they store vertex and edge ids only. This
+ * way the index takes four integers (16 bytes on most platforms)
+ * per edge and two integers per vertex.
+ *
+ * - <b>deleted</b> Edges and vertices that were deleted by
+ *   \ref igraph_delete_edges_deferred() or \ref
+ *   igraph_delete_vertices_deferred(), but are still part of the
+ *   edge list, until the graph is compacted. This is a null pointer
+ *   if there are no such edges and vertices.
+ * - <b>snapshot</b> If not a null pointer, then the six index vectors
+ *   are views into a read-only memory mapped snapshot file, and the
+ *   graph cannot be modified.
+ * - <b>shared</b> If not a null pointer, then the six index vectors
+ *   might be shared with copies of the graph, and they must not be
+ *   modified before the graph gets its own copy of them.
+ * - <b>adjindex</b> The optional adjacency index of the graph, see
+ *   \ref igraph_adjacency_index_build(), or a null pointer. It is
+ *   dropped when the edge index changes, and it is not copied.
+ *
  * The storage requirements for a graph with \c |V| vertices
  * and \c |E| edges is \c O(|E|+|V|).
  */
 typedef struct igraph_s {
     igraph_integer_t n;
     igraph_bool_t directed;
-    igraph_vector_t from;
-    igraph_vector_t to;
-    igraph_vector_t oi;
-    igraph_vector_t ii;
-    igraph_vector_t os;
-    igraph_vector_t is;
+    igraph_vector_int_t from;
+    igraph_vector_int_t to;
+    igraph_vector_int_t oi;
+    igraph_vector_int_t ii;
+    igraph_vector_int_t os;
+    igraph_vector_int_t is;
     void *attr;
+    struct igraph_i_deleted_t *deleted;
+    struct igraph_i_snapshot_t *snapshot;
+    struct igraph_i_shared_t *shared;
+    struct igraph_i_adjindex_t *adjindex;
 } igraph_t;
 
 __END_DECLS
@@ -61,6 +61,7 @@ DECLDIR int igraph_read_graph_graphdb(igraph_t *graph, FILE *instream,
 DECLDIR int igraph_read_graph_gml(igraph_t *graph, FILE *instream);
 DECLDIR int igraph_read_graph_dl(igraph_t *graph, FILE *instream,
                                  igraph_bool_t directed);
+DECLDIR int igraph_read_graph_snapshot(igraph_t *graph, FILE *instream);
 
 DECLDIR int igraph_write_graph_edgelist(const igraph_t *graph, FILE *outstream);
 DECLDIR int igraph_write_graph_ncol(const igraph_t *graph, FILE *outstream,
@@ -79,6 +80,7 @@ DECLDIR int igraph_write_graph_gml(const igraph_t *graph, FILE *outstream,
 DECLDIR int igraph_write_graph_dot(const igraph_t *graph, FILE *outstream);
 DECLDIR int igraph_write_graph_leda(const igraph_t *graph, FILE *outstream,
                                     const char* vertex_attr_name, const char* edge_attr_name);
+DECLDIR int igraph_write_graph_snapshot(const igraph_t *graph, FILE *outstream);
 
 __END_DECLS
 
@@ -31,6 +31,64 @@
 
 __BEGIN_DECLS
 
+/**
+ * \struct igraph_incident_view_t
+ * \brief A view of the incident edges of a vertex.
+ *
+ * Created by \ref igraph_incident_view(), it points into the edge
+ * index of the graph, without copying it. Use the \ref
+ * IGRAPH_VIEW_SIZE, \ref IGRAPH_VIEW_EDGE, \ref IGRAPH_VIEW_NEIGHBOR
+ * and \ref IGRAPH_VIEW_DELETED macros to access it, instead of its
+ * members.
+ */
+typedef struct igraph_incident_view_t {
+    const igraph_integer_t *eids;
+    const igraph_integer_t *other;
+    const char *deleted;
+    igraph_integer_t size;
+} igraph_incident_view_t;
+
+/**
+ * \define IGRAPH_VIEW_SIZE
+ * \brief The number of edges in an incident edge view.
+ *
+ * This includes the edges marked as deleted, see \ref
+ * IGRAPH_VIEW_DELETED.
+ * \param view The view, an \type igraph_incident_view_t.
+ */
+#define IGRAPH_VIEW_SIZE(view) ((view).size)
+/**
+ * \define IGRAPH_VIEW_EDGE
+ * \brief The id of an edge in an incident edge view.
+ *
+ * \param view The view, an \type igraph_incident_view_t.
+ * \param i The position in the view, between zero and \ref
+ *    IGRAPH_VIEW_SIZE minus one.
+ */
+#define IGRAPH_VIEW_EDGE(view,i) ((view).eids[(i)])
+/**
+ * \define IGRAPH_VIEW_NEIGHBOR
+ * \brief The other endpoint of an edge in an incident edge view.
+ *
+ * \param view The view, an \type igraph_incident_view_t.
+ * \param i The position in the view, between zero and \ref
+ *    IGRAPH_VIEW_SIZE minus one.
+ */
+#define IGRAPH_VIEW_NEIGHBOR(view,i) ((view).other[(view).eids[(i)]])
+/**
+ * \define IGRAPH_VIEW_DELETED
+ * \brief Whether an edge in an incident edge view is marked as deleted.
+ *
+ * Edges deleted by \ref igraph_delete_edges_deferred() or \ref
+ * igraph_delete_vertices_deferred() stay in the view until the graph
+ * is compacted, they should be skipped.
+ * \param view The view, an \type igraph_incident_view_t.
+ * \param i The position in the view, between zero and \ref
+ *    IGRAPH_VIEW_SIZE minus one.
+ */
+#define IGRAPH_VIEW_DELETED(view,i) \
+    ((view).deleted && (view).deleted[(view).eids[(i)]])
+
 /* -------------------------------------------------- */
 /* Interface                                          */
 /* -------------------------------------------------- */
@@ -48,6 +106,22 @@ DECLDIR int igraph_delete_vertices(igraph_t *graph, const igraph_vs_t vertices);
 DECLDIR int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
                                        igraph_vector_t *idx,
                                        igraph_vector_t *invidx);
+DECLDIR int igraph_delete_edges_deferred(igraph_t *graph, igraph_es_t edges,
+                                         igraph_real_t threshold);
+DECLDIR int igraph_delete_vertices_deferred(igraph_t *graph, igraph_vs_t vertices,
+                                            igraph_real_t threshold);
+DECLDIR int igraph_compact_deleted(igraph_t *graph, igraph_vector_t *idx,
+                                   igraph_vector_t *invidx);
+DECLDIR igraph_integer_t igraph_deleted_ecount(const igraph_t *graph);
+DECLDIR igraph_integer_t igraph_deleted_vcount(const igraph_t *graph);
+DECLDIR igraph_bool_t igraph_is_edge_deleted(const igraph_t *graph,
+                                             igraph_integer_t eid);
+DECLDIR igraph_bool_t igraph_is_vertex_deleted(const igraph_t *graph,
+                                               igraph_integer_t vid);
+DECLDIR int igraph_adjacency_index_build(igraph_t *graph,
+                                         igraph_integer_t min_degree);
+DECLDIR void igraph_adjacency_index_destroy(igraph_t *graph);
+DECLDIR igraph_bool_t igraph_has_adjacency_index(const igraph_t *graph);
 DECLDIR igraph_integer_t igraph_vcount(const igraph_t *graph);
 DECLDIR igraph_integer_t igraph_ecount(const igraph_t *graph);
 DECLDIR int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_integer_t vid,
@@ -75,6 +149,8 @@ DECLDIR int igraph_adjacent(const igraph_t *graph, igraph_vector_t *eids, igraph
                             igraph_neimode_t mode);          /* deprecated */
 DECLDIR int igraph_incident(const igraph_t *graph, igraph_vector_t *eids, igraph_integer_t vid,
                             igraph_neimode_t mode);
+DECLDIR int igraph_incident_view(const igraph_t *graph, igraph_incident_view_t *view,
+                                 igraph_integer_t vid, igraph_neimode_t mode);
 
 #define IGRAPH_FROM(g,e) ((igraph_integer_t)(VECTOR((g)->from)[(long int)(e)]))
 #define IGRAPH_TO(g,e)   ((igraph_integer_t)(VECTOR((g)->to)  [(long int)(e)]))
@@ -32,6 +32,8 @@
 #include "igraph_matrix.h"
 #include "igraph_iterators.h"
 
+#include <stdio.h>
+
 __BEGIN_DECLS
 
 DECLDIR int igraph_diameter(const igraph_t *graph, igraph_integer_t *res,
@@ -97,6 +99,120 @@ DECLDIR int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
         igraph_integer_t to,
         const igraph_vector_t *weights,
         igraph_neimode_t mode);
+
+/**
+ * \typedef igraph_astar_heuristic_func_t
+ * \brief Distance estimate for the A* algorithm.
+ *
+ * \ref igraph_get_shortest_path_astar() calls this function for every
+ * vertex it reaches, to estimate its distance from the target vertex.
+ * The search finds a shortest path if the estimate is never larger than
+ * the real distance.
+ *
+ * \param result The estimate must be stored here. It may be
+ *   \c IGRAPH_INFINITY if the target cannot be reached from the vertex,
+ *   the vertex is skipped then.
+ * \param from The vertex whose distance is estimated.
+ * \param to The target vertex of the search.
+ * \param extra The extra argument that was passed to \ref
+ *   igraph_get_shortest_path_astar().
+ * \return Error code, the search stops with this error if it is not
+ *   \c IGRAPH_SUCCESS.
+ */
+typedef int igraph_astar_heuristic_func_t(igraph_real_t *result,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        void *extra);
+
+DECLDIR int igraph_get_shortest_path_astar(const igraph_t *graph,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_astar_heuristic_func_t *heuristic,
+        void *extra);
+
+/**
+ * \struct igraph_landmarks_t
+ * \brief Distances to and from landmark vertices.
+ *
+ * Created by \ref igraph_landmarks_init(), it stores the distances
+ * between a few landmark vertices and all vertices of a graph, and
+ * gives lower bounds on the distance of any two vertices with \ref
+ * igraph_landmarks_heuristic(). Do not access its members directly.
+ */
+typedef struct igraph_landmarks_t {
+    igraph_vector_t vids;
+    igraph_matrix_t from;
+    igraph_matrix_t to;
+    igraph_bool_t symmetric;
+} igraph_landmarks_t;
+
+DECLDIR int igraph_landmarks_init(const igraph_t *graph,
+                                  igraph_landmarks_t *landmarks,
+                                  const igraph_vector_t *weights,
+                                  igraph_neimode_t mode,
+                                  igraph_integer_t no_of_landmarks,
+                                  const igraph_vector_t *vids);
+DECLDIR void igraph_landmarks_destroy(igraph_landmarks_t *landmarks);
+DECLDIR int igraph_landmarks_vids(const igraph_landmarks_t *landmarks,
+                                  igraph_vector_t *res);
+DECLDIR int igraph_landmarks_heuristic(igraph_real_t *result,
+                                       igraph_integer_t from,
+                                       igraph_integer_t to,
+                                       void *extra);
+
+/**
+ * \struct igraph_contraction_hierarchy_t
+ * \brief Preprocessed graph for fast shortest path queries.
+ *
+ * Created by \ref igraph_contraction_hierarchy_init() or \ref
+ * igraph_contraction_hierarchy_read(). It stores the graph with
+ * shortcut edges and the contraction order of the vertices, and a
+ * workspace for the queries. Do not access its members directly.
+ */
+typedef struct igraph_contraction_hierarchy_t {
+    igraph_integer_t n;
+    igraph_vector_int_t rank;
+    igraph_vector_int_t arc_from;
+    igraph_vector_int_t arc_to;
+    igraph_vector_t arc_weight;
+    igraph_vector_int_t arc_first;
+    igraph_vector_int_t arc_second;
+    igraph_vector_int_t up_start;
+    igraph_vector_int_t up_arcs;
+    igraph_vector_int_t down_start;
+    igraph_vector_int_t down_arcs;
+    struct igraph_i_ch_workspace_t *work;
+} igraph_contraction_hierarchy_t;
+
+DECLDIR int igraph_contraction_hierarchy_init(const igraph_t *graph,
+        igraph_contraction_hierarchy_t *ch,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode);
+DECLDIR void igraph_contraction_hierarchy_destroy(igraph_contraction_hierarchy_t *ch);
+DECLDIR igraph_integer_t igraph_contraction_hierarchy_vcount(const igraph_contraction_hierarchy_t *ch);
+DECLDIR igraph_integer_t igraph_contraction_hierarchy_shortcut_count(const igraph_contraction_hierarchy_t *ch);
+DECLDIR int igraph_contraction_hierarchy_distance(igraph_contraction_hierarchy_t *ch,
+        igraph_real_t *res,
+        igraph_integer_t from,
+        igraph_integer_t to);
+DECLDIR int igraph_contraction_hierarchy_path(igraph_contraction_hierarchy_t *ch,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to);
+DECLDIR int igraph_contraction_hierarchy_distances(igraph_contraction_hierarchy_t *ch,
+        igraph_matrix_t *res,
+        const igraph_vector_t *from,
+        const igraph_vector_t *to);
+DECLDIR int igraph_contraction_hierarchy_write(const igraph_contraction_hierarchy_t *ch,
+        FILE *outstream);
+DECLDIR int igraph_contraction_hierarchy_read(igraph_contraction_hierarchy_t *ch,
+        FILE *instream);
+
 DECLDIR int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         igraph_vector_ptr_t *res,
         igraph_vector_t *nrgeo,
@@ -113,6 +229,13 @@ DECLDIR int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res
                                        igraph_bool_t directed, igraph_bool_t unconn);
 DECLDIR int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
                                     igraph_real_t *unconnected, igraph_bool_t directed);
+DECLDIR int igraph_hyperanf(const igraph_t *graph, igraph_vector_t *nf,
+                            igraph_vector_t *sizes, igraph_integer_t order,
+                            igraph_neimode_t mode, igraph_integer_t log2m);
+DECLDIR int igraph_hyperanf_stats(const igraph_vector_t *nf, igraph_vector_t *hist,
+                                  igraph_real_t *average_path_length,
+                                  igraph_real_t *effective_diameter,
+                                  igraph_real_t quantile);
 
 DECLDIR int igraph_eccentricity(const igraph_t *graph,
                                 igraph_vector_t *res,
@@ -121,6 +244,10 @@ DECLDIR int igraph_eccentricity(const igraph_t *graph,
 
 DECLDIR int igraph_radius(const igraph_t *graph, igraph_real_t *radius,
                           igraph_neimode_t mode);
+DECLDIR int igraph_graph_center(const igraph_t *graph, igraph_vector_t *res,
+                                igraph_neimode_t mode);
+DECLDIR int igraph_graph_periphery(const igraph_t *graph, igraph_vector_t *res,
+                                   igraph_neimode_t mode);
 
 DECLDIR int igraph_get_all_simple_paths(const igraph_t *graph,
                                         igraph_vector_int_t *res,
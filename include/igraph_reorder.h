@@ -0,0 +1,64 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_REORDER_H
+#define IGRAPH_REORDER_H
+
+#include "igraph_decls.h"
+#include "igraph_constants.h"
+#include "igraph_datatype.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+
+__BEGIN_DECLS
+
+/**
+ * \typedef igraph_reorder_t
+ * Vertex reordering heuristics for igraph_reorder_vertices()
+ *
+ * \enumval IGRAPH_REORDER_RCM Reverse Cuthill-McKee ordering, see
+ *   \ref igraph_vertex_order_rcm().
+ * \enumval IGRAPH_REORDER_DEGREE Vertices in decreasing order of
+ *   their total degree, see \ref igraph_vertex_order_degree().
+ * \enumval IGRAPH_REORDER_GORDER Gorder, with a window size of five,
+ *   see \ref igraph_vertex_order_gorder().
+ */
+typedef enum { IGRAPH_REORDER_RCM = 0,
+               IGRAPH_REORDER_DEGREE,
+               IGRAPH_REORDER_GORDER
+             } igraph_reorder_t;
+
+DECLDIR int igraph_vertex_order_rcm(const igraph_t *graph,
+                                    igraph_vector_t *permutation);
+DECLDIR int igraph_vertex_order_degree(const igraph_t *graph,
+                                       igraph_vector_t *permutation,
+                                       igraph_neimode_t mode);
+DECLDIR int igraph_vertex_order_gorder(const igraph_t *graph,
+                                       igraph_vector_t *permutation,
+                                       igraph_integer_t window);
+DECLDIR int igraph_reorder_vertices(const igraph_t *graph, igraph_t *res,
+                                    igraph_vector_t *permutation,
+                                    igraph_reorder_t method);
+
+__END_DECLS
+
+#endif
@@ -69,6 +69,61 @@ DECLDIR int igraph_induced_subgraph(const igraph_t *graph, igraph_t *res,
                                     const igraph_vs_t vids, igraph_subgraph_implementation_t impl);
 DECLDIR int igraph_subgraph_edges(const igraph_t *graph, igraph_t *res,
                                   const igraph_es_t eids, igraph_bool_t delete_vertices);
+
+/**
+ * \struct igraph_subgraph_view_t
+ * \brief An induced subgraph that refers to its parent graph.
+ *
+ * Created by \ref igraph_subgraph_view_init(), it stores the selected
+ * vertices of the parent graph only, the edges are read from the edge
+ * index of the parent. Vertices of the view are numbered from zero,
+ * in the order they were selected. Do not access its members
+ * directly.
+ */
+typedef struct igraph_subgraph_view_t {
+    const igraph_t *graph;
+    igraph_vector_int_t vids;
+    igraph_vector_int_t map;
+} igraph_subgraph_view_t;
+
+DECLDIR int igraph_subgraph_view_init(const igraph_t *graph,
+                                      igraph_subgraph_view_t *view,
+                                      const igraph_vs_t vids);
+DECLDIR void igraph_subgraph_view_destroy(igraph_subgraph_view_t *view);
+DECLDIR int igraph_subgraph_view_select(igraph_subgraph_view_t *view,
+                                        const igraph_vs_t vids);
+DECLDIR igraph_integer_t igraph_subgraph_view_vcount(const igraph_subgraph_view_t *view);
+DECLDIR igraph_integer_t igraph_subgraph_view_ecount(const igraph_subgraph_view_t *view);
+DECLDIR igraph_integer_t igraph_subgraph_view_parent_vid(const igraph_subgraph_view_t *view,
+        igraph_integer_t vid);
+DECLDIR igraph_integer_t igraph_subgraph_view_vid(const igraph_subgraph_view_t *view,
+        igraph_integer_t parent_vid);
+DECLDIR int igraph_subgraph_view_edges(const igraph_subgraph_view_t *view,
+                                       igraph_vector_t *eids);
+DECLDIR int igraph_subgraph_view_neighbors(const igraph_subgraph_view_t *view,
+        igraph_vector_t *neis,
+        igraph_integer_t vid,
+        igraph_neimode_t mode);
+DECLDIR int igraph_subgraph_view_degree(const igraph_subgraph_view_t *view,
+                                        igraph_vector_t *res,
+                                        igraph_neimode_t mode,
+                                        igraph_bool_t loops);
+DECLDIR int igraph_subgraph_view_bfs(const igraph_subgraph_view_t *view,
+                                     igraph_integer_t root,
+                                     igraph_neimode_t mode,
+                                     igraph_vector_t *order,
+                                     igraph_vector_t *father,
+                                     igraph_vector_t *dist);
+DECLDIR int igraph_subgraph_view_clusters(const igraph_subgraph_view_t *view,
+        igraph_vector_t *membership,
+        igraph_vector_t *csize,
+        igraph_integer_t *no);
+DECLDIR int igraph_subgraph_view_transitivity(const igraph_subgraph_view_t *view,
+        igraph_real_t *res,
+        igraph_transitivity_mode_t mode);
+DECLDIR int igraph_subgraph_view_transitivity_local(const igraph_subgraph_view_t *view,
+        igraph_vector_t *res,
+        igraph_transitivity_mode_t mode);
 DECLDIR int igraph_simplify(igraph_t *graph, igraph_bool_t multiple,
                             igraph_bool_t loops,
                             const igraph_attribute_combination_t *edge_comb);
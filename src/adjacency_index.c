@@ -0,0 +1,351 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+
+/* Multiplicative hashing of vertex ids into tables with a power of
+   two number of slots, the table holds two integers per slot. */
+#define IGRAPH_I_ADJINDEX_HASH(nei, mask) \
+    ((long int) ((((unsigned int) (nei)) * 2654435769U) ^ \
+                 ((((unsigned int) (nei)) * 2654435769U) >> 16)) & (mask))
+
+/* The smallest power of two that is at least twice as large as 'n',
+   but at least eight */
+static long int igraph_i_adjindex_capacity(long int n) {
+    long int cap = 8;
+    while (cap < 2 * n) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+/* Builds the tables of one side of the index. 'start' is os or is,
+   'index' is oi or ii and 'other' is to or from, respectively. */
+
+static int igraph_i_adjindex_build_side(const igraph_t *graph,
+                                        const igraph_vector_int_t *start,
+                                        const igraph_vector_int_t *index,
+                                        const igraph_vector_int_t *other,
+                                        long int min_degree,
+                                        igraph_vector_int_t *tstart,
+                                        igraph_vector_int_t *table) {
+    long int no_of_nodes = graph->n;
+    long int i, j, slots = 0;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(tstart, no_of_nodes + 1));
+    VECTOR(*tstart)[0] = 0;
+    for (i = 0; i < no_of_nodes; i++) {
+        long int deg = VECTOR(*start)[i + 1] - VECTOR(*start)[i];
+        if (deg >= min_degree) {
+            slots += igraph_i_adjindex_capacity(deg);
+        }
+        VECTOR(*tstart)[i + 1] = (igraph_integer_t) slots;
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_resize(table, 2 * slots));
+    igraph_vector_int_fill(table, -1);
+
+    for (i = 0; i < no_of_nodes; i++) {
+        long int cap = VECTOR(*tstart)[i + 1] - VECTOR(*tstart)[i];
+        long int mask = cap - 1, prev = -1;
+        igraph_integer_t *tab = VECTOR(*table) + 2 * VECTOR(*tstart)[i];
+        if (cap == 0) {
+            continue;
+        }
+        /* the list is sorted, only the first edge to each neighbor
+           is stored */
+        for (j = VECTOR(*start)[i]; j < VECTOR(*start)[i + 1]; j++) {
+            long int nei = VECTOR(*other)[ VECTOR(*index)[j] ];
+            long int h;
+            if (nei == prev) {
+                continue;
+            }
+            prev = nei;
+            h = IGRAPH_I_ADJINDEX_HASH(nei, mask);
+            while (tab[2 * h] != -1) {
+                h = (h + 1) & mask;
+            }
+            tab[2 * h] = (igraph_integer_t) nei;
+            tab[2 * h + 1] = (igraph_integer_t) j;
+        }
+    }
+
+    return 0;
+}
+
+static void igraph_i_adjindex_free(igraph_i_adjindex_t *adjindex) {
+    igraph_vector_int_destroy(&adjindex->ostart);
+    igraph_vector_int_destroy(&adjindex->otable);
+    igraph_vector_int_destroy(&adjindex->istart);
+    igraph_vector_int_destroy(&adjindex->itable);
+    igraph_Free(adjindex);
+}
+
+/**
+ * \function igraph_adjacency_index_build
+ * \brief Builds an index for fast edge lookups at high degree vertices.
+ *
+ * </para><para>
+ * \ref igraph_get_eid(), \ref igraph_get_eids(), \ref
+ * igraph_get_eids_multi() and \ref igraph_are_connected() find an
+ * edge by a binary search in the sorted list of the incident edges of
+ * one of its endpoints. For vertices with millions of edges, and
+ * many lookups, this is slow. This function adds hash tables of the
+ * neighbors of all vertices with at least \p min_degree out-edges or
+ * in-edges to the graph, and the functions above use them
+ * automatically, so finding an edge at these vertices takes
+ * expected constant time. The lists of the other vertices are still
+ * binary searched.
+ *
+ * </para><para>
+ * The index takes four to eight integers for each out-edge (in-edge)
+ * of the indexed vertices, and two integers for each vertex. Modifying
+ * the graph (e.g. adding or deleting edges or vertices) drops the
+ * index, it has to be built again if needed. Edges deleted by \ref
+ * igraph_delete_edges_deferred() are skipped by the lookups, so
+ * deferred deletion keeps the index, until the graph is compacted.
+ * \ref igraph_copy() does not copy the index. The index can also be
+ * built for read-only snapshots, see \ref igraph_read_graph_snapshot().
+ *
+ * \param graph The graph, an existing index is replaced.
+ * \param min_degree Positive integer, vertices with at least this
+ *        many out-edges or in-edges are indexed. The binary search
+ *        is fast for short lists, a value in the hundreds is a
+ *        reasonable choice.
+ * \return Error code:
+ *         \c IGRAPH_EINVAL if \p min_degree is not positive,
+ *         \c IGRAPH_ENOMEM if there is not enough memory.
+ *
+ * \sa \ref igraph_adjacency_index_destroy(), \ref
+ * igraph_has_adjacency_index().
+ *
+ * Time complexity: O(|V|+|E|), the number of vertices and edges.
+ */
+
+int igraph_adjacency_index_build(igraph_t *graph, igraph_integer_t min_degree) {
+    igraph_i_adjindex_t *adjindex;
+
+    if (min_degree <= 0) {
+        IGRAPH_ERROR("The minimum degree of the adjacency index must be positive",
+                     IGRAPH_EINVAL);
+    }
+
+    adjindex = igraph_Calloc(1, igraph_i_adjindex_t);
+    if (adjindex == 0) {
+        IGRAPH_ERROR("Cannot build adjacency index", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, adjindex);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&adjindex->ostart, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&adjindex->otable, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&adjindex->istart, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&adjindex->itable, 0);
+    adjindex->min_degree = min_degree;
+
+    IGRAPH_CHECK(igraph_i_adjindex_build_side(graph, &graph->os, &graph->oi,
+                 &graph->to, min_degree,
+                 &adjindex->ostart, &adjindex->otable));
+    IGRAPH_CHECK(igraph_i_adjindex_build_side(graph, &graph->is, &graph->ii,
+                 &graph->from, min_degree,
+                 &adjindex->istart, &adjindex->itable));
+
+    IGRAPH_FINALLY_CLEAN(5);
+
+    igraph_adjacency_index_destroy(graph);
+    graph->adjindex = adjindex;
+
+    return 0;
+}
+
+/**
+ * \function igraph_adjacency_index_destroy
+ * \brief Drops the adjacency index of a graph.
+ *
+ * </para><para>
+ * Frees the memory used by the index built by \ref
+ * igraph_adjacency_index_build(). It is not an error to call this
+ * function for a graph without an index.
+ *
+ * \param graph The graph.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_adjacency_index_destroy(igraph_t *graph) {
+    if (graph->adjindex) {
+        igraph_i_adjindex_free(graph->adjindex);
+        graph->adjindex = 0;
+    }
+}
+
+/**
+ * \function igraph_has_adjacency_index
+ * \brief Whether a graph has an adjacency index.
+ *
+ * \param graph The graph.
+ * \return True if the graph has an index built by \ref
+ *         igraph_adjacency_index_build(), that was not dropped since.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_bool_t igraph_has_adjacency_index(const igraph_t *graph) {
+    return graph->adjindex != 0;
+}
+
+/* Finds the first edge between 'vid' and its out-neighbor (or
+   in-neighbor) 'nei' in the index. Returns false if 'vid' is not
+   indexed. Otherwise 'pos' is set to the position of the edge in
+   oi (ii), or to the end of the list of 'vid' if there is no such
+   edge. */
+
+igraph_bool_t igraph_i_adjindex_find(const igraph_t *graph,
+                                     igraph_neimode_t mode, long int vid,
+                                     long int nei, long int *pos) {
+    const igraph_i_adjindex_t *adjindex = graph->adjindex;
+    const igraph_vector_int_t *tstart, *table, *start;
+    const igraph_integer_t *tab;
+    long int cap, mask, h;
+
+    if (mode == IGRAPH_OUT) {
+        tstart = &adjindex->ostart;
+        table = &adjindex->otable;
+        start = &graph->os;
+    } else {
+        tstart = &adjindex->istart;
+        table = &adjindex->itable;
+        start = &graph->is;
+    }
+
+    cap = VECTOR(*tstart)[vid + 1] - VECTOR(*tstart)[vid];
+    if (cap == 0) {
+        return 0;
+    }
+    mask = cap - 1;
+    tab = VECTOR(*table) + 2 * VECTOR(*tstart)[vid];
+    for (h = IGRAPH_I_ADJINDEX_HASH(nei, mask); tab[2 * h] != -1;
+         h = (h + 1) & mask) {
+        if (tab[2 * h] == nei) {
+            *pos = tab[2 * h + 1];
+            return 1;
+        }
+    }
+    *pos = VECTOR(*start)[vid + 1];
+    return 1;
+}
+
+/* A hash set of vertex ids, with multiplicities, it is used for the
+   neighbors of high degree vertices in algorithms that change the
+   edges often, where the adjacency index of the graph would need to
+   be rebuilt. Keys are not removed from the table, only their count
+   goes down to zero, these keys are dropped when the table is
+   rebuilt. 'used' is the number of non-empty slots. */
+
+static int igraph_i_adjset_rehash(igraph_i_adjset_t *set, long int size) {
+    igraph_vector_int_t table;
+    long int cap = igraph_i_adjindex_capacity(size), mask = cap - 1;
+    long int i, n = igraph_vector_int_size(&set->table) / 2;
+
+    IGRAPH_CHECK(igraph_vector_int_init(&table, 2 * cap));
+    igraph_vector_int_fill(&table, -1);
+    set->used = 0;
+    for (i = 0; i < n; i++) {
+        long int nei = VECTOR(set->table)[2 * i];
+        long int h;
+        if (nei == -1 || VECTOR(set->table)[2 * i + 1] == 0) {
+            continue;
+        }
+        h = IGRAPH_I_ADJINDEX_HASH(nei, mask);
+        while (VECTOR(table)[2 * h] != -1) {
+            h = (h + 1) & mask;
+        }
+        VECTOR(table)[2 * h] = VECTOR(set->table)[2 * i];
+        VECTOR(table)[2 * h + 1] = VECTOR(set->table)[2 * i + 1];
+        set->used++;
+    }
+    igraph_vector_int_destroy(&set->table);
+    set->table = table;
+
+    return 0;
+}
+
+/* Slot of 'nei', or the empty slot where it would go */
+static long int igraph_i_adjset_slot(const igraph_i_adjset_t *set, long int nei) {
+    long int mask = igraph_vector_int_size(&set->table) / 2 - 1;
+    long int h = IGRAPH_I_ADJINDEX_HASH(nei, mask);
+    while (VECTOR(set->table)[2 * h] != -1 && VECTOR(set->table)[2 * h] != nei) {
+        h = (h + 1) & mask;
+    }
+    return h;
+}
+
+/* 'size' is the expected number of distinct keys */
+int igraph_i_adjset_init(igraph_i_adjset_t *set, long int size) {
+    IGRAPH_CHECK(igraph_vector_int_init(&set->table,
+                                        2 * igraph_i_adjindex_capacity(size)));
+    igraph_vector_int_fill(&set->table, -1);
+    set->used = 0;
+    return 0;
+}
+
+void igraph_i_adjset_destroy(igraph_i_adjset_t *set) {
+    igraph_vector_int_destroy(&set->table);
+}
+
+igraph_bool_t igraph_i_adjset_has(const igraph_i_adjset_t *set, long int nei) {
+    long int h = igraph_i_adjset_slot(set, nei);
+    return VECTOR(set->table)[2 * h] != -1 && VECTOR(set->table)[2 * h + 1] > 0;
+}
+
+int igraph_i_adjset_add(igraph_i_adjset_t *set, long int nei) {
+    long int h = igraph_i_adjset_slot(set, nei);
+    if (VECTOR(set->table)[2 * h] == -1) {
+        long int cap = igraph_vector_int_size(&set->table) / 2;
+        if (2 * (set->used + 1) > cap) {
+            /* the keys with zero count go away, the table grows
+               only if the live keys need it */
+            long int live = 0, i;
+            for (i = 0; i < cap; i++) {
+                if (VECTOR(set->table)[2 * i] != -1 && VECTOR(set->table)[2 * i + 1] > 0) {
+                    live++;
+                }
+            }
+            IGRAPH_CHECK(igraph_i_adjset_rehash(set, 2 * (live + 1)));
+            h = igraph_i_adjset_slot(set, nei);
+        }
+        VECTOR(set->table)[2 * h] = (igraph_integer_t) nei;
+        VECTOR(set->table)[2 * h + 1] = 0;
+        set->used++;
+    }
+    VECTOR(set->table)[2 * h + 1] += 1;
+    return 0;
+}
+
+void igraph_i_adjset_remove(igraph_i_adjset_t *set, long int nei) {
+    long int h = igraph_i_adjset_slot(set, nei);
+    if (VECTOR(set->table)[2 * h] != -1 && VECTOR(set->table)[2 * h + 1] > 0) {
+        VECTOR(set->table)[2 * h + 1] -= 1;
+    }
+}
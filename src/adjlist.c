@@ -22,6 +22,7 @@
 */
 
 #include "igraph_adjlist.h"
+#include "igraph_adjlist_internal.h"
 #include "igraph_memory.h"
 #include "igraph_interface.h"
 #include "igraph_interrupt_internal.h"
@@ -71,6 +72,177 @@
  * </para>
  */
 
+/* The vector array of adjacency and incidence lists has an extra
+   element after the vectors of the vertices. It is empty, except for
+   the lists created by igraph_i_adjlist_init_flat() and
+   igraph_i_inclist_init_flat(), where it holds a single memory block
+   and the vectors of the vertices are views into it. The block has
+   one extra element, so that the empty vectors at its end point
+   inside it, too. The public functions always create vectors with
+   their own memory, because callers may grow them. */
+
+typedef int igraph_i_adjlist_query_t(const igraph_t *graph,
+                                     igraph_vector_t *res,
+                                     igraph_integer_t vid,
+                                     igraph_neimode_t mode);
+
+static igraph_bool_t igraph_i_adjlist_in_block(const igraph_vector_int_t *data,
+        const igraph_vector_int_t *v) {
+    return data->stor_begin != 0 && v->stor_begin >= VECTOR(*data) &&
+           v->stor_begin < VECTOR(*data) + igraph_vector_int_size(data);
+}
+
+static void igraph_i_adjlist_destroy_vectors(igraph_vector_int_t *vecs,
+        long int length) {
+    long int i;
+    if (vecs == 0) {
+        return;
+    }
+    for (i = 0; i < length; i++) {
+        /* This works if some igraph_vector_int_t's are 0,
+           because igraph_vector_destroy can handle this. */
+        if (!igraph_i_adjlist_in_block(&vecs[length], &vecs[i])) {
+            igraph_vector_int_destroy(&vecs[i]);
+        }
+    }
+    igraph_vector_int_destroy(&vecs[length]);
+}
+
+static int igraph_i_adjlist_init_block(const igraph_t *graph,
+                                       igraph_vector_int_t *vecs,
+                                       igraph_vector_int_t *data,
+                                       igraph_neimode_t mode,
+                                       igraph_i_adjlist_query_t *query) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int size = igraph_ecount(graph), pos = 0;
+    long int i, j, n;
+    igraph_vector_t tmp;
+
+    /* Every edge appears at most once, or twice if both directions
+       are included. Deleted edges are left out, the block may be a
+       bit larger than needed then. */
+    if (mode == IGRAPH_ALL) {
+        size *= 2;
+    }
+    IGRAPH_CHECK(igraph_vector_int_init(data, size + 1));
+
+    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
+    for (i = 0; i < no_of_nodes; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(query(graph, &tmp, (igraph_integer_t) i, mode));
+        n = igraph_vector_size(&tmp);
+        for (j = 0; j < n; j++) {
+            VECTOR(*data)[pos + j] = (igraph_integer_t) VECTOR(tmp)[j];
+        }
+        igraph_vector_int_view(&vecs[i], VECTOR(*data) + pos, n);
+        pos += n;
+    }
+
+    igraph_vector_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/* Every vector has its own memory */
+
+static int igraph_i_adjlist_init_separate(const igraph_t *graph,
+        igraph_vector_int_t *vecs,
+        igraph_neimode_t mode,
+        igraph_i_adjlist_query_t *query) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int i, j, n;
+    igraph_vector_t tmp;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
+    for (i = 0; i < no_of_nodes; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(query(graph, &tmp, (igraph_integer_t) i, mode));
+        n = igraph_vector_size(&tmp);
+        IGRAPH_CHECK(igraph_vector_int_init(&vecs[i], n));
+        for (j = 0; j < n; j++) {
+            VECTOR(vecs[i])[j] = (igraph_integer_t) VECTOR(tmp)[j];
+        }
+    }
+
+    igraph_vector_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static int igraph_i_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
+                                 igraph_neimode_t mode, igraph_bool_t flat) {
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_EINVMODE);
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    al->length = igraph_vcount(graph);
+    al->adjs = igraph_Calloc(al->length + 1, igraph_vector_int_t);
+    if (al->adjs == 0) {
+        IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_ENOMEM);
+    }
+
+    IGRAPH_FINALLY(igraph_adjlist_destroy, al);
+    if (flat) {
+        IGRAPH_CHECK(igraph_i_adjlist_init_block(graph, al->adjs,
+                     &al->adjs[al->length], mode, igraph_neighbors));
+    } else {
+        IGRAPH_CHECK(igraph_i_adjlist_init_separate(graph, al->adjs, mode,
+                     igraph_neighbors));
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static int igraph_i_inclist_init(const igraph_t *graph, igraph_inclist_t *il,
+                                 igraph_neimode_t mode, igraph_bool_t flat) {
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_EINVMODE);
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    il->length = igraph_vcount(graph);
+    il->incs = igraph_Calloc(il->length + 1, igraph_vector_int_t);
+    if (il->incs == 0) {
+        IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_ENOMEM);
+    }
+
+    IGRAPH_FINALLY(igraph_inclist_destroy, il);
+    if (flat) {
+        IGRAPH_CHECK(igraph_i_adjlist_init_block(graph, il->incs,
+                     &il->incs[il->length], mode, igraph_incident));
+    } else {
+        IGRAPH_CHECK(igraph_i_adjlist_init_separate(graph, il->incs, mode,
+                     igraph_incident));
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/* Adjacency and incidence lists in a single memory block, for
+   internal callers that do not grow the vectors. They are destroyed
+   with igraph_adjlist_destroy() and igraph_inclist_destroy(). */
+
+int igraph_i_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                               igraph_neimode_t mode) {
+    return igraph_i_adjlist_init(graph, al, mode, /*flat=*/ 1);
+}
+
+int igraph_i_inclist_init_flat(const igraph_t *graph, igraph_inclist_t *il,
+                               igraph_neimode_t mode) {
+    return igraph_i_inclist_init(graph, il, mode, /*flat=*/ 1);
+}
+
 /**
  * \function igraph_adjlist_init
  * Initialize an adjacency list of vertices from a given graph
@@ -94,41 +266,7 @@
 
 int igraph_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
                         igraph_neimode_t mode) {
-    igraph_integer_t i;
-    igraph_vector_t tmp;
-
-    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
-        IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_EINVMODE);
-    }
-
-    igraph_vector_init(&tmp, 0);
-    IGRAPH_FINALLY(igraph_vector_destroy, &tmp);
-
-    if (!igraph_is_directed(graph)) {
-        mode = IGRAPH_ALL;
-    }
-
-    al->length = igraph_vcount(graph);
-    al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
-    if (al->adjs == 0) {
-        IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_ENOMEM);
-    }
-
-    IGRAPH_FINALLY(igraph_adjlist_destroy, al);
-    for (i = 0; i < al->length; i++) {
-        int j, n;
-        IGRAPH_ALLOW_INTERRUPTION();
-        IGRAPH_CHECK(igraph_neighbors(graph, &tmp, i, mode));
-        n = igraph_vector_size(&tmp);
-        IGRAPH_CHECK(igraph_vector_int_init(&al->adjs[i], n));
-        for (j = 0; j < n; j++) {
-            VECTOR(al->adjs[i])[j] = VECTOR(tmp)[j];
-        }
-    }
-
-    igraph_vector_destroy(&tmp);
-    IGRAPH_FINALLY_CLEAN(2);
-    return 0;
+    return igraph_i_adjlist_init(graph, al, mode, /*flat=*/ 0);
 }
 
 /**
@@ -149,7 +287,7 @@ int igraph_adjlist_init_empty(igraph_adjlist_t *al, igraph_integer_t no_of_nodes
     long int i;
 
     al->length = no_of_nodes;
-    al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
+    al->adjs = igraph_Calloc(al->length + 1, igraph_vector_int_t);
     if (al->adjs == 0) {
         IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_ENOMEM);
     }
@@ -201,7 +339,7 @@ int igraph_adjlist_init_complementer(const igraph_t *graph,
     }
 
     al->length = igraph_vcount(graph);
-    al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
+    al->adjs = igraph_Calloc(al->length + 1, igraph_vector_int_t);
     if (al->adjs == 0) {
         IGRAPH_ERROR("Cannot create complementer adjlist view", IGRAPH_ENOMEM);
     }
@@ -257,12 +395,7 @@ int igraph_adjlist_init_complementer(const igraph_t *graph,
  */
 
 void igraph_adjlist_destroy(igraph_adjlist_t *al) {
-    long int i;
-    for (i = 0; i < al->length; i++) {
-        if (&al->adjs[i]) {
-            igraph_vector_int_destroy(&al->adjs[i]);
-        }
-    }
+    igraph_i_adjlist_destroy_vectors(al->adjs, al->length);
     igraph_Free(al->adjs);
 }
 
@@ -566,41 +699,7 @@ int igraph_inclist_fprint(const igraph_inclist_t *al, FILE *outfile) {
 int igraph_inclist_init(const igraph_t *graph,
                         igraph_inclist_t *il,
                         igraph_neimode_t mode) {
-    igraph_integer_t i;
-    igraph_vector_t tmp;
-
-    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
-        IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_EINVMODE);
-    }
-
-    igraph_vector_init(&tmp, 0);
-    IGRAPH_FINALLY(igraph_vector_destroy, &tmp);
-
-    if (!igraph_is_directed(graph)) {
-        mode = IGRAPH_ALL;
-    }
-
-    il->length = igraph_vcount(graph);
-    il->incs = igraph_Calloc(il->length, igraph_vector_int_t);
-    if (il->incs == 0) {
-        IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_ENOMEM);
-    }
-
-    IGRAPH_FINALLY(igraph_inclist_destroy, il);
-    for (i = 0; i < il->length; i++) {
-        int j, n;
-        IGRAPH_ALLOW_INTERRUPTION();
-        IGRAPH_CHECK(igraph_incident(graph, &tmp, i, mode));
-        n = igraph_vector_size(&tmp);
-        IGRAPH_CHECK(igraph_vector_int_init(&il->incs[i], n));
-        for (j = 0; j < n; j++) {
-            VECTOR(il->incs[i])[j] = VECTOR(tmp)[j];
-        }
-    }
-
-    igraph_vector_destroy(&tmp);
-    IGRAPH_FINALLY_CLEAN(2);
-    return 0;
+    return igraph_i_inclist_init(graph, il, mode, /*flat=*/ 0);
 }
 
 /**
@@ -622,7 +721,7 @@ int igraph_inclist_init_empty(igraph_inclist_t *il, igraph_integer_t n) {
     long int i;
 
     il->length = n;
-    il->incs = igraph_Calloc(il->length, igraph_vector_int_t);
+    il->incs = igraph_Calloc(il->length + 1, igraph_vector_int_t);
     if (il->incs == 0) {
         IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_ENOMEM);
     }
@@ -646,12 +745,7 @@ int igraph_inclist_init_empty(igraph_inclist_t *il, igraph_integer_t n) {
  */
 
 void igraph_inclist_destroy(igraph_inclist_t *il) {
-    long int i;
-    for (i = 0; i < il->length; i++) {
-        /* This works if some igraph_vector_int_t's are 0,
-           because igraph_vector_destroy can handle this. */
-        igraph_vector_int_destroy(&il->incs[i]);
-    }
+    igraph_i_adjlist_destroy_vectors(il->incs, il->length);
     igraph_Free(il->incs);
 }
 
@@ -670,6 +764,102 @@ void igraph_inclist_clear(igraph_inclist_t *il) {
     }
 }
 
+/**
+ * \function igraph_weighted_adjlist_init
+ * Initialize a weighted adjacency list from a given graph
+ *
+ * Creates a list that stores the neighbor, the incident edge and the
+ * weight of the edge together, for every incident edge of every
+ * vertex, in a single memory block. Weighted algorithms, e.g. the
+ * Dijkstra-like shortest path functions, read everything they need
+ * about an edge from one place this way, instead of looking up the
+ * weight of each edge in a separate weight vector.
+ *
+ * </para><para>
+ * The entries of a vertex are in the same order as in an incidence
+ * list created by \ref igraph_inclist_init(); loop edges appear twice
+ * if \p mode is \c IGRAPH_ALL. The list is independent of the graph
+ * and the weight vector after creation, and it cannot be modified.
+ * \param graph The input graph.
+ * \param wal Pointer to an uninitialized weighted adjacency list.
+ * \param mode Constant specifying whether outgoing
+ *   (<code>IGRAPH_OUT</code>), incoming (<code>IGRAPH_IN</code>),
+ *   or both (<code>IGRAPH_ALL</code>) types of neighbors to include
+ *   in the list. It is ignored for undirected networks.
+ * \param weights The weights of the edges, a null pointer means that
+ *   every edge has weight one.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+int igraph_weighted_adjlist_init(const igraph_t *graph,
+                                 igraph_weighted_adjlist_t *wal,
+                                 igraph_neimode_t mode,
+                                 const igraph_vector_t *weights) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int size = igraph_ecount(graph), pos = 0;
+    long int i, j, n;
+    igraph_vector_t tmp;
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create weighted adjlist", IGRAPH_EINVMODE);
+    }
+    if (weights && igraph_vector_size(weights) != size) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode == IGRAPH_ALL) {
+        size *= 2;
+    }
+
+    wal->length = (igraph_integer_t) no_of_nodes;
+    IGRAPH_CHECK(igraph_vector_int_init(&wal->start, no_of_nodes + 1));
+    wal->entries = igraph_Calloc(size + 1, igraph_weighted_adjlist_entry_t);
+    if (wal->entries == 0) {
+        igraph_vector_int_destroy(&wal->start);
+        IGRAPH_ERROR("Cannot create weighted adjlist", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, wal);
+
+    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
+    for (i = 0; i < no_of_nodes; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_incident(graph, &tmp, (igraph_integer_t) i, mode));
+        n = igraph_vector_size(&tmp);
+        VECTOR(wal->start)[i] = (igraph_integer_t) pos;
+        for (j = 0; j < n; j++, pos++) {
+            igraph_integer_t edge = (igraph_integer_t) VECTOR(tmp)[j];
+            wal->entries[pos].nei = IGRAPH_OTHER(graph, edge, i);
+            wal->entries[pos].edge = edge;
+            wal->entries[pos].weight = weights ? VECTOR(*weights)[(long int) edge] : 1.0;
+        }
+    }
+    VECTOR(wal->start)[no_of_nodes] = (igraph_integer_t) pos;
+
+    igraph_vector_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
+/**
+ * \function igraph_weighted_adjlist_destroy
+ * Deallocate a weighted adjacency list
+ *
+ * \param wal The weighted adjacency list to destroy.
+ *
+ * Time complexity: depends on memory management.
+ */
+
+void igraph_weighted_adjlist_destroy(igraph_weighted_adjlist_t *wal) {
+    igraph_vector_int_destroy(&wal->start);
+    igraph_Free(wal->entries);
+}
+
 /**
  * \function igraph_lazy_adjlist_init
  * Constructor
@@ -26,6 +26,7 @@
 #include "igraph_math.h"
 #include "igraph_interface.h"
 #include "igraph_random.h"
+#include "igraph_atomic_internal.h"
 #include "config.h"
 
 #include <string.h>
@@ -52,10 +53,16 @@ igraph_bool_t igraph_i_cattribute_find(const igraph_vector_ptr_t *ptrvec,
     return l;
 }
 
+/* The tables are shared by a graph and its copies made by
+   igraph_copy(), 'refcount' is the number of graphs using them. They
+   are copied by igraph_i_cattribute_detach() before the first
+   modification. */
+
 typedef struct igraph_i_cattributes_t {
     igraph_vector_ptr_t gal;
     igraph_vector_ptr_t val;
     igraph_vector_ptr_t eal;
+    long int refcount;
 } igraph_i_cattributes_t;
 
 int igraph_i_cattributes_copy_attribute_record(igraph_attribute_record_t **newrec,
@@ -130,6 +137,7 @@ int igraph_i_cattribute_init(igraph_t *graph, igraph_vector_ptr_t *attr) {
     IGRAPH_FINALLY(igraph_vector_ptr_destroy, &nattr->val);
     IGRAPH_CHECK(igraph_vector_ptr_init(&nattr->eal, 0));
     IGRAPH_FINALLY_CLEAN(3);
+    nattr->refcount = 1;
 
     for (i = 0; i < n; i++) {
         IGRAPH_CHECK(igraph_i_cattributes_copy_attribute_record(
@@ -150,6 +158,13 @@ void igraph_i_cattribute_destroy(igraph_t *graph) {
     igraph_strvector_t *str;
     igraph_vector_bool_t *boolvec;
     igraph_attribute_record_t *rec;
+
+    graph->attr = 0;
+    if (IGRAPH_I_ATOMIC_DEC(attr->refcount) > 0) {
+        /* still used by copies of the graph */
+        return;
+    }
+
     for (a = 0; a < 3; a++) {
         n = igraph_vector_ptr_size(als[a]);
         for (i = 0; i < n; i++) {
@@ -176,8 +191,7 @@ void igraph_i_cattribute_destroy(igraph_t *graph) {
     igraph_vector_ptr_destroy(&attr->gal);
     igraph_vector_ptr_destroy(&attr->val);
     igraph_vector_ptr_destroy(&attr->eal);
-    igraph_free(graph->attr);
-    graph->attr = 0;
+    igraph_free(attr);
 }
 
 /* Almost the same as destroy, but we might have null pointers */
@@ -215,18 +229,17 @@ void igraph_i_cattribute_copy_free(igraph_i_cattributes_t *attr) {
     }
 }
 
-/* No reference counting here. If you use attributes in C you should
-   know what you're doing. */
-
-int igraph_i_cattribute_copy(igraph_t *to, const igraph_t *from,
-                             igraph_bool_t ga, igraph_bool_t va, igraph_bool_t ea) {
-    igraph_i_cattributes_t *attrfrom = from->attr, *attrto;
-    igraph_vector_ptr_t *alto[3], *alfrom[3] = { &attrfrom->gal, &attrfrom->val,
-                                                 &attrfrom->eal
-                                               };
+static int igraph_i_cattribute_copy_tables(igraph_i_cattributes_t **res,
+        const igraph_i_cattributes_t *attrfrom,
+        igraph_bool_t ga, igraph_bool_t va, igraph_bool_t ea) {
+    igraph_i_cattributes_t *attrto;
+    const igraph_vector_ptr_t *alfrom[3] = { &attrfrom->gal, &attrfrom->val,
+                                             &attrfrom->eal
+                                           };
+    igraph_vector_ptr_t *alto[3];
     long int i, n, a;
     igraph_bool_t copy[3] = { ga, va, ea };
-    to->attr = attrto = igraph_Calloc(1, igraph_i_cattributes_t);
+    attrto = igraph_Calloc(1, igraph_i_cattributes_t);
     if (!attrto) {
         IGRAPH_ERROR("Cannot copy attributes", IGRAPH_ENOMEM);
     }
@@ -236,6 +249,7 @@ int igraph_i_cattribute_copy(igraph_t *to, const igraph_t *from,
     IGRAPH_VECTOR_PTR_INIT_FINALLY(&attrto->eal, 0);
     IGRAPH_FINALLY_CLEAN(3);
     IGRAPH_FINALLY(igraph_i_cattribute_copy_free, attrto);
+    attrto->refcount = 1;
 
     alto[0] = &attrto->gal; alto[1] = &attrto->val; alto[2] = &attrto->eal;
     for (a = 0; a < 3; a++) {
@@ -253,20 +267,59 @@ int igraph_i_cattribute_copy(igraph_t *to, const igraph_t *from,
     }
 
     IGRAPH_FINALLY_CLEAN(2);
+    *res = attrto;
+    return 0;
+}
+
+/* A full copy shares the attribute tables of the original graph,
+   partial copies are always deep. */
+
+int igraph_i_cattribute_copy(igraph_t *to, const igraph_t *from,
+                             igraph_bool_t ga, igraph_bool_t va, igraph_bool_t ea) {
+    igraph_i_cattributes_t *attrfrom = from->attr, *attrto;
+    if (ga && va && ea) {
+        IGRAPH_I_ATOMIC_INC(attrfrom->refcount);
+        to->attr = attrfrom;
+        return 0;
+    }
+    IGRAPH_CHECK(igraph_i_cattribute_copy_tables(&attrto, attrfrom, ga, va, ea));
+    to->attr = attrto;
+    return 0;
+}
+
+/* Gives 'graph' its own copy of the attribute tables, if they are
+   shared with other graphs. This must be called before modifying
+   the tables. */
+
+static int igraph_i_cattribute_detach(igraph_t *graph) {
+    igraph_i_cattributes_t *attr = graph->attr, *newattr;
+    if (IGRAPH_I_ATOMIC_GET(attr->refcount) == 1) {
+        return 0;
+    }
+    IGRAPH_CHECK(igraph_i_cattribute_copy_tables(&newattr, attr, 1, 1, 1));
+    /* the tables are freed if the copies were destroyed in the
+       meantime, by other threads */
+    igraph_i_cattribute_destroy(graph);
+    graph->attr = newattr;
     return 0;
 }
 
 int igraph_i_cattribute_add_vertices(igraph_t *graph, long int nv,
                                      igraph_vector_ptr_t *nattr) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
-    long int length = igraph_vector_ptr_size(val);
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
+    long int length;
     long int nattrno = nattr == NULL ? 0 : igraph_vector_ptr_size(nattr);
     long int origlen = igraph_vcount(graph) - nv;
     long int newattrs = 0, i;
     igraph_vector_t news;
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    length = igraph_vector_ptr_size(val);
+
     /* First add the new attributes if any */
     newattrs = 0;
     IGRAPH_VECTOR_INIT_FINALLY(&news, 0);
@@ -446,6 +499,8 @@ int igraph_i_cattribute_permute_vertices(const igraph_t *graph,
         igraph_t *newgraph,
         const igraph_vector_t *idx) {
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(newgraph));
+
     if (graph == newgraph) {
 
         igraph_i_cattributes_t *attr = graph->attr;
@@ -1379,14 +1434,18 @@ int igraph_i_cattribute_combine_vertices(const igraph_t *graph,
         const igraph_attribute_combination_t *comb) {
 
     igraph_i_cattributes_t *attr = graph->attr;
-    igraph_i_cattributes_t *toattr = newgraph->attr;
+    igraph_i_cattributes_t *toattr;
     igraph_vector_ptr_t *val = &attr->val;
-    igraph_vector_ptr_t *new_val = &toattr->val;
+    igraph_vector_ptr_t *new_val;
     long int valno = igraph_vector_ptr_size(val);
     long int i, j, keepno = 0;
     int *TODO;
     igraph_function_pointer_t *funcs;
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(newgraph));
+    toattr = newgraph->attr;
+    new_val = &toattr->val;
+
     TODO = igraph_Calloc(valno, int);
     if (!TODO) {
         IGRAPH_ERROR("Cannot combine vertex attributes",
@@ -1648,15 +1707,20 @@ int igraph_i_cattribute_combine_vertices(const igraph_t *graph,
 int igraph_i_cattribute_add_edges(igraph_t *graph, const igraph_vector_t *edges,
                                   igraph_vector_ptr_t *nattr) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
-    long int ealno = igraph_vector_ptr_size(eal);
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
+    long int ealno;
     long int ne = igraph_vector_size(edges) / 2;
     long int origlen = igraph_ecount(graph) - ne;
     long int nattrno = nattr == 0 ? 0 : igraph_vector_ptr_size(nattr);
     igraph_vector_t news;
     long int newattrs, i;
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    ealno = igraph_vector_ptr_size(eal);
+
     /* First add the new attributes if any */
     newattrs = 0;
     IGRAPH_VECTOR_INIT_FINALLY(&news, 0);
@@ -1846,6 +1910,8 @@ int igraph_i_cattribute_permute_edges(const igraph_t *graph,
                                       igraph_t *newgraph,
                                       const igraph_vector_t *idx) {
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(newgraph));
+
     if (graph == newgraph) {
 
         igraph_i_cattributes_t *attr = graph->attr;
@@ -1989,14 +2055,18 @@ int igraph_i_cattribute_combine_edges(const igraph_t *graph,
                                       const igraph_attribute_combination_t *comb) {
 
     igraph_i_cattributes_t *attr = graph->attr;
-    igraph_i_cattributes_t *toattr = newgraph->attr;
+    igraph_i_cattributes_t *toattr;
     igraph_vector_ptr_t *eal = &attr->eal;
-    igraph_vector_ptr_t *new_eal = &toattr->eal;
+    igraph_vector_ptr_t *new_eal;
     long int ealno = igraph_vector_ptr_size(eal);
     long int i, j, keepno = 0;
     int *TODO;
     igraph_function_pointer_t *funcs;
 
+    IGRAPH_CHECK(igraph_i_cattribute_detach(newgraph));
+    toattr = newgraph->attr;
+    new_eal = &toattr->eal;
+
     TODO = igraph_Calloc(ealno, int);
     if (!TODO) {
         IGRAPH_ERROR("Cannot combine edge attributes",
@@ -3139,10 +3209,15 @@ igraph_bool_t igraph_cattribute_has_attr(const igraph_t *graph,
 int igraph_cattribute_GAN_set(igraph_t *graph, const char *name,
                               igraph_real_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *gal = &attr->gal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *gal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(gal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    gal = &attr->gal;
+    l = igraph_i_cattribute_find(gal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*gal)[j];
@@ -3197,10 +3272,15 @@ int igraph_cattribute_GAN_set(igraph_t *graph, const char *name,
 int igraph_cattribute_GAB_set(igraph_t *graph, const char *name,
                               igraph_bool_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *gal = &attr->gal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *gal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(gal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    gal = &attr->gal;
+    l = igraph_i_cattribute_find(gal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*gal)[j];
@@ -3257,10 +3337,15 @@ int igraph_cattribute_GAB_set(igraph_t *graph, const char *name,
 int igraph_cattribute_GAS_set(igraph_t *graph, const char *name,
                               const char *value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *gal = &attr->gal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *gal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(gal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    gal = &attr->gal;
+    l = igraph_i_cattribute_find(gal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*gal)[j];
@@ -3319,10 +3404,15 @@ int igraph_cattribute_GAS_set(igraph_t *graph, const char *name,
 int igraph_cattribute_VAN_set(igraph_t *graph, const char *name,
                               igraph_integer_t vid, igraph_real_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*val)[j];
@@ -3382,10 +3472,15 @@ int igraph_cattribute_VAN_set(igraph_t *graph, const char *name,
 int igraph_cattribute_VAB_set(igraph_t *graph, const char *name,
                               igraph_integer_t vid, igraph_bool_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*val)[j];
@@ -3447,10 +3542,15 @@ int igraph_cattribute_VAB_set(igraph_t *graph, const char *name,
 int igraph_cattribute_VAS_set(igraph_t *graph, const char *name,
                               igraph_integer_t vid, const char *value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*val)[j];
@@ -3509,10 +3609,15 @@ int igraph_cattribute_VAS_set(igraph_t *graph, const char *name,
 int igraph_cattribute_EAN_set(igraph_t *graph, const char *name,
                               igraph_integer_t eid, igraph_real_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*eal)[j];
@@ -3572,10 +3677,15 @@ int igraph_cattribute_EAN_set(igraph_t *graph, const char *name,
 int igraph_cattribute_EAB_set(igraph_t *graph, const char *name,
                               igraph_integer_t eid, igraph_bool_t value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*eal)[j];
@@ -3637,10 +3747,15 @@ int igraph_cattribute_EAB_set(igraph_t *graph, const char *name,
 int igraph_cattribute_EAS_set(igraph_t *graph, const char *name,
                               igraph_integer_t eid, const char *value) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     if (l) {
         igraph_attribute_record_t *rec = VECTOR(*eal)[j];
@@ -3696,10 +3811,15 @@ int igraph_cattribute_EAS_set(igraph_t *graph, const char *name,
 
 int igraph_cattribute_VAN_setv(igraph_t *graph, const char *name,
                                const igraph_vector_t *v) {
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     /* Check length first */
     if (igraph_vector_size(v) != igraph_vcount(graph)) {
@@ -3761,10 +3881,15 @@ int igraph_cattribute_VAN_setv(igraph_t *graph, const char *name,
 
 int igraph_cattribute_VAB_setv(igraph_t *graph, const char *name,
                                const igraph_vector_bool_t *v) {
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     /* Check length first */
     if (igraph_vector_bool_size(v) != igraph_vcount(graph)) {
@@ -3828,10 +3953,15 @@ int igraph_cattribute_VAB_setv(igraph_t *graph, const char *name,
 int igraph_cattribute_VAS_setv(igraph_t *graph, const char *name,
                                const igraph_strvector_t *sv) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     /* Check length first */
     if (igraph_strvector_size(sv) != igraph_vcount(graph)) {
@@ -3894,10 +4024,15 @@ int igraph_cattribute_VAS_setv(igraph_t *graph, const char *name,
 int igraph_cattribute_EAN_setv(igraph_t *graph, const char *name,
                                const igraph_vector_t *v) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     /* Check length first */
     if (igraph_vector_size(v) != igraph_ecount(graph)) {
@@ -3960,10 +4095,15 @@ int igraph_cattribute_EAN_setv(igraph_t *graph, const char *name,
 int igraph_cattribute_EAB_setv(igraph_t *graph, const char *name,
                                const igraph_vector_bool_t *v) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     /* Check length first */
     if (igraph_vector_bool_size(v) != igraph_ecount(graph)) {
@@ -4027,10 +4167,15 @@ int igraph_cattribute_EAB_setv(igraph_t *graph, const char *name,
 int igraph_cattribute_EAS_setv(igraph_t *graph, const char *name,
                                const igraph_strvector_t *sv) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    IGRAPH_CHECK(igraph_i_cattribute_detach(graph));
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     /* Check length first */
     if (igraph_strvector_size(sv) != igraph_ecount(graph)) {
@@ -4104,10 +4249,17 @@ void igraph_i_cattribute_free_rec(igraph_attribute_record_t *rec) {
  */
 void igraph_cattribute_remove_g(igraph_t *graph, const char *name) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *gal = &attr->gal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *gal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(gal, name, &j);
+    igraph_bool_t l;
+
+    if (igraph_i_cattribute_detach(graph) != 0) {
+        return;
+    }
+    attr = graph->attr;
+    gal = &attr->gal;
+    l = igraph_i_cattribute_find(gal, name, &j);
 
     if (l) {
         igraph_i_cattribute_free_rec(VECTOR(*gal)[j]);
@@ -4129,10 +4281,17 @@ void igraph_cattribute_remove_g(igraph_t *graph, const char *name) {
  */
 void igraph_cattribute_remove_v(igraph_t *graph, const char *name) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *val = &attr->val;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *val;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(val, name, &j);
+    igraph_bool_t l;
+
+    if (igraph_i_cattribute_detach(graph) != 0) {
+        return;
+    }
+    attr = graph->attr;
+    val = &attr->val;
+    l = igraph_i_cattribute_find(val, name, &j);
 
     if (l) {
         igraph_i_cattribute_free_rec(VECTOR(*val)[j]);
@@ -4154,10 +4313,17 @@ void igraph_cattribute_remove_v(igraph_t *graph, const char *name) {
  */
 void igraph_cattribute_remove_e(igraph_t *graph, const char *name) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
-    igraph_vector_ptr_t *eal = &attr->eal;
+    igraph_i_cattributes_t *attr;
+    igraph_vector_ptr_t *eal;
     long int j;
-    igraph_bool_t l = igraph_i_cattribute_find(eal, name, &j);
+    igraph_bool_t l;
+
+    if (igraph_i_cattribute_detach(graph) != 0) {
+        return;
+    }
+    attr = graph->attr;
+    eal = &attr->eal;
+    l = igraph_i_cattribute_find(eal, name, &j);
 
     if (l) {
         igraph_i_cattribute_free_rec(VECTOR(*eal)[j]);
@@ -4182,7 +4348,12 @@ void igraph_cattribute_remove_e(igraph_t *graph, const char *name) {
 void igraph_cattribute_remove_all(igraph_t *graph, igraph_bool_t g,
                                   igraph_bool_t v, igraph_bool_t e) {
 
-    igraph_i_cattributes_t *attr = graph->attr;
+    igraph_i_cattributes_t *attr;
+
+    if (igraph_i_cattribute_detach(graph) != 0) {
+        return;
+    }
+    attr = graph->attr;
 
     if (g) {
         igraph_vector_ptr_t *gal = &attr->gal;
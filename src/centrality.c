@@ -27,9 +27,12 @@
 #include "igraph_memory.h"
 #include "igraph_random.h"
 #include "igraph_adjlist.h"
+#include "igraph_adjlist_internal.h"
 #include "igraph_interface.h"
 #include "igraph_progress.h"
 #include "igraph_interrupt_internal.h"
+#include "igraph_parallel_internal.h"
+#include "igraph_dial_internal.h"
 #include "igraph_topology.h"
 #include "igraph_types_internal.h"
 #include "igraph_stack.h"
@@ -1567,6 +1570,14 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
  * going through it. If there are more than one geodesic between two
  * vertices, the value of these geodesics are weighted by one over the
  * number of geodesics.
+ *
+ * </para><para>
+ * The sources of the shortest paths are split between the threads set
+ * by \ref igraph_set_num_threads(), every thread needs O(|V|)
+ * memory, or O(|V|+|E|) for weighted graphs. With the same number of
+ * threads the result is the same in every run, with a different number
+ * of threads it may differ in the rounding errors.
+ *
  * \param graph The graph object.
  * \param res The result of the computation, a vector containing the
  *        betweenness scores for the specified vertices.
@@ -1608,90 +1619,311 @@ int igraph_betweenness(const igraph_t *graph, igraph_vector_t *res,
                                        nobigint);
 }
 
-static int igraph_i_betweenness_estimate_weighted(
-        const igraph_t *graph,
-        igraph_vector_t *res,
-        const igraph_vs_t vids,
-        igraph_bool_t directed,
-        igraph_real_t cutoff,
-        const igraph_vector_t *weights,
-        igraph_bool_t nobigint) {
+static void igraph_i_destroy_biguints(igraph_biguint_t *p) {
+    igraph_biguint_t *p2 = p;
+    while ( *((long int*)(p)) ) {
+        igraph_biguint_destroy(p);
+        p++;
+    }
+    igraph_Free(p2);
+}
 
-    igraph_real_t minweight;
-    igraph_integer_t no_of_nodes = (igraph_integer_t) igraph_vcount(graph);
-    igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
-    igraph_2wheap_t Q;
-    igraph_inclist_t inclist;
-    igraph_adjlist_t fathers;
-    long int source, j;
-    igraph_stack_t S;
-    igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
-    igraph_vector_t dist, nrgeo, tmpscore;
-    igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
-    igraph_vit_t vit;
-    int cmp_result;
-    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+/* The betweenness functions below run one BFS or Dijkstra search from
+   every source vertex. The sources are split between the tasks of a
+   parallel loop: with k tasks, task i does the sources i, i+k, i+2k,
+   ..., and sums the scores into its own vector. These are added up in
+   task order at the end, so the results do not depend on how the
+   threads were scheduled. Every task has its own search buffers. */
+
+typedef struct igraph_i_brandes_ws_t {
+    igraph_vector_t score;      /* summed over the sources of the task */
+    double *tmpscore;           /* the dependencies on the current source */
+    igraph_stack_t stack;
+    /* BFS */
+    igraph_dqueue_t q;
+    long int *distance;
+    unsigned long long int *nrgeo;
+    igraph_biguint_t *big_nrgeo, D, R, T;
+    /* Dijkstra */
+    igraph_i_dial_t Q;
+    igraph_vector_t dist, wnrgeo;
+    igraph_adjlist_t fathers;   /* vertices, or edges for edge betweenness */
+} igraph_i_brandes_ws_t;
+
+typedef struct igraph_i_brandes_t {
+    const igraph_t *graph;
+    long int no_of_nodes;
+    igraph_real_t cutoff;
+    igraph_bool_t nobigint;
+    igraph_adjlist_t *adjlist_out, *adjlist_in;
+    igraph_inclist_t *elist_out, *elist_in;
+    igraph_weighted_adjlist_t *wal;
+    int no_of_tasks;
+    igraph_i_brandes_ws_t *ws;
+} igraph_i_brandes_t;
+
+static void igraph_i_brandes_destroy(igraph_i_brandes_t *b) {
+    int i;
+    for (i = 0; i < b->no_of_tasks; i++) {
+        igraph_i_brandes_ws_t *ws = &b->ws[i];
+        igraph_vector_destroy(&ws->score);
+        igraph_Free(ws->tmpscore);
+        igraph_stack_destroy(&ws->stack);
+        igraph_dqueue_destroy(&ws->q);
+        igraph_Free(ws->distance);
+        igraph_Free(ws->nrgeo);
+        if (ws->big_nrgeo) {
+            igraph_i_destroy_biguints(ws->big_nrgeo);
+        }
+        igraph_biguint_destroy(&ws->D);
+        igraph_biguint_destroy(&ws->R);
+        igraph_biguint_destroy(&ws->T);
+        igraph_i_dial_destroy(&ws->Q);
+        igraph_vector_destroy(&ws->dist);
+        igraph_vector_destroy(&ws->wnrgeo);
+        igraph_adjlist_destroy(&ws->fathers);
+    }
+    igraph_Free(b->ws);
+}
 
-    IGRAPH_UNUSED(nobigint);
+/* Allocates the buffers of the tasks, score_size is the length of the
+   score vectors. The BFS buffers are allocated if wal is null, the
+   Dijkstra buffers otherwise. */
 
-    if (igraph_vector_size(weights) != no_of_edges) {
-        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+static int igraph_i_brandes_init(igraph_i_brandes_t *b, const igraph_t *graph,
+                                 long int score_size,
+                                 igraph_weighted_adjlist_t *wal,
+                                 igraph_bool_t nobigint) {
+    long int no_of_nodes = igraph_vcount(graph);
+    int i;
+    long int j;
+
+    memset(b, 0, sizeof(igraph_i_brandes_t));
+    b->graph = graph;
+    b->no_of_nodes = no_of_nodes;
+    b->nobigint = nobigint;
+    b->wal = wal;
+    b->no_of_tasks = igraph_i_parallel_threads(no_of_nodes);
+    b->ws = igraph_Calloc(b->no_of_tasks, igraph_i_brandes_ws_t);
+    if (b->ws == 0) {
+        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
     }
-    minweight = igraph_vector_min(weights);
-    if (minweight <= 0) {
-        IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
-    } else if (minweight <= eps) {
-        IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
+    IGRAPH_FINALLY(igraph_i_brandes_destroy, b);
+
+    for (i = 0; i < b->no_of_tasks; i++) {
+        igraph_i_brandes_ws_t *ws = &b->ws[i];
+        IGRAPH_CHECK(igraph_vector_init(&ws->score, score_size));
+        ws->tmpscore = igraph_Calloc(no_of_nodes, double);
+        if (ws->tmpscore == 0) {
+            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+        }
+        IGRAPH_CHECK(igraph_stack_init(&ws->stack, no_of_nodes));
+        if (wal) {
+            IGRAPH_CHECK(igraph_i_dial_init(&ws->Q, no_of_nodes, wal));
+            IGRAPH_CHECK(igraph_vector_init(&ws->dist, no_of_nodes));
+            IGRAPH_CHECK(igraph_vector_init(&ws->wnrgeo, no_of_nodes));
+            IGRAPH_CHECK(igraph_adjlist_init_empty(&ws->fathers,
+                                                   (igraph_integer_t) no_of_nodes));
+            continue;
+        }
+        IGRAPH_CHECK(igraph_dqueue_init(&ws->q, 100));
+        ws->distance = igraph_Calloc(no_of_nodes, long int);
+        if (ws->distance == 0) {
+            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+        }
+        if (nobigint) {
+            ws->nrgeo = igraph_Calloc(no_of_nodes, unsigned long long int);
+            if (ws->nrgeo == 0) {
+                IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+            }
+        } else {
+            /* +1 is to have one containing zeros, when we free it, we stop
+               at the zero */
+            ws->big_nrgeo = igraph_Calloc(no_of_nodes + 1, igraph_biguint_t);
+            if (!ws->big_nrgeo) {
+                IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+            }
+            for (j = 0; j < no_of_nodes; j++) {
+                IGRAPH_CHECK(igraph_biguint_init(&ws->big_nrgeo[j]));
+            }
+            IGRAPH_CHECK(igraph_biguint_init(&ws->D));
+            IGRAPH_CHECK(igraph_biguint_init(&ws->R));
+            IGRAPH_CHECK(igraph_biguint_init(&ws->T));
+        }
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-    IGRAPH_CHECK(igraph_adjlist_init_empty(&fathers, no_of_nodes));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &fathers);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
 
-    IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &S);
-    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmpscore, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&nrgeo, no_of_nodes);
+/* Adds up the scores of the tasks, in task order */
 
-    if (igraph_vs_is_all(&vids)) {
-        IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
-        igraph_vector_null(res);
-        tmpres = res;
-    } else {
-        IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
+static void igraph_i_brandes_sum(const igraph_i_brandes_t *b,
+                                 igraph_vector_t *res) {
+    long int j, n = igraph_vector_size(res);
+    int i;
+    igraph_vector_update(res, &b->ws[0].score);
+    for (i = 1; i < b->no_of_tasks; i++) {
+        const igraph_vector_t *score = &b->ws[i].score;
+        for (j = 0; j < n; j++) {
+            VECTOR(*res)[j] += VECTOR(*score)[j];
+        }
     }
+}
+
+static int igraph_i_betweenness_bfs_task(void *data, long int task,
+                                         int thread) {
+
+    igraph_i_brandes_t *b = (igraph_i_brandes_t *) data;
+    igraph_i_brandes_ws_t *ws = &b->ws[task];
+    long int no_of_nodes = b->no_of_nodes;
+    igraph_real_t cutoff = b->cutoff;
+    igraph_bool_t nobigint = b->nobigint;
+    long int *distance = ws->distance;
+    unsigned long long int *nrgeo = ws->nrgeo;
+    igraph_biguint_t *big_nrgeo = ws->big_nrgeo;
+    double *tmpscore = ws->tmpscore;
+    long int source, j, nneis;
+    igraph_vector_int_t *neis;
+
+    for (source = task; source < no_of_nodes; source += b->no_of_tasks) {
+        if (thread == 0 &&
+            igraph_progress("Betweenness centrality: ",
+                            100.0 * source / no_of_nodes, 0) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
+        }
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_CHECK(igraph_dqueue_push(&ws->q, source));
+        if (nobigint) {
+            nrgeo[source] = 1;
+        } else {
+            igraph_biguint_set_limb(&big_nrgeo[source], 1);
+        }
+        distance[source] = 1;
+
+        while (!igraph_dqueue_empty(&ws->q)) {
+            long int actnode = (long int) igraph_dqueue_pop(&ws->q);
+            IGRAPH_CHECK(igraph_stack_push(&ws->stack, actnode));
+
+            if (cutoff > 0 && distance[actnode] >= cutoff + 1) {
+                continue;
+            }
+
+            neis = igraph_adjlist_get(b->adjlist_out, actnode);
+            nneis = igraph_vector_int_size(neis);
+            for (j = 0; j < nneis; j++) {
+                long int neighbor = (long int) VECTOR(*neis)[j];
+                if (distance[neighbor] == 0) {
+                    distance[neighbor] = distance[actnode] + 1;
+                    IGRAPH_CHECK(igraph_dqueue_push(&ws->q, neighbor));
+                }
+                if (distance[neighbor] == distance[actnode] + 1) {
+                    if (nobigint) {
+                        nrgeo[neighbor] += nrgeo[actnode];
+                    } else {
+                        IGRAPH_CHECK(igraph_biguint_add(&big_nrgeo[neighbor],
+                                                        &big_nrgeo[neighbor],
+                                                        &big_nrgeo[actnode]));
+                    }
+                }
+            }
+        } /* while !igraph_dqueue_empty */
+
+        /* Ok, we've the distance of each node and also the number of
+           shortest paths to them. Now we do an inverse search, starting
+           with the farthest nodes. The predecessors of a node are its
+           in-neighbors one step closer to the source, these are not
+           popped from the stack yet. */
+        while (!igraph_stack_empty(&ws->stack)) {
+            long int actnode = (long int) igraph_stack_pop(&ws->stack);
+            if (actnode != source) {
+                neis = igraph_adjlist_get(b->adjlist_in, actnode);
+                nneis = igraph_vector_int_size(neis);
+                for (j = 0; j < nneis; j++) {
+                    long int neighbor = (long int) VECTOR(*neis)[j];
+                    if (distance[neighbor] != distance[actnode] - 1) {
+                        continue;
+                    }
+                    if (nobigint) {
+                        tmpscore[neighbor] +=  (tmpscore[actnode] + 1) *
+                                               ((double)(nrgeo[neighbor])) / nrgeo[actnode];
+                    } else {
+                        if (!igraph_biguint_compare_limb(&big_nrgeo[actnode], 0)) {
+                            tmpscore[neighbor] = IGRAPH_INFINITY;
+                        } else {
+                            double div;
+                            limb_t shift = 1000000000L;
+                            IGRAPH_CHECK(igraph_biguint_mul_limb(&ws->T, &big_nrgeo[neighbor],
+                                                                 shift));
+                            igraph_biguint_div(&ws->D, &ws->R, &ws->T, &big_nrgeo[actnode]);
+                            div = igraph_biguint_get(&ws->D) / shift;
+                            tmpscore[neighbor] += (tmpscore[actnode] + 1) * div;
+                        }
+                    }
+                }
+
+                VECTOR(ws->score)[actnode] += tmpscore[actnode];
+            }
+
+            distance[actnode] = 0;
+            if (nobigint) {
+                nrgeo[actnode] = 0;
+            } else {
+                igraph_biguint_set_limb(&big_nrgeo[actnode], 0);
+            }
+            tmpscore[actnode] = 0;
+        }
+
+    } /* for source < no_of_nodes */
+
+    return 0;
+}
+
+static int igraph_i_betweenness_dijkstra_task(void *data, long int task,
+                                              int thread) {
+
+    igraph_i_brandes_t *b = (igraph_i_brandes_t *) data;
+    igraph_i_brandes_ws_t *ws = &b->ws[task];
+    long int no_of_nodes = b->no_of_nodes;
+    igraph_real_t cutoff = b->cutoff;
+    igraph_i_dial_t *Q = &ws->Q;
+    igraph_vector_t *dist = &ws->dist, *nrgeo = &ws->wnrgeo;
+    double *tmpscore = ws->tmpscore;
+    long int source, j;
+    int cmp_result;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
+    for (source = task; source < no_of_nodes; source += b->no_of_tasks) {
+        if (thread == 0 &&
+            igraph_progress("Betweenness centrality: ",
+                            100.0 * source / no_of_nodes, 0) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
+        }
         IGRAPH_ALLOW_INTERRUPTION();
 
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-        VECTOR(dist)[source] = 1.0;
-        VECTOR(nrgeo)[source] = 1;
+        igraph_i_dial_push_with_index(Q, source, -1.0);
+        VECTOR(*dist)[source] = 1.0;
+        VECTOR(*nrgeo)[source] = 1;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-            igraph_vector_int_t *neis;
+        while (!igraph_i_dial_empty(Q)) {
+            long int minnei = igraph_i_dial_max_index(Q);
+            igraph_real_t mindist = -igraph_i_dial_delete_max(Q);
+            igraph_weighted_adjlist_entry_t *neis;
             long int nlen;
 
-            igraph_stack_push(&S, minnei);
-            if (cutoff > 0 && VECTOR(dist)[minnei] >= cutoff + 1.0) {
+            igraph_stack_push(&ws->stack, minnei);
+            if (cutoff > 0 && VECTOR(*dist)[minnei] >= cutoff + 1.0) {
                 continue;
             }
 
             /* Now check all neighbors of 'minnei' for a shorter path */
-            neis = igraph_inclist_get(&inclist, minnei);
-            nlen = igraph_vector_int_size(neis);
+            neis = igraph_weighted_adjlist_get(b->wal, minnei);
+            nlen = igraph_weighted_adjlist_size(b->wal, minnei);
             for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int to = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_real_t curdist = VECTOR(dist)[to];
+                long int to = neis[j].nei;
+                igraph_real_t altdist = mindist + neis[j].weight;
+                igraph_real_t curdist = VECTOR(*dist)[to];
 
                 if (curdist == 0) {
                     /* this means curdist is infinity */
@@ -1702,51 +1934,103 @@ static int igraph_i_betweenness_estimate_weighted(
 
                 if (curdist == 0) {
                     /* This is the first non-infinite distance */
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_resize(v, 1);
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
                     VECTOR(*v)[0] = minnei;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
+                    VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
 
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+                    VECTOR(*dist)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_dial_push_with_index(Q, to, -altdist));
                 } else if (cmp_result < 0) {
                     /* This is a shorter path */
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_resize(v, 1);
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
                     VECTOR(*v)[0] = minnei;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
+                    VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
 
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+                    VECTOR(*dist)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_dial_modify(Q, to, -altdist));
                 } else if (cmp_result == 0) {
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_push_back(v, minnei);
-                    VECTOR(nrgeo)[to] += VECTOR(nrgeo)[minnei];
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_push_back(v, minnei));
+                    VECTOR(*nrgeo)[to] += VECTOR(*nrgeo)[minnei];
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_dial_empty(Q) */
 
-        while (!igraph_stack_empty(&S)) {
-            long int w = (long int) igraph_stack_pop(&S);
-            igraph_vector_int_t *fatv = igraph_adjlist_get(&fathers, w);
+        while (!igraph_stack_empty(&ws->stack)) {
+            long int w = (long int) igraph_stack_pop(&ws->stack);
+            igraph_vector_int_t *fatv = igraph_adjlist_get(&ws->fathers, w);
             long int fatv_len = igraph_vector_int_size(fatv);
             for (j = 0; j < fatv_len; j++) {
                 long int f = (long int) VECTOR(*fatv)[j];
-                VECTOR(tmpscore)[f] += VECTOR(nrgeo)[f] / VECTOR(nrgeo)[w] * (1 + VECTOR(tmpscore)[w]);
+                tmpscore[f] += VECTOR(*nrgeo)[f] / VECTOR(*nrgeo)[w] * (1 + tmpscore[w]);
             }
             if (w != source) {
-                VECTOR(*tmpres)[w] += VECTOR(tmpscore)[w];
+                VECTOR(ws->score)[w] += tmpscore[w];
             }
 
-            VECTOR(tmpscore)[w] = 0;
-            VECTOR(dist)[w] = 0;
-            VECTOR(nrgeo)[w] = 0;
-            igraph_vector_int_clear(igraph_adjlist_get(&fathers, w));
+            tmpscore[w] = 0;
+            VECTOR(*dist)[w] = 0;
+            VECTOR(*nrgeo)[w] = 0;
+            igraph_vector_int_clear(fatv);
         }
 
     } /* source < no_of_nodes */
 
+    return 0;
+}
+
+static int igraph_i_betweenness_estimate_weighted(
+        const igraph_t *graph,
+        igraph_vector_t *res,
+        const igraph_vs_t vids,
+        igraph_bool_t directed,
+        igraph_real_t cutoff,
+        const igraph_vector_t *weights,
+        igraph_bool_t nobigint) {
+
+    igraph_real_t minweight;
+    igraph_integer_t no_of_nodes = (igraph_integer_t) igraph_vcount(graph);
+    igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
+    igraph_weighted_adjlist_t wal;
+    igraph_i_brandes_t b;
+    long int j;
+    igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
+    igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
+    igraph_vit_t vit;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+
+    IGRAPH_UNUSED(nobigint);
+
+    if (igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    minweight = igraph_vector_min(weights);
+    if (minweight <= 0) {
+        IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
+    } else if (minweight <= eps) {
+        IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
+    }
+
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+    IGRAPH_CHECK(igraph_i_brandes_init(&b, graph, no_of_nodes, &wal, nobigint));
+    IGRAPH_FINALLY(igraph_i_brandes_destroy, &b);
+    b.cutoff = cutoff;
+
+    if (igraph_vs_is_all(&vids)) {
+        IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+        tmpres = res;
+    } else {
+        IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
+    }
+
+    IGRAPH_PARALLEL_FOR(b.no_of_tasks, b.no_of_tasks,
+                        igraph_i_betweenness_dijkstra_task, &b);
+    igraph_i_brandes_sum(&b, tmpres);
+
     if (!igraph_vs_is_all(&vids)) {
         IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
         IGRAPH_FINALLY(igraph_vit_destroy, &vit);
@@ -1773,27 +2057,13 @@ static int igraph_i_betweenness_estimate_weighted(
 
     IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
 
-    igraph_vector_destroy(&nrgeo);
-    igraph_vector_destroy(&tmpscore);
-    igraph_vector_destroy(&dist);
-    igraph_stack_destroy(&S);
-    igraph_adjlist_destroy(&fathers);
-    igraph_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
-    IGRAPH_FINALLY_CLEAN(7);
+    igraph_i_brandes_destroy(&b);
+    igraph_weighted_adjlist_destroy(&wal);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
 
-static void igraph_i_destroy_biguints(igraph_biguint_t *p) {
-    igraph_biguint_t *p2 = p;
-    while ( *((long int*)(p)) ) {
-        igraph_biguint_destroy(p);
-        p++;
-    }
-    igraph_Free(p2);
-}
-
 /**
  * \ingroup structural
  * \function igraph_betweenness_estimate
@@ -1808,6 +2078,13 @@ static void igraph_i_destroy_biguints(igraph_biguint_t *p) {
  * equal to a prescribed length. Note that the estimated centrality
  * will always be less than the real one.
  *
+ * </para><para>
+ * The sources of the shortest paths are split between the threads set
+ * by \ref igraph_set_num_threads(), every thread needs O(|V|)
+ * memory, or O(|V|+|E|) for weighted graphs. With the same number of
+ * threads the result is the same in every run, with a different number
+ * of threads it may differ in the rounding errors.
+ *
  * \param graph The graph object.
  * \param res The result of the computation, a vector containing the
  *        estimated betweenness scores for the specified vertices.
@@ -1849,24 +2126,14 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
                                 igraph_bool_t nobigint) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    long int *distance;
-    unsigned long long int *nrgeo = 0;  /* must be long long; consider grid
-                       graphs for example */
-    igraph_biguint_t *big_nrgeo = 0;
-    double *tmpscore;
-    igraph_stack_t stack = IGRAPH_STACK_NULL;
-    long int source;
     long int j, k, nneis;
-    igraph_vector_int_t *neis;
     igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
     igraph_vit_t vit;
+    igraph_i_brandes_t b;
 
     igraph_adjlist_t adjlist_out, adjlist_in;
     igraph_adjlist_t *adjlist_out_p, *adjlist_in_p;
 
-    igraph_biguint_t D, R, T;
-
     if (weights) {
         return igraph_i_betweenness_estimate_weighted(graph, res, vids, directed,
                 cutoff, weights, nobigint);
@@ -1878,110 +2145,141 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
     } else {
         /* only  */
         IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
-        igraph_vector_null(res);
         tmpres = res;
     }
 
     directed = directed && igraph_is_directed(graph);
     if (directed) {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_OUT));
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist_out, IGRAPH_OUT));
         IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_IN));
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist_in, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
         adjlist_out_p = &adjlist_out;
         adjlist_in_p = &adjlist_in;
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_ALL));
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist_out, IGRAPH_ALL));
         IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_ALL));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
-        adjlist_out_p = &adjlist_out;
-        adjlist_in_p = &adjlist_in;
-    }
-    for (j = 0; j < no_of_nodes; j++) {
-        igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, j));
+        adjlist_out_p = adjlist_in_p = &adjlist_out;
     }
 
-    distance = igraph_Calloc(no_of_nodes, long int);
-    if (distance == 0) {
-        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, distance);
-    if (nobigint) {
-        nrgeo = igraph_Calloc(no_of_nodes, unsigned long long int);
-        if (nrgeo == 0) {
-            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
-        }
-        IGRAPH_FINALLY(igraph_free, nrgeo);
-    } else {
-        /* +1 is to have one containing zeros, when we free it, we stop
-           at the zero */
-        big_nrgeo = igraph_Calloc(no_of_nodes + 1, igraph_biguint_t);
-        if (!big_nrgeo) {
-            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+    IGRAPH_CHECK(igraph_i_brandes_init(&b, graph, no_of_nodes, /*wal=*/ 0,
+                                       nobigint));
+    IGRAPH_FINALLY(igraph_i_brandes_destroy, &b);
+    b.cutoff = cutoff;
+    b.adjlist_out = adjlist_out_p;
+    b.adjlist_in = adjlist_in_p;
+
+    /* here we go */
+
+    IGRAPH_PARALLEL_FOR(b.no_of_tasks, b.no_of_tasks,
+                        igraph_i_betweenness_bfs_task, &b);
+    igraph_i_brandes_sum(&b, tmpres);
+
+    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
+
+    /* clean  */
+    igraph_i_brandes_destroy(&b);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    /* Keep only the requested vertices */
+    if (!igraph_vs_is_all(&vids)) {
+        IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+        IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+        IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+
+        for (k = 0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
+             IGRAPH_VIT_NEXT(vit), k++) {
+            long int node = IGRAPH_VIT_GET(vit);
+            VECTOR(*res)[k] = VECTOR(*tmpres)[node];
         }
-        IGRAPH_FINALLY(igraph_i_destroy_biguints, big_nrgeo);
-        for (j = 0; j < no_of_nodes; j++) {
-            IGRAPH_CHECK(igraph_biguint_init(&big_nrgeo[j]));
+
+        igraph_vit_destroy(&vit);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    /* divide by 2 for undirected graph */
+    if (!directed) {
+        nneis = igraph_vector_size(res);
+        for (j = 0; j < nneis; j++) {
+            VECTOR(*res)[j] /= 2.0;
         }
-        IGRAPH_CHECK(igraph_biguint_init(&D));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &D);
-        IGRAPH_CHECK(igraph_biguint_init(&R));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &R);
-        IGRAPH_CHECK(igraph_biguint_init(&T));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &T);
     }
-    tmpscore = igraph_Calloc(no_of_nodes, double);
-    if (tmpscore == 0) {
-        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+
+    if (directed) {
+        igraph_adjlist_destroy(&adjlist_in);
+        IGRAPH_FINALLY_CLEAN(1);
     }
-    IGRAPH_FINALLY(igraph_free, tmpscore);
+    igraph_adjlist_destroy(&adjlist_out);
+    IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    igraph_stack_init(&stack, no_of_nodes);
-    IGRAPH_FINALLY(igraph_stack_destroy, &stack);
+    if (!igraph_vs_is_all(&vids)) {
+        igraph_vector_destroy(tmpres);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
 
-    /* here we go */
+    return 0;
+}
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
+static int igraph_i_edge_betweenness_bfs_task(void *data, long int task,
+                                              int thread) {
+
+    igraph_i_brandes_t *b = (igraph_i_brandes_t *) data;
+    igraph_i_brandes_ws_t *ws = &b->ws[task];
+    const igraph_t *graph = b->graph;
+    long int no_of_nodes = b->no_of_nodes;
+    igraph_real_t cutoff = b->cutoff;
+    long int *distance = ws->distance;
+    unsigned long long int *nrgeo = ws->nrgeo;
+    double *tmpscore = ws->tmpscore;
+    long int source;
+    igraph_vector_int_t *neip;
+    long int neino;
+    long int i;
 
-        IGRAPH_CHECK(igraph_dqueue_push(&q, source));
-        if (nobigint) {
-            nrgeo[source] = 1;
-        } else {
-            igraph_biguint_set_limb(&big_nrgeo[source], 1);
+    for (source = task; source < no_of_nodes; source += b->no_of_tasks) {
+        if (thread == 0 &&
+            igraph_progress("Edge betweenness centrality: ",
+                            100.0 * source / no_of_nodes, 0) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
         }
-        distance[source] = 1;
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            IGRAPH_CHECK(igraph_stack_push(&stack, actnode));
+        IGRAPH_ALLOW_INTERRUPTION();
 
-            if (cutoff > 0 && distance[actnode] >= cutoff + 1) {
+        memset(distance, 0, (size_t) no_of_nodes * sizeof(long int));
+        memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(unsigned long long int));
+        memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
+        igraph_stack_clear(&ws->stack); /* it should be empty anyway... */
+
+        IGRAPH_CHECK(igraph_dqueue_push(&ws->q, source));
+
+        nrgeo[source] = 1;
+        distance[source] = 0;
+
+        while (!igraph_dqueue_empty(&ws->q)) {
+            long int actnode = (long int) igraph_dqueue_pop(&ws->q);
+
+            if (cutoff > 0 && distance[actnode] >= cutoff ) {
                 continue;
             }
 
-            neis = igraph_adjlist_get(adjlist_out_p, actnode);
-            nneis = igraph_vector_int_size(neis);
-            for (j = 0; j < nneis; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (distance[neighbor] == 0) {
-                    distance[neighbor] = distance[actnode] + 1;
-                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                }
-                if (distance[neighbor] == distance[actnode] + 1) {
-                    igraph_vector_int_t *v = igraph_adjlist_get(adjlist_in_p,
-                                             neighbor);
-                    igraph_vector_int_push_back(v, actnode);
-                    if (nobigint) {
+            /* check the neighbors and add to them to the queue if unseen before */
+            neip = igraph_inclist_get(b->elist_out, actnode);
+            neino = igraph_vector_int_size(neip);
+            for (i = 0; i < neino; i++) {
+                igraph_integer_t edge = (igraph_integer_t) VECTOR(*neip)[i], from, to;
+                long int neighbor;
+                igraph_edge(graph, edge, &from, &to);
+                neighbor = actnode != from ? from : to;
+                if (nrgeo[neighbor] != 0) {
+                    /* we've already seen this node, another shortest path? */
+                    if (distance[neighbor] == distance[actnode] + 1) {
                         nrgeo[neighbor] += nrgeo[actnode];
-                    } else {
-                        IGRAPH_CHECK(igraph_biguint_add(&big_nrgeo[neighbor],
-                                                        &big_nrgeo[neighbor],
-                                                        &big_nrgeo[actnode]));
                     }
+                } else {
+                    /* we haven't seen this node yet */
+                    nrgeo[neighbor] += nrgeo[actnode];
+                    distance[neighbor] = distance[actnode] + 1;
+                    IGRAPH_CHECK(igraph_dqueue_push(&ws->q, neighbor));
+                    IGRAPH_CHECK(igraph_stack_push(&ws->stack, neighbor));
                 }
             }
         } /* while !igraph_dqueue_empty */
@@ -1989,182 +2287,86 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
         /* Ok, we've the distance of each node and also the number of
            shortest paths to them. Now we do an inverse search, starting
            with the farthest nodes. */
-        while (!igraph_stack_empty(&stack)) {
-            long int actnode = (long int) igraph_stack_pop(&stack);
-            neis = igraph_adjlist_get(adjlist_in_p, actnode);
-            nneis = igraph_vector_int_size(neis);
-            for (j = 0; j < nneis; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (nobigint) {
-                    tmpscore[neighbor] +=  (tmpscore[actnode] + 1) *
-                                           ((double)(nrgeo[neighbor])) / nrgeo[actnode];
-                } else {
-                    if (!igraph_biguint_compare_limb(&big_nrgeo[actnode], 0)) {
-                        tmpscore[neighbor] = IGRAPH_INFINITY;
-                    } else {
-                        double div;
-                        limb_t shift = 1000000000L;
-                        IGRAPH_CHECK(igraph_biguint_mul_limb(&T, &big_nrgeo[neighbor],
-                                                             shift));
-                        igraph_biguint_div(&D, &R, &T, &big_nrgeo[actnode]);
-                        div = igraph_biguint_get(&D) / shift;
-                        tmpscore[neighbor] += (tmpscore[actnode] + 1) * div;
-                    }
-                }
-            }
-
-            if (actnode != source) {
-                VECTOR(*tmpres)[actnode] += tmpscore[actnode];
+        while (!igraph_stack_empty(&ws->stack)) {
+            long int actnode = (long int) igraph_stack_pop(&ws->stack);
+            if (distance[actnode] < 1) {
+                continue;    /* skip source node */
             }
 
-            distance[actnode] = 0;
-            if (nobigint) {
-                nrgeo[actnode] = 0;
-            } else {
-                igraph_biguint_set_limb(&big_nrgeo[actnode], 0);
+            /* set the temporary score of the friends */
+            neip = igraph_inclist_get(b->elist_in, actnode);
+            neino = igraph_vector_int_size(neip);
+            for (i = 0; i < neino; i++) {
+                igraph_integer_t from, to;
+                long int neighbor;
+                igraph_integer_t edgeno = (igraph_integer_t) VECTOR(*neip)[i];
+                igraph_edge(graph, edgeno, &from, &to);
+                neighbor = actnode != from ? from : to;
+                if (distance[neighbor] == distance[actnode] - 1 &&
+                    nrgeo[neighbor] != 0) {
+                    tmpscore[neighbor] +=
+                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
+                    VECTOR(ws->score)[edgeno] +=
+                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
+                }
             }
-            tmpscore[actnode] = 0;
-            igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, actnode));
         }
-
-    } /* for source < no_of_nodes */
-
-    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
-
-    /* clean  */
-    igraph_Free(distance);
-    if (nobigint) {
-        igraph_Free(nrgeo);
-    } else {
-        igraph_biguint_destroy(&T);
-        igraph_biguint_destroy(&R);
-        igraph_biguint_destroy(&D);
-        IGRAPH_FINALLY_CLEAN(3);
-        igraph_i_destroy_biguints(big_nrgeo);
-    }
-    igraph_Free(tmpscore);
-
-    igraph_dqueue_destroy(&q);
-    igraph_stack_destroy(&stack);
-    IGRAPH_FINALLY_CLEAN(5);
-
-    /* Keep only the requested vertices */
-    if (!igraph_vs_is_all(&vids)) {
-        IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
-        IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-        IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
-
-        for (k = 0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
-             IGRAPH_VIT_NEXT(vit), k++) {
-            long int node = IGRAPH_VIT_GET(vit);
-            VECTOR(*res)[k] = VECTOR(*tmpres)[node];
-        }
-
-        igraph_vit_destroy(&vit);
-        igraph_vector_destroy(tmpres);
-        IGRAPH_FINALLY_CLEAN(2);
-    }
-
-    /* divide by 2 for undirected graph */
-    if (!directed) {
-        nneis = igraph_vector_size(res);
-        for (j = 0; j < nneis; j++) {
-            VECTOR(*res)[j] /= 2.0;
-        }
-    }
-
-    igraph_adjlist_destroy(&adjlist_out);
-    igraph_adjlist_destroy(&adjlist_in);
-    IGRAPH_FINALLY_CLEAN(2);
+        /* Ok, we've the scores for this source */
+    } /* for source <= no_of_nodes */
 
     return 0;
 }
 
-static int igraph_i_edge_betweenness_estimate_weighted(
-        const igraph_t *graph,
-        igraph_vector_t *result,
-        igraph_bool_t directed,
-        igraph_real_t cutoff,
-        const igraph_vector_t *weights) {
-
-    igraph_real_t minweight;
-    igraph_integer_t no_of_nodes = (igraph_integer_t) igraph_vcount(graph);
-    igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
-    igraph_2wheap_t Q;
-    igraph_inclist_t inclist;
-    igraph_inclist_t fathers;
-    igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
-    igraph_vector_t distance, tmpscore;
-    igraph_vector_long_t nrgeo;
+static int igraph_i_edge_betweenness_dijkstra_task(void *data, long int task,
+                                                   int thread) {
+
+    igraph_i_brandes_t *b = (igraph_i_brandes_t *) data;
+    igraph_i_brandes_ws_t *ws = &b->ws[task];
+    const igraph_t *graph = b->graph;
+    long int no_of_nodes = b->no_of_nodes;
+    igraph_real_t cutoff = b->cutoff;
+    igraph_i_dial_t *Q = &ws->Q;
+    igraph_vector_t *distance = &ws->dist, *nrgeo = &ws->wnrgeo;
+    double *tmpscore = ws->tmpscore;
     long int source, j;
     int cmp_result;
     const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
-    igraph_stack_t S;
-
-    if (igraph_vector_size(weights) != no_of_edges) {
-        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
-    }
-    minweight = igraph_vector_min(weights);
-    if (minweight <= 0) {
-        IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
-    } else if (minweight <= eps) {
-        IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
-    }
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-    IGRAPH_CHECK(igraph_inclist_init_empty(&fathers, no_of_nodes));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &fathers);
-
-    IGRAPH_VECTOR_INIT_FINALLY(&distance, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmpscore, no_of_nodes);
-    IGRAPH_CHECK(igraph_vector_long_init(&nrgeo, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &nrgeo);
-
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &S);
-
-    IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
-    igraph_vector_null(result);
-
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
+    for (source = task; source < no_of_nodes; source += b->no_of_tasks) {
+        if (thread == 0 &&
+            igraph_progress("Edge betweenness centrality: ",
+                            100.0 * source / no_of_nodes, 0) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
+        }
         IGRAPH_ALLOW_INTERRUPTION();
 
-        /*     printf("source: %li\n", source); */
-
-        igraph_vector_null(&distance);
-        igraph_vector_null(&tmpscore);
-        igraph_vector_long_null(&nrgeo);
+        igraph_vector_null(distance);
+        memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
+        igraph_vector_null(nrgeo);
 
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-        VECTOR(distance)[source] = 1.0;
-        VECTOR(nrgeo)[source] = 1;
+        igraph_i_dial_push_with_index(Q, source, -1.0);
+        VECTOR(*distance)[source] = 1.0;
+        VECTOR(*nrgeo)[source] = 1;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-            igraph_vector_int_t *neis;
+        while (!igraph_i_dial_empty(Q)) {
+            long int minnei = igraph_i_dial_max_index(Q);
+            igraph_real_t mindist = -igraph_i_dial_delete_max(Q);
+            igraph_weighted_adjlist_entry_t *neis;
             long int nlen;
 
-            /* printf("SP to %li is final, dist: %g, nrgeo: %li\n", minnei, */
-            /* VECTOR(distance)[minnei]-1.0, VECTOR(nrgeo)[minnei]); */
-
-            igraph_stack_push(&S, minnei);
+            igraph_stack_push(&ws->stack, minnei);
 
-            if (cutoff > 0 && VECTOR(distance)[minnei] >= cutoff + 1.0) {
+            if (cutoff > 0 && VECTOR(*distance)[minnei] >= cutoff + 1.0) {
                 continue;
             }
 
-            neis = igraph_inclist_get(&inclist, minnei);
-            nlen = igraph_vector_int_size(neis);
+            neis = igraph_weighted_adjlist_get(b->wal, minnei);
+            nlen = igraph_weighted_adjlist_size(b->wal, minnei);
             for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int to = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_real_t curdist = VECTOR(distance)[to];
+                long int edge = neis[j].edge;
+                long int to = neis[j].nei;
+                igraph_real_t altdist = mindist + neis[j].weight;
+                igraph_real_t curdist = VECTOR(*distance)[to];
 
                 if (curdist == 0) {
                     /* this means curdist is infinity */
@@ -2173,60 +2375,94 @@ static int igraph_i_edge_betweenness_estimate_weighted(
                     cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
                 }
 
-                /* printf("to=%ld, altdist = %lg, curdist = %lg, cmp = %d\n",
-                  to, altdist, curdist-1, cmp_result); */
                 if (curdist == 0) {
                     /* This is the first finite distance to 'to' */
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found first path to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_resize(v, 1);
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
                     VECTOR(*v)[0] = edge;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-                    VECTOR(distance)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+                    VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                    VECTOR(*distance)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_dial_push_with_index(Q, to, -altdist));
                 } else if (cmp_result < 0) {
                     /* This is a shorter path */
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found a shorter path to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_resize(v, 1);
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
                     VECTOR(*v)[0] = edge;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-                    VECTOR(distance)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+                    VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                    VECTOR(*distance)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_dial_modify(Q, to, -altdist));
                 } else if (cmp_result == 0) {
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found a second SP to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_push_back(v, edge);
-                    VECTOR(nrgeo)[to] += VECTOR(nrgeo)[minnei];
+                    igraph_vector_int_t *v = igraph_adjlist_get(&ws->fathers, to);
+                    IGRAPH_CHECK(igraph_vector_int_push_back(v, edge));
+                    VECTOR(*nrgeo)[to] += VECTOR(*nrgeo)[minnei];
                 }
             }
 
-        } /* igraph_2wheap_empty(&Q) */
+        } /* igraph_i_dial_empty(Q) */
 
-        while (!igraph_stack_empty(&S)) {
-            long int w = (long int) igraph_stack_pop(&S);
-            igraph_vector_int_t *fatv = igraph_inclist_get(&fathers, w);
+        while (!igraph_stack_empty(&ws->stack)) {
+            long int w = (long int) igraph_stack_pop(&ws->stack);
+            igraph_vector_int_t *fatv = igraph_adjlist_get(&ws->fathers, w);
             long int fatv_len = igraph_vector_int_size(fatv);
-            /* printf("Popping %li.\n", w); */
             for (j = 0; j < fatv_len; j++) {
                 long int fedge = (long int) VECTOR(*fatv)[j];
                 long int neighbor = IGRAPH_OTHER(graph, fedge, w);
-                VECTOR(tmpscore)[neighbor] += ((double)VECTOR(nrgeo)[neighbor]) /
-                                              VECTOR(nrgeo)[w] * (1.0 + VECTOR(tmpscore)[w]);
-                /* printf("Scoring %li (edge %li)\n", neighbor, fedge); */
-                VECTOR(*result)[fedge] +=
-                    ((VECTOR(tmpscore)[w] + 1) * VECTOR(nrgeo)[neighbor]) /
-                    VECTOR(nrgeo)[w];
+                tmpscore[neighbor] += VECTOR(*nrgeo)[neighbor] /
+                                      VECTOR(*nrgeo)[w] * (1.0 + tmpscore[w]);
+                VECTOR(ws->score)[fedge] +=
+                    ((tmpscore[w] + 1) * VECTOR(*nrgeo)[neighbor]) /
+                    VECTOR(*nrgeo)[w];
             }
 
-            VECTOR(tmpscore)[w] = 0;
-            VECTOR(distance)[w] = 0;
-            VECTOR(nrgeo)[w] = 0;
+            tmpscore[w] = 0;
+            VECTOR(*distance)[w] = 0;
+            VECTOR(*nrgeo)[w] = 0;
             igraph_vector_int_clear(fatv);
         }
 
     } /* source < no_of_nodes */
 
+    return 0;
+}
+
+static int igraph_i_edge_betweenness_estimate_weighted(
+        const igraph_t *graph,
+        igraph_vector_t *result,
+        igraph_bool_t directed,
+        igraph_real_t cutoff,
+        const igraph_vector_t *weights) {
+
+    igraph_real_t minweight;
+    igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
+    igraph_weighted_adjlist_t wal;
+    igraph_i_brandes_t b;
+    igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
+    long int j;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+
+    if (igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    minweight = igraph_vector_min(weights);
+    if (minweight <= 0) {
+        IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
+    } else if (minweight <= eps) {
+        IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
+    }
+
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+    IGRAPH_CHECK(igraph_i_brandes_init(&b, graph, no_of_edges, &wal,
+                                       /*nobigint=*/ 1));
+    IGRAPH_FINALLY(igraph_i_brandes_destroy, &b);
+    b.cutoff = cutoff;
+
+    IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
+
+    IGRAPH_PARALLEL_FOR(b.no_of_tasks, b.no_of_tasks,
+                        igraph_i_edge_betweenness_dijkstra_task, &b);
+    igraph_i_brandes_sum(&b, result);
+
     if (!directed || !igraph_is_directed(graph)) {
         for (j = 0; j < no_of_edges; j++) {
             VECTOR(*result)[j] /= 2.0;
@@ -2235,17 +2471,10 @@ static int igraph_i_edge_betweenness_estimate_weighted(
 
     IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
-    igraph_stack_destroy(&S);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_brandes_destroy(&b);
+    igraph_weighted_adjlist_destroy(&wal);
     IGRAPH_FINALLY_CLEAN(2);
 
-    igraph_inclist_destroy(&inclist);
-    igraph_inclist_destroy(&fathers);
-    igraph_vector_destroy(&distance);
-    igraph_vector_destroy(&tmpscore);
-    igraph_vector_long_destroy(&nrgeo);
-    IGRAPH_FINALLY_CLEAN(5);
-
     return 0;
 }
 
@@ -2259,6 +2488,14 @@ static int igraph_i_edge_betweenness_estimate_weighted(
  * going through it. If there are more than one geodesics between two
  * vertices, the value of these geodesics are weighted by one over the
  * number of geodesics.
+ *
+ * </para><para>
+ * The sources of the shortest paths are split between the threads set
+ * by \ref igraph_set_num_threads(), every thread needs O(|V|+|E|)
+ * memory. With the same number of threads the result is the same in
+ * every run, with a different number of threads it may differ in the
+ * rounding errors.
+ *
  * \param graph The graph object.
  * \param result The result of the computation, vector containing the
  *        betweenness scores for the edges.
@@ -2303,6 +2540,14 @@ int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
  * takes into consideration only those paths that are shorter than or
  * equal to a prescribed length. Note that the estimated centrality
  * will always be less than the real one.
+ *
+ * </para><para>
+ * The sources of the shortest paths are split between the threads set
+ * by \ref igraph_set_num_threads(), every thread needs O(|V|+|E|)
+ * memory. With the same number of threads the result is the same in
+ * every run, with a different number of threads it may differ in the
+ * rounding errors.
+ *
  * \param graph The graph object.
  * \param result The result of the computation, vector containing the
  *        betweenness scores for the edges.
@@ -2330,21 +2575,12 @@ int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
 int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *result,
                                      igraph_bool_t directed, igraph_real_t cutoff,
                                      const igraph_vector_t *weights) {
-    long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    long int *distance;
-    unsigned long long int *nrgeo;
-    double *tmpscore;
-    igraph_stack_t stack = IGRAPH_STACK_NULL;
-    long int source;
+    igraph_i_brandes_t b;
     long int j;
 
     igraph_inclist_t elist_out, elist_in;
     igraph_inclist_t *elist_out_p, *elist_in_p;
-    igraph_vector_int_t *neip;
-    long int neino;
-    long int i;
 
     if (weights) {
         return igraph_i_edge_betweenness_estimate_weighted(graph, result,
@@ -2353,126 +2589,38 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
 
     directed = directed && igraph_is_directed(graph);
     if (directed) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_OUT));
+        IGRAPH_CHECK(igraph_i_inclist_init_flat(graph, &elist_out, IGRAPH_OUT));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_in, IGRAPH_IN));
+        IGRAPH_CHECK(igraph_i_inclist_init_flat(graph, &elist_in, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_in);
         elist_out_p = &elist_out;
         elist_in_p = &elist_in;
     } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_ALL));
+        IGRAPH_CHECK(igraph_i_inclist_init_flat(graph, &elist_out, IGRAPH_ALL));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
         elist_out_p = elist_in_p = &elist_out;
     }
 
-    distance = igraph_Calloc(no_of_nodes, long int);
-    if (distance == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, distance);
-    nrgeo = igraph_Calloc(no_of_nodes, unsigned long long int);
-    if (nrgeo == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, nrgeo);
-    tmpscore = igraph_Calloc(no_of_nodes, double);
-    if (tmpscore == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, tmpscore);
-
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    IGRAPH_CHECK(igraph_stack_init(&stack, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &stack);
+    IGRAPH_CHECK(igraph_i_brandes_init(&b, graph, no_of_edges, /*wal=*/ 0,
+                                       /*nobigint=*/ 1));
+    IGRAPH_FINALLY(igraph_i_brandes_destroy, &b);
+    b.cutoff = cutoff;
+    b.elist_out = elist_out_p;
+    b.elist_in = elist_in_p;
 
     IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
 
-    igraph_vector_null(result);
-
     /* here we go */
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        memset(distance, 0, (size_t) no_of_nodes * sizeof(long int));
-        memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(unsigned long long int));
-        memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
-        igraph_stack_clear(&stack); /* it should be empty anyway... */
-
-        IGRAPH_CHECK(igraph_dqueue_push(&q, source));
-
-        nrgeo[source] = 1;
-        distance[source] = 0;
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-
-            if (cutoff > 0 && distance[actnode] >= cutoff ) {
-                continue;
-            }
-
-            /* check the neighbors and add to them to the queue if unseen before */
-            neip = igraph_inclist_get(elist_out_p, actnode);
-            neino = igraph_vector_int_size(neip);
-            for (i = 0; i < neino; i++) {
-                igraph_integer_t edge = (igraph_integer_t) VECTOR(*neip)[i], from, to;
-                long int neighbor;
-                igraph_edge(graph, edge, &from, &to);
-                neighbor = actnode != from ? from : to;
-                if (nrgeo[neighbor] != 0) {
-                    /* we've already seen this node, another shortest path? */
-                    if (distance[neighbor] == distance[actnode] + 1) {
-                        nrgeo[neighbor] += nrgeo[actnode];
-                    }
-                } else {
-                    /* we haven't seen this node yet */
-                    nrgeo[neighbor] += nrgeo[actnode];
-                    distance[neighbor] = distance[actnode] + 1;
-                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                    IGRAPH_CHECK(igraph_stack_push(&stack, neighbor));
-                }
-            }
-        } /* while !igraph_dqueue_empty */
-
-        /* Ok, we've the distance of each node and also the number of
-           shortest paths to them. Now we do an inverse search, starting
-           with the farthest nodes. */
-        while (!igraph_stack_empty(&stack)) {
-            long int actnode = (long int) igraph_stack_pop(&stack);
-            if (distance[actnode] < 1) {
-                continue;    /* skip source node */
-            }
+    IGRAPH_PARALLEL_FOR(b.no_of_tasks, b.no_of_tasks,
+                        igraph_i_edge_betweenness_bfs_task, &b);
+    igraph_i_brandes_sum(&b, result);
 
-            /* set the temporary score of the friends */
-            neip = igraph_inclist_get(elist_in_p, actnode);
-            neino = igraph_vector_int_size(neip);
-            for (i = 0; i < neino; i++) {
-                igraph_integer_t from, to;
-                long int neighbor;
-                igraph_integer_t edgeno = (igraph_integer_t) VECTOR(*neip)[i];
-                igraph_edge(graph, edgeno, &from, &to);
-                neighbor = actnode != from ? from : to;
-                if (distance[neighbor] == distance[actnode] - 1 &&
-                    nrgeo[neighbor] != 0) {
-                    tmpscore[neighbor] +=
-                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                    VECTOR(*result)[edgeno] +=
-                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                }
-            }
-        }
-        /* Ok, we've the scores for this source */
-    } /* for source <= no_of_nodes */
     IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
     /* clean and return */
-    igraph_Free(distance);
-    igraph_Free(nrgeo);
-    igraph_Free(tmpscore);
-    igraph_dqueue_destroy(&q);
-    igraph_stack_destroy(&stack);
-    IGRAPH_FINALLY_CLEAN(5);
+    igraph_i_brandes_destroy(&b);
+    IGRAPH_FINALLY_CLEAN(1);
 
     if (directed) {
         igraph_inclist_destroy(&elist_out);
@@ -2517,6 +2665,10 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
  * that single vertex will be NaN (because we are essentially dividing
  * zero with zero).
  *
+ * </para><para>
+ * The searches from the given vertices are split between the threads
+ * set by \ref igraph_set_num_threads().
+ *
  * \param graph The graph object.
  * \param res The result of the computation, a vector containing the
  *        closeness centrality scores for the given vertices.
@@ -2564,139 +2716,335 @@ int igraph_closeness(const igraph_t *graph, igraph_vector_t *res,
                                      normalized);
 }
 
-static int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
-                                                igraph_vector_t *res,
-                                                const igraph_vs_t vids,
-                                                igraph_neimode_t mode,
-                                                igraph_real_t cutoff,
-                                                const igraph_vector_t *weights,
-                                                igraph_bool_t normalized) {
-
-    /* See igraph_shortest_paths_dijkstra() for the implementation
-       details and the dirty tricks. */
+/* Closeness and harmonic centrality run one BFS or Dijkstra search
+   from every vertex in 'vids'. The vertices are split into blocks, one
+   block is a task of a parallel loop. Each vertex has its own result,
+   so the results do not depend on the number of threads. */
+
+typedef struct igraph_i_closeness_ws_t {
+    igraph_vector_long_t which;     /* index of the last source + 1 */
+    igraph_dqueue_t q;              /* BFS */
+    igraph_i_dial_t Q;              /* Dijkstra */
+    igraph_vector_t dist;           /* Dijkstra, distance + 1 */
+    igraph_bool_t warning_shown;
+} igraph_i_closeness_ws_t;
+
+typedef struct igraph_i_closeness_t {
+    long int no_of_nodes;
+    igraph_vector_t sources;
+    long int block_size;
+    igraph_real_t cutoff;
+    igraph_bool_t harmonic;
+    igraph_adjlist_t *adjlist;
+    igraph_weighted_adjlist_t *wal;
+    igraph_vector_t *res;
+    int no_of_threads;
+    igraph_i_closeness_ws_t *ws;
+} igraph_i_closeness_t;
+
+static void igraph_i_closeness_destroy(igraph_i_closeness_t *c) {
+    int i;
+    for (i = 0; i < c->no_of_threads; i++) {
+        igraph_vector_long_destroy(&c->ws[i].which);
+        igraph_dqueue_destroy(&c->ws[i].q);
+        igraph_i_dial_destroy(&c->ws[i].Q);
+        igraph_vector_destroy(&c->ws[i].dist);
+    }
+    igraph_Free(c->ws);
+    igraph_vector_destroy(&c->sources);
+}
 
-    igraph_real_t minweight;
+static int igraph_i_closeness_init(igraph_i_closeness_t *c,
+                                   const igraph_t *graph, igraph_vs_t vids,
+                                   igraph_weighted_adjlist_t *wal) {
     long int no_of_nodes = igraph_vcount(graph);
-    long int no_of_edges = igraph_ecount(graph);
-
-    igraph_2wheap_t Q;
+    long int nodes_to_calc, no_of_blocks;
     igraph_vit_t vit;
-    long int nodes_to_calc;
-
-    igraph_lazy_inclist_t inclist;
-    long int i, j;
+    int i;
 
-    igraph_vector_t dist;
-    igraph_vector_long_t which;
-    long int nodes_reached;
-
-    int cmp_result;
-    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
-    igraph_real_t mindist;
+    memset(c, 0, sizeof(igraph_i_closeness_t));
+    c->no_of_nodes = no_of_nodes;
+    c->wal = wal;
+    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_VECTOR_INIT_FINALLY(&c->sources, 0);
+    IGRAPH_CHECK(igraph_vit_as_vector(&vit, &c->sources));
 
-    igraph_bool_t warning_shown = 0;
+    /* About 16 blocks per thread, so that the threads can balance the
+       work, but not too small blocks */
+    nodes_to_calc = igraph_vector_size(&c->sources);
+    c->no_of_threads = igraph_i_parallel_threads(nodes_to_calc);
+    c->block_size = nodes_to_calc / (16 * c->no_of_threads);
+    if (c->block_size < 16) {
+        c->block_size = 16;
+    }
+    no_of_blocks = (nodes_to_calc + c->block_size - 1) / c->block_size;
+    if (c->no_of_threads > no_of_blocks) {
+        c->no_of_threads = no_of_blocks < 1 ? 1 : (int) no_of_blocks;
+    }
 
-    if (igraph_vector_size(weights) != no_of_edges) {
-        IGRAPH_ERROR("Invalid weight vector length", IGRAPH_EINVAL);
+    c->ws = igraph_Calloc(c->no_of_threads, igraph_i_closeness_ws_t);
+    if (c->ws == 0) {
+        IGRAPH_ERROR("closeness failed", IGRAPH_ENOMEM);
     }
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_i_closeness_destroy, c);
 
-    minweight = igraph_vector_min(weights);
-    if (minweight <= 0) {
-        IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
-    } else if (minweight <= eps) {
-        IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
+    for (i = 0; i < c->no_of_threads; i++) {
+        IGRAPH_CHECK(igraph_vector_long_init(&c->ws[i].which, no_of_nodes));
+        if (wal) {
+            IGRAPH_CHECK(igraph_i_dial_init(&c->ws[i].Q, no_of_nodes, wal));
+            IGRAPH_CHECK(igraph_vector_init(&c->ws[i].dist, no_of_nodes));
+        } else {
+            IGRAPH_CHECK(igraph_dqueue_init(&c->ws[i].q, 100));
+        }
     }
 
-    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
-    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
+static int igraph_i_closeness_bfs(igraph_i_closeness_t *c,
+                                  igraph_i_closeness_ws_t *ws, long int i) {
+
+    long int no_of_nodes = c->no_of_nodes;
+    long int source = (long int) VECTOR(c->sources)[i];
+    igraph_real_t cutoff = c->cutoff;
+    igraph_vector_long_t *which = &ws->which;
+    igraph_dqueue_t *q = &ws->q;
+    igraph_vector_int_t *neis;
+    igraph_real_t sum = 0;
+    long int j, nodes_reached, actdist = 0;
+
+    igraph_dqueue_clear(q);
+    IGRAPH_CHECK(igraph_dqueue_push(q, source));
+    IGRAPH_CHECK(igraph_dqueue_push(q, 0));
+    nodes_reached = 1;
+    VECTOR(*which)[source] = i + 1;
+
+    while (!igraph_dqueue_empty(q)) {
+        long int act = (long int) igraph_dqueue_pop(q);
+        actdist = (long int) igraph_dqueue_pop(q);
+
+        if (c->harmonic) {
+            if (actdist > 0) {
+                sum += 1.0 / actdist;
+            }
+        } else {
+            sum += actdist;
+        }
 
-    nodes_to_calc = IGRAPH_VIT_SIZE(vit);
+        if (cutoff > 0 && actdist >= cutoff) {
+            continue;    /* NOT break!!! */
+        }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+        /* check the neighbors */
+        neis = igraph_adjlist_get(c->adjlist, act);
+        for (j = 0; j < igraph_vector_int_size(neis); j++) {
+            long int neighbor = (long int) VECTOR(*neis)[j];
+            if (VECTOR(*which)[neighbor] == i + 1) {
+                continue;
+            }
+            VECTOR(*which)[neighbor] = i + 1;
+            nodes_reached++;
+            IGRAPH_CHECK(igraph_dqueue_push(q, neighbor));
+            IGRAPH_CHECK(igraph_dqueue_push(q, actdist + 1));
+        }
+    }
 
-    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
-    IGRAPH_CHECK(igraph_vector_long_init(&which, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &which);
+    if (c->harmonic) {
+        VECTOR(*c->res)[i] = sum;
+        return 0;
+    }
 
-    IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
-    igraph_vector_null(res);
+    /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
+    sum += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
+    VECTOR(*c->res)[i] = (no_of_nodes - 1) / sum;
 
-    for (i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
+    if (((cutoff > 0 && actdist < cutoff) || cutoff <= 0) &&
+        no_of_nodes > nodes_reached && !ws->warning_shown) {
+        IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
+        ws->warning_shown = 1;
+    }
 
-        long int source = IGRAPH_VIT_GET(vit);
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-        VECTOR(which)[source] = i + 1;
-        VECTOR(dist)[source] = 1.0;     /* actual distance is zero but we need to store distance + 1 */
-        nodes_reached = 0;
+    return 0;
+}
 
-        while (!igraph_2wheap_empty(&Q)) {
-            igraph_integer_t minnei = (igraph_integer_t) igraph_2wheap_max_index(&Q);
-            /* Now check all neighbors of minnei for a shorter path */
-            igraph_vector_t *neis = igraph_lazy_inclist_get(&inclist, minnei);
-            long int nlen = igraph_vector_size(neis);
+static int igraph_i_closeness_dijkstra(igraph_i_closeness_t *c,
+                                       igraph_i_closeness_ws_t *ws, long int i) {
 
-            mindist = -igraph_2wheap_delete_max(&Q);
+    /* See igraph_shortest_paths_dijkstra() for the implementation
+       details and the dirty tricks. */
 
-            VECTOR(*res)[i] += (mindist - 1.0);
-            nodes_reached++;
+    long int no_of_nodes = c->no_of_nodes;
+    long int source = (long int) VECTOR(c->sources)[i];
+    igraph_real_t cutoff = c->cutoff;
+    igraph_vector_long_t *which = &ws->which;
+    igraph_vector_t *dist = &ws->dist;
+    igraph_i_dial_t *Q = &ws->Q;
+    igraph_real_t sum = 0, mindist = 0;
+    long int j, nodes_reached;
+    int cmp_result;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
-            if (cutoff > 0 && mindist >= cutoff + 1.0) {
-                continue;    /* NOT break!!! */
+    igraph_i_dial_clear(Q);
+    igraph_i_dial_push_with_index(Q, source, -1.0);
+    VECTOR(*which)[source] = i + 1;
+    VECTOR(*dist)[source] = 1.0;     /* actual distance is zero but we need to store distance + 1 */
+    nodes_reached = 0;
+
+    while (!igraph_i_dial_empty(Q)) {
+        igraph_integer_t minnei = (igraph_integer_t) igraph_i_dial_max_index(Q);
+        /* Now check all neighbors of minnei for a shorter path */
+        igraph_weighted_adjlist_entry_t *neis = igraph_weighted_adjlist_get(c->wal, minnei);
+        long int nlen = igraph_weighted_adjlist_size(c->wal, minnei);
+
+        mindist = -igraph_i_dial_delete_max(Q);
+
+        if (c->harmonic) {
+            /* Vertices farther than the cutoff are in the heap if
+               their neighbors are not */
+            if (minnei != source && (cutoff <= 0 || mindist - 1.0 <= cutoff)) {
+                sum += 1.0 / (mindist - 1.0);
             }
+        } else {
+            sum += (mindist - 1.0);
+        }
+        nodes_reached++;
 
-            for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int to = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_real_t curdist = VECTOR(dist)[to];
-                if (curdist == 0) {
-                    /* this means curdist is infinity */
-                    cmp_result = -1;
-                } else {
-                    cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
-                }
+        if (cutoff > 0 && mindist >= cutoff + 1.0) {
+            continue;    /* NOT break!!! */
+        }
 
-                if (VECTOR(which)[to] != i + 1) {
-                    /* First non-infinite distance */
-                    VECTOR(which)[to] = i + 1;
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
-                } else if (cmp_result < 0) {
-                    /* This is a shorter path */
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
-                }
+        for (j = 0; j < nlen; j++) {
+            long int to = neis[j].nei;
+            igraph_real_t altdist = mindist + neis[j].weight;
+            igraph_real_t curdist = VECTOR(*dist)[to];
+            if (curdist == 0) {
+                /* this means curdist is infinity */
+                cmp_result = -1;
+            } else {
+                cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
+            }
+
+            if (VECTOR(*which)[to] != i + 1) {
+                /* First non-infinite distance */
+                VECTOR(*which)[to] = i + 1;
+                VECTOR(*dist)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_dial_push_with_index(Q, to, -altdist));
+            } else if (cmp_result < 0) {
+                /* This is a shorter path */
+                VECTOR(*dist)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_dial_modify(Q, to, -altdist));
             }
+        }
+
+    } /* !igraph_i_dial_empty(Q) */
+
+    if (c->harmonic) {
+        VECTOR(*c->res)[i] = sum;
+        return 0;
+    }
+
+    /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
+    sum += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
+    VECTOR(*c->res)[i] = (no_of_nodes - 1) / sum;
+
+    if (((cutoff > 0 && mindist < cutoff + 1.0) || (cutoff <= 0)) &&
+        nodes_reached < no_of_nodes && !ws->warning_shown) {
+        IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
+        ws->warning_shown = 1;
+    }
 
-        } /* !igraph_2wheap_empty(&Q) */
+    return 0;
+}
 
-        /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
-        VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
-        VECTOR(*res)[i] = (no_of_nodes - 1) / VECTOR(*res)[i];
+static int igraph_i_closeness_task(void *data, long int task, int thread) {
+    igraph_i_closeness_t *c = (igraph_i_closeness_t *) data;
+    igraph_i_closeness_ws_t *ws = &c->ws[thread];
+    long int nodes_to_calc = igraph_vector_size(&c->sources);
+    long int i = task * c->block_size;
+    long int end = i + c->block_size < nodes_to_calc ? i + c->block_size : nodes_to_calc;
 
-        if (((cutoff > 0 && mindist < cutoff + 1.0) || (cutoff <= 0)) &&
-            nodes_reached < no_of_nodes && !warning_shown) {
-            IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
-            warning_shown = 1;
+    for (; i < end; i++) {
+        if (thread == 0 &&
+            igraph_progress(c->harmonic ? "Harmonic centrality: " : "Closeness: ",
+                            100.0 * i / nodes_to_calc, 0) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
         }
-    } /* !IGRAPH_VIT_END(vit) */
+        IGRAPH_ALLOW_INTERRUPTION();
 
-    if (!normalized) {
-        for (i = 0; i < nodes_to_calc; i++) {
-            VECTOR(*res)[i] /= (no_of_nodes - 1);
+        if (c->wal) {
+            IGRAPH_CHECK(igraph_i_closeness_dijkstra(c, ws, i));
+        } else {
+            IGRAPH_CHECK(igraph_i_closeness_bfs(c, ws, i));
         }
     }
 
-    igraph_vector_long_destroy(&which);
-    igraph_vector_destroy(&dist);
-    igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
-    igraph_vit_destroy(&vit);
-    IGRAPH_FINALLY_CLEAN(5);
+    return 0;
+}
+
+/* Calculates closeness or harmonic centrality, without normalization */
+
+static int igraph_i_closeness(const igraph_t *graph, igraph_vector_t *res,
+                              const igraph_vs_t vids, igraph_neimode_t mode,
+                              igraph_real_t cutoff,
+                              const igraph_vector_t *weights,
+                              igraph_bool_t harmonic) {
+
+    igraph_i_closeness_t c;
+    igraph_adjlist_t adjlist;
+    igraph_weighted_adjlist_t wal;
+    long int nodes_to_calc;
+
+    if (weights) {
+        igraph_real_t minweight;
+        const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+        if (igraph_vector_size(weights) != igraph_ecount(graph)) {
+            IGRAPH_ERROR("Invalid weight vector length", IGRAPH_EINVAL);
+        }
+        minweight = igraph_vector_min(weights);
+        if (minweight <= 0) {
+            IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
+        } else if (minweight <= eps) {
+            IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
+        }
+    } else if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+               mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("calculating closeness", IGRAPH_EINVMODE);
+    }
+
+    if (weights) {
+        IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+        IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+    } else {
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist, mode));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+    }
+
+    IGRAPH_CHECK(igraph_i_closeness_init(&c, graph, vids, weights ? &wal : 0));
+    IGRAPH_FINALLY(igraph_i_closeness_destroy, &c);
+    c.cutoff = cutoff;
+    c.harmonic = harmonic;
+    c.res = res;
+    if (!weights) {
+        c.adjlist = &adjlist;
+    }
+
+    nodes_to_calc = igraph_vector_size(&c.sources);
+    IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
+
+    IGRAPH_PARALLEL_FOR((nodes_to_calc + c.block_size - 1) / c.block_size,
+                        c.no_of_threads, igraph_i_closeness_task, &c);
+
+    igraph_i_closeness_destroy(&c);
+    if (weights) {
+        igraph_weighted_adjlist_destroy(&wal);
+    } else {
+        igraph_adjlist_destroy(&adjlist);
+    }
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -2725,6 +3073,10 @@ static int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
  * the given value as disconnected, the resulting estimation will always be
  * lower than the actual closeness centrality.
  *
+ * </para><para>
+ * The searches from the given vertices are split between the threads
+ * set by \ref igraph_set_num_threads().
+ *
  * \param graph The graph object.
  * \param res The result of the computation, a vector containing the
  *        closeness centrality scores for the given vertices.
@@ -2773,105 +3125,139 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
                               igraph_bool_t normalized) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t already_counted;
-    igraph_vector_int_t *neis;
-    long int i, j;
-    long int nodes_reached;
-    long int actdist;
-    igraph_adjlist_t allneis;
-
-    igraph_dqueue_t q;
-
-    long int nodes_to_calc;
-    igraph_vit_t vit;
-
-    igraph_bool_t warning_shown = 0;
-
-    if (weights) {
-        return igraph_i_closeness_estimate_weighted(graph, res, vids, mode, cutoff,
-                weights, normalized);
-    }
-
-    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
-    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    long int i;
 
-    nodes_to_calc = IGRAPH_VIT_SIZE(vit);
+    IGRAPH_CHECK(igraph_i_closeness(graph, res, vids, mode, cutoff, weights,
+                                    /*harmonic=*/ 0));
 
-    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
-        mode != IGRAPH_ALL) {
-        IGRAPH_ERROR("calculating closeness", IGRAPH_EINVMODE);
+    if (!normalized) {
+        for (i = 0; i < igraph_vector_size(res); i++) {
+            VECTOR(*res)[i] /= (no_of_nodes - 1);
+        }
     }
 
-    IGRAPH_VECTOR_INIT_FINALLY(&already_counted, no_of_nodes);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
-
-    IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
-    igraph_vector_null(res);
-
-    for (IGRAPH_VIT_RESET(vit), i = 0;
-         !IGRAPH_VIT_END(vit);
-         IGRAPH_VIT_NEXT(vit), i++) {
-        igraph_dqueue_clear(&q);
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(vit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        nodes_reached = 1;
-        VECTOR(already_counted)[(long int)IGRAPH_VIT_GET(vit)] = i + 1;
-
-        IGRAPH_PROGRESS("Closeness: ", 100.0 * i / no_of_nodes, NULL);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            actdist = (long int) igraph_dqueue_pop(&q);
+    IGRAPH_PROGRESS("Closeness: ", 100.0, NULL);
 
-            VECTOR(*res)[i] += actdist;
+    return 0;
+}
 
-            if (cutoff > 0 && actdist >= cutoff) {
-                continue;    /* NOT break!!! */
-            }
+/**
+ * \ingroup structural
+ * \function igraph_harmonic_centrality
+ * \brief Harmonic centrality for some vertices.
+ *
+ * </para><para>
+ * The harmonic centrality of a vertex is the sum of the inverse
+ * distances to all other vertices, i.e. the mean inverse distance if
+ * it is normalized. Unreachable vertices are at infinite distance, so
+ * they add zero to the sum; unlike closeness centrality, harmonic
+ * centrality is well-defined for disconnected graphs.
+ *
+ * </para><para>
+ * The searches from the given vertices are split between the threads
+ * set by \ref igraph_set_num_threads().
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        harmonic centrality scores for the given vertices.
+ * \param vids The vertices for which the harmonic centrality will be
+ *        computed.
+ * \param mode The type of shortest paths to be used for the
+ *        calculation in directed graphs. Possible values:
+ *        \clist
+ *        \cli IGRAPH_OUT
+ *          the lengths of the outgoing paths are calculated.
+ *        \cli IGRAPH_IN
+ *          the lengths of the incoming paths are calculated.
+ *        \cli IGRAPH_ALL
+ *          the directed graph is considered as an
+ *          undirected one for the computation.
+ *        \endclist
+ * \param weights An optional vector containing positive edge weights
+ *        for weighted harmonic centrality. Supply a null pointer here
+ *        for unweighted harmonic centrality.
+ * \param normalized Boolean, whether to divide the results by the
+ *        number of vertices minus one.
+ * \return Error code:
+ *        \clist
+ *        \cli IGRAPH_ENOMEM
+ *           not enough memory for temporary data.
+ *        \cli IGRAPH_EINVVID
+ *           invalid vertex id passed.
+ *        \cli IGRAPH_EINVMODE
+ *           invalid mode argument.
+ *        \cli IGRAPH_EINVAL
+ *           invalid weight vector.
+ *        \endclist
+ *
+ * Time complexity: O(n|E|), n is the number of vertices for which the
+ * calculation is done and |E| is the number of edges in the graph,
+ * for unweighted graphs. O(n|E|log|V|) for weighted graphs.
+ *
+ * \sa \ref igraph_closeness(), \ref igraph_harmonic_centrality_estimate().
+ */
+int igraph_harmonic_centrality(const igraph_t *graph, igraph_vector_t *res,
+                               const igraph_vs_t vids, igraph_neimode_t mode,
+                               const igraph_vector_t *weights,
+                               igraph_bool_t normalized) {
+    return igraph_harmonic_centrality_estimate(graph, res, vids, mode, -1,
+            weights, normalized);
+}
 
-            /* check the neighbors */
-            neis = igraph_adjlist_get(&allneis, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_counted)[neighbor] == i + 1) {
-                    continue;
-                }
-                VECTOR(already_counted)[neighbor] = i + 1;
-                nodes_reached++;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-            }
-        }
+/**
+ * \ingroup structural
+ * \function igraph_harmonic_centrality_estimate
+ * \brief Harmonic centrality, considering only short paths.
+ *
+ * </para><para>
+ * This function is like \ref igraph_harmonic_centrality(), but the
+ * vertices farther than \p cutoff are treated as if they were
+ * unreachable, i.e. they add zero to the sum. The result is a lower
+ * bound of the harmonic centrality.
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        estimated harmonic centrality scores for the given vertices.
+ * \param vids The vertices for which the harmonic centrality will be
+ *        estimated.
+ * \param mode The type of shortest paths to be used for the
+ *        calculation in directed graphs, \c IGRAPH_OUT, \c IGRAPH_IN
+ *        or \c IGRAPH_ALL, see \ref igraph_harmonic_centrality().
+ * \param cutoff The maximal length of paths that will be considered.
+ *        If zero or negative, the exact harmonic centrality will be
+ *        calculated (no upper limit on path lengths).
+ * \param weights An optional vector containing positive edge weights
+ *        for weighted harmonic centrality. Supply a null pointer here
+ *        for unweighted harmonic centrality.
+ * \param normalized Boolean, whether to divide the results by the
+ *        number of vertices minus one.
+ * \return Error code, see \ref igraph_harmonic_centrality().
+ *
+ * Time complexity: O(n|E|), n is the number of vertices for which the
+ * calculation is done and |E| is the number of edges in the graph,
+ * for unweighted graphs. O(n|E|log|V|) for weighted graphs. The
+ * cutoff usually makes it much faster.
+ *
+ * \sa \ref igraph_closeness_estimate().
+ */
+int igraph_harmonic_centrality_estimate(const igraph_t *graph,
+                                        igraph_vector_t *res,
+                                        const igraph_vs_t vids,
+                                        igraph_neimode_t mode,
+                                        igraph_real_t cutoff,
+                                        const igraph_vector_t *weights,
+                                        igraph_bool_t normalized) {
 
-        /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
-        VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
-        VECTOR(*res)[i] = (no_of_nodes - 1) / VECTOR(*res)[i];
+    long int no_of_nodes = igraph_vcount(graph);
 
-        if (((cutoff > 0 && actdist < cutoff) || cutoff <= 0) &&
-            no_of_nodes > nodes_reached && !warning_shown) {
-            IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
-            warning_shown = 1;
-        }
-    }
+    IGRAPH_CHECK(igraph_i_closeness(graph, res, vids, mode, cutoff, weights,
+                                    /*harmonic=*/ 1));
 
-    if (!normalized) {
-        for (i = 0; i < nodes_to_calc; i++) {
-            VECTOR(*res)[i] /= (no_of_nodes - 1);
-        }
+    if (normalized && no_of_nodes > 1) {
+        igraph_vector_scale(res, 1.0 / (no_of_nodes - 1));
     }
 
-    IGRAPH_PROGRESS("Closeness: ", 100.0, NULL);
-
-    /* Clean */
-    igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&already_counted);
-    igraph_vit_destroy(&vit);
-    igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_PROGRESS("Harmonic centrality: ", 100.0, NULL);
 
     return 0;
 }
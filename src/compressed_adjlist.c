@@ -0,0 +1,767 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_adjlist.h"
+#include "igraph_interface.h"
+#include "igraph_constructors.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+
+#include <limits.h>
+#include <math.h>
+
+/**
+ * \section about_compressed
+ *
+ * <para>A compressed graph, <type>igraph_compressed_t</type>, is an
+ * immutable copy of a graph that needs much less memory than the
+ * graph itself. The sorted neighbor list of every vertex is stored as
+ * the differences of consecutive neighbor ids, each of them encoded
+ * in a variable number of bytes, seven bits per byte. Small
+ * differences, which are common if the vertices are numbered with
+ * locality in mind, see \ref igraph_reorder_vertices(), need a single
+ * byte. The neighbors are decoded on the fly while iterating over
+ * them with an <type>igraph_compressed_nit_t</type> iterator.</para>
+ *
+ * <para>Breadth-first search, weakly connected components and PageRank
+ * are implemented directly on compressed graphs. Other algorithms can
+ * be run on the graph restored by \ref igraph_compressed_get_graph().
+ * Edge ids are not stored.</para>
+ */
+
+/* The neighbor list of vertex v starts at byte base[v >> SHIFT] +
+   offset[v]. The list is the number of neighbors, the first neighbor
+   relative to v, zigzag encoded, and the gaps between the following
+   neighbors, all as unsigned LEB128 varints. */
+
+#define IGRAPH_I_COMPRESSED_SHIFT 8
+#define IGRAPH_I_COMPRESSED_MASK ((1L << IGRAPH_I_COMPRESSED_SHIFT) - 1)
+
+#define IGRAPH_I_COMPRESSED_START(adj,v) \
+    ((const unsigned char *) VECTOR((adj)->data) + \
+     VECTOR((adj)->base)[(v) >> IGRAPH_I_COMPRESSED_SHIFT] + \
+     VECTOR((adj)->offset)[(v)])
+
+static int igraph_i_compressed_put(igraph_vector_char_t *data,
+                                   unsigned long int x) {
+    while (x >= 0x80) {
+        IGRAPH_CHECK(igraph_vector_char_push_back(data, (char) ((x & 0x7f) | 0x80)));
+        x >>= 7;
+    }
+    IGRAPH_CHECK(igraph_vector_char_push_back(data, (char) x));
+    return 0;
+}
+
+static unsigned long int igraph_i_compressed_get(const unsigned char **pos) {
+    const unsigned char *p = *pos;
+    unsigned long int x = *p & 0x7f;
+    int shift = 7;
+    while (*p++ & 0x80) {
+        x |= (unsigned long int) (*p & 0x7f) << shift;
+        shift += 7;
+    }
+    *pos = p;
+    return x;
+}
+
+static void igraph_i_compressed_adj_destroy(igraph_compressed_adj_t *adj) {
+    igraph_vector_char_destroy(&adj->data);
+    igraph_vector_long_destroy(&adj->base);
+    igraph_vector_int_destroy(&adj->offset);
+}
+
+/* For IGRAPH_ALL, the out-neighbors of a vertex in an undirected graph
+   are not larger than the vertex and the in-neighbors are not smaller,
+   so the two lists together are sorted. This is only used for
+   undirected graphs. */
+
+static int igraph_i_compressed_adj_init(const igraph_t *graph,
+                                        igraph_compressed_adj_t *adj,
+                                        igraph_neimode_t mode) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int v, i, j;
+
+    IGRAPH_CHECK(igraph_vector_char_init(&adj->data, 0));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &adj->data);
+    IGRAPH_CHECK(igraph_vector_long_init(&adj->base,
+                                         (no_of_nodes >> IGRAPH_I_COMPRESSED_SHIFT) + 1));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &adj->base);
+    IGRAPH_CHECK(igraph_vector_int_init(&adj->offset, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &adj->offset);
+    IGRAPH_CHECK(igraph_vector_char_reserve(&adj->data, no_of_nodes +
+                                            (mode == IGRAPH_ALL ? 2 : 1) * igraph_ecount(graph)));
+
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_incident_view_t views[2];
+        int no_of_views = mode == IGRAPH_ALL ? 2 : 1;
+        long int size = igraph_vector_char_size(&adj->data);
+        long int degree = 0, prev = -1;
+
+        if ((v & IGRAPH_I_COMPRESSED_MASK) == 0) {
+            VECTOR(adj->base)[v >> IGRAPH_I_COMPRESSED_SHIFT] = size;
+        }
+        size -= VECTOR(adj->base)[v >> IGRAPH_I_COMPRESSED_SHIFT];
+        if (size > INT_MAX) {
+            IGRAPH_ERROR("Compressed adjacency list is too large", IGRAPH_EOVERFLOW);
+        }
+        VECTOR(adj->offset)[v] = (int) size;
+
+        IGRAPH_CHECK(igraph_incident_view(graph, &views[0], (igraph_integer_t) v,
+                                          mode == IGRAPH_ALL ? IGRAPH_OUT : mode));
+        if (mode == IGRAPH_ALL) {
+            IGRAPH_CHECK(igraph_incident_view(graph, &views[1], (igraph_integer_t) v,
+                                              IGRAPH_IN));
+        }
+
+        for (j = 0; j < no_of_views; j++) {
+            for (i = 0; i < IGRAPH_VIEW_SIZE(views[j]); i++) {
+                if (!IGRAPH_VIEW_DELETED(views[j], i)) {
+                    degree++;
+                }
+            }
+        }
+        IGRAPH_CHECK(igraph_i_compressed_put(&adj->data, (unsigned long int) degree));
+
+        for (j = 0; j < no_of_views; j++) {
+            for (i = 0; i < IGRAPH_VIEW_SIZE(views[j]); i++) {
+                long int nei;
+                if (IGRAPH_VIEW_DELETED(views[j], i)) {
+                    continue;
+                }
+                nei = IGRAPH_VIEW_NEIGHBOR(views[j], i);
+                if (prev < 0) {
+                    long int diff = nei - v;
+                    IGRAPH_CHECK(igraph_i_compressed_put(&adj->data, diff < 0 ?
+                                                         ((unsigned long int) (-diff) << 1) - 1 :
+                                                         (unsigned long int) diff << 1));
+                } else {
+                    IGRAPH_CHECK(igraph_i_compressed_put(&adj->data,
+                                                         (unsigned long int) (nei - prev)));
+                }
+                prev = nei;
+            }
+        }
+    }
+
+    IGRAPH_FINALLY_CLEAN(3);
+    return 0;
+}
+
+/* Sets up 'nit' without checking the arguments, 'mode' is ignored for
+   undirected graphs */
+
+static void igraph_i_compressed_nit_create(const igraph_compressed_t *cg,
+        igraph_compressed_nit_t *nit,
+        long int vid, igraph_neimode_t mode) {
+    const igraph_compressed_adj_t *adj =
+        cg->directed && mode == IGRAPH_IN ? &cg->in : &cg->out;
+
+    nit->pos = IGRAPH_I_COMPRESSED_START(adj, vid);
+    nit->remaining = (long int) igraph_i_compressed_get(&nit->pos);
+    nit->last = -1;
+    nit->vid = vid;
+    nit->pos2 = 0;
+    nit->remaining2 = 0;
+    if (cg->directed && mode == IGRAPH_ALL) {
+        nit->pos2 = IGRAPH_I_COMPRESSED_START(&cg->in, vid);
+        nit->remaining2 = (long int) igraph_i_compressed_get(&nit->pos2);
+    }
+}
+
+static igraph_bool_t igraph_i_compressed_nit_next(igraph_compressed_nit_t *nit,
+        long int *nei) {
+    if (nit->remaining == 0) {
+        if (nit->remaining2 == 0) {
+            return 0;
+        }
+        nit->pos = nit->pos2;
+        nit->remaining = nit->remaining2;
+        nit->remaining2 = 0;
+        nit->last = -1;
+    }
+    if (nit->last < 0) {
+        unsigned long int z = igraph_i_compressed_get(&nit->pos);
+        nit->last = nit->vid + ((z & 1) ? -(long int) ((z + 1) >> 1) : (long int) (z >> 1));
+    } else {
+        nit->last += (long int) igraph_i_compressed_get(&nit->pos);
+    }
+    nit->remaining--;
+    *nei = nit->last;
+    return 1;
+}
+
+/**
+ * \function igraph_compressed_init
+ * \brief Creates a compressed copy of a graph.
+ *
+ * </para><para>
+ * Edges and vertices marked as deleted, see \ref
+ * igraph_delete_edges_deferred(), are not included. The compressed
+ * graph does not depend on \p graph, which may be destroyed.
+ *
+ * \param graph The input graph.
+ * \param cg Pointer to an uninitialized compressed graph object.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ *
+ * \example examples/tests/igraph_compressed.c
+ */
+
+int igraph_compressed_init(const igraph_t *graph, igraph_compressed_t *cg) {
+
+    cg->n = igraph_vcount(graph);
+    cg->m = igraph_ecount(graph) - igraph_deleted_ecount(graph);
+    cg->directed = igraph_is_directed(graph);
+
+    if (cg->directed) {
+        IGRAPH_CHECK(igraph_i_compressed_adj_init(graph, &cg->out, IGRAPH_OUT));
+        IGRAPH_FINALLY(igraph_i_compressed_adj_destroy, &cg->out);
+        IGRAPH_CHECK(igraph_i_compressed_adj_init(graph, &cg->in, IGRAPH_IN));
+        IGRAPH_FINALLY_CLEAN(1);
+    } else {
+        IGRAPH_CHECK(igraph_i_compressed_adj_init(graph, &cg->out, IGRAPH_ALL));
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_destroy
+ * \brief Frees the memory used by a compressed graph.
+ *
+ * \param cg The compressed graph.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_compressed_destroy(igraph_compressed_t *cg) {
+    igraph_i_compressed_adj_destroy(&cg->out);
+    if (cg->directed) {
+        igraph_i_compressed_adj_destroy(&cg->in);
+    }
+}
+
+/**
+ * \function igraph_compressed_vcount
+ * \brief The number of vertices in a compressed graph.
+ *
+ * \param cg The compressed graph.
+ * \return The number of vertices.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_compressed_vcount(const igraph_compressed_t *cg) {
+    return cg->n;
+}
+
+/**
+ * \function igraph_compressed_ecount
+ * \brief The number of edges in a compressed graph.
+ *
+ * \param cg The compressed graph.
+ * \return The number of edges.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_compressed_ecount(const igraph_compressed_t *cg) {
+    return cg->m;
+}
+
+/**
+ * \function igraph_compressed_is_directed
+ * \brief Whether a compressed graph is directed.
+ *
+ * \param cg The compressed graph.
+ * \return Logical value, true if the graph is directed.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_bool_t igraph_compressed_is_directed(const igraph_compressed_t *cg) {
+    return cg->directed;
+}
+
+/**
+ * \function igraph_compressed_memory
+ * \brief The memory used by a compressed graph.
+ *
+ * \param cg The compressed graph.
+ * \return The number of bytes used by the encoded neighbor lists and
+ *   their index.
+ *
+ * Time complexity: O(1).
+ */
+
+size_t igraph_compressed_memory(const igraph_compressed_t *cg) {
+    size_t size = sizeof(igraph_compressed_t);
+    int i;
+    for (i = 0; i < (cg->directed ? 2 : 1); i++) {
+        const igraph_compressed_adj_t *adj = i == 0 ? &cg->out : &cg->in;
+        size += (size_t) igraph_vector_char_size(&adj->data) * sizeof(char) +
+                (size_t) igraph_vector_long_size(&adj->base) * sizeof(long int) +
+                (size_t) igraph_vector_int_size(&adj->offset) * sizeof(int);
+    }
+    return size;
+}
+
+/**
+ * \function igraph_compressed_degree
+ * \brief The degree of a vertex in a compressed graph.
+ *
+ * \param cg The compressed graph.
+ * \param res Pointer to an integer, the degree is stored here.
+ * \param vid The vertex id.
+ * \param mode For directed graphs \c IGRAPH_OUT gives the out-degree,
+ *   \c IGRAPH_IN the in-degree and \c IGRAPH_ALL their sum. Ignored
+ *   for undirected graphs.
+ * \return Error code: \c IGRAPH_EINVVID for an invalid vertex id,
+ *   \c IGRAPH_EINVMODE for an invalid mode.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_compressed_degree(const igraph_compressed_t *cg, igraph_integer_t *res,
+                             igraph_integer_t vid, igraph_neimode_t mode) {
+    const unsigned char *pos;
+    long int v = vid;
+
+    if (v < 0 || v >= cg->n) {
+        IGRAPH_ERROR("Invalid vertex id for compressed graph degree", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode for compressed graph degree", IGRAPH_EINVMODE);
+    }
+
+    pos = IGRAPH_I_COMPRESSED_START(cg->directed && mode == IGRAPH_IN ?
+                                    &cg->in : &cg->out, v);
+    *res = (igraph_integer_t) igraph_i_compressed_get(&pos);
+    if (cg->directed && mode == IGRAPH_ALL) {
+        pos = IGRAPH_I_COMPRESSED_START(&cg->in, v);
+        *res += (igraph_integer_t) igraph_i_compressed_get(&pos);
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_nit_create
+ * \brief Creates an iterator over the neighbors of a vertex.
+ *
+ * </para><para>
+ * The neighbors are returned in increasing order of their ids. For
+ * \c IGRAPH_ALL on directed graphs the out-neighbors come first, then
+ * the in-neighbors, both in increasing order. A neighbor is returned
+ * as many times as there are edges to it, loops appear twice in
+ * undirected graphs, like in \ref igraph_neighbors().
+ *
+ * </para><para>
+ * The iterator stays valid as long as the compressed graph exists.
+ *
+ * \param cg The compressed graph.
+ * \param nit Pointer to an iterator object, it is initialized here.
+ * \param vid The vertex id.
+ * \param mode \c IGRAPH_OUT, \c IGRAPH_IN or \c IGRAPH_ALL for
+ *   directed graphs, ignored for undirected ones.
+ * \return Error code: \c IGRAPH_EINVVID for an invalid vertex id,
+ *   \c IGRAPH_EINVMODE for an invalid mode.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_compressed_nit_create(const igraph_compressed_t *cg,
+                                 igraph_compressed_nit_t *nit,
+                                 igraph_integer_t vid, igraph_neimode_t mode) {
+    if (vid < 0 || vid >= cg->n) {
+        IGRAPH_ERROR("Invalid vertex id for compressed neighbor iterator",
+                     IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode for compressed neighbor iterator",
+                     IGRAPH_EINVMODE);
+    }
+    igraph_i_compressed_nit_create(cg, nit, vid, mode);
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_nit_next
+ * \brief Steps a compressed neighbor iterator.
+ *
+ * \param nit The iterator.
+ * \param nei Pointer to an integer, the next neighbor is stored here.
+ * \return True if there was a next neighbor, false at the end of the
+ *   neighbor list.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_bool_t igraph_compressed_nit_next(igraph_compressed_nit_t *nit,
+        igraph_integer_t *nei) {
+    long int n;
+    if (!igraph_i_compressed_nit_next(nit, &n)) {
+        return 0;
+    }
+    *nei = (igraph_integer_t) n;
+    return 1;
+}
+
+/**
+ * \function igraph_compressed_get_graph
+ * \brief Restores the graph from a compressed graph.
+ *
+ * </para><para>
+ * The edges of the new graph are ordered by their first endpoint and
+ * then their second endpoint, the edge ids of the original graph are
+ * not kept. Attributes are not kept either.
+ *
+ * \param cg The compressed graph.
+ * \param graph Pointer to an uninitialized graph object.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|).
+ */
+
+int igraph_compressed_get_graph(const igraph_compressed_t *cg, igraph_t *graph) {
+    igraph_vector_t edges;
+    igraph_compressed_nit_t nit;
+    long int v, nei, p = 0;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&edges, 2 * (long int) cg->m);
+
+    for (v = 0; v < cg->n; v++) {
+        long int loops = 0;
+        igraph_i_compressed_nit_create(cg, &nit, v, IGRAPH_OUT);
+        while (igraph_i_compressed_nit_next(&nit, &nei)) {
+            /* Undirected edges are in the lists of both endpoints */
+            if (!cg->directed && nei <= v) {
+                if (nei < v || loops++ % 2 == 1) {
+                    continue;
+                }
+            }
+            VECTOR(edges)[p++] = v;
+            VECTOR(edges)[p++] = nei;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_create(graph, &edges, cg->n, cg->directed));
+    igraph_vector_destroy(&edges);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_bfs
+ * \brief Breadth-first search on a compressed graph.
+ *
+ * </para><para>
+ * This is the same search as \ref igraph_bfs() from a single root with
+ * \c unreachable set to false, decoding the neighbor lists on the fly.
+ * The vertices that are not reachable from \p root have \c NaN in the
+ * result vectors.
+ *
+ * \param cg The compressed graph.
+ * \param root The id of the root vertex.
+ * \param mode For directed graphs, \c IGRAPH_OUT follows the edges,
+ *   \c IGRAPH_IN follows them backwards, and \c IGRAPH_ALL ignores
+ *   their direction. Ignored for undirected graphs.
+ * \param order If not a null pointer, the vertex ids are stored here
+ *   in the order they were visited.
+ * \param father If not a null pointer, the father of each vertex in
+ *   the search tree is stored here, -1 for the root.
+ * \param dist If not a null pointer, the distance of each vertex from
+ *   the root is stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|).
+ */
+
+int igraph_compressed_bfs(const igraph_compressed_t *cg, igraph_integer_t root,
+                          igraph_neimode_t mode, igraph_vector_t *order,
+                          igraph_vector_t *father, igraph_vector_t *dist) {
+    long int no_of_nodes = cg->n;
+    long int head = 0, tail = 0, levelend = 1, actdist = 0, i;
+    igraph_vector_long_t queue;
+    igraph_compressed_nit_t nit;
+    char *added;
+
+    if (root < 0 || root >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid root vertex in compressed BFS", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    added = igraph_Calloc(no_of_nodes, char);
+    if (added == 0) {
+        IGRAPH_ERROR("Cannot run compressed BFS", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, added);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+
+#define VINIT(v) if (v) {                            \
+        IGRAPH_CHECK(igraph_vector_resize((v), no_of_nodes)); \
+        igraph_vector_fill((v), IGRAPH_NAN); }
+
+    VINIT(order);
+    VINIT(father);
+    VINIT(dist);
+
+#undef VINIT
+
+    VECTOR(queue)[tail++] = root;
+    added[(long int) root] = 1;
+    if (father) {
+        VECTOR(*father)[(long int) root] = -1;
+    }
+
+    while (head < tail) {
+        long int actnode, nei;
+        if (head == levelend) {
+            actdist++;
+            levelend = tail;
+        }
+        actnode = VECTOR(queue)[head++];
+        if (dist) {
+            VECTOR(*dist)[actnode] = actdist;
+        }
+        igraph_i_compressed_nit_create(cg, &nit, actnode, mode);
+        while (igraph_i_compressed_nit_next(&nit, &nei)) {
+            if (!added[nei]) {
+                added[nei] = 1;
+                VECTOR(queue)[tail++] = nei;
+                if (father) {
+                    VECTOR(*father)[nei] = actnode;
+                }
+            }
+        }
+        if (head % 1024 == 0) {
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+    }
+
+    if (order) {
+        for (i = 0; i < tail; i++) {
+            VECTOR(*order)[i] = VECTOR(queue)[i];
+        }
+    }
+
+    igraph_vector_long_destroy(&queue);
+    igraph_Free(added);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_clusters
+ * \brief Weakly connected components of a compressed graph.
+ *
+ * </para><para>
+ * The components are numbered the same way as by \ref
+ * igraph_clusters() with \c IGRAPH_WEAK.
+ *
+ * \param cg The compressed graph.
+ * \param membership If not a null pointer, the component id of each
+ *   vertex is stored here.
+ * \param csize If not a null pointer, the size of each component is
+ *   stored here.
+ * \param no If not a null pointer, the number of components is stored
+ *   here.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|).
+ */
+
+int igraph_compressed_clusters(const igraph_compressed_t *cg,
+                               igraph_vector_t *membership,
+                               igraph_vector_t *csize,
+                               igraph_integer_t *no) {
+    long int no_of_nodes = cg->n;
+    long int no_of_clusters = 0, v;
+    igraph_vector_long_t queue;
+    igraph_compressed_nit_t nit;
+    char *added;
+
+    added = igraph_Calloc(no_of_nodes, char);
+    if (added == 0) {
+        IGRAPH_ERROR("Cannot find compressed graph components", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, added);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+
+    if (membership) {
+        IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
+    }
+    if (csize) {
+        igraph_vector_clear(csize);
+    }
+
+    for (v = 0; v < no_of_nodes; v++) {
+        long int head = 0, tail = 0;
+
+        if (added[v]) {
+            continue;
+        }
+
+        VECTOR(queue)[tail++] = v;
+        added[v] = 1;
+        while (head < tail) {
+            long int actnode = VECTOR(queue)[head++], nei;
+            if (membership) {
+                VECTOR(*membership)[actnode] = no_of_clusters;
+            }
+            igraph_i_compressed_nit_create(cg, &nit, actnode, IGRAPH_ALL);
+            while (igraph_i_compressed_nit_next(&nit, &nei)) {
+                if (!added[nei]) {
+                    added[nei] = 1;
+                    VECTOR(queue)[tail++] = nei;
+                }
+            }
+        }
+
+        if (csize) {
+            IGRAPH_CHECK(igraph_vector_push_back(csize, tail));
+        }
+        no_of_clusters++;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    if (no) {
+        *no = (igraph_integer_t) no_of_clusters;
+    }
+
+    igraph_vector_long_destroy(&queue);
+    igraph_Free(added);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_pagerank
+ * \brief PageRank of the vertices of a compressed graph.
+ *
+ * </para><para>
+ * The PageRank is calculated with power iteration, decoding the
+ * neighbor lists in every iteration, until the sum of the absolute
+ * changes drops below 1e-10. The random surfer jumps to a uniformly
+ * chosen vertex from vertices without out-edges, like in \ref
+ * igraph_pagerank(), so the results agree with it up to this
+ * precision.
+ *
+ * \param cg The compressed graph.
+ * \param vector Pointer to an initialized vector, the PageRank scores
+ *   are stored here, they sum up to one.
+ * \param value Pointer to a real, the eigenvalue, which is always one,
+ *   is stored here. It may be a null pointer.
+ * \param damping The damping factor, between zero and one.
+ * \param directed Whether to consider edge directions in directed
+ *   graphs. Ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(k(|V|+|E|)), k is the number of iterations.
+ */
+
+int igraph_compressed_pagerank(const igraph_compressed_t *cg,
+                               igraph_vector_t *vector,
+                               igraph_real_t *value,
+                               igraph_real_t damping,
+                               igraph_bool_t directed) {
+    long int no_of_nodes = cg->n;
+    igraph_neimode_t inmode = directed ? IGRAPH_IN : IGRAPH_ALL;
+    igraph_neimode_t outmode = directed ? IGRAPH_OUT : IGRAPH_ALL;
+    igraph_vector_t degree, scaled, next;
+    igraph_compressed_nit_t nit;
+    long int i, iter;
+
+    if (damping < 0 || damping > 1) {
+        IGRAPH_ERROR("The PageRank damping factor must be in [0,1]", IGRAPH_EINVAL);
+    }
+
+    if (value) {
+        *value = 1.0;
+    }
+    IGRAPH_CHECK(igraph_vector_resize(vector, no_of_nodes));
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&scaled, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&next, no_of_nodes);
+
+    for (i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t d;
+        IGRAPH_CHECK(igraph_compressed_degree(cg, &d, (igraph_integer_t) i, outmode));
+        VECTOR(degree)[i] = d;
+    }
+    igraph_vector_fill(vector, 1.0 / no_of_nodes);
+
+    for (iter = 0; iter < 10000; iter++) {
+        igraph_real_t dangling = 0, base, diff = 0;
+        long int nei;
+
+        for (i = 0; i < no_of_nodes; i++) {
+            if (VECTOR(degree)[i] == 0) {
+                dangling += VECTOR(*vector)[i];
+                VECTOR(scaled)[i] = 0;
+            } else {
+                VECTOR(scaled)[i] = VECTOR(*vector)[i] / VECTOR(degree)[i];
+            }
+        }
+        base = (1 - damping) / no_of_nodes + damping * dangling / no_of_nodes;
+
+        for (i = 0; i < no_of_nodes; i++) {
+            igraph_real_t sum = 0;
+            igraph_i_compressed_nit_create(cg, &nit, i, inmode);
+            while (igraph_i_compressed_nit_next(&nit, &nei)) {
+                sum += VECTOR(scaled)[nei];
+            }
+            VECTOR(next)[i] = base + damping * sum;
+            diff += fabs(VECTOR(next)[i] - VECTOR(*vector)[i]);
+        }
+
+        IGRAPH_CHECK(igraph_vector_update(vector, &next));
+        if (diff < 1e-10) {
+            break;
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    igraph_vector_scale(vector, 1.0 / igraph_vector_sum(vector));
+
+    igraph_vector_destroy(&next);
+    igraph_vector_destroy(&scaled);
+    igraph_vector_destroy(&degree);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
@@ -0,0 +1,1305 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_progress.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_types_internal.h"
+
+#include <string.h>
+
+/**
+ * \section about_contraction_hierarchies
+ *
+ * <para>A contraction hierarchy answers shortest path queries in a
+ * static weighted graph much faster than Dijkstra's algorithm, after
+ * some preprocessing. The vertices are ordered by importance and
+ * contracted one by one, from the least important one: contracting a
+ * vertex removes it from the graph, and adds a shortcut edge between
+ * two of its neighbors if the only shortest path between them went
+ * through it. A query then runs two Dijkstra searches, from the source
+ * and from the target, that only follow edges towards more important
+ * vertices, and they usually settle a few hundred vertices even in
+ * graphs with millions of vertices. The technique works best on road
+ * networks and similar graphs; on graphs with a small diameter and
+ * high degree vertices the preprocessing adds many shortcuts.</para>
+ *
+ * <para>The hierarchy does not refer to the graph after it is built,
+ * it can be saved to a file with \ref
+ * igraph_contraction_hierarchy_write() and loaded with \ref
+ * igraph_contraction_hierarchy_read(), so the preprocessing is not
+ * repeated. The queries reuse a workspace that is stored in the
+ * hierarchy, so a hierarchy must not be queried from several threads
+ * at once.</para>
+ */
+
+/* Witness searches settle at most this many vertices, if no witness
+   path is found within this limit, a shortcut is added, even if it is
+   not needed. The searches that only estimate the number of shortcuts
+   for the contraction order are shorter. */
+#define IGRAPH_I_CH_WITNESS_LIMIT 500
+#define IGRAPH_I_CH_SIMULATE_LIMIT 5
+
+/* The second part of an arc that was replaced by a shorter shortcut
+   while building the hierarchy */
+#define IGRAPH_I_CH_DEAD (-2)
+
+/* A Dijkstra search whose labels are reset in constant time: a label
+   is valid if its stamp is the current mark. The heap may contain
+   outdated entries, they are skipped. */
+
+typedef struct igraph_i_ch_search_t {
+    igraph_real_t *dist;
+    int *parent;
+    long int *stamp;
+    long int mark;
+    igraph_indheap_t heap;
+} igraph_i_ch_search_t;
+
+struct igraph_i_ch_workspace_t {
+    igraph_i_ch_search_t search[2];
+};
+
+static int igraph_i_ch_search_init(igraph_i_ch_search_t *s, long int n) {
+    s->mark = 0;
+    s->dist = igraph_Calloc(n > 0 ? n : 1, igraph_real_t);
+    if (s->dist == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s->dist);
+    s->parent = igraph_Calloc(n > 0 ? n : 1, int);
+    if (s->parent == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s->parent);
+    s->stamp = igraph_Calloc(n > 0 ? n : 1, long int);
+    if (s->stamp == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s->stamp);
+    IGRAPH_CHECK(igraph_indheap_init(&s->heap, 16));
+    IGRAPH_FINALLY_CLEAN(3);
+    return 0;
+}
+
+static void igraph_i_ch_search_destroy(igraph_i_ch_search_t *s) {
+    igraph_indheap_destroy(&s->heap);
+    igraph_Free(s->stamp);
+    igraph_Free(s->parent);
+    igraph_Free(s->dist);
+}
+
+#define IGRAPH_I_CH_DIST(s,v) \
+    ((s)->stamp[(v)] == (s)->mark ? (s)->dist[(v)] : IGRAPH_INFINITY)
+
+static void igraph_i_ch_search_reset(igraph_i_ch_search_t *s) {
+    s->mark++;
+    igraph_indheap_clear(&s->heap);
+}
+
+static int igraph_i_ch_search_label(igraph_i_ch_search_t *s, long int v,
+                                    igraph_real_t dist, int parent) {
+    s->stamp[v] = s->mark;
+    s->dist[v] = dist;
+    s->parent[v] = parent;
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&s->heap, v, -dist));
+    return 0;
+}
+
+/* Removes the outdated entries from the top of the heap, and returns
+   the distance of the next vertex to settle, or infinity */
+
+static igraph_real_t igraph_i_ch_search_top(igraph_i_ch_search_t *s) {
+    while (!igraph_indheap_empty(&s->heap)) {
+        long int v = igraph_indheap_max_index(&s->heap);
+        igraph_real_t d = -igraph_indheap_max(&s->heap);
+        if (d <= s->dist[v]) {
+            return d;
+        }
+        igraph_indheap_delete_max(&s->heap);
+    }
+    return IGRAPH_INFINITY;
+}
+
+static void igraph_i_ch_workspace_destroy(struct igraph_i_ch_workspace_t *work) {
+    igraph_i_ch_search_destroy(&work->search[1]);
+    igraph_i_ch_search_destroy(&work->search[0]);
+    igraph_Free(work);
+}
+
+static int igraph_i_ch_workspace_init(igraph_contraction_hierarchy_t *ch) {
+    struct igraph_i_ch_workspace_t *work;
+    work = igraph_Calloc(1, struct igraph_i_ch_workspace_t);
+    if (work == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, work);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&work->search[0], ch->n));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &work->search[0]);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&work->search[1], ch->n));
+    IGRAPH_FINALLY_CLEAN(2);
+    ch->work = work;
+    return 0;
+}
+
+static int igraph_i_ch_vectors_init(igraph_contraction_hierarchy_t *ch) {
+    ch->work = 0;
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->rank, ch->n));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->rank);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->arc_from, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->arc_from);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->arc_to, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->arc_to);
+    IGRAPH_CHECK(igraph_vector_init(&ch->arc_weight, 0));
+    IGRAPH_FINALLY(igraph_vector_destroy, &ch->arc_weight);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->arc_first, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->arc_first);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->arc_second, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->arc_second);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->up_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->up_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->up_arcs, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->up_arcs);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->down_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->down_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->down_arcs, 0));
+    IGRAPH_FINALLY_CLEAN(9);
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_destroy
+ * \brief Frees the memory of a contraction hierarchy.
+ *
+ * \param ch The contraction hierarchy to destroy.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_contraction_hierarchy_destroy(igraph_contraction_hierarchy_t *ch) {
+    if (ch->work) {
+        igraph_i_ch_workspace_destroy(ch->work);
+        ch->work = 0;
+    }
+    igraph_vector_int_destroy(&ch->down_arcs);
+    igraph_vector_int_destroy(&ch->down_start);
+    igraph_vector_int_destroy(&ch->up_arcs);
+    igraph_vector_int_destroy(&ch->up_start);
+    igraph_vector_int_destroy(&ch->arc_second);
+    igraph_vector_int_destroy(&ch->arc_first);
+    igraph_vector_destroy(&ch->arc_weight);
+    igraph_vector_int_destroy(&ch->arc_to);
+    igraph_vector_int_destroy(&ch->arc_from);
+    igraph_vector_int_destroy(&ch->rank);
+}
+
+/* Sorts the arcs into the upward arcs of their lower ranked tail and
+   the downward arcs of their lower ranked head, these are followed by
+   the forward and the backward searches */
+
+static int igraph_i_ch_index(igraph_contraction_hierarchy_t *ch) {
+    long int n = ch->n, no_of_arcs = igraph_vector_int_size(&ch->arc_from);
+    long int a, v;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->up_start, n + 1));
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->down_start, n + 1));
+    igraph_vector_int_null(&ch->up_start);
+    igraph_vector_int_null(&ch->down_start);
+    for (a = 0; a < no_of_arcs; a++) {
+        long int from = VECTOR(ch->arc_from)[a], to = VECTOR(ch->arc_to)[a];
+        if (VECTOR(ch->rank)[from] < VECTOR(ch->rank)[to]) {
+            VECTOR(ch->up_start)[from + 1] += 1;
+        } else {
+            VECTOR(ch->down_start)[to + 1] += 1;
+        }
+    }
+    for (v = 0; v < n; v++) {
+        VECTOR(ch->up_start)[v + 1] += VECTOR(ch->up_start)[v];
+        VECTOR(ch->down_start)[v + 1] += VECTOR(ch->down_start)[v];
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->up_arcs, VECTOR(ch->up_start)[n]));
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->down_arcs, VECTOR(ch->down_start)[n]));
+    for (a = 0; a < no_of_arcs; a++) {
+        long int from = VECTOR(ch->arc_from)[a], to = VECTOR(ch->arc_to)[a];
+        if (VECTOR(ch->rank)[from] < VECTOR(ch->rank)[to]) {
+            VECTOR(ch->up_arcs)[ VECTOR(ch->up_start)[from]++ ] = (int) a;
+        } else {
+            VECTOR(ch->down_arcs)[ VECTOR(ch->down_start)[to]++ ] = (int) a;
+        }
+    }
+    for (v = n; v > 0; v--) {
+        VECTOR(ch->up_start)[v] = VECTOR(ch->up_start)[v - 1];
+        VECTOR(ch->down_start)[v] = VECTOR(ch->down_start)[v - 1];
+    }
+    VECTOR(ch->up_start)[0] = 0;
+    VECTOR(ch->down_start)[0] = 0;
+
+    return 0;
+}
+
+/* -------------------------------------------------- */
+/* Preprocessing                                      */
+/* -------------------------------------------------- */
+
+/* The graph that is not contracted yet, the arcs of a vertex are the
+   ones between it and other uncontracted vertices */
+
+typedef struct igraph_i_ch_builder_t {
+    igraph_contraction_hierarchy_t *ch;
+    igraph_vector_int_t *out, *in;
+    igraph_vector_int_t deleted_neighbors;
+    igraph_vector_int_t neighbors;
+    igraph_i_ch_search_t witness;
+    long int *target;
+    long int target_mark;
+} igraph_i_ch_builder_t;
+
+static void igraph_i_ch_builder_destroy(igraph_i_ch_builder_t *b) {
+    long int v;
+    for (v = 0; v < b->ch->n; v++) {
+        igraph_vector_int_destroy(&b->out[v]);
+        igraph_vector_int_destroy(&b->in[v]);
+    }
+    igraph_Free(b->out);
+    igraph_Free(b->in);
+    igraph_Free(b->target);
+    igraph_vector_int_destroy(&b->deleted_neighbors);
+    igraph_vector_int_destroy(&b->neighbors);
+    igraph_i_ch_search_destroy(&b->witness);
+}
+
+static int igraph_i_ch_builder_init(igraph_i_ch_builder_t *b,
+                                    igraph_contraction_hierarchy_t *ch) {
+    long int n = ch->n, v;
+
+    b->ch = ch;
+    b->target_mark = 0;
+    IGRAPH_CHECK(igraph_i_ch_search_init(&b->witness, n));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &b->witness);
+    b->target = igraph_Calloc(n > 0 ? n : 1, long int);
+    if (b->target == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, b->target);
+    IGRAPH_CHECK(igraph_vector_int_init(&b->neighbors, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &b->neighbors);
+    IGRAPH_CHECK(igraph_vector_int_init(&b->deleted_neighbors, n));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &b->deleted_neighbors);
+    /* zeroed vectors can be destroyed, even if not initialized */
+    b->out = igraph_Calloc(n > 0 ? n : 1, igraph_vector_int_t);
+    if (b->out == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, b->out);
+    b->in = igraph_Calloc(n > 0 ? n : 1, igraph_vector_int_t);
+    if (b->in == 0) {
+        IGRAPH_ERROR("Cannot create contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY(igraph_i_ch_builder_destroy, b);
+    for (v = 0; v < n; v++) {
+        IGRAPH_CHECK(igraph_vector_int_init(&b->out[v], 0));
+        IGRAPH_CHECK(igraph_vector_int_init(&b->in[v], 0));
+    }
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static void igraph_i_ch_remove_arc(igraph_vector_int_t *arcs, long int arc) {
+    long int i, n = igraph_vector_int_size(arcs);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(*arcs)[i] == arc) {
+            VECTOR(*arcs)[i] = VECTOR(*arcs)[n - 1];
+            igraph_vector_int_pop_back(arcs);
+            return;
+        }
+    }
+}
+
+/* Adds an arc, unless there is already an arc between the same
+   vertices that is not longer. A longer original arc is replaced in
+   place; a longer arc is replaced by a shortcut as a new arc, so that
+   a shortcut only refers to earlier arcs. The replaced arc is marked
+   dead and removed later; no shortcut refers to it, since an arc is
+   never replaced after one of its endpoints was contracted. */
+
+static int igraph_i_ch_add_arc(igraph_i_ch_builder_t *b, long int from,
+                               long int to, igraph_real_t weight,
+                               long int first, long int second) {
+    igraph_contraction_hierarchy_t *ch = b->ch;
+    igraph_vector_int_t *out = &b->out[from];
+    long int i, n = igraph_vector_int_size(out), arc;
+
+    for (i = 0; i < n; i++) {
+        arc = VECTOR(*out)[i];
+        if (VECTOR(ch->arc_to)[arc] == to) {
+            if (weight >= VECTOR(ch->arc_weight)[arc]) {
+                return 0;
+            }
+            if (second < 0) {
+                VECTOR(ch->arc_weight)[arc] = weight;
+                VECTOR(ch->arc_first)[arc] = (int) first;
+                VECTOR(ch->arc_second)[arc] = (int) second;
+                return 0;
+            }
+            VECTOR(ch->arc_second)[arc] = IGRAPH_I_CH_DEAD;
+            igraph_i_ch_remove_arc(out, arc);
+            igraph_i_ch_remove_arc(&b->in[to], arc);
+            break;
+        }
+    }
+
+    arc = igraph_vector_int_size(&ch->arc_from);
+    IGRAPH_CHECK(igraph_vector_int_push_back(&ch->arc_from, (int) from));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&ch->arc_to, (int) to));
+    IGRAPH_CHECK(igraph_vector_push_back(&ch->arc_weight, weight));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&ch->arc_first, (int) first));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&ch->arc_second, (int) second));
+    IGRAPH_CHECK(igraph_vector_int_push_back(out, (int) arc));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->in[to], (int) arc));
+
+    return 0;
+}
+
+/* Dijkstra search from 'source' in the uncontracted graph, avoiding
+   'avoid', up to distance 'limit', or until the 'no_of_targets' marked
+   vertices or 'max_settled' vertices are settled */
+
+static int igraph_i_ch_witness(igraph_i_ch_builder_t *b, long int source,
+                               long int avoid, igraph_real_t limit,
+                               long int no_of_targets, long int max_settled) {
+    igraph_contraction_hierarchy_t *ch = b->ch;
+    igraph_i_ch_search_t *s = &b->witness;
+    long int settled = 0;
+
+    igraph_i_ch_search_reset(s);
+    IGRAPH_CHECK(igraph_i_ch_search_label(s, source, 0, -1));
+
+    while (1) {
+        igraph_real_t d = igraph_i_ch_search_top(s);
+        long int v, i, n;
+        if (d > limit || ++settled > max_settled) {
+            break;
+        }
+        v = igraph_indheap_max_index(&s->heap);
+        igraph_indheap_delete_max(&s->heap);
+        if (b->target[v] == b->target_mark && --no_of_targets == 0) {
+            break;
+        }
+        n = igraph_vector_int_size(&b->out[v]);
+        for (i = 0; i < n; i++) {
+            long int arc = VECTOR(b->out[v])[i];
+            long int to = VECTOR(ch->arc_to)[arc];
+            igraph_real_t nd = d + VECTOR(ch->arc_weight)[arc];
+            if (to != avoid && nd < IGRAPH_I_CH_DIST(s, to)) {
+                IGRAPH_CHECK(igraph_i_ch_search_label(s, to, nd, -1));
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Adds the shortcuts needed to contract 'v', or if 'simulate' is true,
+   only counts them */
+
+static int igraph_i_ch_contract(igraph_i_ch_builder_t *b, long int v,
+                                igraph_bool_t simulate, long int *shortcuts) {
+    igraph_contraction_hierarchy_t *ch = b->ch;
+    igraph_vector_int_t *in = &b->in[v], *out = &b->out[v];
+    long int i, j, nin = igraph_vector_int_size(in);
+    long int nout = igraph_vector_int_size(out);
+
+    *shortcuts = 0;
+    b->target_mark++;
+    for (j = 0; j < nout; j++) {
+        b->target[ VECTOR(ch->arc_to)[ VECTOR(*out)[j] ] ] = b->target_mark;
+    }
+
+    for (i = 0; i < nin; i++) {
+        long int arc1 = VECTOR(*in)[i];
+        long int from = VECTOR(ch->arc_from)[arc1];
+        igraph_real_t w1 = VECTOR(ch->arc_weight)[arc1], limit = -1;
+
+        for (j = 0; j < nout; j++) {
+            long int arc2 = VECTOR(*out)[j];
+            igraph_real_t w = w1 + VECTOR(ch->arc_weight)[arc2];
+            if (VECTOR(ch->arc_to)[arc2] != from && w > limit) {
+                limit = w;
+            }
+        }
+        if (limit < 0) {
+            continue;
+        }
+
+        IGRAPH_CHECK(igraph_i_ch_witness(b, from, v, limit, nout,
+                                         simulate ? IGRAPH_I_CH_SIMULATE_LIMIT :
+                                         IGRAPH_I_CH_WITNESS_LIMIT));
+        for (j = 0; j < nout; j++) {
+            long int arc2 = VECTOR(*out)[j];
+            long int to = VECTOR(ch->arc_to)[arc2];
+            igraph_real_t w = w1 + VECTOR(ch->arc_weight)[arc2];
+            if (to == from || IGRAPH_I_CH_DIST(&b->witness, to) <= w) {
+                continue;
+            }
+            (*shortcuts)++;
+            if (!simulate) {
+                IGRAPH_CHECK(igraph_i_ch_add_arc(b, from, to, w, arc1, arc2));
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* The edge difference, plus the number of contracted neighbors, which
+   spreads the contractions evenly over the graph */
+
+static int igraph_i_ch_priority(igraph_i_ch_builder_t *b, long int v,
+                                igraph_real_t *priority) {
+    long int shortcuts;
+    IGRAPH_CHECK(igraph_i_ch_contract(b, v, /*simulate=*/ 1, &shortcuts));
+    *priority = shortcuts - igraph_vector_int_size(&b->in[v]) -
+                igraph_vector_int_size(&b->out[v]) +
+                VECTOR(b->deleted_neighbors)[v];
+    return 0;
+}
+
+/* Removes the arcs of a contracted vertex from its neighbors, and
+   collects the neighbors */
+
+static int igraph_i_ch_detach(igraph_i_ch_builder_t *b, long int v) {
+    igraph_contraction_hierarchy_t *ch = b->ch;
+    long int i, n;
+
+    igraph_vector_int_clear(&b->neighbors);
+    n = igraph_vector_int_size(&b->in[v]);
+    for (i = 0; i < n; i++) {
+        long int arc = VECTOR(b->in[v])[i];
+        long int from = VECTOR(ch->arc_from)[arc];
+        igraph_i_ch_remove_arc(&b->out[from], arc);
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->neighbors, (int) from));
+    }
+    n = igraph_vector_int_size(&b->out[v]);
+    for (i = 0; i < n; i++) {
+        long int arc = VECTOR(b->out[v])[i];
+        long int to = VECTOR(ch->arc_to)[arc];
+        igraph_i_ch_remove_arc(&b->in[to], arc);
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->neighbors, (int) to));
+    }
+    igraph_vector_int_clear(&b->in[v]);
+    igraph_vector_int_clear(&b->out[v]);
+
+    igraph_vector_int_sort(&b->neighbors);
+    n = igraph_vector_int_size(&b->neighbors);
+    for (i = 0; i < n; i++) {
+        if (i == 0 || VECTOR(b->neighbors)[i] != VECTOR(b->neighbors)[i - 1]) {
+            VECTOR(b->deleted_neighbors)[ VECTOR(b->neighbors)[i] ] += 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Removes the dead arcs; the live ones keep their order, so the
+   shortcuts still refer to earlier arcs */
+
+static int igraph_i_ch_compact(igraph_contraction_hierarchy_t *ch) {
+    long int no_of_arcs = igraph_vector_int_size(&ch->arc_from);
+    long int i, j = 0;
+    igraph_vector_int_t newid;
+
+    IGRAPH_CHECK(igraph_vector_int_init(&newid, no_of_arcs));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &newid);
+    for (i = 0; i < no_of_arcs; i++) {
+        long int first = VECTOR(ch->arc_first)[i];
+        long int second = VECTOR(ch->arc_second)[i];
+        if (second == IGRAPH_I_CH_DEAD) {
+            continue;
+        }
+        if (second >= 0) {
+            first = VECTOR(newid)[first];
+            second = VECTOR(newid)[second];
+        }
+        VECTOR(newid)[i] = (int) j;
+        VECTOR(ch->arc_from)[j] = VECTOR(ch->arc_from)[i];
+        VECTOR(ch->arc_to)[j] = VECTOR(ch->arc_to)[i];
+        VECTOR(ch->arc_weight)[j] = VECTOR(ch->arc_weight)[i];
+        VECTOR(ch->arc_first)[j] = (int) first;
+        VECTOR(ch->arc_second)[j] = (int) second;
+        j++;
+    }
+    igraph_vector_int_resize(&ch->arc_from, j);
+    igraph_vector_int_resize(&ch->arc_to, j);
+    igraph_vector_resize(&ch->arc_weight, j);
+    igraph_vector_int_resize(&ch->arc_first, j);
+    igraph_vector_int_resize(&ch->arc_second, j);
+
+    igraph_vector_int_destroy(&newid);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static int igraph_i_ch_build(const igraph_t *graph,
+                             igraph_contraction_hierarchy_t *ch,
+                             const igraph_vector_t *weights,
+                             igraph_neimode_t mode) {
+
+    long int no_of_nodes = ch->n, no_of_edges = igraph_ecount(graph);
+    igraph_i_ch_builder_t b;
+    igraph_2wheap_t queue;
+    long int e, v, i, order = 0;
+    igraph_real_t priority;
+
+    IGRAPH_CHECK(igraph_i_ch_builder_init(&b, ch));
+    IGRAPH_FINALLY(igraph_i_ch_builder_destroy, &b);
+    IGRAPH_CHECK(igraph_2wheap_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &queue);
+
+    /* The arcs point in the direction of the searches, loops and
+       parallel edges are dropped, except the shortest one */
+    for (e = 0; e < no_of_edges; e++) {
+        long int from = IGRAPH_FROM(graph, e), to = IGRAPH_TO(graph, e);
+        igraph_real_t w = weights ? VECTOR(*weights)[e] : 1;
+        if (from == to || igraph_is_edge_deleted(graph, (igraph_integer_t) e)) {
+            continue;
+        }
+        if (mode & IGRAPH_OUT) {
+            IGRAPH_CHECK(igraph_i_ch_add_arc(&b, from, to, w, e, -1));
+        }
+        if (mode & IGRAPH_IN) {
+            IGRAPH_CHECK(igraph_i_ch_add_arc(&b, to, from, w, e, -1));
+        }
+    }
+
+    for (v = 0; v < no_of_nodes; v++) {
+        IGRAPH_CHECK(igraph_i_ch_priority(&b, v, &priority));
+        IGRAPH_CHECK(igraph_2wheap_push_with_index(&queue, v, -priority));
+    }
+
+    /* The vertex with the lowest priority is contracted next, its
+       priority is recomputed first, since it may be outdated */
+    while (!igraph_2wheap_empty(&queue)) {
+        long int shortcuts, n;
+
+        v = igraph_2wheap_max_index(&queue);
+        IGRAPH_CHECK(igraph_i_ch_priority(&b, v, &priority));
+        if (priority > -igraph_2wheap_max(&queue)) {
+            igraph_2wheap_modify(&queue, v, -priority);
+            continue;
+        }
+        igraph_2wheap_delete_max(&queue);
+
+        if (order % 1000 == 0) {
+            IGRAPH_PROGRESS("Contraction hierarchy: ",
+                            100.0 * order / no_of_nodes, NULL);
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+
+        IGRAPH_CHECK(igraph_i_ch_contract(&b, v, /*simulate=*/ 0, &shortcuts));
+        IGRAPH_CHECK(igraph_i_ch_detach(&b, v));
+        VECTOR(ch->rank)[v] = (int) order++;
+
+        n = igraph_vector_int_size(&b.neighbors);
+        for (i = 0; i < n; i++) {
+            long int nei = VECTOR(b.neighbors)[i];
+            if (i > 0 && nei == VECTOR(b.neighbors)[i - 1]) {
+                continue;
+            }
+            IGRAPH_CHECK(igraph_i_ch_priority(&b, nei, &priority));
+            igraph_2wheap_modify(&queue, nei, -priority);
+        }
+    }
+    IGRAPH_PROGRESS("Contraction hierarchy: ", 100.0, NULL);
+
+    igraph_2wheap_destroy(&queue);
+    igraph_i_ch_builder_destroy(&b);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    IGRAPH_CHECK(igraph_i_ch_compact(ch));
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_init
+ * \brief Builds a contraction hierarchy of a weighted graph.
+ *
+ * </para><para>
+ * The vertices are contracted in the order of their edge difference,
+ * the number of shortcuts needed minus the number of edges removed,
+ * plus the number of their neighbors contracted before. Shortcuts are
+ * added if no path that avoids the contracted vertex is found by a
+ * small local search, so the hierarchy may have a few unnecessary
+ * shortcuts, but all distances are exact.
+ *
+ * \param graph The input graph. It is not needed after the hierarchy
+ *        was built.
+ * \param ch Pointer to an uninitialized contraction hierarchy.
+ * \param weights Vector of non-negative edge weights, in the order of
+ *        edge ids, or a null pointer to use unit weights.
+ * \param mode The direction of the paths in directed graphs: \c
+ *        IGRAPH_OUT follows the edge directions, \c IGRAPH_IN the
+ *        opposite directions, \c IGRAPH_ALL ignores them. It is
+ *        ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: depends on the structure of the graph, it is close
+ * to linear in the number of edges on road networks and grid-like
+ * graphs.
+ *
+ * \sa \ref igraph_contraction_hierarchy_distance(), \ref
+ * igraph_contraction_hierarchy_path(), \ref
+ * igraph_contraction_hierarchy_distances() for the queries.
+ */
+
+int igraph_contraction_hierarchy_init(const igraph_t *graph,
+                                      igraph_contraction_hierarchy_t *ch,
+                                      const igraph_vector_t *weights,
+                                      igraph_neimode_t mode) {
+
+    long int no_of_edges = igraph_ecount(graph);
+
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+            IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+        }
+    }
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    ch->n = igraph_vcount(graph);
+    IGRAPH_CHECK(igraph_i_ch_vectors_init(ch));
+    IGRAPH_FINALLY(igraph_contraction_hierarchy_destroy, ch);
+    IGRAPH_CHECK(igraph_i_ch_build(graph, ch, weights, mode));
+    IGRAPH_CHECK(igraph_i_ch_index(ch));
+    IGRAPH_CHECK(igraph_i_ch_workspace_init(ch));
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_vcount
+ * \brief The number of vertices in a contraction hierarchy.
+ *
+ * \param ch The contraction hierarchy.
+ * \return The number of vertices of the graph it was built from.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_contraction_hierarchy_vcount(const igraph_contraction_hierarchy_t *ch) {
+    return ch->n;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_shortcut_count
+ * \brief The number of shortcuts in a contraction hierarchy.
+ *
+ * </para><para>
+ * This is a measure of the preprocessing quality, the queries are
+ * faster with fewer shortcuts.
+ *
+ * \param ch The contraction hierarchy.
+ * \return The number of shortcuts added to the graph.
+ *
+ * Time complexity: O(|E|+|S|), the number of edges and shortcuts.
+ */
+
+igraph_integer_t igraph_contraction_hierarchy_shortcut_count(const igraph_contraction_hierarchy_t *ch) {
+    long int a, no_of_arcs = igraph_vector_int_size(&ch->arc_second);
+    igraph_integer_t res = 0;
+    for (a = 0; a < no_of_arcs; a++) {
+        if (VECTOR(ch->arc_second)[a] >= 0) {
+            res++;
+        }
+    }
+    return res;
+}
+
+/* -------------------------------------------------- */
+/* Queries                                            */
+/* -------------------------------------------------- */
+
+/* Settles the next vertex of a search, following the upward arcs
+   (forward search, 'backward' is false) or the downward arcs backwards
+   (backward search). Returns the vertex and its distance.
+
+   Stall-on-demand: if a higher ranked neighbor, reached already, gives
+   a shorter path to the vertex along an arc in the wrong direction,
+   then the distance of the vertex is not the length of a shortest
+   path, and neither are the distances through it, so its arcs are not
+   followed and 'stalled' is set. */
+
+static int igraph_i_ch_settle(const igraph_contraction_hierarchy_t *ch,
+                              igraph_i_ch_search_t *s, igraph_bool_t backward,
+                              long int *vertex, igraph_real_t *dist,
+                              igraph_bool_t *stalled) {
+    const igraph_vector_int_t *start = backward ? &ch->down_start : &ch->up_start;
+    const igraph_vector_int_t *arcs = backward ? &ch->down_arcs : &ch->up_arcs;
+    const igraph_vector_int_t *other = backward ? &ch->arc_from : &ch->arc_to;
+    const igraph_vector_int_t *stall_start = backward ? &ch->up_start : &ch->down_start;
+    const igraph_vector_int_t *stall_arcs = backward ? &ch->up_arcs : &ch->down_arcs;
+    const igraph_vector_int_t *stall_other = backward ? &ch->arc_to : &ch->arc_from;
+    long int v = igraph_indheap_max_index(&s->heap), i, end;
+    igraph_real_t d = -igraph_indheap_delete_max(&s->heap);
+
+    *vertex = v;
+    *dist = d;
+    *stalled = 0;
+
+    end = VECTOR(*stall_start)[v + 1];
+    for (i = VECTOR(*stall_start)[v]; i < end; i++) {
+        long int arc = VECTOR(*stall_arcs)[i];
+        long int from = VECTOR(*stall_other)[arc];
+        if (IGRAPH_I_CH_DIST(s, from) + VECTOR(ch->arc_weight)[arc] < d) {
+            *stalled = 1;
+            return 0;
+        }
+    }
+
+    end = VECTOR(*start)[v + 1];
+    for (i = VECTOR(*start)[v]; i < end; i++) {
+        long int arc = VECTOR(*arcs)[i];
+        long int to = VECTOR(*other)[arc];
+        igraph_real_t nd = d + VECTOR(ch->arc_weight)[arc];
+        if (nd < IGRAPH_I_CH_DIST(s, to)) {
+            IGRAPH_CHECK(igraph_i_ch_search_label(s, to, nd, (int) arc));
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_ch_check_vid(const igraph_contraction_hierarchy_t *ch,
+                                 long int vid) {
+    if (vid < 0 || vid >= ch->n) {
+        IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+    }
+    return 0;
+}
+
+/* Bidirectional upward search, the shortest path goes through 'meet',
+   which is -1 if there is no path */
+
+static int igraph_i_ch_query(igraph_contraction_hierarchy_t *ch,
+                             long int from, long int to,
+                             igraph_real_t *res, long int *meet) {
+    igraph_i_ch_search_t *s = ch->work->search;
+    igraph_real_t best = IGRAPH_INFINITY;
+    int side;
+
+    IGRAPH_CHECK(igraph_i_ch_check_vid(ch, from));
+    IGRAPH_CHECK(igraph_i_ch_check_vid(ch, to));
+
+    igraph_i_ch_search_reset(&s[0]);
+    igraph_i_ch_search_reset(&s[1]);
+    IGRAPH_CHECK(igraph_i_ch_search_label(&s[0], from, 0, -1));
+    IGRAPH_CHECK(igraph_i_ch_search_label(&s[1], to, 0, -1));
+    *meet = -1;
+
+    /* A search can stop when its next vertex is not closer than the
+       best path found, the path through the highest ranked vertex is
+       found by both of them */
+    while (1) {
+        igraph_real_t top0 = igraph_i_ch_search_top(&s[0]);
+        igraph_real_t top1 = igraph_i_ch_search_top(&s[1]);
+        igraph_real_t d, other;
+        igraph_bool_t stalled;
+        long int v;
+
+        if (top0 >= best && top1 >= best) {
+            break;
+        }
+        side = top0 <= top1 ? 0 : 1;
+        IGRAPH_CHECK(igraph_i_ch_settle(ch, &s[side], side, &v, &d, &stalled));
+        if (stalled) {
+            continue;
+        }
+        other = IGRAPH_I_CH_DIST(&s[1 - side], v);
+        if (d + other < best) {
+            best = d + other;
+            *meet = v;
+        }
+    }
+
+    *res = best;
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_distance
+ * \brief The length of the shortest path between two vertices.
+ *
+ * \param ch The contraction hierarchy.
+ * \param res The distance is stored here, it is \c IGRAPH_INFINITY if
+ *        there is no path.
+ * \param from The source vertex.
+ * \param to The target vertex.
+ * \return Error code.
+ *
+ * Time complexity: O(s log s), where s is the number of vertices
+ * settled by the two upward searches, this is usually small, and
+ * independent of the size of the graph.
+ */
+
+int igraph_contraction_hierarchy_distance(igraph_contraction_hierarchy_t *ch,
+        igraph_real_t *res,
+        igraph_integer_t from,
+        igraph_integer_t to) {
+    long int meet;
+    IGRAPH_CHECK(igraph_i_ch_query(ch, from, to, res, &meet));
+    return 0;
+}
+
+/* Replaces the shortcuts in a list of arcs by the arcs they stand for,
+   the original edges are written to 'edges' */
+
+static int igraph_i_ch_unpack(const igraph_contraction_hierarchy_t *ch,
+                              igraph_vector_int_t *stack,
+                              igraph_vector_t *edges,
+                              igraph_vector_t *vertices) {
+    while (!igraph_vector_int_empty(stack)) {
+        long int arc = igraph_vector_int_pop_back(stack);
+        if (VECTOR(ch->arc_second)[arc] < 0) {
+            if (edges) {
+                IGRAPH_CHECK(igraph_vector_push_back(edges, VECTOR(ch->arc_first)[arc]));
+            }
+            if (vertices) {
+                IGRAPH_CHECK(igraph_vector_push_back(vertices, VECTOR(ch->arc_to)[arc]));
+            }
+        } else {
+            IGRAPH_CHECK(igraph_vector_int_push_back(stack, VECTOR(ch->arc_second)[arc]));
+            IGRAPH_CHECK(igraph_vector_int_push_back(stack, VECTOR(ch->arc_first)[arc]));
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_path
+ * \brief A shortest path between two vertices.
+ *
+ * \param ch The contraction hierarchy.
+ * \param vertices Pointer to an initialized vector or a null pointer.
+ *        If not a null pointer, then the vertex ids along the path are
+ *        stored here, including the source and target vertices.
+ * \param edges Pointer to an initialized vector or a null pointer. If
+ *        not a null pointer, then the ids of the edges of the graph
+ *        the hierarchy was built from are stored here.
+ * \param from The source vertex.
+ * \param to The target vertex.
+ * \return Error code. If there is no path, a warning is given and the
+ *         vectors are empty.
+ *
+ * Time complexity: O(s log s + l), s is the number of vertices settled
+ * by the two upward searches, l is the length of the path.
+ */
+
+int igraph_contraction_hierarchy_path(igraph_contraction_hierarchy_t *ch,
+                                      igraph_vector_t *vertices,
+                                      igraph_vector_t *edges,
+                                      igraph_integer_t from,
+                                      igraph_integer_t to) {
+    igraph_i_ch_search_t *s;
+    igraph_vector_int_t stack;
+    igraph_real_t dist;
+    long int meet, v, i, n;
+
+    IGRAPH_CHECK(igraph_i_ch_query(ch, from, to, &dist, &meet));
+    s = ch->work->search;
+
+    if (vertices) {
+        igraph_vector_clear(vertices);
+    }
+    if (edges) {
+        igraph_vector_clear(edges);
+    }
+    if (meet < 0) {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        return 0;
+    }
+
+    /* The arcs of the forward search, from 'meet' back to 'from', are
+       pushed first, so that they are unpacked in reverse order */
+    IGRAPH_CHECK(igraph_vector_int_init(&stack, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &stack);
+    for (v = meet; v != to; v = VECTOR(ch->arc_to)[ s[1].parent[v] ]) {
+        IGRAPH_CHECK(igraph_vector_int_push_back(&stack, s[1].parent[v]));
+    }
+    n = igraph_vector_int_size(&stack);
+    for (i = 0; i < n / 2; i++) {
+        int tmp = VECTOR(stack)[i];
+        VECTOR(stack)[i] = VECTOR(stack)[n - 1 - i];
+        VECTOR(stack)[n - 1 - i] = tmp;
+    }
+    for (v = meet; v != from; v = VECTOR(ch->arc_from)[ s[0].parent[v] ]) {
+        IGRAPH_CHECK(igraph_vector_int_push_back(&stack, s[0].parent[v]));
+    }
+
+    if (vertices) {
+        IGRAPH_CHECK(igraph_vector_push_back(vertices, from));
+    }
+    IGRAPH_CHECK(igraph_i_ch_unpack(ch, &stack, edges, vertices));
+
+    igraph_vector_int_destroy(&stack);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_distances
+ * \brief Distances between many sources and targets.
+ *
+ * </para><para>
+ * An upward search is run from every target and every source only,
+ * instead of one query per pair: the distances found by the backward
+ * searches are stored in buckets at the vertices, and the forward
+ * searches scan the buckets of the vertices they settle.
+ *
+ * \param ch The contraction hierarchy.
+ * \param res Pointer to an initialized matrix, the distances are
+ *        stored here, one row for every source and one column for
+ *        every target. Unreachable targets have \c IGRAPH_INFINITY.
+ * \param from The source vertices.
+ * \param to The target vertices.
+ * \return Error code.
+ *
+ * Time complexity: O((|F|+|T|) s log s + |F||T|), |F| and |T| are the
+ * numbers of sources and targets, s is the size of an upward search
+ * space.
+ */
+
+int igraph_contraction_hierarchy_distances(igraph_contraction_hierarchy_t *ch,
+        igraph_matrix_t *res,
+        const igraph_vector_t *from,
+        const igraph_vector_t *to) {
+
+    igraph_i_ch_search_t *s = ch->work->search;
+    long int no_of_from = igraph_vector_size(from);
+    long int no_of_to = igraph_vector_size(to);
+    igraph_vector_int_t bucket_vertex, bucket_target, bucket_start;
+    igraph_vector_int_t order;
+    igraph_vector_t bucket_dist;
+    long int i, j, k, n = ch->n, no_of_buckets;
+
+    for (i = 0; i < no_of_from; i++) {
+        IGRAPH_CHECK(igraph_i_ch_check_vid(ch, VECTOR(*from)[i]));
+    }
+    for (j = 0; j < no_of_to; j++) {
+        IGRAPH_CHECK(igraph_i_ch_check_vid(ch, VECTOR(*to)[j]));
+    }
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
+    igraph_matrix_fill(res, IGRAPH_INFINITY);
+
+    IGRAPH_CHECK(igraph_vector_int_init(&bucket_vertex, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bucket_vertex);
+    IGRAPH_CHECK(igraph_vector_int_init(&bucket_target, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bucket_target);
+    IGRAPH_VECTOR_INIT_FINALLY(&bucket_dist, 0);
+    IGRAPH_CHECK(igraph_vector_int_init(&bucket_start, n + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bucket_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&order, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &order);
+
+    /* Backward searches fill the buckets */
+    for (j = 0; j < no_of_to; j++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        igraph_i_ch_search_reset(&s[1]);
+        IGRAPH_CHECK(igraph_i_ch_search_label(&s[1], VECTOR(*to)[j], 0, -1));
+        while (igraph_i_ch_search_top(&s[1]) != IGRAPH_INFINITY) {
+            long int v;
+            igraph_real_t d;
+            igraph_bool_t stalled;
+            IGRAPH_CHECK(igraph_i_ch_settle(ch, &s[1], /*backward=*/ 1, &v, &d,
+                                            &stalled));
+            if (stalled) {
+                continue;
+            }
+            IGRAPH_CHECK(igraph_vector_int_push_back(&bucket_vertex, (int) v));
+            IGRAPH_CHECK(igraph_vector_int_push_back(&bucket_target, (int) j));
+            IGRAPH_CHECK(igraph_vector_push_back(&bucket_dist, d));
+            VECTOR(bucket_start)[v + 1] += 1;
+        }
+    }
+
+    /* Sort the bucket entries by vertex */
+    no_of_buckets = igraph_vector_int_size(&bucket_vertex);
+    for (i = 0; i < n; i++) {
+        VECTOR(bucket_start)[i + 1] += VECTOR(bucket_start)[i];
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(&order, no_of_buckets));
+    for (k = 0; k < no_of_buckets; k++) {
+        long int v = VECTOR(bucket_vertex)[k];
+        VECTOR(order)[ VECTOR(bucket_start)[v]++ ] = (int) k;
+    }
+    for (i = n; i > 0; i--) {
+        VECTOR(bucket_start)[i] = VECTOR(bucket_start)[i - 1];
+    }
+    VECTOR(bucket_start)[0] = 0;
+
+    /* Forward searches scan the buckets */
+    for (i = 0; i < no_of_from; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        igraph_i_ch_search_reset(&s[0]);
+        IGRAPH_CHECK(igraph_i_ch_search_label(&s[0], VECTOR(*from)[i], 0, -1));
+        while (igraph_i_ch_search_top(&s[0]) != IGRAPH_INFINITY) {
+            long int v, end;
+            igraph_real_t d;
+            igraph_bool_t stalled;
+            IGRAPH_CHECK(igraph_i_ch_settle(ch, &s[0], /*backward=*/ 0, &v, &d,
+                                            &stalled));
+            if (stalled) {
+                continue;
+            }
+            end = VECTOR(bucket_start)[v + 1];
+            for (k = VECTOR(bucket_start)[v]; k < end; k++) {
+                long int b = VECTOR(order)[k];
+                long int target = VECTOR(bucket_target)[b];
+                igraph_real_t total = d + VECTOR(bucket_dist)[b];
+                if (total < MATRIX(*res, i, target)) {
+                    MATRIX(*res, i, target) = total;
+                }
+            }
+        }
+    }
+
+    igraph_vector_int_destroy(&order);
+    igraph_vector_int_destroy(&bucket_start);
+    igraph_vector_destroy(&bucket_dist);
+    igraph_vector_int_destroy(&bucket_target);
+    igraph_vector_int_destroy(&bucket_vertex);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return 0;
+}
+
+/* -------------------------------------------------- */
+/* Saving and loading                                 */
+/* -------------------------------------------------- */
+
+/* The file is a fixed size header, followed by the ranks of the
+   vertices and the five arc vectors: tails, heads, first and second
+   parts (edge id and -1 for the arcs of the graph), and weights. The
+   numbers are stored in the byte order and sizes of the machine that
+   wrote the file, like in graph snapshots. The search index is
+   rebuilt when reading. */
+
+#define IGRAPH_I_CH_MAGIC     "IGRAPHCH"
+#define IGRAPH_I_CH_VERSION   1
+#define IGRAPH_I_CH_BYTEORDER 0x01020304
+
+typedef struct igraph_i_ch_header_t {
+    char magic[8];
+    unsigned int version;
+    unsigned int byteorder;
+    unsigned int intsize;
+    unsigned int realsize;
+    igraph_integer_t n;
+    igraph_integer_t no_of_arcs;
+    char reserved[32];
+} igraph_i_ch_header_t;
+
+static int igraph_i_ch_write_ints(FILE *outstream, const igraph_vector_int_t *v) {
+    size_t n = (size_t) igraph_vector_int_size(v);
+    if (fwrite(VECTOR(*v), sizeof(int), n, outstream) != n) {
+        IGRAPH_ERROR("Cannot write contraction hierarchy", IGRAPH_EFILE);
+    }
+    return 0;
+}
+
+static int igraph_i_ch_read_ints(FILE *instream, igraph_vector_int_t *v,
+                                 long int n) {
+    IGRAPH_CHECK(igraph_vector_int_resize(v, n));
+    if (fread(VECTOR(*v), sizeof(int), (size_t) n, instream) != (size_t) n) {
+        IGRAPH_ERROR("Truncated contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_write
+ * \brief Saves a contraction hierarchy to a binary file.
+ *
+ * </para><para>
+ * The file can only be read on machines with the same byte order and
+ * number sizes.
+ *
+ * \param ch The contraction hierarchy.
+ * \param outstream The stream to write to, it must be opened in binary
+ *        mode.
+ * \return Error code, \c IGRAPH_EFILE if writing fails.
+ *
+ * Time complexity: O(|V|+|E|+|S|), the number of vertices, edges and
+ * shortcuts.
+ */
+
+int igraph_contraction_hierarchy_write(const igraph_contraction_hierarchy_t *ch,
+                                       FILE *outstream) {
+    igraph_i_ch_header_t header;
+    size_t no_of_arcs = (size_t) igraph_vector_int_size(&ch->arc_from);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_CH_MAGIC, sizeof(header.magic));
+    header.version = IGRAPH_I_CH_VERSION;
+    header.byteorder = IGRAPH_I_CH_BYTEORDER;
+    header.intsize = sizeof(int);
+    header.realsize = sizeof(igraph_real_t);
+    header.n = ch->n;
+    header.no_of_arcs = (igraph_integer_t) no_of_arcs;
+
+    if (fwrite(&header, sizeof(header), 1, outstream) != 1) {
+        IGRAPH_ERROR("Cannot write contraction hierarchy", IGRAPH_EFILE);
+    }
+    IGRAPH_CHECK(igraph_i_ch_write_ints(outstream, &ch->rank));
+    IGRAPH_CHECK(igraph_i_ch_write_ints(outstream, &ch->arc_from));
+    IGRAPH_CHECK(igraph_i_ch_write_ints(outstream, &ch->arc_to));
+    IGRAPH_CHECK(igraph_i_ch_write_ints(outstream, &ch->arc_first));
+    IGRAPH_CHECK(igraph_i_ch_write_ints(outstream, &ch->arc_second));
+    if (fwrite(VECTOR(ch->arc_weight), sizeof(igraph_real_t), no_of_arcs,
+               outstream) != no_of_arcs) {
+        IGRAPH_ERROR("Cannot write contraction hierarchy", IGRAPH_EFILE);
+    }
+
+    return 0;
+}
+
+/* Cheap sanity checks, so that the queries cannot index out of range
+   and the unpacking terminates: the ranks are a permutation, and a
+   shortcut is a path of two earlier arcs */
+
+static int igraph_i_ch_check(const igraph_contraction_hierarchy_t *ch) {
+    long int n = ch->n, no_of_arcs = igraph_vector_int_size(&ch->arc_from);
+    long int i;
+    char *seen;
+
+    seen = igraph_Calloc(n > 0 ? n : 1, char);
+    if (seen == 0) {
+        IGRAPH_ERROR("Cannot read contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, seen);
+    for (i = 0; i < n; i++) {
+        long int rank = VECTOR(ch->rank)[i];
+        if (rank < 0 || rank >= n || seen[rank]) {
+            IGRAPH_ERROR("Corrupt contraction hierarchy file", IGRAPH_PARSEERROR);
+        }
+        seen[rank] = 1;
+    }
+    igraph_Free(seen);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    for (i = 0; i < no_of_arcs; i++) {
+        long int from = VECTOR(ch->arc_from)[i], to = VECTOR(ch->arc_to)[i];
+        long int first = VECTOR(ch->arc_first)[i];
+        long int second = VECTOR(ch->arc_second)[i];
+        if (from < 0 || from >= n || to < 0 || to >= n || first < 0 ||
+            second < -1) {
+            IGRAPH_ERROR("Corrupt contraction hierarchy file", IGRAPH_PARSEERROR);
+        }
+        if (second >= 0 &&
+            (first >= i || second >= i ||
+             VECTOR(ch->arc_from)[first] != from ||
+             VECTOR(ch->arc_to)[first] != VECTOR(ch->arc_from)[second] ||
+             VECTOR(ch->arc_to)[second] != to)) {
+            IGRAPH_ERROR("Corrupt contraction hierarchy file", IGRAPH_PARSEERROR);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_read
+ * \brief Loads a contraction hierarchy from a binary file.
+ *
+ * \param ch Pointer to an uninitialized contraction hierarchy.
+ * \param instream The stream to read from, written by \ref
+ *        igraph_contraction_hierarchy_write(). It must be opened in
+ *        binary mode.
+ * \return Error code, \c IGRAPH_PARSEERROR if the file is not a
+ *         contraction hierarchy, or it was written on an incompatible
+ *         machine.
+ *
+ * Time complexity: O(|V|+|E|+|S|), the number of vertices, edges and
+ * shortcuts.
+ */
+
+int igraph_contraction_hierarchy_read(igraph_contraction_hierarchy_t *ch,
+                                      FILE *instream) {
+    igraph_i_ch_header_t header;
+    long int no_of_arcs;
+
+    if (fread(&header, sizeof(header), 1, instream) != 1) {
+        IGRAPH_ERROR("Truncated contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+    if (memcmp(header.magic, IGRAPH_I_CH_MAGIC, sizeof(header.magic))) {
+        IGRAPH_ERROR("Not a contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+    if (header.version != IGRAPH_I_CH_VERSION) {
+        IGRAPH_ERROR("Unsupported contraction hierarchy version",
+                     IGRAPH_PARSEERROR);
+    }
+    if (header.byteorder != IGRAPH_I_CH_BYTEORDER ||
+        header.intsize != sizeof(int) ||
+        header.realsize != sizeof(igraph_real_t)) {
+        IGRAPH_ERROR("Contraction hierarchy was written on an incompatible platform",
+                     IGRAPH_PARSEERROR);
+    }
+    if (header.n < 0 || header.no_of_arcs < 0) {
+        IGRAPH_ERROR("Corrupt contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+
+    ch->n = header.n;
+    no_of_arcs = header.no_of_arcs;
+    IGRAPH_CHECK(igraph_i_ch_vectors_init(ch));
+    IGRAPH_FINALLY(igraph_contraction_hierarchy_destroy, ch);
+    IGRAPH_CHECK(igraph_i_ch_read_ints(instream, &ch->rank, ch->n));
+    IGRAPH_CHECK(igraph_i_ch_read_ints(instream, &ch->arc_from, no_of_arcs));
+    IGRAPH_CHECK(igraph_i_ch_read_ints(instream, &ch->arc_to, no_of_arcs));
+    IGRAPH_CHECK(igraph_i_ch_read_ints(instream, &ch->arc_first, no_of_arcs));
+    IGRAPH_CHECK(igraph_i_ch_read_ints(instream, &ch->arc_second, no_of_arcs));
+    IGRAPH_CHECK(igraph_vector_resize(&ch->arc_weight, no_of_arcs));
+    if (fread(VECTOR(ch->arc_weight), sizeof(igraph_real_t), (size_t) no_of_arcs,
+              instream) != (size_t) no_of_arcs) {
+        IGRAPH_ERROR("Truncated contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+    IGRAPH_CHECK(igraph_i_ch_check(ch));
+    IGRAPH_CHECK(igraph_i_ch_index(ch));
+    IGRAPH_CHECK(igraph_i_ch_workspace_init(ch));
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
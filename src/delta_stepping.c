@@ -0,0 +1,390 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_delta_stepping_internal.h"
+#include "igraph_parallel_internal.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+#include "igraph_interrupt_internal.h"
+
+#include <string.h>
+
+/* Smaller graphs are searched with Dijkstra's algorithm, the phases
+   of delta-stepping cost more than they save there */
+#define IGRAPH_I_DELTA_STEPPING_MIN_EDGES 65536
+
+/* More owners than threads, so that the threads can balance the load
+   of the owners with many requests */
+#define IGRAPH_I_DELTA_STEPPING_OWNERS_PER_THREAD 4
+
+/* The bucket width is the mean weight times this factor, divided by
+   the mean degree, but at least the largest weight divided by
+   IGRAPH_I_DELTA_STEPPING_MAX_BUCKETS */
+#define IGRAPH_I_DELTA_STEPPING_FACTOR 2.0
+#define IGRAPH_I_DELTA_STEPPING_MAX_BUCKETS 4096
+
+/* Phases with fewer vertices or requests than this run on the calling
+   thread only */
+#define IGRAPH_I_DELTA_STEPPING_MIN_PARALLEL 1024
+
+/* Vertices per task when resetting the labels */
+#define IGRAPH_I_DELTA_STEPPING_BLOCK 65536
+
+/* The number of threads to use for a graph, one means that
+   delta-stepping is not worth it */
+
+int igraph_i_delta_stepping_threads(const igraph_t *graph) {
+    if (igraph_ecount(graph) < IGRAPH_I_DELTA_STEPPING_MIN_EDGES) {
+        return 1;
+    }
+    return igraph_i_parallel_threads(igraph_vcount(graph));
+}
+
+void igraph_i_delta_stepping_destroy(igraph_i_delta_stepping_t *ds) {
+    long int i, j;
+    if (ds->owners) {
+        for (i = 0; i < ds->no_of_owners; i++) {
+            igraph_i_delta_stepping_owner_t *owner = &ds->owners[i];
+            if (owner->buckets) {
+                for (j = 0; j < ds->no_of_buckets; j++) {
+                    igraph_vector_long_destroy(&owner->buckets[j]);
+                }
+                igraph_Free(owner->buckets);
+            }
+            igraph_vector_long_destroy(&owner->frontier);
+            igraph_vector_long_destroy(&owner->settled);
+        }
+        igraph_Free(ds->owners);
+    }
+    if (ds->requests) {
+        for (i = 0; i < ds->no_of_owners * ds->no_of_owners; i++) {
+            igraph_vector_destroy(&ds->requests[i]);
+        }
+        igraph_Free(ds->requests);
+    }
+    igraph_Free(ds->emptied);
+    igraph_Free(ds->queued);
+    igraph_Free(ds->inbound);
+    igraph_Free(ds->hops);
+    igraph_Free(ds->dist);
+}
+
+int igraph_i_delta_stepping_init(igraph_i_delta_stepping_t *ds,
+                                 const igraph_weighted_adjlist_t *wal,
+                                 int no_of_threads) {
+
+    long int no_of_nodes = wal->length;
+    long int no_of_entries = VECTOR(wal->start)[no_of_nodes];
+    long int i, j, finite = 0, size = no_of_nodes > 0 ? no_of_nodes : 1;
+    igraph_real_t sum = 0.0, max = 0.0;
+
+    memset(ds, 0, sizeof(igraph_i_delta_stepping_t));
+    ds->wal = wal;
+    ds->no_of_nodes = no_of_nodes;
+    ds->no_of_threads = no_of_threads;
+    ds->no_of_owners = no_of_threads * IGRAPH_I_DELTA_STEPPING_OWNERS_PER_THREAD;
+
+    /* Bucket width: Meyer and Sanders suggest 1/d for random weights
+       from [0,1] and maximum degree d; the mean weight and degree are
+       less sensitive to a few outliers */
+    for (i = 0; i < no_of_entries; i++) {
+        igraph_real_t w = wal->entries[i].weight;
+        if (w != IGRAPH_INFINITY) {
+            sum += w;
+            finite++;
+            if (w > max) {
+                max = w;
+            }
+        }
+    }
+    if (finite > 0) {
+        ds->delta = IGRAPH_I_DELTA_STEPPING_FACTOR * (sum / finite) /
+                    ((igraph_real_t) finite / no_of_nodes);
+    }
+    if (ds->delta < max / IGRAPH_I_DELTA_STEPPING_MAX_BUCKETS) {
+        ds->delta = max / IGRAPH_I_DELTA_STEPPING_MAX_BUCKETS;
+    }
+    if (!(ds->delta > 0)) {
+        ds->delta = 1.0;
+    }
+    /* A vertex is at most max/delta+1 buckets after the current one */
+    ds->no_of_buckets = (long int) (max / ds->delta) + 3;
+
+    IGRAPH_FINALLY(igraph_i_delta_stepping_destroy, ds);
+
+    ds->dist = igraph_Calloc(size, igraph_real_t);
+    ds->hops = igraph_Calloc(size, long int);
+    ds->inbound = igraph_Calloc(size, long int);
+    ds->queued = igraph_Calloc(size, long int);
+    ds->emptied = igraph_Calloc(size, long int);
+    if (!ds->dist || !ds->hops || !ds->inbound || !ds->queued || !ds->emptied) {
+        IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+    }
+
+    /* zeroed vectors can be destroyed, even if not initialized */
+    ds->requests = igraph_Calloc(ds->no_of_owners * ds->no_of_owners,
+                                 igraph_vector_t);
+    if (!ds->requests) {
+        IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+    }
+    for (i = 0; i < ds->no_of_owners * ds->no_of_owners; i++) {
+        IGRAPH_CHECK(igraph_vector_init(&ds->requests[i], 0));
+    }
+
+    ds->owners = igraph_Calloc(ds->no_of_owners, igraph_i_delta_stepping_owner_t);
+    if (!ds->owners) {
+        IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+    }
+    for (i = 0; i < ds->no_of_owners; i++) {
+        igraph_i_delta_stepping_owner_t *owner = &ds->owners[i];
+        IGRAPH_CHECK(igraph_vector_long_init(&owner->frontier, 0));
+        IGRAPH_CHECK(igraph_vector_long_init(&owner->settled, 0));
+        owner->buckets = igraph_Calloc(ds->no_of_buckets, igraph_vector_long_t);
+        if (!owner->buckets) {
+            IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+        }
+        for (j = 0; j < ds->no_of_buckets; j++) {
+            IGRAPH_CHECK(igraph_vector_long_init(&owner->buckets[j], 0));
+        }
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static int igraph_i_delta_stepping_reset_task(void *data, long int task,
+        int thread) {
+    igraph_i_delta_stepping_t *ds = (igraph_i_delta_stepping_t *) data;
+    long int v, from = task * IGRAPH_I_DELTA_STEPPING_BLOCK;
+    long int to = from + IGRAPH_I_DELTA_STEPPING_BLOCK;
+
+    IGRAPH_UNUSED(thread);
+    if (to > ds->no_of_nodes) {
+        to = ds->no_of_nodes;
+    }
+    for (v = from; v < to; v++) {
+        ds->dist[v] = IGRAPH_INFINITY;
+        ds->hops[v] = 0;
+        ds->inbound[v] = -1;
+        ds->queued[v] = -1;
+        ds->emptied[v] = -1;
+    }
+    return 0;
+}
+
+/* Relaxes the light edges of the vertices in the current bucket of an
+   owner, emptying the bucket, or the heavy edges of all vertices
+   removed from it. The requests are only created if they improve the
+   label of the target; the labels are not changed in this phase, so
+   they can be read by all threads. */
+
+static int igraph_i_delta_stepping_relax_task(void *data, long int task,
+        int thread) {
+    igraph_i_delta_stepping_t *ds = (igraph_i_delta_stepping_t *) data;
+    igraph_i_delta_stepping_owner_t *owner = &ds->owners[task];
+    igraph_vector_t *requests = &ds->requests[task * ds->no_of_owners];
+    igraph_vector_long_t *list;
+    igraph_real_t delta = ds->delta;
+    igraph_bool_t heavy = ds->heavy;
+    long int i, j, n;
+
+    IGRAPH_UNUSED(thread);
+
+    if (!heavy) {
+        igraph_vector_long_t *bucket =
+            &owner->buckets[ds->current % ds->no_of_buckets];
+        igraph_vector_long_clear(&owner->frontier);
+        n = igraph_vector_long_size(bucket);
+        for (i = 0; i < n; i++) {
+            long int v = VECTOR(*bucket)[i];
+            if (ds->queued[v] != ds->current) {
+                continue;       /* moved to a lower bucket, or duplicate */
+            }
+            ds->queued[v] = -1;
+            IGRAPH_CHECK(igraph_vector_long_push_back(&owner->frontier, v));
+            if (ds->emptied[v] != ds->current) {
+                ds->emptied[v] = ds->current;
+                IGRAPH_CHECK(igraph_vector_long_push_back(&owner->settled, v));
+            }
+        }
+        igraph_vector_long_clear(bucket);
+        list = &owner->frontier;
+    } else {
+        list = &owner->settled;
+    }
+
+    n = igraph_vector_long_size(list);
+    for (i = 0; i < n; i++) {
+        long int v = VECTOR(*list)[i];
+        igraph_real_t d = ds->dist[v];
+        long int h = ds->hops[v] + 1;
+        igraph_weighted_adjlist_entry_t *entries =
+            igraph_weighted_adjlist_get(ds->wal, v);
+        long int nlen = igraph_weighted_adjlist_size(ds->wal, v);
+        for (j = 0; j < nlen; j++) {
+            long int nei = entries[j].nei, edge = entries[j].edge;
+            igraph_real_t w = entries[j].weight, nd = d + w;
+            igraph_vector_t *req;
+            if ((w > delta) != heavy || nd == IGRAPH_INFINITY) {
+                continue;
+            }
+            if (nd > ds->dist[nei] ||
+                (nd == ds->dist[nei] &&
+                 (h > ds->hops[nei] ||
+                  (h == ds->hops[nei] && edge >= ds->inbound[nei])))) {
+                continue;
+            }
+            req = &requests[nei % ds->no_of_owners];
+            IGRAPH_CHECK(igraph_vector_push_back(req, nei));
+            IGRAPH_CHECK(igraph_vector_push_back(req, nd));
+            IGRAPH_CHECK(igraph_vector_push_back(req, h));
+            IGRAPH_CHECK(igraph_vector_push_back(req, edge));
+        }
+    }
+
+    return 0;
+}
+
+/* Applies the requests addressed to an owner, in the order of the
+   requesting owners, and puts the improved vertices into buckets */
+
+static int igraph_i_delta_stepping_apply_task(void *data, long int task,
+        int thread) {
+    igraph_i_delta_stepping_t *ds = (igraph_i_delta_stepping_t *) data;
+    igraph_i_delta_stepping_owner_t *owner = &ds->owners[task];
+    long int i, j, n;
+
+    IGRAPH_UNUSED(thread);
+
+    for (i = 0; i < ds->no_of_owners; i++) {
+        igraph_vector_t *req = &ds->requests[i * ds->no_of_owners + task];
+        n = igraph_vector_size(req);
+        for (j = 0; j < n; j += 4) {
+            long int v = (long int) VECTOR(*req)[j];
+            igraph_real_t nd = VECTOR(*req)[j + 1];
+            long int h = (long int) VECTOR(*req)[j + 2];
+            long int edge = (long int) VECTOR(*req)[j + 3];
+            long int b;
+            if (nd > ds->dist[v] ||
+                (nd == ds->dist[v] &&
+                 (h > ds->hops[v] || (h == ds->hops[v] && edge >= ds->inbound[v])))) {
+                continue;
+            }
+            ds->dist[v] = nd;
+            ds->hops[v] = h;
+            ds->inbound[v] = edge;
+            b = (long int) (nd / ds->delta);
+            if (ds->queued[v] != b) {
+                ds->queued[v] = b;
+                IGRAPH_CHECK(igraph_vector_long_push_back(
+                                 &owner->buckets[b % ds->no_of_buckets], v));
+            }
+        }
+        igraph_vector_clear(req);
+    }
+
+    return 0;
+}
+
+static long int igraph_i_delta_stepping_bucket_size(igraph_i_delta_stepping_t *ds,
+        long int bucket) {
+    long int i, size = 0;
+    for (i = 0; i < ds->no_of_owners; i++) {
+        size += igraph_vector_long_size(&ds->owners[i].buckets[bucket % ds->no_of_buckets]);
+    }
+    return size;
+}
+
+static long int igraph_i_delta_stepping_request_count(igraph_i_delta_stepping_t *ds) {
+    long int i, size = 0;
+    for (i = 0; i < ds->no_of_owners * ds->no_of_owners; i++) {
+        size += igraph_vector_size(&ds->requests[i]);
+    }
+    return size / 4;
+}
+
+#define IGRAPH_I_DELTA_STEPPING_THREADS(ds, size) \
+    ((size) < IGRAPH_I_DELTA_STEPPING_MIN_PARALLEL ? 1 : (ds)->no_of_threads)
+
+int igraph_i_delta_stepping_run(igraph_i_delta_stepping_t *ds, long int source) {
+    long int no_of_blocks = (ds->no_of_nodes + IGRAPH_I_DELTA_STEPPING_BLOCK - 1) /
+                            IGRAPH_I_DELTA_STEPPING_BLOCK;
+    long int i, k, size;
+
+    IGRAPH_PARALLEL_FOR(no_of_blocks, ds->no_of_threads,
+                        igraph_i_delta_stepping_reset_task, ds);
+
+    ds->dist[source] = 0.0;
+    ds->queued[source] = 0;
+    IGRAPH_CHECK(igraph_vector_long_push_back(
+                     &ds->owners[source % ds->no_of_owners].buckets[0], source));
+    ds->current = 0;
+
+    while (1) {
+        /* The next non-empty bucket, the ones after it may only hold
+           vertices up to no_of_buckets-1 buckets ahead */
+        for (k = 0; k < ds->no_of_buckets; k++) {
+            if (igraph_i_delta_stepping_bucket_size(ds, ds->current + k) > 0) {
+                break;
+            }
+        }
+        if (k == ds->no_of_buckets) {
+            break;
+        }
+        ds->current += k;
+        for (i = 0; i < ds->no_of_owners; i++) {
+            igraph_vector_long_clear(&ds->owners[i].settled);
+        }
+
+        /* Light edges, until the bucket stays empty */
+        ds->heavy = 0;
+        while ((size = igraph_i_delta_stepping_bucket_size(ds, ds->current)) > 0) {
+            IGRAPH_PARALLEL_FOR(ds->no_of_owners,
+                                IGRAPH_I_DELTA_STEPPING_THREADS(ds, size),
+                                igraph_i_delta_stepping_relax_task, ds);
+            size = igraph_i_delta_stepping_request_count(ds);
+            IGRAPH_PARALLEL_FOR(ds->no_of_owners,
+                                IGRAPH_I_DELTA_STEPPING_THREADS(ds, size),
+                                igraph_i_delta_stepping_apply_task, ds);
+        }
+
+        /* Heavy edges, they lead to later buckets */
+        ds->heavy = 1;
+        for (size = 0, i = 0; i < ds->no_of_owners; i++) {
+            size += igraph_vector_long_size(&ds->owners[i].settled);
+        }
+        IGRAPH_PARALLEL_FOR(ds->no_of_owners,
+                            IGRAPH_I_DELTA_STEPPING_THREADS(ds, size),
+                            igraph_i_delta_stepping_relax_task, ds);
+        size = igraph_i_delta_stepping_request_count(ds);
+        IGRAPH_PARALLEL_FOR(ds->no_of_owners,
+                            IGRAPH_I_DELTA_STEPPING_THREADS(ds, size),
+                            igraph_i_delta_stepping_apply_task, ds);
+
+        ds->current++;
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    return 0;
+}
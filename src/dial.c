@@ -0,0 +1,209 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_dial_internal.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+
+#include <math.h>
+#include <string.h>
+
+/* The largest weight, or -1 if some weight is not a small
+   non-negative integer */
+
+static long int igraph_i_dial_max_weight(const igraph_weighted_adjlist_t *wal) {
+    long int no_of_entries = VECTOR(wal->start)[wal->length];
+    long int i;
+    igraph_real_t max = 0.0;
+
+    for (i = 0; i < no_of_entries; i++) {
+        igraph_real_t w = wal->entries[i].weight;
+        if (!(w >= 0 && w <= IGRAPH_I_DIAL_MAX_WEIGHT) || w != floor(w)) {
+            return -1;
+        }
+        if (w > max) {
+            max = w;
+        }
+    }
+    return (long int) max;
+}
+
+int igraph_i_dial_init(igraph_i_dial_t *q, long int size,
+                       const igraph_weighted_adjlist_t *wal) {
+    long int max_weight = igraph_i_dial_max_weight(wal);
+    long int n = size > 0 ? size : 1;
+
+    memset(q, 0, sizeof(igraph_i_dial_t));
+    if (max_weight < 0) {
+        return igraph_2wheap_init(&q->heap, size);
+    }
+
+    q->buckets = 1;
+    q->no_of_nodes = size;
+    q->no_of_buckets = max_weight + 1;
+    q->head = igraph_Calloc(q->no_of_buckets, long int);
+    q->next = igraph_Calloc(n, long int);
+    q->prev = igraph_Calloc(n, long int);
+    q->key = igraph_Calloc(n, long int);
+    q->state = igraph_Calloc(n, char);
+    if (!q->head || !q->next || !q->prev || !q->key || !q->state) {
+        igraph_i_dial_destroy(q);
+        IGRAPH_ERROR("Cannot create bucket queue", IGRAPH_ENOMEM);
+    }
+    igraph_i_dial_clear(q);
+
+    return 0;
+}
+
+void igraph_i_dial_destroy(igraph_i_dial_t *q) {
+    igraph_2wheap_destroy(&q->heap);
+    igraph_Free(q->state);
+    igraph_Free(q->key);
+    igraph_Free(q->prev);
+    igraph_Free(q->next);
+    igraph_Free(q->head);
+}
+
+void igraph_i_dial_clear(igraph_i_dial_t *q) {
+    long int i;
+    if (!q->buckets) {
+        igraph_2wheap_clear(&q->heap);
+        return;
+    }
+    for (i = 0; i < q->no_of_buckets; i++) {
+        q->head[i] = -1;
+    }
+    memset(q->state, 0, (size_t) q->no_of_nodes);
+    q->size = 0;
+    q->current = 0;
+}
+
+igraph_bool_t igraph_i_dial_empty(const igraph_i_dial_t *q) {
+    return q->buckets ? q->size == 0 : igraph_2wheap_empty(&q->heap);
+}
+
+static void igraph_i_dial_link(igraph_i_dial_t *q, long int idx) {
+    long int b = q->key[idx] % q->no_of_buckets;
+    q->prev[idx] = -1;
+    q->next[idx] = q->head[b];
+    if (q->head[b] >= 0) {
+        q->prev[q->head[b]] = idx;
+    }
+    q->head[b] = idx;
+}
+
+static void igraph_i_dial_unlink(igraph_i_dial_t *q, long int idx) {
+    if (q->prev[idx] >= 0) {
+        q->next[q->prev[idx]] = q->next[idx];
+    } else {
+        q->head[q->key[idx] % q->no_of_buckets] = q->next[idx];
+    }
+    if (q->next[idx] >= 0) {
+        q->prev[q->next[idx]] = q->prev[idx];
+    }
+}
+
+int igraph_i_dial_push_with_index(igraph_i_dial_t *q, long int idx,
+                                  igraph_real_t elem) {
+    if (!q->buckets) {
+        return igraph_2wheap_push_with_index(&q->heap, idx, elem);
+    }
+    q->key[idx] = (long int) (-elem);
+    if (q->size == 0 || q->key[idx] < q->current) {
+        /* the neighbors of the last removed vertex may be pushed in
+           any order after it emptied the queue */
+        q->current = q->key[idx];
+    }
+    q->state[idx] = 1;
+    q->size++;
+    igraph_i_dial_link(q, idx);
+    return 0;
+}
+
+/* Skips the empty buckets, the queued vertices are at most
+   no_of_buckets-1 farther than the closest one */
+
+long int igraph_i_dial_max_index(igraph_i_dial_t *q) {
+    if (!q->buckets) {
+        return igraph_2wheap_max_index(&q->heap);
+    }
+    while (q->head[q->current % q->no_of_buckets] < 0) {
+        q->current++;
+    }
+    return q->head[q->current % q->no_of_buckets];
+}
+
+igraph_real_t igraph_i_dial_delete_max(igraph_i_dial_t *q) {
+    long int idx;
+    if (!q->buckets) {
+        return igraph_2wheap_delete_max(&q->heap);
+    }
+    idx = igraph_i_dial_max_index(q);
+    igraph_i_dial_unlink(q, idx);
+    q->state[idx] = 0;
+    q->size--;
+    return -q->key[idx];
+}
+
+igraph_real_t igraph_i_dial_deactivate_max(igraph_i_dial_t *q) {
+    long int idx;
+    if (!q->buckets) {
+        return igraph_2wheap_deactivate_max(&q->heap);
+    }
+    idx = igraph_i_dial_max_index(q);
+    igraph_i_dial_unlink(q, idx);
+    q->state[idx] = 2;
+    q->size--;
+    return -q->key[idx];
+}
+
+igraph_bool_t igraph_i_dial_has_elem(const igraph_i_dial_t *q, long int idx) {
+    return q->buckets ? q->state[idx] != 0 : igraph_2wheap_has_elem(&q->heap, idx);
+}
+
+igraph_bool_t igraph_i_dial_has_active(const igraph_i_dial_t *q, long int idx) {
+    return q->buckets ? q->state[idx] == 1 : igraph_2wheap_has_active(&q->heap, idx);
+}
+
+igraph_real_t igraph_i_dial_get(const igraph_i_dial_t *q, long int idx) {
+    return q->buckets ? -q->key[idx] : igraph_2wheap_get(&q->heap, idx);
+}
+
+/* The new distance must not be smaller than the last removed one,
+   Dijkstra's algorithm never decreases a distance below that. It may
+   be smaller than 'current' though, if the queue was empty when the
+   first neighbor of the last removed vertex was pushed, e.g. with
+   multiple edges. */
+
+int igraph_i_dial_modify(igraph_i_dial_t *q, long int idx, igraph_real_t elem) {
+    if (!q->buckets) {
+        return igraph_2wheap_modify(&q->heap, idx, elem);
+    }
+    igraph_i_dial_unlink(q, idx);
+    q->key[idx] = (long int) (-elem);
+    if (q->key[idx] < q->current) {
+        q->current = q->key[idx];
+    }
+    igraph_i_dial_link(q, idx);
+    return 0;
+}
@@ -23,12 +23,60 @@
 */
 
 #include "igraph_datatype.h"
-#include "igraph_dqueue.h"
 #include "igraph_iterators.h"
 #include "igraph_interrupt_internal.h"
 #include "igraph_vector.h"
 #include "igraph_interface.h"
 #include "igraph_adjlist.h"
+#include "igraph_adjlist_internal.h"
+#include "igraph_paths.h"
+#include "igraph_msbfs_internal.h"
+
+#include <string.h>
+
+/* Visitor of the multi-source BFS in igraph_i_eccentricity(). The
+   eccentricity of a source is the last distance at which it reaches
+   new vertices; the sources seen at the current distance are collected
+   in 'level' and written to the result when the distance changes. */
+
+typedef struct igraph_i_eccentricity_t {
+    const igraph_i_msbfs_t *msbfs;
+    igraph_vector_t *res;
+    igraph_i_msbfs_word_t level[IGRAPH_I_MSBFS_MAX_WORDS];
+    long int first, dist;
+} igraph_i_eccentricity_t;
+
+static void igraph_i_eccentricity_flush(igraph_i_eccentricity_t *data) {
+    int w;
+    for (w = 0; w < data->msbfs->words; w++) {
+        igraph_i_msbfs_word_t x = data->level[w];
+        while (x) {
+            long int i = data->first + w * IGRAPH_I_MSBFS_WORD_BITS +
+                         IGRAPH_I_MSBFS_CTZ(x);
+            VECTOR(*data->res)[i] = data->dist;
+            x &= x - 1;
+        }
+        data->level[w] = 0;
+    }
+}
+
+static int igraph_i_eccentricity_visit(long int vertex, long int dist,
+                                       long int first,
+                                       const igraph_i_msbfs_word_t *sources,
+                                       void *extra) {
+    igraph_i_eccentricity_t *data = (igraph_i_eccentricity_t *) extra;
+    int w;
+    if (dist != data->dist || first != data->first) {
+        igraph_i_eccentricity_flush(data);
+        data->dist = dist;
+        data->first = first;
+    }
+    for (w = 0; w < data->msbfs->words; w++) {
+        data->level[w] |= sources[w];
+    }
+    IGRAPH_UNUSED(vertex);
+    return 0;
+}
 
 static int igraph_i_eccentricity(const igraph_t *graph,
                                  igraph_vector_t *res,
@@ -36,87 +84,290 @@ static int igraph_i_eccentricity(const igraph_t *graph,
                                  igraph_neimode_t mode,
                                  const igraph_adjlist_t *adjlist) {
 
-    int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_long_t q;
     igraph_vit_t vit;
-    igraph_vector_int_t counted;
-    int i, mark = 1;
-    igraph_vector_t vneis;
-    igraph_vector_int_t *neis;
-
-    IGRAPH_CHECK(igraph_dqueue_long_init(&q, 100));
-    IGRAPH_FINALLY(igraph_dqueue_long_destroy, &q);
+    igraph_adjlist_t myadjlist;
+    igraph_i_msbfs_t msbfs;
+    igraph_i_eccentricity_t data;
 
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
 
-    IGRAPH_CHECK(igraph_vector_int_init(&counted, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_int_destroy, &counted);
-
     if (!adjlist) {
-        IGRAPH_VECTOR_INIT_FINALLY(&vneis, 0);
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &myadjlist, mode));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &myadjlist);
+        adjlist = &myadjlist;
     }
 
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, adjlist, IGRAPH_VIT_SIZE(vit)));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
+
     IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
     igraph_vector_fill(res, -1);
 
-    for (i = 0, IGRAPH_VIT_RESET(vit);
-         !IGRAPH_VIT_END(vit);
-         IGRAPH_VIT_NEXT(vit), mark++, i++) {
+    data.msbfs = &msbfs;
+    data.res = res;
+    memset(data.level, 0, sizeof(data.level));
+    data.first = 0;
+    data.dist = 0;
+    IGRAPH_CHECK(igraph_i_msbfs_run(&msbfs, &vit, igraph_i_eccentricity_visit,
+                                    &data, /*progress=*/ 0));
+    igraph_i_eccentricity_flush(&data);
+
+    igraph_i_msbfs_destroy(&msbfs);
+    IGRAPH_FINALLY_CLEAN(1);
+    if (adjlist == &myadjlist) {
+        igraph_adjlist_destroy(&myadjlist);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* Eccentricities with few searches, for undirected paths (Takes and
+   Kosters: Computing the eccentricity distribution of large graphs,
+   Algorithms 6, 100-118, 2013). Every vertex has a lower and an upper
+   bound on its eccentricity: a BFS from v, of eccentricity e, gives
+   max(d(v,w), e - d(v,w)) <= ecc(w) <= e + d(v,w) for the vertices w
+   it reaches. The sources are chosen alternately with the largest
+   upper and the smallest lower bound, ties broken by degree. The
+   search ends when the bounds are equal for every vertex, or, for the
+   center or the periphery, when the remaining vertices cannot have the
+   smallest or the largest eccentricity; these are left at -1 in 'res'.
+
+   Leaves attached to the same vertex have the same eccentricity, only
+   the first one is searched.
+
+   In graphs with a small diameter the bounds of many vertices stay
+   apart for a long time. When a window of searches decides too few
+   vertices, the remaining ones are searched with the multi-source BFS,
+   which costs much less than a BFS per source. */
+
+#define IGRAPH_I_ECC_WINDOW 32
+#define IGRAPH_I_ECC_MIN_DECIDED 16
+
+typedef enum { IGRAPH_I_ECC_ALL = 0,
+               IGRAPH_I_ECC_CENTER,
+               IGRAPH_I_ECC_PERIPHERY
+             } igraph_i_ecc_goal_t;
+
+static int igraph_i_eccentricity_bounds(const igraph_t *graph,
+                                        const igraph_adjlist_t *adjlist,
+                                        igraph_vector_t *res,
+                                        igraph_i_ecc_goal_t goal) {
+
+    long int no_of_nodes = igraph_adjlist_size(adjlist);
+    igraph_vector_long_t lower, upper, dist, queue, cand, rep;
+    long int i, k, ncand = 0, searches = 0, window_start = 0;
+    long int radius_upper = no_of_nodes, diameter_lower = 0;
+    igraph_bool_t turn = 0;
+
+    IGRAPH_CHECK(igraph_vector_long_init(&lower, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &lower);
+    IGRAPH_CHECK(igraph_vector_long_init(&upper, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &upper);
+    IGRAPH_CHECK(igraph_vector_long_init(&dist, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &dist);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+    IGRAPH_CHECK(igraph_vector_long_init(&cand, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &cand);
+    IGRAPH_CHECK(igraph_vector_long_init_seq(&rep, 0, no_of_nodes - 1));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &rep);
+
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+    igraph_vector_fill(res, -1);
+    igraph_vector_long_fill(&upper, no_of_nodes);
+    igraph_vector_long_fill(&dist, -1);
+
+    /* 'queue' holds the first leaf of each vertex here */
+    igraph_vector_long_fill(&queue, -1);
+    for (i = 0; i < no_of_nodes; i++) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, i);
+        if (igraph_vector_int_size(neis) == 1) {
+            long int u = (long int) VECTOR(*neis)[0];
+            if (igraph_vector_int_size(igraph_adjlist_get(adjlist, u)) > 1) {
+                if (VECTOR(queue)[u] < 0) {
+                    VECTOR(queue)[u] = i;
+                } else {
+                    VECTOR(rep)[i] = VECTOR(queue)[u];
+                }
+            }
+        }
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        if (VECTOR(rep)[i] == i) {
+            VECTOR(cand)[ncand++] = i;
+        }
+    }
 
-        long int source;
-        source = IGRAPH_VIT_GET(vit);
-        IGRAPH_CHECK(igraph_dqueue_long_push(&q, source));
-        IGRAPH_CHECK(igraph_dqueue_long_push(&q, 0));
-        VECTOR(counted)[source] = mark;
+    while (ncand > 0) {
+        long int v = VECTOR(cand)[0], head = 0, tail = 0, ecc;
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_long_empty(&q)) {
-            long int act = igraph_dqueue_long_pop(&q);
-            long int dist = igraph_dqueue_long_pop(&q);
-            int j, n;
+        if (searches % IGRAPH_I_ECC_WINDOW == 0) {
+            if (searches > 0 && window_start - ncand <
+                IGRAPH_I_ECC_WINDOW * IGRAPH_I_ECC_MIN_DECIDED) {
+                break;
+            }
+            window_start = ncand;
+        }
+        searches++;
 
-            if (dist > VECTOR(*res)[i]) {
-                VECTOR(*res)[i] = dist;
+        for (k = 1; k < ncand; k++) {
+            long int w = VECTOR(cand)[k];
+            long int a = turn ? VECTOR(lower)[v] : VECTOR(upper)[w];
+            long int b = turn ? VECTOR(lower)[w] : VECTOR(upper)[v];
+            if (a > b || (a == b &&
+                          igraph_vector_int_size(igraph_adjlist_get(adjlist, w)) >
+                          igraph_vector_int_size(igraph_adjlist_get(adjlist, v)))) {
+                v = w;
             }
+        }
+        turn = !turn;
 
-            if (adjlist) {
-                neis = igraph_adjlist_get(adjlist, act);
-                n = (int) igraph_vector_int_size(neis);
-                for (j = 0; j < n; j++) {
-                    int nei = (int) VECTOR(*neis)[j];
-                    if (VECTOR(counted)[nei] != mark) {
-                        VECTOR(counted)[nei] = mark;
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist + 1));
-                    }
-                }
-            } else {
-                IGRAPH_CHECK(igraph_neighbors(graph, &vneis,
-                                              (igraph_integer_t) act, mode));
-                n = (int) igraph_vector_size(&vneis);
-                for (j = 0; j < n; j++) {
-                    int nei = (int) VECTOR(vneis)[j];
-                    if (VECTOR(counted)[nei] != mark) {
-                        VECTOR(counted)[nei] = mark;
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist + 1));
-                    }
+        VECTOR(queue)[tail++] = v;
+        VECTOR(dist)[v] = 0;
+        while (head < tail) {
+            long int act = VECTOR(queue)[head++];
+            igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, act);
+            long int j, n = igraph_vector_int_size(neis);
+            for (j = 0; j < n; j++) {
+                long int nei = (long int) VECTOR(*neis)[j];
+                if (VECTOR(dist)[nei] < 0) {
+                    VECTOR(dist)[nei] = VECTOR(dist)[act] + 1;
+                    VECTOR(queue)[tail++] = nei;
                 }
             }
-        } /* while !igraph_dqueue_long_empty(dqueue) */
+        }
 
-    } /* for IGRAPH_VIT_NEXT(vit) */
+        ecc = VECTOR(dist)[VECTOR(queue)[tail - 1]];
+        for (k = 0; k < tail; k++) {
+            long int w = VECTOR(queue)[k], d = VECTOR(dist)[w];
+            long int lo = d > ecc - d ? d : ecc - d;
+            if (lo > VECTOR(lower)[w]) {
+                VECTOR(lower)[w] = lo;
+            }
+            if (ecc + d < VECTOR(upper)[w]) {
+                VECTOR(upper)[w] = ecc + d;
+            }
+            if (VECTOR(upper)[w] < radius_upper) {
+                radius_upper = VECTOR(upper)[w];
+            }
+            if (VECTOR(lower)[w] > diameter_lower) {
+                diameter_lower = VECTOR(lower)[w];
+            }
+            VECTOR(dist)[w] = -1;
+        }
 
-    if (!adjlist) {
-        igraph_vector_destroy(&vneis);
-        IGRAPH_FINALLY_CLEAN(1);
+        /* Keep the undecided candidates */
+        for (i = 0, k = 0; k < ncand; k++) {
+            long int w = VECTOR(cand)[k];
+            if (VECTOR(lower)[w] == VECTOR(upper)[w]) {
+                VECTOR(*res)[w] = VECTOR(lower)[w];
+            } else if (!(goal == IGRAPH_I_ECC_CENTER &&
+                         VECTOR(lower)[w] > radius_upper) &&
+                       !(goal == IGRAPH_I_ECC_PERIPHERY &&
+                         VECTOR(upper)[w] < diameter_lower)) {
+                VECTOR(cand)[i++] = w;
+            }
+        }
+        ncand = i;
     }
-    igraph_vector_int_destroy(&counted);
-    igraph_vit_destroy(&vit);
-    igraph_dqueue_long_destroy(&q);
-    IGRAPH_FINALLY_CLEAN(3);
+
+    if (ncand > 0) {
+        igraph_vector_t vids, ecc;
+        IGRAPH_VECTOR_INIT_FINALLY(&vids, ncand);
+        IGRAPH_VECTOR_INIT_FINALLY(&ecc, ncand);
+        for (k = 0; k < ncand; k++) {
+            VECTOR(vids)[k] = VECTOR(cand)[k];
+        }
+        IGRAPH_CHECK(igraph_i_eccentricity(graph, &ecc, igraph_vss_vector(&vids),
+                                           IGRAPH_ALL, adjlist));
+        for (k = 0; k < ncand; k++) {
+            VECTOR(*res)[VECTOR(cand)[k]] = VECTOR(ecc)[k];
+        }
+        igraph_vector_destroy(&ecc);
+        igraph_vector_destroy(&vids);
+        IGRAPH_FINALLY_CLEAN(2);
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(*res)[i] = VECTOR(*res)[VECTOR(rep)[i]];
+    }
+
+    igraph_vector_long_destroy(&rep);
+    igraph_vector_long_destroy(&cand);
+    igraph_vector_long_destroy(&queue);
+    igraph_vector_long_destroy(&dist);
+    igraph_vector_long_destroy(&upper);
+    igraph_vector_long_destroy(&lower);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
+/* The eccentricities of all vertices, the ones that cannot be in the
+   center or the periphery (see 'goal') may be left at -1 */
+
+static int igraph_i_eccentricity_all(const igraph_t *graph,
+                                     igraph_vector_t *res,
+                                     igraph_neimode_t mode,
+                                     igraph_i_ecc_goal_t goal) {
+
+    igraph_adjlist_t adjlist;
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist, mode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+
+    if (mode == IGRAPH_ALL) {
+        IGRAPH_CHECK(igraph_i_eccentricity_bounds(graph, &adjlist, res, goal));
+    } else {
+        IGRAPH_CHECK(igraph_i_eccentricity(graph, res, igraph_vss_all(), mode,
+                                           &adjlist));
+    }
+
+    igraph_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* The vertices of the smallest or the largest eccentricity */
+
+static int igraph_i_eccentricity_select(const igraph_t *graph,
+                                        igraph_vector_t *res,
+                                        igraph_neimode_t mode,
+                                        igraph_i_ecc_goal_t goal) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_t ecc;
+    igraph_real_t best = -1;
+    long int i;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&ecc, no_of_nodes);
+    IGRAPH_CHECK(igraph_i_eccentricity_all(graph, &ecc, mode, goal));
+
+    for (i = 0; i < no_of_nodes; i++) {
+        igraph_real_t e = VECTOR(ecc)[i];
+        if (e >= 0 && (best < 0 || (goal == IGRAPH_I_ECC_CENTER ? e < best : e > best))) {
+            best = e;
+        }
+    }
+    igraph_vector_clear(res);
+    for (i = 0; i < no_of_nodes; i++) {
+        if (VECTOR(ecc)[i] == best) {
+            IGRAPH_CHECK(igraph_vector_push_back(res, i));
+        }
+    }
+
+    igraph_vector_destroy(&ecc);
+    IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
 }
@@ -133,6 +384,19 @@ static int igraph_i_eccentricity(const igraph_t *graph,
  * This implementation ignores vertex pairs that are in different
  * components. Isolated vertices have eccentricity zero.
  *
+ * </para><para>
+ * If the eccentricity of all vertices is requested and the paths are
+ * undirected, then the algorithm of Takes and Kosters is used: it
+ * keeps a lower and an upper bound for the eccentricity of every
+ * vertex, and tightens them with a breadth-first search from a few
+ * vertices only, until they are equal. Otherwise a search is started
+ * from every requested vertex.
+ *
+ * </para><para>
+ * Reference: Frank W. Takes and Walter A. Kosters: Computing the
+ * eccentricity distribution of large graphs, Algorithms 6, 100-118
+ * (2013).
+ *
  * \param graph The input graph, it can be directed or undirected.
  * \param res Pointer to an initialized vector, the result is stored
  *    here.
@@ -146,9 +410,12 @@ static int igraph_i_eccentricity(const igraph_t *graph,
  *
  * Time complexity: O(v*(|V|+|E|)), where |V| is the number of
  * vertices, |E| is the number of edges and v is the number of
- * vertices for which eccentricity is calculated.
+ * vertices for which eccentricity is calculated. For all vertices
+ * and undirected paths this is the worst case, usually much fewer
+ * searches are needed.
  *
- * \sa \ref igraph_radius().
+ * \sa \ref igraph_radius(), \ref igraph_graph_center(), \ref
+ * igraph_graph_periphery().
  *
  * \example examples/simple/igraph_eccentricity.c
  */
@@ -158,6 +425,10 @@ int igraph_eccentricity(const igraph_t *graph,
                         igraph_vs_t vids,
                         igraph_neimode_t mode) {
 
+    if (igraph_vs_is_all(&vids) &&
+        (mode == IGRAPH_ALL || !igraph_is_directed(graph))) {
+        return igraph_i_eccentricity_all(graph, res, mode, IGRAPH_I_ECC_ALL);
+    }
     return igraph_i_eccentricity(graph, res, vids, mode, /*adjlist=*/ 0);
 }
 
@@ -168,6 +439,11 @@ int igraph_eccentricity(const igraph_t *graph,
  * The radius of a graph is the defined as the minimum eccentricity of
  * its vertices, see \ref igraph_eccentricity().
  *
+ * </para><para>
+ * For undirected paths only the vertices that may have the smallest
+ * eccentricity are searched until their eccentricity is known, see
+ * \ref igraph_eccentricity().
+ *
  * \param graph The input graph, it can be directed or undirected.
  * \param radius Pointer to a real variable, the result is stored
  *   here.
@@ -179,9 +455,10 @@ int igraph_eccentricity(const igraph_t *graph,
  * \return Error code.
  *
  * Time complexity: O(|V|(|V|+|E|)), where |V| is the number of
- * vertices and |E| is the number of edges.
+ * vertices and |E| is the number of edges. For undirected paths this
+ * is the worst case, usually much fewer searches are needed.
  *
- * \sa \ref igraph_eccentricity().
+ * \sa \ref igraph_eccentricity(), \ref igraph_graph_center().
  *
  * \example examples/simple/igraph_radius.c
  */
@@ -194,18 +471,94 @@ int igraph_radius(const igraph_t *graph, igraph_real_t *radius,
     if (no_of_nodes == 0) {
         *radius = IGRAPH_NAN;
     } else {
-        igraph_adjlist_t adjlist;
         igraph_vector_t ecc;
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-        IGRAPH_VECTOR_INIT_FINALLY(&ecc, igraph_vcount(graph));
-        IGRAPH_CHECK(igraph_i_eccentricity(graph, &ecc, igraph_vss_all(),
-                                           mode, &adjlist));
-        *radius = igraph_vector_min(&ecc);
+        long int i;
+        IGRAPH_VECTOR_INIT_FINALLY(&ecc, no_of_nodes);
+        IGRAPH_CHECK(igraph_i_eccentricity_all(graph, &ecc, mode,
+                                               IGRAPH_I_ECC_CENTER));
+        *radius = IGRAPH_INFINITY;
+        for (i = 0; i < no_of_nodes; i++) {
+            if (VECTOR(ecc)[i] >= 0 && VECTOR(ecc)[i] < *radius) {
+                *radius = VECTOR(ecc)[i];
+            }
+        }
         igraph_vector_destroy(&ecc);
-        igraph_adjlist_destroy(&adjlist);
-        IGRAPH_FINALLY_CLEAN(2);
+        IGRAPH_FINALLY_CLEAN(1);
     }
 
     return 0;
 }
+
+/**
+ * \function igraph_graph_center
+ * Central vertices of a graph
+ *
+ * The center of a graph is the set of its vertices with the smallest
+ * eccentricity, the radius of the graph, see \ref igraph_radius().
+ *
+ * </para><para>
+ * For undirected paths only the vertices that may have the smallest
+ * eccentricity are searched until their eccentricity is known, see
+ * \ref igraph_eccentricity().
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param res Pointer to an initialized vector, the ids of the central
+ *    vertices are stored here, in increasing order. It is empty for
+ *    the null graph.
+ * \param mode What kind of paths to consider for the calculation:
+ *    \c IGRAPH_OUT, paths that follow edge directions;
+ *    \c IGRAPH_IN, paths that follow the opposite directions; and
+ *    \c IGRAPH_ALL, paths that ignore edge directions. This argument
+ *    is ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|(|V|+|E|)), where |V| is the number of
+ * vertices and |E| is the number of edges. For undirected paths this
+ * is the worst case, usually much fewer searches are needed.
+ *
+ * \sa \ref igraph_radius(), \ref igraph_graph_periphery().
+ */
+
+int igraph_graph_center(const igraph_t *graph, igraph_vector_t *res,
+                        igraph_neimode_t mode) {
+
+    return igraph_i_eccentricity_select(graph, res, mode, IGRAPH_I_ECC_CENTER);
+}
+
+/**
+ * \function igraph_graph_periphery
+ * Peripheral vertices of a graph
+ *
+ * The periphery of a graph is the set of its vertices with the
+ * largest eccentricity. Vertex pairs in different components are
+ * ignored, as in \ref igraph_eccentricity(), so this is the diameter
+ * of the largest component, see \ref igraph_diameter().
+ *
+ * </para><para>
+ * For undirected paths only the vertices that may have the largest
+ * eccentricity are searched until their eccentricity is known, see
+ * \ref igraph_eccentricity().
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param res Pointer to an initialized vector, the ids of the
+ *    peripheral vertices are stored here, in increasing order. It is
+ *    empty for the null graph.
+ * \param mode What kind of paths to consider for the calculation:
+ *    \c IGRAPH_OUT, paths that follow edge directions;
+ *    \c IGRAPH_IN, paths that follow the opposite directions; and
+ *    \c IGRAPH_ALL, paths that ignore edge directions. This argument
+ *    is ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|(|V|+|E|)), where |V| is the number of
+ * vertices and |E| is the number of edges. For undirected paths this
+ * is the worst case, usually much fewer searches are needed.
+ *
+ * \sa \ref igraph_graph_center(), \ref igraph_diameter().
+ */
+
+int igraph_graph_periphery(const igraph_t *graph, igraph_vector_t *res,
+                           igraph_neimode_t mode) {
+
+    return igraph_i_eccentricity_select(graph, res, mode, IGRAPH_I_ECC_PERIPHERY);
+}
@@ -0,0 +1,456 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "config.h"
+#include "igraph_paths.h"
+#include "igraph_adjlist.h"
+#include "igraph_adjlist_internal.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_random.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_parallel_internal.h"
+
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#else
+    #ifdef HAVE_SYS_INT_TYPES_H
+        #include <sys/int_types.h>
+    #else
+        #include "pstdint.h"
+    #endif
+#endif
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * \section about_hyperanf
+ *
+ * <para>The neighborhood function of a graph gives, for every distance
+ * t, the number of vertex pairs that are at most t apart. HyperANF
+ * (Boldi, Rosa and Vigna) approximates it without a search from every
+ * vertex: each vertex has a HyperLogLog counter, a small array of
+ * registers that estimates the number of distinct vertices added to
+ * it. The counter of a vertex starts with the vertex itself, and in
+ * each pass over the graph it is merged with the counters of its
+ * neighbors, so after t passes it estimates the number of vertices
+ * within distance t. The passes stop when no counter changes, after
+ * at most the diameter of the graph plus one passes; a few less if
+ * the pairs at the largest distances do not change any register.</para>
+ *
+ * <para>With 2^b registers per vertex, the relative standard error of
+ * the estimates is about 1.04 / sqrt(2^b), and the counters need
+ * 2 * 2^b bytes per vertex. The estimates depend on the state of the
+ * random number generator, but not on the number of threads set by
+ * \ref igraph_set_num_threads().</para>
+ *
+ * <para>Reference: Paolo Boldi, Marco Rosa and Sebastiano Vigna:
+ * HyperANF: Approximating the neighbourhood function of very large
+ * graphs on a budget, Proceedings of the 20th International Conference
+ * on World Wide Web, 625-634 (2011).</para>
+ */
+
+/* Vertices per task of a pass */
+#define IGRAPH_I_HYPERANF_BLOCK 4096
+
+/* The registers are bytes, eight in a word. They are at most 61, so
+   the highest bit of each byte is free for the broadword comparisons. */
+#define IGRAPH_I_HYPERANF_HIGH UINT64_C(0x8080808080808080)
+
+typedef struct igraph_i_hyperanf_t {
+    const igraph_adjlist_t *adjlist;
+    long int no_of_nodes;
+    long int m;                 /* registers per vertex */
+    long int words;             /* m / 8 */
+    uint64_t *cur, *next;       /* the counters, m bytes per vertex */
+    char *changed, *next_changed;
+    igraph_real_t *est;         /* the estimate of each counter */
+    igraph_real_t *block_sum;
+    long int *block_changed;
+    igraph_real_t alpha_mm;
+    igraph_real_t pow2[65];     /* 2^-r */
+} igraph_i_hyperanf_t;
+
+static uint64_t igraph_i_hyperanf_hash(uint64_t x) {
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+/* The number of leading zeros plus one, of the bits after the
+   register index */
+
+static int igraph_i_hyperanf_rho(uint64_t x, int bits) {
+    int r = 1;
+    while (r <= bits && !(x & (UINT64_C(1) << 63))) {
+        x <<= 1;
+        r++;
+    }
+    return r;
+}
+
+static igraph_real_t igraph_i_hyperanf_estimate(const igraph_i_hyperanf_t *h,
+        const unsigned char *reg) {
+    igraph_real_t sum = 0.0, e;
+    long int j, zeros = 0;
+    for (j = 0; j < h->m; j++) {
+        sum += h->pow2[reg[j]];
+        zeros += (reg[j] == 0);
+    }
+    e = h->alpha_mm / sum;
+    if (e <= 2.5 * h->m && zeros > 0) {
+        /* linear counting for small sets */
+        e = h->m * log((double) h->m / zeros);
+    }
+    return e;
+}
+
+/* One pass over a block of vertices. The counter of v only needs to be
+   merged with the neighbors that changed in the previous pass, the
+   others were merged already. The buffers are swapped after the pass,
+   so 'next' holds the counter of two passes ago, which is up to date
+   unless v changed in the previous pass. */
+
+static int igraph_i_hyperanf_task(void *data, long int task, int thread) {
+    igraph_i_hyperanf_t *h = (igraph_i_hyperanf_t *) data;
+    long int v, from = task * IGRAPH_I_HYPERANF_BLOCK;
+    long int to = from + IGRAPH_I_HYPERANF_BLOCK;
+    long int words = h->words, count = 0;
+    igraph_real_t sum = 0.0;
+
+    IGRAPH_UNUSED(thread);
+    if (to > h->no_of_nodes) {
+        to = h->no_of_nodes;
+    }
+
+    for (v = from; v < to; v++) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(h->adjlist, v);
+        long int j, k, n = igraph_vector_int_size(neis);
+        uint64_t *dst = h->next + v * words;
+        const uint64_t *src = h->cur + v * words;
+        igraph_bool_t copied = 0;
+        uint64_t grew = 0;
+
+        for (j = 0; j < n; j++) {
+            long int nei = (long int) VECTOR(*neis)[j];
+            const uint64_t *other;
+            if (!h->changed[nei]) {
+                continue;
+            }
+            if (!copied) {
+                memcpy(dst, src, (size_t) words * sizeof(uint64_t));
+                copied = 1;
+            }
+            /* Byte-wise maximum: the high bit of a byte of
+               (a | HIGH) - b is set if a >= b, there is no borrow
+               between the bytes */
+            other = h->cur + nei * words;
+            for (k = 0; k < words; k++) {
+                uint64_t a = other[k], b = dst[k];
+                uint64_t ge = ((a | IGRAPH_I_HYPERANF_HIGH) - b) & IGRAPH_I_HYPERANF_HIGH;
+                uint64_t mask = (ge >> 7) * 0xFF;
+                grew |= ~((b | IGRAPH_I_HYPERANF_HIGH) - a) & IGRAPH_I_HYPERANF_HIGH;
+                dst[k] = (a & mask) | (b & ~mask);
+            }
+        }
+        if (!copied && h->changed[v]) {
+            memcpy(dst, src, (size_t) words * sizeof(uint64_t));
+        }
+
+        h->next_changed[v] = (char) (grew != 0);
+        if (grew) {
+            h->est[v] = igraph_i_hyperanf_estimate(h, (const unsigned char *) dst);
+            count++;
+        }
+        sum += h->est[v];
+    }
+
+    h->block_sum[task] = sum;
+    h->block_changed[task] = count;
+    return 0;
+}
+
+static void igraph_i_hyperanf_destroy(igraph_i_hyperanf_t *h) {
+    igraph_Free(h->block_changed);
+    igraph_Free(h->block_sum);
+    igraph_Free(h->est);
+    igraph_Free(h->next_changed);
+    igraph_Free(h->changed);
+    igraph_Free(h->next);
+    igraph_Free(h->cur);
+}
+
+/**
+ * \function igraph_hyperanf
+ * \brief Approximate neighborhood function, with HyperLogLog counters.
+ *
+ * Estimates the number of vertex pairs within each distance, and the
+ * number of vertices within a given distance from each vertex, in a
+ * few passes over the graph, see \ref about_hyperanf. The passes are
+ * split between the threads set by \ref igraph_set_num_threads().
+ *
+ * </para><para>
+ * The exact values are given by \ref igraph_path_length_hist() and
+ * \ref igraph_neighborhood_size(), but these need a search from every
+ * vertex.
+ *
+ * \param graph The input graph.
+ * \param nf Pointer to an initialized vector or a null pointer. If not
+ *    a null pointer, then element t is the estimated number of ordered
+ *    vertex pairs (u, v) with a path from u to v of length at most t,
+ *    including the pairs (u, u), for t = 0, 1, ... up to the largest
+ *    distance in the graph (or a little less, see \ref
+ *    about_hyperanf), or up to \p order if it is smaller. The
+ *    last element is the estimated number of pairs with a path
+ *    between them, unless \p order stopped the passes.
+ * \param sizes Pointer to an initialized vector or a null pointer. If
+ *    not a null pointer, then the estimated number of vertices
+ *    reachable from each vertex within \p order steps, including the
+ *    vertex itself, is stored here.
+ * \param order The largest distance to consider, the number of passes.
+ *    If negative, then the passes go on until no counter changes.
+ * \param mode The type of the paths, ignored for undirected graphs.
+ *    \c IGRAPH_OUT follows the edge directions, \c IGRAPH_IN goes
+ *    against them, \c IGRAPH_ALL ignores them.
+ * \param log2m The base two logarithm of the number of registers of a
+ *    counter, between 4 and 16. The relative standard error is about
+ *    1.04 / sqrt(2^log2m), and the counters need 2 * 2^log2m bytes
+ *    per vertex; 6, i.e. 64 registers, gives 13 percent.
+ * \return Error code:
+ *    \c IGRAPH_EINVAL: invalid \p log2m or \p mode;
+ *    \c IGRAPH_ENOMEM: not enough memory for the counters.
+ *
+ * Time complexity: O(d(|V| 2^log2m + |E|)) in the worst case, where d
+ * is the number of passes, at most the diameter of the graph plus one,
+ * if \p order is negative. Counters are only merged along the edges
+ * whose source changed in the previous pass.
+ *
+ * \sa \ref igraph_hyperanf_stats() for the distance distribution, the
+ * average path length and the effective diameter.
+ */
+
+int igraph_hyperanf(const igraph_t *graph, igraph_vector_t *nf,
+                    igraph_vector_t *sizes, igraph_integer_t order,
+                    igraph_neimode_t mode, igraph_integer_t log2m) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_blocks = (no_of_nodes + IGRAPH_I_HYPERANF_BLOCK - 1) /
+                            IGRAPH_I_HYPERANF_BLOCK;
+    int no_of_threads = igraph_i_parallel_threads(no_of_blocks);
+    igraph_i_hyperanf_t h;
+    igraph_adjlist_t adjlist;
+    uint64_t seed;
+    long int i, j, t;
+    igraph_real_t sum;
+
+    if (log2m < 4 || log2m > 16) {
+        IGRAPH_ERROR("The number of registers must be between 2^4 and 2^16",
+                     IGRAPH_EINVAL);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist, mode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+
+    memset(&h, 0, sizeof(h));
+    IGRAPH_FINALLY(igraph_i_hyperanf_destroy, &h);
+    h.adjlist = &adjlist;
+    h.no_of_nodes = no_of_nodes;
+    h.m = 1L << log2m;
+    h.words = h.m / 8;
+    h.cur = igraph_Calloc(no_of_nodes * h.words, uint64_t);
+    h.next = igraph_Calloc(no_of_nodes * h.words, uint64_t);
+    h.changed = igraph_Calloc(no_of_nodes, char);
+    h.next_changed = igraph_Calloc(no_of_nodes, char);
+    h.est = igraph_Calloc(no_of_nodes, igraph_real_t);
+    h.block_sum = igraph_Calloc(no_of_blocks, igraph_real_t);
+    h.block_changed = igraph_Calloc(no_of_blocks, long int);
+    if (no_of_nodes > 0 && (!h.cur || !h.next || !h.changed ||
+                            !h.next_changed || !h.est || !h.block_sum ||
+                            !h.block_changed)) {
+        IGRAPH_ERROR("Cannot allocate HyperLogLog counters", IGRAPH_ENOMEM);
+    }
+
+    switch (h.m) {
+    case 16:
+        h.alpha_mm = 0.673;
+        break;
+    case 32:
+        h.alpha_mm = 0.697;
+        break;
+    case 64:
+        h.alpha_mm = 0.709;
+        break;
+    default:
+        h.alpha_mm = 0.7213 / (1.0 + 1.079 / h.m);
+        break;
+    }
+    h.alpha_mm *= (igraph_real_t) h.m * h.m;
+    for (i = 0; i <= 64; i++) {
+        h.pow2[i] = ldexp(1.0, (int) -i);
+    }
+
+    RNG_BEGIN();
+    seed = (uint64_t) RNG_INTEGER(0, 0x7fffffff);
+    seed = (seed << 31) ^ (uint64_t) RNG_INTEGER(0, 0x7fffffff);
+    RNG_END();
+
+    /* Every counter starts with its own vertex */
+    sum = 0.0;
+    for (i = 0; i < no_of_nodes; i++) {
+        uint64_t x = igraph_i_hyperanf_hash(seed ^ (uint64_t) i);
+        unsigned char *reg = (unsigned char *) (h.cur + i * h.words);
+        reg[x >> (64 - log2m)] =
+            (unsigned char) igraph_i_hyperanf_rho(x << log2m, 64 - (int) log2m);
+        h.est[i] = igraph_i_hyperanf_estimate(&h, reg);
+        h.changed[i] = 1;
+        sum += h.est[i];
+    }
+    if (nf) {
+        igraph_vector_clear(nf);
+        IGRAPH_CHECK(igraph_vector_push_back(nf, sum));
+    }
+
+    for (t = 1; order < 0 || t <= order; t++) {
+        long int count = 0;
+        uint64_t *tmp;
+        char *tmpc;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_PARALLEL_FOR(no_of_blocks, no_of_threads,
+                            igraph_i_hyperanf_task, &h);
+
+        sum = 0.0;
+        for (j = 0; j < no_of_blocks; j++) {
+            sum += h.block_sum[j];
+            count += h.block_changed[j];
+        }
+        if (count == 0) {
+            break;
+        }
+        if (nf) {
+            IGRAPH_CHECK(igraph_vector_push_back(nf, sum));
+        }
+
+        tmp = h.cur; h.cur = h.next; h.next = tmp;
+        tmpc = h.changed; h.changed = h.next_changed; h.next_changed = tmpc;
+    }
+
+    if (sizes) {
+        IGRAPH_CHECK(igraph_vector_resize(sizes, no_of_nodes));
+        for (i = 0; i < no_of_nodes; i++) {
+            VECTOR(*sizes)[i] = h.est[i];
+        }
+    }
+
+    igraph_i_hyperanf_destroy(&h);
+    igraph_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_hyperanf_stats
+ * \brief Distance statistics from an approximate neighborhood function.
+ *
+ * \param nf The neighborhood function, as returned by \ref
+ *    igraph_hyperanf(), with a negative \p order.
+ * \param hist Pointer to an initialized vector or a null pointer. If
+ *    not a null pointer, then element i is the estimated number of
+ *    ordered vertex pairs at distance i+1. Undirected graphs have two
+ *    ordered pairs for each unordered one, so these are twice the
+ *    values of \ref igraph_path_length_hist().
+ * \param average_path_length Pointer to a real or a null pointer, the
+ *    estimated average distance between the pairs of different
+ *    vertices with a path between them is stored here. NaN if there
+ *    are no such pairs.
+ * \param effective_diameter Pointer to a real or a null pointer, the
+ *    effective diameter is stored here: the distance within which a
+ *    \p quantile fraction of the pairs of different vertices with a
+ *    path between them are, interpolated linearly between integer
+ *    distances. NaN if there are no such pairs.
+ * \param quantile The fraction of the pairs for the effective
+ *    diameter, 0.9 is commonly used. It must be between 0 and 1.
+ * \return Error code:
+ *    \c IGRAPH_EINVAL: invalid \p quantile.
+ *
+ * Time complexity: O(d), the length of \p nf.
+ */
+
+int igraph_hyperanf_stats(const igraph_vector_t *nf, igraph_vector_t *hist,
+                          igraph_real_t *average_path_length,
+                          igraph_real_t *effective_diameter,
+                          igraph_real_t quantile) {
+
+    long int i, n = igraph_vector_size(nf);
+    igraph_real_t total = 0.0, sum = 0.0, prev = 0.0;
+
+    if (!(quantile > 0 && quantile <= 1)) {
+        IGRAPH_ERROR("The quantile must be between 0 and 1", IGRAPH_EINVAL);
+    }
+
+    if (hist) {
+        IGRAPH_CHECK(igraph_vector_resize(hist, n > 0 ? n - 1 : 0));
+    }
+
+    /* The estimates may decrease a little where the HyperLogLog
+       estimator switches to linear counting, these are ignored */
+    for (i = 1; i < n; i++) {
+        igraph_real_t h = VECTOR(*nf)[i] - VECTOR(*nf)[i - 1];
+        if (h < 0) {
+            h = 0;
+        }
+        if (hist) {
+            VECTOR(*hist)[i - 1] = h;
+        }
+        total += h;
+        sum += i * h;
+    }
+
+    if (average_path_length) {
+        *average_path_length = total > 0 ? sum / total : IGRAPH_NAN;
+    }
+
+    if (effective_diameter) {
+        igraph_real_t cum = 0.0;
+        *effective_diameter = IGRAPH_NAN;
+        for (i = 1; total > 0 && i < n; i++) {
+            igraph_real_t h = VECTOR(*nf)[i] - VECTOR(*nf)[i - 1], f;
+            cum += h > 0 ? h : 0;
+            f = cum / total;
+            if (f >= quantile) {
+                *effective_diameter = i - 1 + (quantile - prev) / (f - prev);
+                break;
+            }
+            prev = f;
+        }
+    }
+
+    return 0;
+}
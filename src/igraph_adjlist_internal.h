@@ -0,0 +1,55 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_ADJLIST_INTERNAL_H
+#define IGRAPH_ADJLIST_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_adjlist.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+    #define __BEGIN_DECLS extern "C" {
+    #define __END_DECLS }
+#else
+    #define __BEGIN_DECLS /* empty */
+    #define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Adjacency and incidence lists with all vectors in a single memory
+   block, which is about three times faster to create than a separate
+   vector for every vertex. The vectors can be read, modified and
+   shrunk, but not grown beyond their original length, so these are
+   only for callers that do not add neighbors. Destroy them with
+   igraph_adjlist_destroy() and igraph_inclist_destroy(). */
+
+int igraph_i_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                               igraph_neimode_t mode);
+int igraph_i_inclist_init_flat(const igraph_t *graph, igraph_inclist_t *il,
+                               igraph_neimode_t mode);
+
+__END_DECLS
+
+#endif
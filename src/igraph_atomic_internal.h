@@ -0,0 +1,53 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_ATOMIC_INTERNAL_H
+#define IGRAPH_ATOMIC_INTERNAL_H
+
+/* Atomic operations on the reference counts of the data shared by
+   graphs and their copies, which may be used from different threads.
+
+   IGRAPH_I_ATOMIC_INC() and IGRAPH_I_ATOMIC_DEC() change a long int
+   and return its new value, IGRAPH_I_ATOMIC_GET() reads it.
+   IGRAPH_I_ATOMIC_SET_PTR() sets a null pointer to a new value and
+   returns true, or returns false if the pointer is not null. Only
+   GCC, Clang and MSVC are supported, other compilers stop with an
+   error instead of silently using non-atomic updates. */
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define IGRAPH_I_ATOMIC_INC(x) _InterlockedIncrement(&(x))
+    #define IGRAPH_I_ATOMIC_DEC(x) _InterlockedDecrement(&(x))
+    #define IGRAPH_I_ATOMIC_GET(x) _InterlockedCompareExchange(&(x), 0, 0)
+    #define IGRAPH_I_ATOMIC_SET_PTR(p, value) \
+        (_InterlockedCompareExchangePointer((void * volatile *) &(p), (value), 0) == 0)
+#elif defined(__GNUC__)
+    #define IGRAPH_I_ATOMIC_INC(x) __sync_add_and_fetch(&(x), 1)
+    #define IGRAPH_I_ATOMIC_DEC(x) __sync_sub_and_fetch(&(x), 1)
+    #define IGRAPH_I_ATOMIC_GET(x) __sync_add_and_fetch(&(x), 0)
+    #define IGRAPH_I_ATOMIC_SET_PTR(p, value) \
+        __sync_bool_compare_and_swap(&(p), 0, (value))
+#else
+    #error "Atomic operations are not supported with this compiler"
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_DELTA_STEPPING_INTERNAL_H
+#define IGRAPH_DELTA_STEPPING_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_vector.h"
+#include "igraph_adjlist.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+    #define __BEGIN_DECLS extern "C" {
+    #define __END_DECLS }
+#else
+    #define __BEGIN_DECLS /* empty */
+    #define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Parallel single-source shortest paths with non-negative weights
+   (Meyer and Sanders' delta-stepping).
+
+   The tentative distances are kept in buckets of width delta. The
+   lowest non-empty bucket is emptied repeatedly, relaxing the light
+   edges (weight at most delta) of its vertices, which may put
+   vertices back into it; then the heavy edges of all vertices removed
+   from it are relaxed once. Every phase runs on the thread pool: the
+   vertices are divided among 'owners', vertex v belongs to owner
+   v % no_of_owners, and only the owner of a vertex changes its label
+   or buckets. An owner relaxes the edges of its own vertices into one
+   request buffer per target owner, then every owner applies the
+   requests addressed to it.
+
+   The labels are compared by distance, then by the number of edges,
+   then by the id of the inbound edge, so the shortest path tree does
+   not depend on the scheduling of the threads, and it has no cycles
+   even if there are zero weights.
+
+   After igraph_i_delta_stepping_run(), dist[v] is the distance of v
+   from the source, IGRAPH_INFINITY if it was not reached, and
+   inbound[v] is the last edge of a shortest path to v, -1 for the
+   source and the unreached vertices. */
+
+typedef struct igraph_i_delta_stepping_owner_t {
+    igraph_vector_long_t *buckets;     /* cyclic, no_of_buckets */
+    igraph_vector_long_t frontier;     /* removed from the current bucket */
+    igraph_vector_long_t settled;      /* all removed from the current bucket */
+} igraph_i_delta_stepping_owner_t;
+
+typedef struct igraph_i_delta_stepping_t {
+    const igraph_weighted_adjlist_t *wal;
+    long int no_of_nodes;
+    int no_of_threads;
+    int no_of_owners;
+    igraph_real_t delta;
+    long int no_of_buckets;
+    long int current;           /* the bucket being emptied */
+    igraph_bool_t heavy;        /* relaxing heavy edges */
+    igraph_real_t *dist;
+    long int *hops, *inbound;
+    long int *queued;           /* bucket of the vertex, or -1 */
+    long int *emptied;          /* last bucket it was removed from */
+    igraph_vector_t *requests;  /* [from_owner * no_of_owners + to_owner] */
+    igraph_i_delta_stepping_owner_t *owners;
+} igraph_i_delta_stepping_t;
+
+int igraph_i_delta_stepping_threads(const igraph_t *graph);
+int igraph_i_delta_stepping_init(igraph_i_delta_stepping_t *ds,
+                                 const igraph_weighted_adjlist_t *wal,
+                                 int no_of_threads);
+void igraph_i_delta_stepping_destroy(igraph_i_delta_stepping_t *ds);
+int igraph_i_delta_stepping_run(igraph_i_delta_stepping_t *ds, long int source);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,88 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_DIAL_INTERNAL_H
+#define IGRAPH_DIAL_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_adjlist.h"
+#include "igraph_types_internal.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+    #define __BEGIN_DECLS extern "C" {
+    #define __END_DECLS }
+#else
+    #define __BEGIN_DECLS /* empty */
+    #define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* The priority queue of Dijkstra's algorithm, with the interface of
+   igraph_2wheap_t: the priorities are the negated distances, the
+   queue returns the largest one first.
+
+   If all weights are integers between zero and
+   IGRAPH_I_DIAL_MAX_WEIGHT, then it is a bucket queue (Dial's
+   algorithm): the vertices at distance d are in a linked list in
+   bucket d % (max_weight + 1). Dijkstra's algorithm never pushes a
+   vertex farther than the largest weight from the last removed one,
+   so each bucket holds a single distance, and all operations take
+   constant time, except for skipping the empty buckets. Otherwise it
+   is an igraph_2wheap_t. Only distances that are sums of the weights,
+   plus an integer offset, can be pushed. */
+
+#define IGRAPH_I_DIAL_MAX_WEIGHT 1024
+
+typedef struct igraph_i_dial_t {
+    igraph_bool_t buckets;      /* bucket queue, or the heap */
+    igraph_2wheap_t heap;
+    long int no_of_nodes;
+    long int no_of_buckets;     /* the largest weight plus one */
+    long int *head;             /* first vertex of each bucket, or -1 */
+    long int *next, *prev;      /* the lists of the buckets */
+    long int *key;              /* distance of the vertex */
+    char *state;                /* 0: not pushed, 1: queued, 2: deactivated */
+    long int size;              /* number of queued vertices */
+    long int current;           /* no queued vertex is closer than this */
+} igraph_i_dial_t;
+
+int igraph_i_dial_init(igraph_i_dial_t *q, long int size,
+                       const igraph_weighted_adjlist_t *wal);
+void igraph_i_dial_destroy(igraph_i_dial_t *q);
+void igraph_i_dial_clear(igraph_i_dial_t *q);
+igraph_bool_t igraph_i_dial_empty(const igraph_i_dial_t *q);
+int igraph_i_dial_push_with_index(igraph_i_dial_t *q, long int idx,
+                                  igraph_real_t elem);
+long int igraph_i_dial_max_index(igraph_i_dial_t *q);
+igraph_real_t igraph_i_dial_delete_max(igraph_i_dial_t *q);
+igraph_real_t igraph_i_dial_deactivate_max(igraph_i_dial_t *q);
+igraph_bool_t igraph_i_dial_has_elem(const igraph_i_dial_t *q, long int idx);
+igraph_bool_t igraph_i_dial_has_active(const igraph_i_dial_t *q, long int idx);
+igraph_real_t igraph_i_dial_get(const igraph_i_dial_t *q, long int idx);
+int igraph_i_dial_modify(igraph_i_dial_t *q, long int idx, igraph_real_t elem);
+
+__END_DECLS
+
+#endif
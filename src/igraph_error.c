@@ -24,6 +24,7 @@
 #include "config.h"
 #include "igraph_error.h"
 #include "igraph_types.h"
+#include "igraph_parallel_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -114,6 +115,12 @@ const char* igraph_strerror(const int igraph_errno) {
 int igraph_error(const char *reason, const char *file, int line,
                  int igraph_errno) {
 
+    /* Errors in the tasks of parallel loops are reported later, on
+       the thread that started the loop */
+    if (igraph_i_parallel_in_task()) {
+        return igraph_i_parallel_error(reason, file, line, igraph_errno);
+    }
+
     if (igraph_i_error_handler) {
         igraph_i_error_handler(reason, file, line, igraph_errno);
 #ifndef USING_R
@@ -127,14 +134,21 @@ int igraph_error(const char *reason, const char *file, int line,
 int igraph_errorf(const char *reason, const char *file, int line,
                   int igraph_errno, ...) {
     va_list ap;
+    int ret;
     va_start(ap, igraph_errno);
-    vsnprintf(igraph_i_errormsg_buffer,
-              sizeof(igraph_i_errormsg_buffer) / sizeof(char), reason, ap);
-    return igraph_error(igraph_i_errormsg_buffer, file, line, igraph_errno);
+    ret = igraph_errorvf(reason, file, line, igraph_errno, ap);
+    va_end(ap);
+    return ret;
 }
 
 int igraph_errorvf(const char *reason, const char *file, int line,
                    int igraph_errno, va_list ap) {
+    if (igraph_i_parallel_in_task()) {
+        /* the message buffer may be shared by the threads */
+        char buffer[sizeof(igraph_i_errormsg_buffer)];
+        vsnprintf(buffer, sizeof(buffer) / sizeof(char), reason, ap);
+        return igraph_error(buffer, file, line, igraph_errno);
+    }
     vsnprintf(igraph_i_errormsg_buffer,
               sizeof(igraph_i_errormsg_buffer) / sizeof(char), reason, ap);
     return igraph_error(igraph_i_errormsg_buffer, file, line, igraph_errno);
@@ -262,6 +276,11 @@ void igraph_warning_handler_print (const char *reason, const char *file,
 int igraph_warning(const char *reason, const char *file, int line,
                    int igraph_errno) {
 
+    if (igraph_i_parallel_in_task()) {
+        igraph_i_parallel_warning(reason, file, line, igraph_errno);
+        return igraph_errno;
+    }
+
     if (igraph_i_warning_handler) {
         igraph_i_warning_handler(reason, file, line, igraph_errno);
 #ifndef USING_R
@@ -276,8 +295,16 @@ int igraph_warningf(const char *reason, const char *file, int line,
                     int igraph_errno, ...) {
     va_list ap;
     va_start(ap, igraph_errno);
+    if (igraph_i_parallel_in_task()) {
+        /* the message buffer may be shared by the threads */
+        char buffer[sizeof(igraph_i_warningmsg_buffer)];
+        vsnprintf(buffer, sizeof(buffer) / sizeof(char), reason, ap);
+        va_end(ap);
+        return igraph_warning(buffer, file, line, igraph_errno);
+    }
     vsnprintf(igraph_i_warningmsg_buffer,
               sizeof(igraph_i_warningmsg_buffer) / sizeof(char), reason, ap);
+    va_end(ap);
     return igraph_warning(igraph_i_warningmsg_buffer, file, line,
                           igraph_errno);
 }
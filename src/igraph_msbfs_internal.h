@@ -0,0 +1,117 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_MSBFS_INTERNAL_H
+#define IGRAPH_MSBFS_INTERNAL_H
+
+#include "config.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+#include "igraph_adjlist.h"
+#include "igraph_iterators.h"
+
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#else
+    #ifdef HAVE_SYS_INT_TYPES_H
+        #include <sys/int_types.h>
+    #else
+        #include "pstdint.h"
+    #endif
+#endif
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+    #define __BEGIN_DECLS extern "C" {
+    #define __END_DECLS }
+#else
+    #define __BEGIN_DECLS /* empty */
+    #define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Bit-parallel multi-source breadth-first search.
+
+   The sources are processed in batches of up to 512. Every vertex has
+   a bitset with one bit per source of the batch, so the adjacency list
+   of a vertex is read once per batch and level, for all the sources
+   that reach it at the same distance, instead of once per source.
+
+   For every vertex and distance the visitor function is called with
+   the bitset of the sources that first reach the vertex at that
+   distance; bit b of word w stands for the source with index
+   first + 64 * w + b in the iterator of the sources. The visitor is
+   called with distance zero for the sources themselves, and the
+   distances of the calls are non-decreasing within a batch. It may
+   return IGRAPH_STOP to skip the rest of the batch, it must not fail
+   otherwise. */
+
+typedef uint64_t igraph_i_msbfs_word_t;
+
+#define IGRAPH_I_MSBFS_WORD_BITS 64
+
+/* At most this many words per vertex, i.e. 512 sources per batch */
+#define IGRAPH_I_MSBFS_MAX_WORDS 8
+
+typedef int igraph_i_msbfs_visit_t(long int vertex, long int dist,
+                                   long int first,
+                                   const igraph_i_msbfs_word_t *sources,
+                                   void *extra);
+
+typedef struct igraph_i_msbfs_t {
+    const igraph_adjlist_t *adjlist;
+    long int no_of_nodes;
+    int words;                  /* words of the bitset of a vertex */
+    igraph_i_msbfs_word_t *seen, *visit, *next;
+    igraph_vector_long_t frontier, touched, reached;
+    igraph_vector_long_t stamp;
+    long int mark;
+} igraph_i_msbfs_t;
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *msbfs,
+                        const igraph_adjlist_t *adjlist,
+                        long int no_of_sources);
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *msbfs);
+int igraph_i_msbfs_run(igraph_i_msbfs_t *msbfs, igraph_vit_t *sources,
+                       igraph_i_msbfs_visit_t *visit, void *extra,
+                       const char *progress);
+
+/* Bit counting on the bitsets */
+
+#ifdef __GNUC__
+    #define IGRAPH_I_MSBFS_POPCOUNT(x) __builtin_popcountll(x)
+    #define IGRAPH_I_MSBFS_CTZ(x) __builtin_ctzll(x)
+#else
+    #define IGRAPH_I_MSBFS_POPCOUNT(x) igraph_i_msbfs_popcount(x)
+    #define IGRAPH_I_MSBFS_CTZ(x) igraph_i_msbfs_ctz(x)
+#endif
+
+int igraph_i_msbfs_popcount(igraph_i_msbfs_word_t x);
+int igraph_i_msbfs_ctz(igraph_i_msbfs_word_t x);
+long int igraph_i_msbfs_count(const igraph_i_msbfs_t *msbfs,
+                              const igraph_i_msbfs_word_t *sources);
+
+__END_DECLS
+
+#endif
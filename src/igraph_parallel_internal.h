@@ -0,0 +1,94 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_PARALLEL_INTERNAL_H
+#define IGRAPH_PARALLEL_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_error.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+    #define __BEGIN_DECLS extern "C" {
+    #define __END_DECLS }
+#else
+    #define __BEGIN_DECLS /* empty */
+    #define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* The thread pool of parallel algorithms.
+
+   A parallel loop runs the tasks 0, 1, ..., no_of_tasks-1 of a task
+   function on several threads; the calling thread takes part as
+   thread 0. Algorithms allocate their per-thread buffers before the
+   loop, for igraph_i_parallel_threads() threads, and index them with
+   the 'thread' argument of the task function.
+
+   Task functions may use IGRAPH_CHECK, IGRAPH_ERROR, IGRAPH_WARNING
+   and IGRAPH_ALLOW_INTERRUPTION, but not IGRAPH_FINALLY and the
+   default random number generator; they must free their own temporary
+   memory on errors. An error or interruption in a task stops the
+   loop, and the first error is reported on the calling thread, through
+   the usual error handler, after all threads have stopped. Warnings
+   are reported the same way. Thread 0 is the calling thread, progress
+   can only be reported from there.
+
+   The tasks of a loop are run in no particular order, so the results
+   of algorithms must not depend on which thread runs which task. */
+
+typedef int igraph_i_parallel_task_t(void *data, long int task, int thread);
+
+int igraph_i_parallel_threads(long int no_of_tasks);
+int igraph_i_parallel_for(long int no_of_tasks, int no_of_threads,
+                          igraph_i_parallel_task_t *task, void *data);
+
+/* Runs a parallel loop and returns from the calling function if it
+   fails. Errors were already reported by igraph_i_parallel_for(), so
+   IGRAPH_CHECK() cannot be used for this. On interruption the
+   temporary data of the caller is freed, like in IGRAPH_PROGRESS(). */
+
+#define IGRAPH_PARALLEL_FOR(no_of_tasks, no_of_threads, task, data) \
+    do { \
+        int igraph_i_parallel_ret = \
+            igraph_i_parallel_for((no_of_tasks), (no_of_threads), (task), (data)); \
+        if (igraph_i_parallel_ret == IGRAPH_INTERRUPTED) { \
+            IGRAPH_FINALLY_FREE(); \
+        } \
+        if (igraph_i_parallel_ret != IGRAPH_SUCCESS) { \
+            return igraph_i_parallel_ret; \
+        } \
+    } while (0)
+
+/* Used by the error, warning and interruption functions */
+igraph_bool_t igraph_i_parallel_in_task(void);
+int igraph_i_parallel_error(const char *reason, const char *file, int line,
+                            int igraph_errno);
+void igraph_i_parallel_warning(const char *reason, const char *file, int line,
+                               int igraph_errno);
+int igraph_i_parallel_interruption(void *data);
+
+__END_DECLS
+
+#endif
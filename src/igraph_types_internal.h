@@ -35,6 +35,8 @@
 #endif
 
 #include "igraph_types.h"
+#include "igraph_datatype.h"
+#include "igraph_constants.h"
 #include "igraph_matrix.h"
 #include "igraph_stack.h"
 #include "igraph_strvector.h"
@@ -390,6 +392,31 @@ int igraph_fixed_vectorlist_convert(igraph_fixed_vectorlist_t *l,
                                     const igraph_vector_t *from,
                                     long int size);
 
+/* -------------------------------------------------- */
+/* Memory mapped graph snapshots                      */
+/* -------------------------------------------------- */
+
+void igraph_i_snapshot_destroy(igraph_t *graph);
+
+/* -------------------------------------------------- */
+/* Adjacency index                                    */
+/* -------------------------------------------------- */
+
+igraph_bool_t igraph_i_adjindex_find(const igraph_t *graph,
+                                     igraph_neimode_t mode, long int vid,
+                                     long int nei, long int *pos);
+
+typedef struct igraph_i_adjset_t {
+    igraph_vector_int_t table;
+    long int used;
+} igraph_i_adjset_t;
+
+int igraph_i_adjset_init(igraph_i_adjset_t *set, long int size);
+void igraph_i_adjset_destroy(igraph_i_adjset_t *set);
+igraph_bool_t igraph_i_adjset_has(const igraph_i_adjset_t *set, long int nei);
+int igraph_i_adjset_add(igraph_i_adjset_t *set, long int nei);
+void igraph_i_adjset_remove(igraph_i_adjset_t *set, long int nei);
+
 __END_DECLS
 
 #endif
@@ -22,6 +22,7 @@
 */
 
 #include "igraph_interrupt.h"
+#include "igraph_parallel_internal.h"
 #include "config.h"
 
 #include <stdio.h>
@@ -32,6 +33,9 @@ IGRAPH_THREAD_LOCAL igraph_interruption_handler_t
 *igraph_i_interruption_handler = 0;
 
 int igraph_allow_interruption(void* data) {
+    if (igraph_i_parallel_in_task()) {
+        return igraph_i_parallel_interruption(data);
+    }
     if (igraph_i_interruption_handler) {
         return igraph_i_interruption_handler(data);
     }
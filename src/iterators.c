@@ -1452,15 +1452,15 @@ int igraph_es_size(const igraph_t *graph, const igraph_es_t *es,
 
     switch (es->type) {
     case IGRAPH_ES_ALL:
-        *result = igraph_ecount(graph);
+        *result = igraph_ecount(graph) - igraph_deleted_ecount(graph);
         return 0;
 
     case IGRAPH_ES_ALLFROM:
-        *result = igraph_ecount(graph);
+        *result = igraph_ecount(graph) - igraph_deleted_ecount(graph);
         return 0;
 
     case IGRAPH_ES_ALLTO:
-        *result = igraph_ecount(graph);
+        *result = igraph_ecount(graph) - igraph_deleted_ecount(graph);
         return 0;
 
     case IGRAPH_ES_INCIDENT:
@@ -1646,6 +1646,32 @@ static int igraph_i_eit_create_allfromto(const igraph_t *graph,
     return 0;
 }
 
+/* Iterator over the edges that are not marked as deleted, used for
+   igraph_es_all() if there are deleted edges */
+
+static int igraph_i_eit_create_live(const igraph_t *graph, igraph_eit_t *eit) {
+    long int i, j, n = igraph_ecount(graph);
+
+    eit->type = IGRAPH_EIT_VECTOR;
+    eit->pos = 0;
+    eit->start = 0;
+    eit->vec = igraph_Calloc(1, igraph_vector_t);
+    if (eit->vec == 0) {
+        IGRAPH_ERROR("Cannot create edge iterator", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, (igraph_vector_t*) eit->vec);
+    IGRAPH_VECTOR_INIT_FINALLY((igraph_vector_t*) eit->vec,
+                               n - igraph_deleted_ecount(graph));
+    for (i = 0, j = 0; i < n; i++) {
+        if (!igraph_is_edge_deleted(graph, (igraph_integer_t) i)) {
+            VECTOR(*eit->vec)[j++] = i;
+        }
+    }
+    eit->end = j;
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
 static int igraph_i_eit_pairs(const igraph_t *graph,
                               igraph_es_t es, igraph_eit_t *eit) {
     long int n = igraph_vector_size(es.data.path.ptr);
@@ -1789,6 +1815,10 @@ int igraph_eit_create(const igraph_t *graph,
                       igraph_es_t es, igraph_eit_t *eit) {
     switch (es.type) {
     case IGRAPH_ES_ALL:
+        if (igraph_deleted_ecount(graph) > 0) {
+            IGRAPH_CHECK(igraph_i_eit_create_live(graph, eit));
+            break;
+        }
         eit->type = IGRAPH_EIT_SEQ;
         eit->pos = 0;
         eit->start = 0;
@@ -0,0 +1,324 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_random.h"
+#include "igraph_interrupt_internal.h"
+
+/* Copies the distances from a single source, in the first row of
+   'row', to row 'i' of 'res' */
+
+static void igraph_i_landmarks_set_row(igraph_matrix_t *res, long int i,
+                                       const igraph_matrix_t *row) {
+    long int j, n = igraph_matrix_ncol(row);
+    for (j = 0; j < n; j++) {
+        MATRIX(*res, i, j) = MATRIX(*row, 0, j);
+    }
+}
+
+/* Chooses the landmarks one by one, every new landmark is the vertex
+   farthest from the ones chosen so far, i.e. the one with the largest
+   distance from its closest landmark. Vertices that no landmark reaches
+   come first, so that every component gets a landmark. The first
+   landmark is the vertex farthest from a random vertex. */
+
+static int igraph_i_landmarks_farthest(const igraph_t *graph,
+                                       igraph_landmarks_t *landmarks,
+                                       const igraph_vector_t *weights,
+                                       igraph_neimode_t mode,
+                                       igraph_neimode_t reverse,
+                                       long int no_of_landmarks) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_t mindist;
+    igraph_matrix_t row, backward;
+    long int i, j, next;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&mindist, no_of_nodes);
+    IGRAPH_MATRIX_INIT_FINALLY(&row, 0, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&backward, 0, 0);
+
+    RNG_BEGIN();
+    next = RNG_INTEGER(0, no_of_nodes - 1);
+    RNG_END();
+    for (j = 0; j < no_of_nodes &&
+         igraph_is_vertex_deleted(graph, (igraph_integer_t) next); j++) {
+        next = (next + 1) % no_of_nodes;
+    }
+    IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, &row,
+                 igraph_vss_1((igraph_integer_t) next),
+                 igraph_vss_all(), weights, mode));
+    igraph_vector_fill(&mindist, IGRAPH_INFINITY);
+
+    for (i = 0; i < no_of_landmarks; i++) {
+        igraph_real_t max = -1;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* 'row' has the distances from the previous landmark, or from
+           the random vertex at first */
+        next = -1;
+        for (j = 0; j < no_of_nodes; j++) {
+            igraph_real_t d = MATRIX(row, 0, j);
+            if (i == 0) {
+                if (d == IGRAPH_INFINITY) {
+                    continue;
+                }
+            } else if (d < VECTOR(mindist)[j]) {
+                VECTOR(mindist)[j] = d;
+            } else {
+                d = VECTOR(mindist)[j];
+            }
+            if (d > max && !igraph_is_vertex_deleted(graph, (igraph_integer_t) j)) {
+                max = d;
+                next = j;
+            }
+        }
+        if (next < 0 || (i > 0 && max == 0)) {
+            /* every vertex is a landmark already */
+            break;
+        }
+
+        IGRAPH_CHECK(igraph_vector_push_back(&landmarks->vids, next));
+        IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, &row,
+                     igraph_vss_1((igraph_integer_t) next),
+                     igraph_vss_all(), weights, mode));
+        igraph_i_landmarks_set_row(&landmarks->from, i, &row);
+        if (!landmarks->symmetric) {
+            IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, &backward,
+                         igraph_vss_1((igraph_integer_t) next),
+                         igraph_vss_all(), weights, reverse));
+            igraph_i_landmarks_set_row(&landmarks->to, i, &backward);
+        }
+    }
+
+    /* Fewer landmarks than requested, in a small graph */
+    while (igraph_matrix_nrow(&landmarks->from) > i) {
+        IGRAPH_CHECK(igraph_matrix_remove_row(&landmarks->from, i));
+        if (!landmarks->symmetric) {
+            IGRAPH_CHECK(igraph_matrix_remove_row(&landmarks->to, i));
+        }
+    }
+
+    igraph_matrix_destroy(&backward);
+    igraph_matrix_destroy(&row);
+    igraph_vector_destroy(&mindist);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_landmarks_init
+ * \brief Computes the distances between landmarks and all vertices.
+ *
+ * </para><para>
+ * The distances are used for the lower bounds of \ref
+ * igraph_landmarks_heuristic(), by the triangle inequality: if
+ * <code>d(L,v)</code> is the distance from landmark <code>L</code>
+ * to vertex <code>v</code>, then the distance from <code>v</code> to
+ * <code>t</code> is at least <code>d(L,t)-d(L,v)</code> and
+ * <code>d(v,L)-d(t,L)</code>. With these bounds \ref
+ * igraph_get_shortest_path_astar() usually finds a path by visiting
+ * a small fraction of the vertices that Dijkstra's algorithm visits,
+ * which pays off if many paths are searched in the same graph. This
+ * is called the ALT (A*, landmarks, triangle inequality) algorithm.
+ *
+ * </para><para>
+ * The bounds are best for vertices behind a landmark, so the
+ * landmarks should be on the periphery of the graph. If they are not
+ * given, they are chosen greedily: every landmark is the vertex
+ * farthest from the previous ones. This uses the random number
+ * generator. A dozen or so landmarks are usually enough; every one
+ * needs memory proportional to the number of vertices, twice as much
+ * in directed graphs.
+ *
+ * </para><para>
+ * The landmarks are only valid for the graph, weights and mode they
+ * were computed for, they must be recomputed if any of these change.
+ *
+ * \param graph The input graph.
+ * \param landmarks Pointer to an uninitialized landmarks object.
+ * \param weights Vector of non-negative edge weights, in the order of
+ *        edge ids, or a null pointer to use unit weights.
+ * \param mode The mode of the searches that will use the landmarks,
+ *        \c IGRAPH_OUT, \c IGRAPH_IN or \c IGRAPH_ALL. It is ignored
+ *        for undirected graphs.
+ * \param no_of_landmarks The number of landmarks to choose, if \p vids
+ *        is a null pointer. Fewer landmarks are chosen if the graph
+ *        has fewer vertices.
+ * \param vids The landmark vertices, or a null pointer to choose them
+ *        automatically.
+ * \return Error code.
+ *
+ * Time complexity: O(k(|E|log|E|+|V|)), k is the number of landmarks,
+ * |V| is the number of vertices, |E| is the number of edges.
+ *
+ * \sa \ref igraph_landmarks_destroy(), \ref igraph_landmarks_heuristic().
+ */
+
+int igraph_landmarks_init(const igraph_t *graph,
+                          igraph_landmarks_t *landmarks,
+                          const igraph_vector_t *weights,
+                          igraph_neimode_t mode,
+                          igraph_integer_t no_of_landmarks,
+                          const igraph_vector_t *vids) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_neimode_t reverse;
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    reverse = mode == IGRAPH_OUT ? IGRAPH_IN :
+              mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+    if (!vids && no_of_landmarks < 0) {
+        IGRAPH_ERROR("Number of landmarks must not be negative", IGRAPH_EINVAL);
+    }
+    if (!vids && no_of_landmarks > no_of_nodes) {
+        no_of_landmarks = (igraph_integer_t) no_of_nodes;
+    }
+
+    landmarks->symmetric = (mode == IGRAPH_ALL);
+    IGRAPH_VECTOR_INIT_FINALLY(&landmarks->vids, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&landmarks->from, 0, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&landmarks->to, 0, 0);
+
+    if (vids) {
+        IGRAPH_CHECK(igraph_vector_update(&landmarks->vids, vids));
+        IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, &landmarks->from,
+                     igraph_vss_vector(vids), igraph_vss_all(),
+                     weights, mode));
+        if (!landmarks->symmetric) {
+            IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, &landmarks->to,
+                         igraph_vss_vector(vids), igraph_vss_all(),
+                         weights, reverse));
+        }
+    } else if (no_of_landmarks > 0) {
+        IGRAPH_CHECK(igraph_matrix_resize(&landmarks->from, no_of_landmarks,
+                                          no_of_nodes));
+        if (!landmarks->symmetric) {
+            IGRAPH_CHECK(igraph_matrix_resize(&landmarks->to, no_of_landmarks,
+                                              no_of_nodes));
+        }
+        IGRAPH_CHECK(igraph_i_landmarks_farthest(graph, landmarks, weights, mode,
+                     reverse, no_of_landmarks));
+    } else {
+        IGRAPH_CHECK(igraph_matrix_resize(&landmarks->from, 0, no_of_nodes));
+    }
+
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_landmarks_destroy
+ * \brief Frees the memory of a landmarks object.
+ *
+ * \param landmarks The object to destroy.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_landmarks_destroy(igraph_landmarks_t *landmarks) {
+    igraph_matrix_destroy(&landmarks->to);
+    igraph_matrix_destroy(&landmarks->from);
+    igraph_vector_destroy(&landmarks->vids);
+}
+
+/**
+ * \function igraph_landmarks_vids
+ * \brief The ids of the landmark vertices.
+ *
+ * \param landmarks The landmarks object.
+ * \param res Pointer to an initialized vector, the vertex ids are
+ *        stored here, in the order they were chosen.
+ * \return Error code.
+ *
+ * Time complexity: O(k), the number of landmarks.
+ */
+
+int igraph_landmarks_vids(const igraph_landmarks_t *landmarks,
+                          igraph_vector_t *res) {
+    IGRAPH_CHECK(igraph_vector_update(res, &landmarks->vids));
+    return 0;
+}
+
+/**
+ * \function igraph_landmarks_heuristic
+ * \brief Lower bound on a distance, from the landmark distances.
+ *
+ * </para><para>
+ * This function is an \ref igraph_astar_heuristic_func_t, pass it to
+ * \ref igraph_get_shortest_path_astar() together with a pointer to an
+ * \ref igraph_landmarks_t as the extra argument. The bound is the
+ * largest one given by any landmark, and it is infinite if a landmark
+ * shows that there is no path. These bounds are consistent, so
+ * every vertex is settled at most once by the search.
+ *
+ * \param result The lower bound is stored here.
+ * \param from The first vertex.
+ * \param to The second vertex.
+ * \param extra Pointer to the \ref igraph_landmarks_t object. It must
+ *        be created for the same graph, weights and mode as the
+ *        search.
+ * \return Error code.
+ *
+ * Time complexity: O(k), the number of landmarks.
+ */
+
+int igraph_landmarks_heuristic(igraph_real_t *result,
+                               igraph_integer_t from,
+                               igraph_integer_t to,
+                               void *extra) {
+
+    const igraph_landmarks_t *landmarks = extra;
+    const igraph_matrix_t *fwd = &landmarks->from;
+    const igraph_matrix_t *bwd = landmarks->symmetric ? &landmarks->from :
+                                 &landmarks->to;
+    long int k = igraph_matrix_nrow(fwd), i;
+    igraph_real_t bound = 0;
+
+    for (i = 0; i < k; i++) {
+        /* d(v,t) >= d(L,t) - d(L,v) and d(v,t) >= d(v,L) - d(t,L), the
+           terms with an infinite subtrahend give no bound */
+        igraph_real_t lv = MATRIX(*fwd, i, from), lt = MATRIX(*fwd, i, to);
+        igraph_real_t vl = MATRIX(*bwd, i, from), tl = MATRIX(*bwd, i, to);
+        if (lv != IGRAPH_INFINITY && lt - lv > bound) {
+            bound = lt - lv;
+        }
+        if (tl != IGRAPH_INFINITY && vl - tl > bound) {
+            bound = vl - tl;
+        }
+    }
+
+    *result = bound;
+
+    return 0;
+}
@@ -0,0 +1,264 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_msbfs_internal.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+#include "igraph_progress.h"
+#include "igraph_interrupt_internal.h"
+
+#include <string.h>
+
+/* Fewer words are used if the three bitset arrays would need more
+   words than this together */
+#define IGRAPH_I_MSBFS_MAX_MEMORY (1L << 24)
+
+int igraph_i_msbfs_popcount(igraph_i_msbfs_word_t x) {
+    int n = 0;
+    while (x) {
+        x &= x - 1;
+        n++;
+    }
+    return n;
+}
+
+int igraph_i_msbfs_ctz(igraph_i_msbfs_word_t x) {
+    int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+
+/* The number of sources in a bitset */
+
+long int igraph_i_msbfs_count(const igraph_i_msbfs_t *msbfs,
+                              const igraph_i_msbfs_word_t *sources) {
+    long int n = 0;
+    int w;
+    for (w = 0; w < msbfs->words; w++) {
+        n += IGRAPH_I_MSBFS_POPCOUNT(sources[w]);
+    }
+    return n;
+}
+
+/* Allocates the bitsets for the given number of sources, the searches
+   follow the adjacency list. */
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *msbfs,
+                        const igraph_adjlist_t *adjlist,
+                        long int no_of_sources) {
+
+    long int no_of_nodes = igraph_adjlist_size(adjlist);
+    long int size;
+    int words;
+
+    words = (int) ((no_of_sources + IGRAPH_I_MSBFS_WORD_BITS - 1) /
+                   IGRAPH_I_MSBFS_WORD_BITS);
+    if (words > IGRAPH_I_MSBFS_MAX_WORDS) {
+        words = IGRAPH_I_MSBFS_MAX_WORDS;
+    }
+    while (words > 1 && 3 * no_of_nodes * words > IGRAPH_I_MSBFS_MAX_MEMORY) {
+        words--;
+    }
+    if (words < 1) {
+        words = 1;
+    }
+    size = no_of_nodes * words;
+
+    msbfs->adjlist = adjlist;
+    msbfs->no_of_nodes = no_of_nodes;
+    msbfs->words = words;
+    msbfs->mark = 0;
+
+    msbfs->seen = igraph_Calloc(size > 0 ? size : 1, igraph_i_msbfs_word_t);
+    if (msbfs->seen == 0) {
+        IGRAPH_ERROR("Cannot run multi-source BFS", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->seen);
+    msbfs->visit = igraph_Calloc(size > 0 ? size : 1, igraph_i_msbfs_word_t);
+    if (msbfs->visit == 0) {
+        IGRAPH_ERROR("Cannot run multi-source BFS", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->visit);
+    msbfs->next = igraph_Calloc(size > 0 ? size : 1, igraph_i_msbfs_word_t);
+    if (msbfs->next == 0) {
+        IGRAPH_ERROR("Cannot run multi-source BFS", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->next);
+
+    IGRAPH_CHECK(igraph_vector_long_init(&msbfs->frontier, 0));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &msbfs->frontier);
+    IGRAPH_CHECK(igraph_vector_long_reserve(&msbfs->frontier, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_long_init(&msbfs->touched, 0));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &msbfs->touched);
+    IGRAPH_CHECK(igraph_vector_long_reserve(&msbfs->touched, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_long_init(&msbfs->reached, 0));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &msbfs->reached);
+    IGRAPH_CHECK(igraph_vector_long_reserve(&msbfs->reached, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_long_init(&msbfs->stamp, no_of_nodes));
+
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *msbfs) {
+    igraph_vector_long_destroy(&msbfs->stamp);
+    igraph_vector_long_destroy(&msbfs->reached);
+    igraph_vector_long_destroy(&msbfs->touched);
+    igraph_vector_long_destroy(&msbfs->frontier);
+    igraph_Free(msbfs->next);
+    igraph_Free(msbfs->visit);
+    igraph_Free(msbfs->seen);
+}
+
+/* Runs the searches from all vertices of the iterator, batch by batch,
+   and calls the visitor for every vertex and distance at which some
+   sources reach the vertex first. The progress is reported with the
+   given message, unless it is a null pointer. */
+
+int igraph_i_msbfs_run(igraph_i_msbfs_t *msbfs, igraph_vit_t *sources,
+                       igraph_i_msbfs_visit_t *visit, void *extra,
+                       const char *progress) {
+
+    long int no_of_sources = IGRAPH_VIT_SIZE(*sources);
+    long int batch_size = msbfs->words * IGRAPH_I_MSBFS_WORD_BITS;
+    int words = msbfs->words;
+    igraph_i_msbfs_word_t *seen = msbfs->seen, *vis = msbfs->visit,
+                           *next = msbfs->next;
+    long int first, i, j, n, dist;
+    int w;
+
+    IGRAPH_VIT_RESET(*sources);
+
+    for (first = 0; first < no_of_sources; first += batch_size) {
+        long int count = no_of_sources - first;
+        igraph_bool_t stop = 0;
+
+        if (count > batch_size) {
+            count = batch_size;
+        }
+
+        if (progress) {
+            IGRAPH_PROGRESS(progress, 100.0 * first / no_of_sources, NULL);
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* The sources are at distance zero */
+        msbfs->mark++;
+        igraph_vector_long_clear(&msbfs->frontier);
+        igraph_vector_long_clear(&msbfs->reached);
+        for (i = 0; i < count; i++, IGRAPH_VIT_NEXT(*sources)) {
+            long int source = IGRAPH_VIT_GET(*sources);
+            igraph_i_msbfs_word_t bit =
+                ((igraph_i_msbfs_word_t) 1) << (i % IGRAPH_I_MSBFS_WORD_BITS);
+            if (VECTOR(msbfs->stamp)[source] != msbfs->mark) {
+                VECTOR(msbfs->stamp)[source] = msbfs->mark;
+                IGRAPH_CHECK(igraph_vector_long_push_back(&msbfs->frontier, source));
+                IGRAPH_CHECK(igraph_vector_long_push_back(&msbfs->reached, source));
+            }
+            seen[source * words + i / IGRAPH_I_MSBFS_WORD_BITS] |= bit;
+            vis[source * words + i / IGRAPH_I_MSBFS_WORD_BITS] |= bit;
+        }
+        n = igraph_vector_long_size(&msbfs->frontier);
+        for (i = 0; i < n && !stop; i++) {
+            long int v = VECTOR(msbfs->frontier)[i];
+            stop = visit(v, 0, first, vis + v * words, extra) == IGRAPH_STOP;
+        }
+
+        for (dist = 1; !stop && igraph_vector_long_size(&msbfs->frontier) > 0;
+             dist++) {
+
+            /* Push the bitsets of the frontier to the neighbors; every
+               adjacency list is read once for all sources of the batch */
+            msbfs->mark++;
+            igraph_vector_long_clear(&msbfs->touched);
+            n = igraph_vector_long_size(&msbfs->frontier);
+            for (i = 0; i < n; i++) {
+                long int v = VECTOR(msbfs->frontier)[i];
+                igraph_i_msbfs_word_t *from = vis + v * words;
+                const igraph_vector_int_t *neis = igraph_adjlist_get(msbfs->adjlist, v);
+                long int nlen = igraph_vector_int_size(neis);
+                for (j = 0; j < nlen; j++) {
+                    long int nei = VECTOR(*neis)[j];
+                    igraph_i_msbfs_word_t *to = next + nei * words;
+                    if (VECTOR(msbfs->stamp)[nei] != msbfs->mark) {
+                        VECTOR(msbfs->stamp)[nei] = msbfs->mark;
+                        IGRAPH_CHECK(igraph_vector_long_push_back(&msbfs->touched, nei));
+                    }
+                    for (w = 0; w < words; w++) {
+                        to[w] |= from[w];
+                    }
+                }
+                memset(from, 0, sizeof(igraph_i_msbfs_word_t) * words);
+            }
+
+            /* The sources that reach a neighbor first form the next
+               frontier */
+            igraph_vector_long_clear(&msbfs->frontier);
+            n = igraph_vector_long_size(&msbfs->touched);
+            for (i = 0; i < n; i++) {
+                long int v = VECTOR(msbfs->touched)[i];
+                igraph_i_msbfs_word_t *s = seen + v * words, *nx = next + v * words,
+                                       *vs = vis + v * words;
+                igraph_i_msbfs_word_t any = 0, old = 0;
+                for (w = 0; w < words; w++) {
+                    igraph_i_msbfs_word_t x = nx[w] & ~s[w];
+                    old |= s[w];
+                    s[w] |= x;
+                    vs[w] = x;
+                    nx[w] = 0;
+                    any |= x;
+                }
+                if (any) {
+                    IGRAPH_CHECK(igraph_vector_long_push_back(&msbfs->frontier, v));
+                    if (!old) {
+                        IGRAPH_CHECK(igraph_vector_long_push_back(&msbfs->reached, v));
+                    }
+                    if (!stop) {
+                        stop = visit(v, dist, first, vs, extra) == IGRAPH_STOP;
+                    }
+                }
+            }
+
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+
+        /* Clear the bitsets for the next batch */
+        n = igraph_vector_long_size(&msbfs->frontier);
+        for (i = 0; i < n; i++) {
+            long int v = VECTOR(msbfs->frontier)[i];
+            memset(vis + v * words, 0, sizeof(igraph_i_msbfs_word_t) * words);
+        }
+        n = igraph_vector_long_size(&msbfs->reached);
+        for (i = 0; i < n; i++) {
+            long int v = VECTOR(msbfs->reached)[i];
+            memset(seen + v * words, 0, sizeof(igraph_i_msbfs_word_t) * words);
+        }
+    }
+
+    return 0;
+}
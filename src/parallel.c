@@ -0,0 +1,551 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_threading.h"
+#include "igraph_error.h"
+#include "igraph_memory.h"
+#include "igraph_parallel_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Without thread-local storage the tasks would share the error
+   handlers and the IGRAPH_FINALLY stack, configure does not enable
+   the thread pool then */
+#if defined(HAVE_PTHREAD) && !defined(HAVE_TLS)
+    #undef HAVE_PTHREAD
+#endif
+
+#ifdef HAVE_PTHREAD
+    #include <errno.h>
+    #include <pthread.h>
+    #include <stdint.h>
+    #include <time.h>
+#endif
+
+/* The number of threads set by igraph_set_num_threads(), or -1 if it
+   was not set and the IGRAPH_NUM_THREADS environment variable is
+   used. */
+static int igraph_i_num_threads = -1;
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t igraph_i_num_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**
+ * \function igraph_set_num_threads
+ * \brief Sets the number of threads used by parallel algorithms.
+ *
+ * </para><para>
+ * Some functions of igraph, e.g. \ref igraph_betweenness(), can split
+ * their work between several threads. This function sets the number
+ * of threads they use, including the calling thread. The worker
+ * threads are started when they are first needed and they are kept
+ * for later calls.
+ *
+ * </para><para>
+ * If this function is not called, then the number of threads is
+ * taken from the \c IGRAPH_NUM_THREADS environment variable, and if
+ * that is not set either, all computations run on the calling thread
+ * only. Parallel algorithms called from different threads at the same
+ * time share the worker threads; if they are busy, the computation
+ * runs on the calling thread.
+ * \param no_of_threads The number of threads, at least one.
+ * \return Error code, \c IGRAPH_EINVAL if the number is smaller than
+ *   one.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_set_num_threads(igraph_integer_t no_of_threads) {
+    if (no_of_threads < 1) {
+        IGRAPH_ERROR("Number of threads must be at least one", IGRAPH_EINVAL);
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&igraph_i_num_threads_lock);
+    igraph_i_num_threads = no_of_threads;
+    pthread_mutex_unlock(&igraph_i_num_threads_lock);
+#else
+    igraph_i_num_threads = no_of_threads;
+#endif
+    return 0;
+}
+
+/**
+ * \function igraph_get_num_threads
+ * \brief The number of threads used by parallel algorithms.
+ *
+ * \return The number set by \ref igraph_set_num_threads() or the
+ *   \c IGRAPH_NUM_THREADS environment variable, or one if neither of
+ *   them is set. It is always one if igraph was built without thread
+ *   support or without thread-local storage.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_get_num_threads(void) {
+#ifdef HAVE_PTHREAD
+    int no_of_threads;
+    pthread_mutex_lock(&igraph_i_num_threads_lock);
+    if (igraph_i_num_threads < 0) {
+        const char *env = getenv("IGRAPH_NUM_THREADS");
+        long int n = env ? strtol(env, 0, 10) : 1;
+        igraph_i_num_threads = n < 1 ? 1 : (n > 1024 ? 1024 : (int) n);
+    }
+    no_of_threads = igraph_i_num_threads;
+    pthread_mutex_unlock(&igraph_i_num_threads_lock);
+    return no_of_threads;
+#else
+    return 1;
+#endif
+}
+
+/* The number of threads a parallel loop of no_of_tasks tasks can use;
+   loops started from a task run on a single thread. */
+
+int igraph_i_parallel_threads(long int no_of_tasks) {
+    long int n = igraph_i_parallel_in_task() ? 1 : igraph_get_num_threads();
+    if (n > no_of_tasks) {
+        n = no_of_tasks;
+    }
+    return n < 1 ? 1 : (int) n;
+}
+
+static int igraph_i_parallel_for_serial(long int no_of_tasks,
+                                        igraph_i_parallel_task_t *task,
+                                        void *data) {
+    long int i;
+    for (i = 0; i < no_of_tasks; i++) {
+        int ret = task(data, i, 0);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+#ifdef HAVE_PTHREAD
+
+/* The tasks not yet started by a thread are the range [next, end).
+   A thread takes its tasks from the front of its own range, and when
+   that is empty, it steals the back half of the range of another
+   thread. Cancelling a loop empties all ranges. */
+
+typedef struct igraph_i_parallel_slot_t {
+    pthread_mutex_t lock;
+    long int next, end;
+    igraph_bool_t cancelled;
+} igraph_i_parallel_slot_t;
+
+static struct {
+    pthread_mutex_t use;        /* held by the thread running a loop */
+    pthread_mutex_t state;      /* protects everything below */
+    pthread_cond_t start, done;
+    pthread_t *workers;
+    int no_of_workers;
+    unsigned long generation;   /* incremented for every loop */
+    int running;                /* workers still working on the loop */
+
+    /* The current loop */
+    int no_of_threads;
+    igraph_i_parallel_task_t *task;
+    void *data;
+    igraph_interruption_handler_t *interruption_handler;
+    igraph_i_parallel_slot_t *slots;
+    igraph_bool_t cancelled, interrupted, has_error, has_warning;
+    char reason[500], warning[500];
+    const char *file, *warning_file;
+    int line, igraph_errno, warning_line, warning_errno;
+} igraph_i_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+/* The index of the thread plus one while it is running a task */
+static pthread_key_t igraph_i_parallel_key;
+static pthread_once_t igraph_i_parallel_key_once = PTHREAD_ONCE_INIT;
+
+static void igraph_i_parallel_key_create(void) {
+    pthread_key_create(&igraph_i_parallel_key, 0);
+}
+
+static int igraph_i_parallel_thread(void) {
+    pthread_once(&igraph_i_parallel_key_once, igraph_i_parallel_key_create);
+    return (int) (intptr_t) pthread_getspecific(igraph_i_parallel_key) - 1;
+}
+
+igraph_bool_t igraph_i_parallel_in_task(void) {
+    return igraph_i_parallel_thread() >= 0;
+}
+
+/* Must be called with the state lock held */
+
+static void igraph_i_parallel_cancel(void) {
+    int i;
+    igraph_i_pool.cancelled = 1;
+    for (i = 0; i < igraph_i_pool.no_of_threads; i++) {
+        igraph_i_parallel_slot_t *slot = &igraph_i_pool.slots[i];
+        pthread_mutex_lock(&slot->lock);
+        slot->end = slot->next;
+        slot->cancelled = 1;
+        pthread_mutex_unlock(&slot->lock);
+    }
+}
+
+int igraph_i_parallel_error(const char *reason, const char *file, int line,
+                            int igraph_errno) {
+    pthread_mutex_lock(&igraph_i_pool.state);
+    if (!igraph_i_pool.has_error) {
+        igraph_i_pool.has_error = 1;
+        strncpy(igraph_i_pool.reason, reason, sizeof(igraph_i_pool.reason) - 1);
+        igraph_i_pool.reason[sizeof(igraph_i_pool.reason) - 1] = '\0';
+        igraph_i_pool.file = file;
+        igraph_i_pool.line = line;
+        igraph_i_pool.igraph_errno = igraph_errno;
+    }
+    igraph_i_parallel_cancel();
+    pthread_mutex_unlock(&igraph_i_pool.state);
+    return igraph_errno;
+}
+
+void igraph_i_parallel_warning(const char *reason, const char *file, int line,
+                               int igraph_errno) {
+    pthread_mutex_lock(&igraph_i_pool.state);
+    if (!igraph_i_pool.has_warning) {
+        igraph_i_pool.has_warning = 1;
+        strncpy(igraph_i_pool.warning, reason, sizeof(igraph_i_pool.warning) - 1);
+        igraph_i_pool.warning[sizeof(igraph_i_pool.warning) - 1] = '\0';
+        igraph_i_pool.warning_file = file;
+        igraph_i_pool.warning_line = line;
+        igraph_i_pool.warning_errno = igraph_errno;
+    }
+    pthread_mutex_unlock(&igraph_i_pool.state);
+}
+
+/* The interruption handler is only called on the calling thread, the
+   workers stop when the loop is cancelled. */
+
+int igraph_i_parallel_interruption(void *data) {
+    int ret = IGRAPH_SUCCESS;
+    if (igraph_i_parallel_thread() == 0) {
+        if (igraph_i_interruption_handler) {
+            ret = igraph_i_interruption_handler(data);
+        }
+        if (ret != IGRAPH_SUCCESS) {
+            pthread_mutex_lock(&igraph_i_pool.state);
+            igraph_i_pool.interrupted = 1;
+            igraph_i_parallel_cancel();
+            pthread_mutex_unlock(&igraph_i_pool.state);
+        }
+    } else {
+        pthread_mutex_lock(&igraph_i_pool.state);
+        if (igraph_i_pool.cancelled) {
+            ret = IGRAPH_INTERRUPTED;
+        }
+        pthread_mutex_unlock(&igraph_i_pool.state);
+    }
+    return ret;
+}
+
+static igraph_bool_t igraph_i_parallel_next(int thread, long int *task) {
+    igraph_i_parallel_slot_t *slots = igraph_i_pool.slots;
+    int n = igraph_i_pool.no_of_threads, k;
+
+    pthread_mutex_lock(&slots[thread].lock);
+    if (slots[thread].next < slots[thread].end) {
+        *task = slots[thread].next++;
+        pthread_mutex_unlock(&slots[thread].lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&slots[thread].lock);
+
+    for (k = 1; k < n; k++) {
+        igraph_i_parallel_slot_t *victim = &slots[(thread + k) % n];
+        long int begin, end;
+        pthread_mutex_lock(&victim->lock);
+        end = victim->end;
+        /* The last task is left to the owner, so every thread runs at
+           least the first task of its range */
+        begin = end - (end - victim->next) / 2;
+        if (begin < end) {
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (begin < end) {
+            /* The loop may have been cancelled since the steal */
+            pthread_mutex_lock(&slots[thread].lock);
+            if (!slots[thread].cancelled) {
+                slots[thread].next = begin + 1;
+                slots[thread].end = end;
+            }
+            pthread_mutex_unlock(&slots[thread].lock);
+            *task = begin;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void igraph_i_parallel_run(int thread) {
+    long int task;
+
+    pthread_setspecific(igraph_i_parallel_key, (void *) (intptr_t) (thread + 1));
+    if (thread != 0) {
+        /* IGRAPH_ALLOW_INTERRUPTION() only checks for interruption if
+           there is a handler; the workers never call it, but they need
+           to know about cancelled loops */
+        igraph_i_interruption_handler = igraph_i_pool.interruption_handler;
+    }
+    while (igraph_i_parallel_next(thread, &task)) {
+        int ret = igraph_i_pool.task(igraph_i_pool.data, task, thread);
+        if (ret == IGRAPH_INTERRUPTED) {
+            pthread_mutex_lock(&igraph_i_pool.state);
+            if (!igraph_i_pool.has_error) {
+                igraph_i_pool.interrupted = 1;
+            }
+            igraph_i_parallel_cancel();
+            pthread_mutex_unlock(&igraph_i_pool.state);
+        } else if (ret != 0) {
+            /* Errors reported by igraph_error() are already recorded,
+               this is for tasks returning an error code directly */
+            igraph_i_parallel_error("Parallel task failed", __FILE__, __LINE__, ret);
+        }
+        if (ret != 0) {
+            break;
+        }
+    }
+    if (thread != 0) {
+        igraph_i_interruption_handler = 0;
+    }
+    pthread_setspecific(igraph_i_parallel_key, 0);
+}
+
+typedef struct igraph_i_parallel_worker_t {
+    int thread;
+    unsigned long generation;
+} igraph_i_parallel_worker_t;
+
+static void *igraph_i_parallel_worker(void *arg) {
+    igraph_i_parallel_worker_t *worker = (igraph_i_parallel_worker_t *) arg;
+    int thread = worker->thread;
+    unsigned long generation = worker->generation;
+
+    igraph_Free(worker);
+    pthread_mutex_lock(&igraph_i_pool.state);
+    for (;;) {
+        while (igraph_i_pool.generation == generation) {
+            pthread_cond_wait(&igraph_i_pool.start, &igraph_i_pool.state);
+        }
+        generation = igraph_i_pool.generation;
+        if (thread >= igraph_i_pool.no_of_threads) {
+            continue;
+        }
+        pthread_mutex_unlock(&igraph_i_pool.state);
+        igraph_i_parallel_run(thread);
+        pthread_mutex_lock(&igraph_i_pool.state);
+        if (--igraph_i_pool.running == 0) {
+            pthread_cond_signal(&igraph_i_pool.done);
+        }
+    }
+    return 0;
+}
+
+/* Starts worker threads until there are no_of_threads-1 of them, and
+   returns the number of threads that can be used */
+
+static int igraph_i_parallel_start_workers(int no_of_threads) {
+    pthread_t *workers;
+
+    if (igraph_i_pool.no_of_workers >= no_of_threads - 1) {
+        return no_of_threads;
+    }
+    workers = igraph_Realloc(igraph_i_pool.workers, no_of_threads - 1, pthread_t);
+    if (workers == 0) {
+        return igraph_i_pool.no_of_workers + 1;
+    }
+    igraph_i_pool.workers = workers;
+    while (igraph_i_pool.no_of_workers < no_of_threads - 1) {
+        igraph_i_parallel_worker_t *worker = igraph_Calloc(1, igraph_i_parallel_worker_t);
+        if (worker == 0) {
+            break;
+        }
+        worker->thread = igraph_i_pool.no_of_workers + 1;
+        worker->generation = igraph_i_pool.generation;
+        if (pthread_create(&workers[igraph_i_pool.no_of_workers], 0,
+                           igraph_i_parallel_worker, worker) != 0) {
+            igraph_Free(worker);
+            break;
+        }
+        igraph_i_pool.no_of_workers++;
+    }
+    return igraph_i_pool.no_of_workers + 1;
+}
+
+#else
+
+igraph_bool_t igraph_i_parallel_in_task(void) {
+    return 0;
+}
+
+int igraph_i_parallel_error(const char *reason, const char *file, int line,
+                            int igraph_errno) {
+    IGRAPH_UNUSED(reason);
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    return igraph_errno;
+}
+
+void igraph_i_parallel_warning(const char *reason, const char *file, int line,
+                               int igraph_errno) {
+    IGRAPH_UNUSED(reason);
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+}
+
+int igraph_i_parallel_interruption(void *data) {
+    IGRAPH_UNUSED(data);
+    return IGRAPH_SUCCESS;
+}
+
+#endif
+
+/* Runs the tasks of a parallel loop on at most no_of_threads threads.
+   The loop runs on the calling thread only if there is a single
+   thread or task, if it is called from a task of another loop, or if
+   the worker threads are busy with a loop started by another thread. */
+
+int igraph_i_parallel_for(long int no_of_tasks, int no_of_threads,
+                          igraph_i_parallel_task_t *task, void *data) {
+#ifdef HAVE_PTHREAD
+    igraph_i_parallel_slot_t *slots;
+    igraph_bool_t has_error, has_warning, interrupted;
+    char reason[500], warning[500];
+    const char *file, *warning_file;
+    int line, igraph_errno, warning_line, warning_errno;
+    long int i;
+
+    if (no_of_threads > no_of_tasks) {
+        no_of_threads = (int) no_of_tasks;
+    }
+    if (no_of_threads <= 1 || igraph_i_parallel_in_task() ||
+        pthread_mutex_trylock(&igraph_i_pool.use) != 0) {
+        return igraph_i_parallel_for_serial(no_of_tasks, task, data);
+    }
+
+    pthread_mutex_lock(&igraph_i_pool.state);
+    no_of_threads = igraph_i_parallel_start_workers(no_of_threads);
+    pthread_mutex_unlock(&igraph_i_pool.state);
+    slots = no_of_threads > 1 ? igraph_Calloc(no_of_threads, igraph_i_parallel_slot_t) : 0;
+    if (slots == 0) {
+        pthread_mutex_unlock(&igraph_i_pool.use);
+        return igraph_i_parallel_for_serial(no_of_tasks, task, data);
+    }
+
+    /* Every thread starts with an equal share of the tasks */
+    for (i = 0; i < no_of_threads; i++) {
+        pthread_mutex_init(&slots[i].lock, 0);
+        slots[i].next = no_of_tasks * i / no_of_threads;
+        slots[i].end = no_of_tasks * (i + 1) / no_of_threads;
+    }
+
+    pthread_mutex_lock(&igraph_i_pool.state);
+    igraph_i_pool.no_of_threads = no_of_threads;
+    igraph_i_pool.task = task;
+    igraph_i_pool.data = data;
+    igraph_i_pool.interruption_handler = igraph_i_interruption_handler;
+    igraph_i_pool.slots = slots;
+    igraph_i_pool.cancelled = igraph_i_pool.interrupted = 0;
+    igraph_i_pool.has_error = igraph_i_pool.has_warning = 0;
+    igraph_i_pool.running = no_of_threads - 1;
+    igraph_i_pool.generation++;
+    pthread_cond_broadcast(&igraph_i_pool.start);
+    pthread_mutex_unlock(&igraph_i_pool.state);
+
+    igraph_i_parallel_run(0);
+
+    /* While waiting for the workers, the calling thread still checks
+       for interruption, every 100 milliseconds */
+    pthread_mutex_lock(&igraph_i_pool.state);
+    while (igraph_i_pool.running > 0) {
+        struct timespec timeout;
+        if (!igraph_i_interruption_handler || igraph_i_pool.cancelled) {
+            pthread_cond_wait(&igraph_i_pool.done, &igraph_i_pool.state);
+            continue;
+        }
+        clock_gettime(CLOCK_REALTIME, &timeout);
+        timeout.tv_nsec += 100000000L;
+        if (timeout.tv_nsec >= 1000000000L) {
+            timeout.tv_sec += 1;
+            timeout.tv_nsec -= 1000000000L;
+        }
+        if (pthread_cond_timedwait(&igraph_i_pool.done, &igraph_i_pool.state,
+                                   &timeout) == ETIMEDOUT) {
+            int ret;
+            pthread_mutex_unlock(&igraph_i_pool.state);
+            ret = igraph_i_interruption_handler(0);
+            pthread_mutex_lock(&igraph_i_pool.state);
+            if (ret != IGRAPH_SUCCESS && !igraph_i_pool.cancelled) {
+                igraph_i_pool.interrupted = 1;
+                igraph_i_parallel_cancel();
+            }
+        }
+    }
+    has_error = igraph_i_pool.has_error;
+    has_warning = igraph_i_pool.has_warning;
+    interrupted = igraph_i_pool.interrupted;
+    strcpy(reason, igraph_i_pool.reason);
+    strcpy(warning, igraph_i_pool.warning);
+    file = igraph_i_pool.file;
+    line = igraph_i_pool.line;
+    igraph_errno = igraph_i_pool.igraph_errno;
+    warning_file = igraph_i_pool.warning_file;
+    warning_line = igraph_i_pool.warning_line;
+    warning_errno = igraph_i_pool.warning_errno;
+    igraph_i_pool.slots = 0;
+    pthread_mutex_unlock(&igraph_i_pool.state);
+
+    for (i = 0; i < no_of_threads; i++) {
+        pthread_mutex_destroy(&slots[i].lock);
+    }
+    igraph_Free(slots);
+    pthread_mutex_unlock(&igraph_i_pool.use);
+
+    /* Report on the calling thread, now that no task is running */
+    if (has_warning) {
+        igraph_warning(warning, warning_file, warning_line, warning_errno);
+    }
+    if (has_error) {
+        return igraph_error(reason, file, line, igraph_errno);
+    }
+    if (interrupted) {
+        return IGRAPH_INTERRUPTED;
+    }
+    return 0;
+#else
+    IGRAPH_UNUSED(no_of_threads);
+    return igraph_i_parallel_for_serial(no_of_tasks, task, data);
+#endif
+}
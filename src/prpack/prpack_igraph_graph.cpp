@@ -18,9 +18,10 @@ prpack_igraph_graph::prpack_igraph_graph(const igraph_t* g, const igraph_vector_
     double* p_weight;
 
     // Get the number of vertices and edges. For undirected graphs, we add
-    // an edge in both directions.
+    // an edge in both directions. Edges marked as deleted are skipped by
+    // the iterators below.
     num_vs = igraph_vcount(g);
-    num_es = igraph_ecount(g);
+    num_es = igraph_ecount(g) - igraph_deleted_ecount(g);
     num_self_es = 0;
     if (!treat_as_directed) {
         num_es *= 2;
@@ -0,0 +1,531 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_reorder.h"
+#include "igraph_interface.h"
+#include "igraph_adjlist.h"
+#include "igraph_structural.h"
+#include "igraph_topology.h"
+#include "igraph_qsort.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_types_internal.h"
+
+#include <math.h>
+
+/**
+ * \section about_reorder
+ *
+ * <para>
+ * Most graph algorithms visit the neighbors of a vertex, and the time
+ * they take on large graphs depends a lot on how close the data of
+ * these neighbors is in memory. The functions in this section compute
+ * vertex orderings in which vertices that are visited together get
+ * close ids. All of them return a permutation vector in the format
+ * expected by \ref igraph_permute_vertices(): element \c i is the new id
+ * of vertex \c i. \ref igraph_reorder_vertices() computes such a
+ * permutation and applies it to the graph in one step.
+ * </para>
+ *
+ * <para>
+ * A vertex property \c x computed on the reordered graph is mapped
+ * back to the original vertex ids as
+ * <code>x_orig[i] = x[permutation[i]]</code>.
+ * </para>
+ */
+
+/* Breadth-first search from 'root' in its component. Returns the
+   eccentricity of root in 'ecc' and a vertex of minimum degree in the
+   last level as the return value. 'dist' must be -1 for all vertices
+   and is restored before returning. */
+
+static long int igraph_i_rcm_last_level(const igraph_adjlist_t *al,
+                                        const igraph_vector_long_t *degree,
+                                        igraph_vector_long_t *dist,
+                                        igraph_vector_long_t *queue,
+                                        long int root, long int *ecc) {
+    long int head = 0, tail = 0, best, i;
+
+    VECTOR(*dist)[root] = 0;
+    VECTOR(*queue)[tail++] = root;
+    while (head < tail) {
+        long int actnode = VECTOR(*queue)[head++];
+        igraph_vector_int_t *neis = igraph_adjlist_get(al, actnode);
+        long int j, n = igraph_vector_int_size(neis);
+        for (j = 0; j < n; j++) {
+            long int nei = VECTOR(*neis)[j];
+            if (VECTOR(*dist)[nei] < 0) {
+                VECTOR(*dist)[nei] = VECTOR(*dist)[actnode] + 1;
+                VECTOR(*queue)[tail++] = nei;
+            }
+        }
+    }
+
+    best = VECTOR(*queue)[tail - 1];
+    *ecc = VECTOR(*dist)[best];
+    for (i = tail - 2; i >= 0 && VECTOR(*dist)[ VECTOR(*queue)[i] ] == *ecc; i--) {
+        long int v = VECTOR(*queue)[i];
+        if (VECTOR(*degree)[v] <= VECTOR(*degree)[best]) {
+            best = v;
+        }
+    }
+
+    for (i = 0; i < tail; i++) {
+        VECTOR(*dist)[ VECTOR(*queue)[i] ] = -1;
+    }
+
+    return best;
+}
+
+static int igraph_i_rcm_cmp(void *degree, const void *a, const void *b) {
+    long int da = VECTOR(*(igraph_vector_long_t*)degree)[ *(const long int*)a ];
+    long int db = VECTOR(*(igraph_vector_long_t*)degree)[ *(const long int*)b ];
+    if (da != db) {
+        return da < db ? -1 : 1;
+    }
+    return *(const long int*)a < *(const long int*)b ? -1 :
+           *(const long int*)a > *(const long int*)b ? 1 : 0;
+}
+
+/**
+ * \function igraph_vertex_order_rcm
+ * \brief Reverse Cuthill-McKee vertex ordering.
+ *
+ * </para><para>
+ * The Cuthill-McKee ordering numbers the vertices in breadth-first
+ * order, starting from a pseudo-peripheral vertex of each component
+ * and visiting the neighbors of a vertex in increasing order of their
+ * degree. This keeps the ids of adjacent vertices close to each
+ * other, i.e. it reduces the bandwidth of the adjacency matrix. The
+ * reverse of this ordering is returned, which is usually better for
+ * sparse matrix factorizations, and equally good for graph traversals.
+ *
+ * </para><para>
+ * The pseudo-peripheral start vertices are found with the heuristic
+ * of George and Liu, starting from the unvisited vertex of smallest
+ * degree. Edge directions are ignored.
+ *
+ * </para><para>
+ * Reference: E. Cuthill and J. McKee: Reducing the bandwidth of sparse
+ * symmetric matrices, Proc. 24th National Conference of the ACM,
+ * 157-172, 1969. https://doi.org/10.1145/800195.805928
+ *
+ * \param graph The input graph.
+ * \param permutation An initialized vector, the permutation is stored
+ *    here, in the format expected by \ref igraph_permute_vertices().
+ * \return Error code.
+ *
+ * Time complexity: O(d(|V|+|E|)+|E| log d), where d is the maximum
+ * degree, the number of breadth-first searches done to find the start
+ * vertices is small in practice.
+ *
+ * \sa \ref igraph_reorder_vertices() to reorder the graph itself.
+ */
+
+int igraph_vertex_order_rcm(const igraph_t *graph,
+                            igraph_vector_t *permutation) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_adjlist_t al;
+    igraph_vector_long_t degree, bydegree, dist, queue, order;
+    long int i, maxdeg = 0, placed = 0;
+
+    IGRAPH_CHECK(igraph_vector_resize(permutation, no_of_nodes));
+    igraph_vector_null(permutation);
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &al, IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
+    IGRAPH_CHECK(igraph_vector_long_init(&degree, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &degree);
+    IGRAPH_CHECK(igraph_vector_long_init(&bydegree, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &bydegree);
+    IGRAPH_CHECK(igraph_vector_long_init(&dist, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &dist);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+    IGRAPH_CHECK(igraph_vector_long_init(&order, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(degree)[i] = igraph_vector_int_size(igraph_adjlist_get(&al, i));
+        if (VECTOR(degree)[i] > maxdeg) {
+            maxdeg = VECTOR(degree)[i];
+        }
+    }
+    igraph_vector_long_fill(&dist, -1);
+
+    /* Counting sort of the vertices by degree, the start vertex of
+       each component is the first unvisited one in this order */
+    {
+        igraph_vector_long_t start;
+        long int sum = 0;
+        IGRAPH_CHECK(igraph_vector_long_init(&start, maxdeg + 1));
+        IGRAPH_FINALLY(igraph_vector_long_destroy, &start);
+        for (i = 0; i < no_of_nodes; i++) {
+            VECTOR(start)[ VECTOR(degree)[i] ] += 1;
+        }
+        for (i = 0; i <= maxdeg; i++) {
+            long int tmp = VECTOR(start)[i];
+            VECTOR(start)[i] = sum;
+            sum += tmp;
+        }
+        for (i = 0; i < no_of_nodes; i++) {
+            VECTOR(bydegree)[ VECTOR(start)[ VECTOR(degree)[i] ]++ ] = i;
+        }
+        igraph_vector_long_destroy(&start);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        long int root = VECTOR(bydegree)[i], cand, ecc, ecc2, head;
+
+        if (VECTOR(*permutation)[root] != 0) {
+            continue;
+        }
+
+        /* George-Liu pseudo-peripheral vertex */
+        cand = igraph_i_rcm_last_level(&al, &degree, &dist, &queue, root, &ecc);
+        while (cand != root) {
+            long int next = igraph_i_rcm_last_level(&al, &degree, &dist,
+                                                    &queue, cand, &ecc2);
+            if (ecc2 <= ecc) {
+                break;
+            }
+            root = cand; ecc = ecc2; cand = next;
+        }
+
+        /* Cuthill-McKee from the root; 'order' is the BFS queue */
+        head = placed;
+        VECTOR(order)[placed++] = root;
+        VECTOR(*permutation)[root] = 1;
+        while (head < placed) {
+            long int actnode = VECTOR(order)[head++];
+            igraph_vector_int_t *neis = igraph_adjlist_get(&al, actnode);
+            long int j, n = igraph_vector_int_size(neis), first = placed;
+            for (j = 0; j < n; j++) {
+                long int nei = VECTOR(*neis)[j];
+                if (VECTOR(*permutation)[nei] == 0) {
+                    VECTOR(*permutation)[nei] = 1;
+                    VECTOR(order)[placed++] = nei;
+                }
+            }
+            igraph_qsort_r(VECTOR(order) + first, (size_t) (placed - first),
+                           sizeof(long int), &degree, igraph_i_rcm_cmp);
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(*permutation)[ VECTOR(order)[i] ] = no_of_nodes - 1 - i;
+    }
+
+    igraph_vector_long_destroy(&order);
+    igraph_vector_long_destroy(&queue);
+    igraph_vector_long_destroy(&dist);
+    igraph_vector_long_destroy(&bydegree);
+    igraph_vector_long_destroy(&degree);
+    igraph_adjlist_destroy(&al);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
+/**
+ * \function igraph_vertex_order_degree
+ * \brief Vertex ordering by decreasing degree.
+ *
+ * </para><para>
+ * The vertices are numbered in decreasing order of their degree,
+ * vertices of equal degree keep their relative order. This puts the
+ * high degree vertices, which are accessed most often, next to each
+ * other at the beginning of the vertex data.
+ *
+ * \param graph The input graph.
+ * \param permutation An initialized vector, the permutation is stored
+ *    here, in the format expected by \ref igraph_permute_vertices().
+ * \param mode The type of degree to use, \c IGRAPH_OUT, \c IGRAPH_IN
+ *    or \c IGRAPH_ALL. Ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|).
+ *
+ * \sa \ref igraph_reorder_vertices() to reorder the graph itself.
+ */
+
+int igraph_vertex_order_degree(const igraph_t *graph,
+                               igraph_vector_t *permutation,
+                               igraph_neimode_t mode) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_t degree;
+    igraph_vector_long_t start;
+    long int i, maxdeg, sum = 0;
+
+    IGRAPH_CHECK(igraph_vector_resize(permutation, no_of_nodes));
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(), mode,
+                               IGRAPH_LOOPS));
+    maxdeg = (long int) igraph_vector_max(&degree);
+
+    IGRAPH_CHECK(igraph_vector_long_init(&start, maxdeg + 1));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &start);
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(start)[ (long int) VECTOR(degree)[i] ] += 1;
+    }
+    for (i = maxdeg; i >= 0; i--) {
+        long int tmp = VECTOR(start)[i];
+        VECTOR(start)[i] = sum;
+        sum += tmp;
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(*permutation)[i] = VECTOR(start)[ (long int) VECTOR(degree)[i] ]++;
+    }
+
+    igraph_vector_long_destroy(&start);
+    igraph_vector_destroy(&degree);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/* Adds 'delta' to the Gorder score of the unplaced vertices that are
+   adjacent to 'v' or share an in-neighbor with it */
+
+static void igraph_i_gorder_update(igraph_2wheap_t *heap,
+                                   const igraph_adjlist_t *out,
+                                   const igraph_adjlist_t *in,
+                                   igraph_bool_t directed, long int hub,
+                                   long int v, igraph_real_t delta) {
+    igraph_vector_int_t *neis = igraph_adjlist_get(out, v);
+    long int i, n = igraph_vector_int_size(neis);
+
+    for (i = 0; i < n; i++) {
+        long int u = VECTOR(*neis)[i];
+        if (igraph_2wheap_has_elem(heap, u)) {
+            igraph_2wheap_modify(heap, u, igraph_2wheap_get(heap, u) + delta);
+        }
+    }
+
+    neis = igraph_adjlist_get(in, v);
+    n = igraph_vector_int_size(neis);
+    for (i = 0; i < n; i++) {
+        long int u = VECTOR(*neis)[i];
+        igraph_vector_int_t *sibs = igraph_adjlist_get(out, u);
+        long int j, n2 = igraph_vector_int_size(sibs);
+        if (directed && igraph_2wheap_has_elem(heap, u)) {
+            igraph_2wheap_modify(heap, u, igraph_2wheap_get(heap, u) + delta);
+        }
+        /* The siblings of hubs are not counted, they would make the
+           update expensive and they say little about locality */
+        if (n2 > hub) {
+            continue;
+        }
+        for (j = 0; j < n2; j++) {
+            long int w = VECTOR(*sibs)[j];
+            if (igraph_2wheap_has_elem(heap, w)) {
+                igraph_2wheap_modify(heap, w, igraph_2wheap_get(heap, w) + delta);
+            }
+        }
+    }
+}
+
+/**
+ * \function igraph_vertex_order_gorder
+ * \brief Gorder vertex ordering.
+ *
+ * </para><para>
+ * Gorder places the vertices one by one, always choosing next the
+ * vertex that has the most in common with the last \p window placed
+ * vertices. The score of a vertex is the number of edges between it
+ * and the vertices in the window, plus the number of common
+ * in-neighbors it has with them. Vertices with consecutive ids then
+ * tend to be visited together, which reduces the number of cache
+ * misses in most traversal algorithms. For undirected graphs every
+ * neighbor is an in-neighbor. Common neighbors via vertices with more
+ * than sqrt(|V|) out-neighbors are not counted.
+ *
+ * </para><para>
+ * Reference: Hao Wei, Jeffrey Xu Yu, Can Lu and Xuemin Lin: Speedup
+ * Graph Processing by Graph Ordering, Proceedings of the 2016
+ * International Conference on Management of Data, 1813-1828, 2016.
+ * https://doi.org/10.1145/2882903.2915220
+ *
+ * \param graph The input graph.
+ * \param permutation An initialized vector, the permutation is stored
+ *    here, in the format expected by \ref igraph_permute_vertices().
+ * \param window The size of the window, a positive integer. The
+ *    original paper recommends five.
+ * \return Error code.
+ *
+ * Time complexity: O(w sum_v sum_{u in N_in(v)} d_out(u) log|V|) in
+ * the worst case, where w is the window size.
+ *
+ * \sa \ref igraph_reorder_vertices() to reorder the graph itself.
+ */
+
+int igraph_vertex_order_gorder(const igraph_t *graph,
+                               igraph_vector_t *permutation,
+                               igraph_integer_t window) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_bool_t directed = igraph_is_directed(graph);
+    long int hub = (long int) sqrt((double) no_of_nodes);
+    igraph_adjlist_t out, in, *inptr = &out;
+    igraph_2wheap_t heap;
+    igraph_vector_long_t order;
+    long int i, start = 0, w = (long int) window;
+
+    if (w < 1) {
+        IGRAPH_ERROR("Gorder window size must be positive", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(permutation, no_of_nodes));
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &out, IGRAPH_OUT));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &out);
+    if (directed) {
+        IGRAPH_CHECK(igraph_adjlist_init(graph, &in, IGRAPH_IN));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &in);
+        inptr = &in;
+    }
+    IGRAPH_CHECK(igraph_vector_long_init(&order, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+    IGRAPH_CHECK(igraph_2wheap_init(&heap, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &heap);
+
+    /* Start with the vertex of largest in-degree */
+    for (i = 1; i < no_of_nodes; i++) {
+        if (igraph_vector_int_size(igraph_adjlist_get(inptr, i)) >
+            igraph_vector_int_size(igraph_adjlist_get(inptr, start))) {
+            start = i;
+        }
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        if (i != start) {
+            IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, i, 0));
+        }
+    }
+
+    VECTOR(order)[0] = start;
+    for (i = 1; i < no_of_nodes; i++) {
+        long int next;
+        igraph_i_gorder_update(&heap, &out, inptr, directed, hub,
+                               VECTOR(order)[i - 1], 1);
+        if (i - 1 - w >= 0) {
+            igraph_i_gorder_update(&heap, &out, inptr, directed, hub,
+                                   VECTOR(order)[i - 1 - w], -1);
+        }
+        igraph_2wheap_delete_max_index(&heap, &next);
+        VECTOR(order)[i] = next;
+
+        if (i % 1024 == 0) {
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(*permutation)[ VECTOR(order)[i] ] = i;
+    }
+
+    igraph_2wheap_destroy(&heap);
+    igraph_vector_long_destroy(&order);
+    IGRAPH_FINALLY_CLEAN(2);
+    if (directed) {
+        igraph_adjlist_destroy(&in);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_adjlist_destroy(&out);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_reorder_vertices
+ * \brief Renumbers the vertices of a graph to improve memory locality.
+ *
+ * </para><para>
+ * This function computes a vertex ordering with one of the
+ * heuristics in this section and creates the reordered graph with
+ * \ref igraph_permute_vertices(), in one pass over the edges. The
+ * graph, vertex and edge attributes are kept, edge ids do not change.
+ *
+ * \param graph The input graph.
+ * \param res Pointer to an uninitialized graph object, the reordered
+ *    graph is created here.
+ * \param permutation An initialized vector or a null pointer. If not
+ *    null, the permutation that was applied is stored here: element
+ *    \c i is the new id of vertex \c i.
+ * \param method The heuristic to use, see \ref igraph_reorder_t.
+ * \return Error code.
+ *
+ * Time complexity: the time complexity of the chosen heuristic, plus
+ * O(|V|+|E|) for the reordering.
+ *
+ * \example examples/tests/igraph_reorder_vertices.c
+ */
+
+int igraph_reorder_vertices(const igraph_t *graph, igraph_t *res,
+                            igraph_vector_t *permutation,
+                            igraph_reorder_t method) {
+
+    igraph_vector_t perm, *myperm = permutation;
+
+    if (!permutation) {
+        IGRAPH_VECTOR_INIT_FINALLY(&perm, 0);
+        myperm = &perm;
+    }
+
+    switch (method) {
+    case IGRAPH_REORDER_RCM:
+        IGRAPH_CHECK(igraph_vertex_order_rcm(graph, myperm));
+        break;
+    case IGRAPH_REORDER_DEGREE:
+        IGRAPH_CHECK(igraph_vertex_order_degree(graph, myperm, IGRAPH_ALL));
+        break;
+    case IGRAPH_REORDER_GORDER:
+        IGRAPH_CHECK(igraph_vertex_order_gorder(graph, myperm, 5));
+        break;
+    default:
+        IGRAPH_ERROR("Invalid vertex reordering method", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_permute_vertices(graph, res, myperm));
+
+    if (!permutation) {
+        igraph_vector_destroy(&perm);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return 0;
+}
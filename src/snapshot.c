@@ -0,0 +1,367 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_foreign.h"
+#include "igraph_interface.h"
+#include "igraph_attributes.h"
+#include "igraph_memory.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+
+#include <string.h>
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#define IGRAPH_I_SNAPSHOT_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* The snapshot file is a fixed size header, followed by the six
+   index vectors of igraph_t, in the order from, to, oi, ii, os, is.
+   Every vector is padded to a multiple of eight bytes. All numbers
+   are stored in the byte order and integer size of the machine that
+   wrote the file, the header records these, so that they can be
+   checked when reading. */
+
+#define IGRAPH_I_SNAPSHOT_MAGIC     "IGRAPHSN"
+#define IGRAPH_I_SNAPSHOT_VERSION   1
+#define IGRAPH_I_SNAPSHOT_BYTEORDER 0x01020304
+#define IGRAPH_I_SNAPSHOT_ALIGN     8
+
+typedef struct igraph_i_snapshot_header_t {
+    char magic[8];
+    unsigned int version;
+    unsigned int byteorder;
+    unsigned int intsize;
+    unsigned int directed;
+    igraph_integer_t n;
+    igraph_integer_t m;
+    char reserved[32];
+} igraph_i_snapshot_header_t;
+
+/* Size of a vector of 'n' integers in the file, with padding */
+static size_t igraph_i_snapshot_section(long int n) {
+    size_t bytes = (size_t) n * sizeof(igraph_integer_t);
+    return (bytes + IGRAPH_I_SNAPSHOT_ALIGN - 1) /
+           IGRAPH_I_SNAPSHOT_ALIGN * IGRAPH_I_SNAPSHOT_ALIGN;
+}
+
+static size_t igraph_i_snapshot_size(const igraph_i_snapshot_header_t *header) {
+    return sizeof(igraph_i_snapshot_header_t) +
+           4 * igraph_i_snapshot_section(header->m) +
+           2 * igraph_i_snapshot_section(header->n + 1L);
+}
+
+static int igraph_i_snapshot_check_header(const igraph_i_snapshot_header_t *header) {
+    if (memcmp(header->magic, IGRAPH_I_SNAPSHOT_MAGIC, sizeof(header->magic))) {
+        IGRAPH_ERROR("Not an igraph snapshot file", IGRAPH_PARSEERROR);
+    }
+    if (header->version != IGRAPH_I_SNAPSHOT_VERSION) {
+        IGRAPH_ERROR("Unsupported igraph snapshot version", IGRAPH_PARSEERROR);
+    }
+    if (header->byteorder != IGRAPH_I_SNAPSHOT_BYTEORDER ||
+        header->intsize != sizeof(igraph_integer_t)) {
+        IGRAPH_ERROR("Snapshot was written on an incompatible platform",
+                     IGRAPH_PARSEERROR);
+    }
+    if (header->n < 0 || header->m < 0) {
+        IGRAPH_ERROR("Invalid graph size in snapshot", IGRAPH_PARSEERROR);
+    }
+    return 0;
+}
+
+static int igraph_i_snapshot_write_section(FILE *outstream,
+        const igraph_vector_int_t *v) {
+    static const char padding[IGRAPH_I_SNAPSHOT_ALIGN] = { 0 };
+    long int n = igraph_vector_int_size(v);
+    size_t pad = igraph_i_snapshot_section(n) - n * sizeof(igraph_integer_t);
+
+    if (fwrite(VECTOR(*v), sizeof(igraph_integer_t), (size_t) n, outstream) !=
+        (size_t) n || fwrite(padding, 1, pad, outstream) != pad) {
+        IGRAPH_ERROR("Cannot write snapshot", IGRAPH_EFILE);
+    }
+    return 0;
+}
+
+static int igraph_i_snapshot_read_section(FILE *instream,
+        igraph_vector_int_t *v, long int n) {
+    char padding[IGRAPH_I_SNAPSHOT_ALIGN];
+    size_t pad = igraph_i_snapshot_section(n) - n * sizeof(igraph_integer_t);
+
+    IGRAPH_CHECK(igraph_vector_int_init(v, n));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, v);
+    if (fread(VECTOR(*v), sizeof(igraph_integer_t), (size_t) n, instream) !=
+        (size_t) n || fread(padding, 1, pad, instream) != pad) {
+        IGRAPH_ERROR("Truncated snapshot file", IGRAPH_PARSEERROR);
+    }
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/* Sanity checks that are cheap, the rest of the file is trusted */
+static int igraph_i_snapshot_check_index(const igraph_t *graph) {
+    long int n = graph->n, m = igraph_vector_int_size(&graph->from);
+    if (VECTOR(graph->os)[0] != 0 || VECTOR(graph->is)[0] != 0 ||
+        VECTOR(graph->os)[n] != m || VECTOR(graph->is)[n] != m) {
+        IGRAPH_ERROR("Corrupt snapshot file", IGRAPH_PARSEERROR);
+    }
+    return 0;
+}
+
+/* Reads the snapshot into ordinary, heap allocated vectors, when the
+   file cannot be mapped */
+
+static int igraph_i_snapshot_read(igraph_t *graph, FILE *instream) {
+    igraph_i_snapshot_header_t header;
+    long int n, m;
+
+    if (fread(&header, sizeof(header), 1, instream) != 1) {
+        IGRAPH_ERROR("Truncated snapshot file", IGRAPH_PARSEERROR);
+    }
+    IGRAPH_CHECK(igraph_i_snapshot_check_header(&header));
+    n = header.n;
+    m = header.m;
+
+    graph->n = header.n;
+    graph->directed = header.directed ? 1 : 0;
+    graph->deleted = 0;
+    graph->snapshot = 0;
+    graph->shared = 0;
+    graph->adjindex = 0;
+    graph->attr = 0;
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->from, m));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->from);
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->to, m));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->to);
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->oi, m));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->oi);
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->ii, m));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->ii);
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->os, n + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->os);
+    IGRAPH_CHECK(igraph_i_snapshot_read_section(instream, &graph->is, n + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &graph->is);
+
+    IGRAPH_CHECK(igraph_i_snapshot_check_index(graph));
+    IGRAPH_CHECK(igraph_i_attribute_init(graph, 0));
+
+    IGRAPH_FINALLY_CLEAN(6);
+    return 0;
+}
+
+#ifdef IGRAPH_I_SNAPSHOT_MMAP
+
+static void igraph_i_snapshot_free(igraph_i_snapshot_t *snapshot) {
+    munmap(snapshot->addr, snapshot->size);
+    igraph_Free(snapshot);
+}
+
+static int igraph_i_snapshot_map(igraph_t *graph, void *addr, size_t size) {
+    igraph_i_snapshot_t *snapshot;
+    igraph_i_snapshot_header_t *header = (igraph_i_snapshot_header_t *) addr;
+    const igraph_integer_t *data;
+    long int n, m;
+
+    snapshot = igraph_Calloc(1, igraph_i_snapshot_t);
+    if (snapshot == 0) {
+        munmap(addr, size);
+        IGRAPH_ERROR("Cannot read snapshot", IGRAPH_ENOMEM);
+    }
+    snapshot->addr = addr;
+    snapshot->size = size;
+    IGRAPH_FINALLY(igraph_i_snapshot_free, snapshot);
+
+    IGRAPH_CHECK(igraph_i_snapshot_check_header(header));
+    if (igraph_i_snapshot_size(header) > size) {
+        IGRAPH_ERROR("Truncated snapshot file", IGRAPH_PARSEERROR);
+    }
+    n = header->n;
+    m = header->m;
+
+    graph->n = header->n;
+    graph->directed = header->directed ? 1 : 0;
+    graph->deleted = 0;
+    graph->shared = 0;
+    graph->adjindex = 0;
+    graph->attr = 0;
+
+    data = (const igraph_integer_t *) ((char *) addr + sizeof(*header));
+    igraph_vector_int_view(&graph->from, data, m);
+    data += igraph_i_snapshot_section(m) / sizeof(igraph_integer_t);
+    igraph_vector_int_view(&graph->to, data, m);
+    data += igraph_i_snapshot_section(m) / sizeof(igraph_integer_t);
+    igraph_vector_int_view(&graph->oi, data, m);
+    data += igraph_i_snapshot_section(m) / sizeof(igraph_integer_t);
+    igraph_vector_int_view(&graph->ii, data, m);
+    data += igraph_i_snapshot_section(m) / sizeof(igraph_integer_t);
+    igraph_vector_int_view(&graph->os, data, n + 1);
+    data += igraph_i_snapshot_section(n + 1) / sizeof(igraph_integer_t);
+    igraph_vector_int_view(&graph->is, data, n + 1);
+
+    IGRAPH_CHECK(igraph_i_snapshot_check_index(graph));
+    IGRAPH_CHECK(igraph_i_attribute_init(graph, 0));
+    graph->snapshot = snapshot;
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+#endif
+
+void igraph_i_snapshot_destroy(igraph_t *graph) {
+#ifdef IGRAPH_I_SNAPSHOT_MMAP
+    if (graph->snapshot) {
+        igraph_i_snapshot_free(graph->snapshot);
+        graph->snapshot = 0;
+    }
+#endif
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_write_graph_snapshot
+ * \brief Writes the graph to a binary snapshot file.
+ *
+ * </para><para>
+ * The snapshot contains the internal edge index of the graph, in a
+ * form that \ref igraph_read_graph_snapshot() can use directly,
+ * without parsing or building an index. Vertex and edge ids are kept.
+ * Graph, vertex and edge attributes are not saved. Edges and
+ * vertices marked by \ref igraph_delete_edges_deferred() or \ref
+ * igraph_delete_vertices_deferred() are left out, so the ids are
+ * those after compaction.
+ *
+ * </para><para>
+ * The file is binary and platform dependent: it can only be read on
+ * a machine with the same byte order and integer size.
+ *
+ * \param graph The graph to write.
+ * \param outstream The stream to write to, it should be opened in
+ *        binary mode.
+ * \return Error code, \c IGRAPH_EFILE if the file cannot be written.
+ *
+ * Time complexity: O(|V|+|E|), the number of vertices and edges.
+ *
+ * \sa \ref igraph_read_graph_snapshot().
+ */
+
+int igraph_write_graph_snapshot(const igraph_t *graph, FILE *outstream) {
+    igraph_i_snapshot_header_t header;
+    igraph_t compacted;
+    const igraph_t *g = graph;
+
+    if (igraph_deleted_ecount(graph) > 0 || igraph_deleted_vcount(graph) > 0) {
+        IGRAPH_CHECK(igraph_copy(&compacted, graph));
+        IGRAPH_FINALLY(igraph_destroy, &compacted);
+        IGRAPH_CHECK(igraph_compact_deleted(&compacted, 0, 0));
+        g = &compacted;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = IGRAPH_I_SNAPSHOT_VERSION;
+    header.byteorder = IGRAPH_I_SNAPSHOT_BYTEORDER;
+    header.intsize = sizeof(igraph_integer_t);
+    header.directed = igraph_is_directed(g) ? 1 : 0;
+    header.n = igraph_vcount(g);
+    header.m = igraph_ecount(g);
+
+    if (fwrite(&header, sizeof(header), 1, outstream) != 1) {
+        IGRAPH_ERROR("Cannot write snapshot", IGRAPH_EFILE);
+    }
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->from));
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->to));
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->oi));
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->ii));
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->os));
+    IGRAPH_CHECK(igraph_i_snapshot_write_section(outstream, &g->is));
+
+    if (g != graph) {
+        igraph_destroy(&compacted);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return 0;
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_read_graph_snapshot
+ * \brief Opens a snapshot file as a read-only graph.
+ *
+ * </para><para>
+ * The file is mapped into memory read-only, and the edge index of the
+ * graph points into the mapping, so opening takes constant time, no
+ * matter how large the graph is. The pages of the file are loaded on
+ * demand, and they are shared by all processes that open the same
+ * file.
+ *
+ * </para><para>
+ * All functions that do not modify the graph work on a snapshot,
+ * functions that would modify it (\ref igraph_add_edges(), \ref
+ * igraph_delete_vertices(), etc.) fail with \c IGRAPH_EINVAL. Use
+ * \ref igraph_copy() to create a modifiable copy. The graph must be
+ * destroyed with \ref igraph_destroy() as usual, this unmaps the
+ * file. The stream itself can be closed right after this function
+ * returns.
+ *
+ * </para><para>
+ * The snapshot must start at the beginning of the file. If the
+ * stream is not a regular file, e.g. it is a pipe, or the platform
+ * does not support memory mapping, then the snapshot is read into
+ * memory from the current position of the stream, and the resulting
+ * graph is an ordinary, modifiable graph.
+ *
+ * </para><para>
+ * Only the sizes and a few entries of the index are checked, so
+ * the file must come from \ref igraph_write_graph_snapshot(), and it
+ * must not be modified while the graph is in use.
+ *
+ * \param graph Pointer to an uninitialized graph object.
+ * \param instream The stream to read from, it should be opened in
+ *        binary mode.
+ * \return Error code, \c IGRAPH_PARSEERROR if the file is not a
+ *         snapshot, it is truncated, or it was written on an
+ *         incompatible platform.
+ *
+ * Time complexity: O(1) if the file is mapped, O(|V|+|E|) otherwise.
+ *
+ * \sa \ref igraph_write_graph_snapshot().
+ */
+
+int igraph_read_graph_snapshot(igraph_t *graph, FILE *instream) {
+#ifdef IGRAPH_I_SNAPSHOT_MMAP
+    struct stat st;
+    int fd = fileno(instream);
+
+    if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+        (size_t) st.st_size >= sizeof(igraph_i_snapshot_header_t)) {
+        void *addr = mmap(0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            return igraph_i_snapshot_map(graph, addr, (size_t) st.st_size);
+        }
+    }
+#endif
+    return igraph_i_snapshot_read(graph, instream);
+}
@@ -29,6 +29,7 @@
 #include "igraph_memory.h"
 #include "igraph_random.h"
 #include "igraph_adjlist.h"
+#include "igraph_adjlist_internal.h"
 #include "igraph_interface.h"
 #include "igraph_progress.h"
 #include "igraph_interrupt_internal.h"
@@ -44,11 +45,216 @@
 #include "igraph_qsort.h"
 #include "config.h"
 #include "structural_properties_internal.h"
+#include "igraph_msbfs_internal.h"
+#include "igraph_delta_stepping_internal.h"
+#include "igraph_dial_internal.h"
 
 #include <assert.h>
 #include <string.h>
 #include <limits.h>
 
+/* Views of the edges incident on 'node', for 'mode'. IGRAPH_ALL and
+   undirected graphs need two views, the edges of the second one come
+   after the edges of the first one, like in igraph_incident(). */
+
+static int igraph_i_incident_views(const igraph_t *graph, long int node,
+                                   igraph_neimode_t mode,
+                                   igraph_incident_view_t *views,
+                                   int *no_of_views) {
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    *no_of_views = 0;
+    if (mode & IGRAPH_OUT) {
+        IGRAPH_CHECK(igraph_incident_view(graph, &views[(*no_of_views)++],
+                                          (igraph_integer_t) node, IGRAPH_OUT));
+    }
+    if (mode & IGRAPH_IN) {
+        IGRAPH_CHECK(igraph_incident_view(graph, &views[(*no_of_views)++],
+                                          (igraph_integer_t) node, IGRAPH_IN));
+    }
+    return 0;
+}
+
+/* Breadth-first search that only finds the distances from 'source'.
+   'dist' must be -1 for all vertices, the distance of the reached
+   vertices is written there, and they are listed in 'order' by
+   distance. If 'targets' is given, the search stops at the level where
+   the last one of its 'no_of_targets' non-zero vertices is reached.
+
+   The search is direction-optimizing: when the edges of the frontier
+   outnumber the edges of the unreached vertices, the next level is
+   found bottom-up, by looking for a frontier vertex among the
+   neighbors (in the opposite direction) of every unreached vertex and
+   stopping at the first one found. It goes back to top-down when the
+   frontier becomes small again. On graphs with a small diameter this
+   skips most edge checks of the few large middle levels.
+
+   If 'top_down' is true, all levels are found top-down. If
+   'edge_checks' is not a null pointer, the number of checked edges
+   is added to it. These two are only used by
+   igraph_i_bfs_edge_checks(). */
+
+#define IGRAPH_I_BFS_ALPHA 14   /* switch to bottom-up */
+#define IGRAPH_I_BFS_BETA  24   /* switch back to top-down */
+
+/* Below this many sources igraph_shortest_paths() uses this search
+   instead of igraph_i_msbfs_run() */
+#define IGRAPH_I_BFS_MAX_SOURCES 8
+
+static int igraph_i_bfs_distances(const igraph_t *graph, long int source,
+                                  igraph_neimode_t mode,
+                                  igraph_vector_int_t *dist,
+                                  igraph_vector_t *order,
+                                  const igraph_vector_t *targets,
+                                  long int no_of_targets,
+                                  igraph_bool_t top_down,
+                                  igraph_real_t *edge_checks) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_neimode_t revmode;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
+    long int begin, end, prev_size = 0, i, j, v, d;
+    long int reached_targets = 0;
+    igraph_real_t frontier_edges = 0, unexplored_edges;
+    igraph_bool_t bottom_up = 0;
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    revmode = mode == IGRAPH_OUT ? IGRAPH_IN :
+              mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+    unexplored_edges = (mode == IGRAPH_ALL ? 2.0 : 1.0) * igraph_ecount(graph);
+
+    igraph_vector_clear(order);
+    IGRAPH_CHECK(igraph_vector_push_back(order, source));
+    VECTOR(*dist)[source] = 0;
+
+    begin = 0;
+    end = 1;
+    for (d = 1; begin < end; d++) {
+
+        /* Edge counts of the new frontier, and check the targets */
+        for (i = begin; i < end; i++) {
+            v = (long int) VECTOR(*order)[i];
+            IGRAPH_CHECK(igraph_i_incident_views(graph, v, mode, views, &no_of_views));
+            for (k = 0; k < no_of_views; k++) {
+                frontier_edges += IGRAPH_VIEW_SIZE(views[k]);
+            }
+            IGRAPH_CHECK(igraph_i_incident_views(graph, v, revmode, views, &no_of_views));
+            for (k = 0; k < no_of_views; k++) {
+                unexplored_edges -= IGRAPH_VIEW_SIZE(views[k]);
+            }
+            if (targets && VECTOR(*targets)[v]) {
+                reached_targets++;
+            }
+        }
+        if (targets && reached_targets == no_of_targets) {
+            break;
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        if (top_down) {
+            /* never switch */
+        } else if (!bottom_up && end - begin > prev_size &&
+            frontier_edges > unexplored_edges / IGRAPH_I_BFS_ALPHA) {
+            bottom_up = 1;
+        } else if (bottom_up && end - begin < prev_size &&
+                   end - begin < no_of_nodes / IGRAPH_I_BFS_BETA) {
+            bottom_up = 0;
+        }
+        prev_size = end - begin;
+        frontier_edges = 0;
+
+        if (bottom_up) {
+            for (v = 0; v < no_of_nodes; v++) {
+                igraph_bool_t found = 0;
+                if (VECTOR(*dist)[v] >= 0) {
+                    continue;
+                }
+                IGRAPH_CHECK(igraph_i_incident_views(graph, v, revmode, views,
+                                                     &no_of_views));
+                for (k = 0; k < no_of_views && !found; k++) {
+                    for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                        long int nei = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                        if (VECTOR(*dist)[nei] == d - 1 &&
+                            !IGRAPH_VIEW_DELETED(views[k], j)) {
+                            found = 1;
+                            break;
+                        }
+                    }
+                    if (edge_checks) {
+                        *edge_checks += found ? j + 1 : j;
+                    }
+                }
+                if (found) {
+                    VECTOR(*dist)[v] = (int) d;
+                    IGRAPH_CHECK(igraph_vector_push_back(order, v));
+                }
+            }
+        } else {
+            for (i = begin; i < end; i++) {
+                v = (long int) VECTOR(*order)[i];
+                IGRAPH_CHECK(igraph_i_incident_views(graph, v, mode, views,
+                                                     &no_of_views));
+                for (k = 0; k < no_of_views; k++) {
+                    for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                        long int nei = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                        if (VECTOR(*dist)[nei] >= 0 ||
+                            IGRAPH_VIEW_DELETED(views[k], j)) {
+                            continue;
+                        }
+                        VECTOR(*dist)[nei] = (int) d;
+                        IGRAPH_CHECK(igraph_vector_push_back(order, nei));
+                    }
+                    if (edge_checks) {
+                        *edge_checks += IGRAPH_VIEW_SIZE(views[k]);
+                    }
+                }
+            }
+        }
+
+        begin = end;
+        end = igraph_vector_size(order);
+    }
+
+    return 0;
+}
+
+/* The number of edges checked by igraph_i_bfs_distances() from
+   'source', with the direction-optimizing search if 'hybrid' is true
+   and top-down only otherwise. This is only for the benchmarks. */
+
+int igraph_i_bfs_edge_checks(const igraph_t *graph, igraph_integer_t source,
+                             igraph_neimode_t mode, igraph_bool_t hybrid,
+                             igraph_real_t *res) {
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_int_t dist;
+    igraph_vector_t order;
+
+    if (source < 0 || source >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid source vertex", IGRAPH_EINVVID);
+    }
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&dist, no_of_nodes);
+    igraph_vector_int_fill(&dist, -1);
+    IGRAPH_VECTOR_INIT_FINALLY(&order, 0);
+
+    *res = 0;
+    IGRAPH_CHECK(igraph_i_bfs_distances(graph, source, mode, &dist, &order,
+                                        /*targets=*/ 0, 0, !hybrid, res));
+
+    igraph_vector_destroy(&order);
+    igraph_vector_int_destroy(&dist);
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
 /**
  * \section about_structural
  *
@@ -56,11 +262,279 @@
  * of a graph, like its diameter, the degree of the nodes, etc.</para>
  */
 
+/* Exact diameter of an undirected graph with the iFUB algorithm
+   (Crescenzi et al.: On computing the diameter of real-world
+   undirected graphs, 2013), in each connected component.
+
+   A 4-sweep chooses a root in the middle of a long path, then the
+   eccentricities of the vertices are computed level by level, from
+   the farthest level of the BFS tree of the root. Once level i is
+   done, every pair of vertices not examined yet is within levels
+   0..i-1, so closer than 2(i-1). The search goes on while these pairs
+   could be as far as the largest eccentricity found, not only
+   farther, so that every pair at the diameter has an endpoint whose
+   eccentricity was computed. Then the smallest vertex of largest
+   eccentricity is either one of these, or the smallest vertex at that
+   distance from one of these. This is the vertex that a BFS from each
+   vertex in turn would choose. */
+
+typedef struct igraph_i_ifub_t {
+    igraph_adjlist_t *adjlist;
+    long int *dist;             /* -1 if not reached */
+    long int *queue;            /* the reached vertices, in BFS order */
+    long int *parent;
+    long int diameter;          /* largest eccentricity found */
+    long int from;              /* smallest vertex with that eccentricity */
+} igraph_i_ifub_t;
+
+/* BFS from 'source', returns its eccentricity and the number of
+   reached vertices in 'size'. igraph_i_ifub_reset() must be called
+   before the next BFS. */
+
+static long int igraph_i_ifub_bfs(igraph_i_ifub_t *s, long int source,
+                                  long int *size) {
+    long int head = 0, tail = 0, ecc, i;
+
+    s->queue[tail++] = source;
+    s->dist[source] = 0;
+    s->parent[source] = -1;
+    while (head < tail) {
+        long int act = s->queue[head++];
+        igraph_vector_int_t *neis = igraph_adjlist_get(s->adjlist, act);
+        long int j, n = igraph_vector_int_size(neis);
+        for (j = 0; j < n; j++) {
+            long int nei = (long int) VECTOR(*neis)[j];
+            if (s->dist[nei] < 0) {
+                s->dist[nei] = s->dist[act] + 1;
+                s->parent[nei] = act;
+                s->queue[tail++] = nei;
+            }
+        }
+    }
+
+    ecc = s->dist[s->queue[tail - 1]];
+    if (ecc >= s->diameter) {
+        long int min = source;
+        for (i = tail - 1; i >= 0 && s->dist[s->queue[i]] == ecc; i--) {
+            if (s->queue[i] < min) {
+                min = s->queue[i];
+            }
+        }
+        if (ecc > s->diameter || min < s->from) {
+            s->from = min;
+        }
+        s->diameter = ecc;
+    }
+
+    *size = tail;
+    return ecc;
+}
+
+static void igraph_i_ifub_reset(igraph_i_ifub_t *s, long int size) {
+    long int i;
+    for (i = 0; i < size; i++) {
+        s->dist[s->queue[i]] = -1;
+    }
+}
+
+static int igraph_i_ifub_cmp(const void *a, const void *b) {
+    long int x = *(const long int *) a, y = *(const long int *) b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* The vertex in the middle of the path from the last BFS source to v */
+
+static long int igraph_i_ifub_middle(igraph_i_ifub_t *s, long int v) {
+    long int i, half = s->dist[v] / 2;
+    for (i = 0; i < half; i++) {
+        v = s->parent[v];
+    }
+    return v;
+}
+
+static int igraph_i_diameter_ifub(igraph_adjlist_t *adjlist,
+                                  igraph_bool_t unconn, long int *res,
+                                  long int *from, long int *to) {
+    long int no_of_nodes = igraph_adjlist_size(adjlist);
+    igraph_i_ifub_t s;
+    long int *order, *levels;
+    char *done;
+    long int v, i, k, size, done_count = 0;
+
+    *res = 0;
+    *from = *to = 0;
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    s.adjlist = adjlist;
+    s.diameter = -1;
+    s.from = 0;
+    s.dist = igraph_Calloc(no_of_nodes, long int);
+    if (s.dist == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s.dist);
+    s.queue = igraph_Calloc(no_of_nodes, long int);
+    if (s.queue == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s.queue);
+    s.parent = igraph_Calloc(no_of_nodes, long int);
+    if (s.parent == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, s.parent);
+    order = igraph_Calloc(no_of_nodes, long int);
+    if (order == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, order);
+    levels = igraph_Calloc(no_of_nodes + 1, long int);
+    if (levels == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, levels);
+    done = igraph_Calloc(no_of_nodes, char);
+    if (done == 0) {
+        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, done);
+
+    for (v = 0; v < no_of_nodes; v++) {
+        s.dist[v] = -1;
+    }
+
+    for (v = 0; v < no_of_nodes; v++) {
+        long int root = v, best = v, ecc, best_ecc, maxdeg = -1;
+
+        if (done[v]) {
+            continue;
+        }
+
+        IGRAPH_PROGRESS("Diameter: ", 100.0 * done_count / no_of_nodes, NULL);
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* The component of v, starting from its highest degree vertex */
+        igraph_i_ifub_bfs(&s, v, &size);
+        igraph_i_ifub_reset(&s, size);
+        done_count += size;
+        if (size < no_of_nodes && !unconn) {
+            *res = no_of_nodes;
+            *from = *to = -1;
+            break;
+        }
+        for (i = 0; i < size; i++) {
+            long int u = s.queue[i];
+            long int deg = igraph_vector_int_size(igraph_adjlist_get(adjlist, u));
+            done[u] = 1;
+            if (deg > maxdeg) {
+                maxdeg = deg;
+                root = u;
+            }
+        }
+        if (size - 1 < s.diameter) {
+            continue;           /* too small to have a longer path */
+        }
+
+        /* 4-sweep: two double sweeps, each from the middle of the
+           longest path found by the previous one. The root of the
+           levels is the vertex of smallest eccentricity among the
+           three sources, the last middle vertex is not always the best
+           in graphs with a small diameter. */
+        best_ecc = size;
+        for (k = 0; ; k++) {
+            long int a, b;
+            ecc = igraph_i_ifub_bfs(&s, root, &size);
+            a = s.queue[size - 1];
+            igraph_i_ifub_reset(&s, size);
+            if (ecc < best_ecc) {
+                best_ecc = ecc;
+                best = root;
+            }
+            if (k == 2) {
+                break;
+            }
+            igraph_i_ifub_bfs(&s, a, &size);
+            b = s.queue[size - 1];
+            root = igraph_i_ifub_middle(&s, b);
+            igraph_i_ifub_reset(&s, size);
+        }
+
+        /* The levels of the BFS tree of the root */
+        ecc = igraph_i_ifub_bfs(&s, best, &size);
+        memcpy(order, s.queue, (size_t) size * sizeof(long int));
+        for (i = 0; i <= ecc + 1; i++) {
+            levels[i] = 0;
+        }
+        for (i = 0; i < size; i++) {
+            levels[s.dist[order[i]] + 1] = i + 1;
+        }
+        igraph_i_ifub_reset(&s, size);
+
+        /* Level i holds order[levels[i]] ... order[levels[i+1]-1]. If
+           2i is the diameter, then it cannot grow any more, only a
+           smaller endpoint can be found, so the vertices are checked
+           in increasing order, until the current one. */
+        for (i = ecc; i >= 1 && 2 * i >= s.diameter; i--) {
+            igraph_bool_t ties = (2 * i == s.diameter);
+            if (ties) {
+                igraph_qsort(order + levels[i], (size_t) (levels[i + 1] - levels[i]),
+                             sizeof(long int), igraph_i_ifub_cmp);
+            }
+            for (k = levels[i]; k < levels[i + 1]; k++) {
+                long int size2;
+                if (ties && order[k] >= s.from) {
+                    break;
+                }
+                IGRAPH_ALLOW_INTERRUPTION();
+                igraph_i_ifub_bfs(&s, order[k], &size2);
+                igraph_i_ifub_reset(&s, size2);
+            }
+        }
+    }
+
+    if (*from >= 0) {
+        /* The first vertex at the largest distance, in BFS order */
+        *res = s.diameter;
+        *from = s.from;
+        igraph_i_ifub_bfs(&s, s.from, &size);
+        for (i = 0; s.dist[s.queue[i]] < s.diameter; i++) ;
+        *to = s.queue[i];
+    }
+
+    igraph_Free(done);
+    igraph_Free(levels);
+    igraph_Free(order);
+    igraph_Free(s.parent);
+    igraph_Free(s.queue);
+    igraph_Free(s.dist);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_diameter
  * \brief Calculates the diameter of a graph (longest geodesic).
  *
+ * </para><para>
+ * For undirected graphs, and when \p directed is false, the
+ * eccentricities of most vertices are not computed: the iFUB
+ * algorithm of Crescenzi et al. starts a breadth-first search from a
+ * vertex in the middle of a long path, found with a few searches, and
+ * then only from the vertices farthest from it, until the remaining
+ * vertices cannot be farther from each other than the diameter
+ * already found. The endpoints and the path returned are the same
+ * as if each vertex was checked in turn: \p pfrom is the vertex with
+ * the smallest id, whose eccentricity is the diameter.
+ *
+ * </para><para>
+ * Reference: Pilu Crescenzi, Roberto Grossi, Michel Habib, Leonardo
+ * Lanzi and Andrea Marino: On computing the diameter of real-world
+ * undirected graphs, Theoretical Computer Science 514, 84-95 (2013).
+ *
  * \param graph The graph object.
  * \param pres Pointer to an integer, if not \c NULL then it will contain
  *        the diameter (the actual distance).
@@ -84,7 +558,9 @@
  *         temporary data.
  *
  * Time complexity: O(|V||E|), the
- * number of vertices times the number of edges.
+ * number of vertices times the number of edges. For undirected
+ * graphs this is the worst case, usually only a few searches are
+ * needed and the running time is close to O(|V|+|E|).
  *
  * \example examples/simple/igraph_diameter.c
  */
@@ -106,62 +582,71 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
     igraph_neimode_t dirmode;
     igraph_adjlist_t allneis;
 
-    if (directed) {
+    if (directed && igraph_is_directed(graph)) {
         dirmode = IGRAPH_OUT;
     } else {
         dirmode = IGRAPH_ALL;
     }
-    already_added = igraph_Calloc(no_of_nodes, long int);
-    if (already_added == 0) {
-        IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, already_added);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &allneis, dirmode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
-    for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 1;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_added[i] = i + 1;
+    if (dirmode == IGRAPH_ALL) {
+        IGRAPH_CHECK(igraph_i_diameter_ifub(&allneis, unconn, &res, &from, &to));
+    } else {
+        already_added = igraph_Calloc(no_of_nodes, long int);
+        if (already_added == 0) {
+            IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, already_added);
+        IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
-        IGRAPH_PROGRESS("Diameter: ", 100.0 * i / no_of_nodes, NULL);
+        for (i = 0; i < no_of_nodes; i++) {
+            nodes_reached = 1;
+            IGRAPH_CHECK(igraph_dqueue_push(&q, i));
+            IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
+            already_added[i] = i + 1;
 
-        IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_PROGRESS("Diameter: ", 100.0 * i / no_of_nodes, NULL);
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-            if (actdist > res) {
-                res = actdist;
-                from = i;
-                to = actnode;
-            }
+            IGRAPH_ALLOW_INTERRUPTION();
 
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_added[neighbor] == i + 1) {
-                    continue;
+            while (!igraph_dqueue_empty(&q)) {
+                long int actnode = (long int) igraph_dqueue_pop(&q);
+                long int actdist = (long int) igraph_dqueue_pop(&q);
+                if (actdist > res) {
+                    res = actdist;
+                    from = i;
+                    to = actnode;
                 }
-                already_added[neighbor] = i + 1;
-                nodes_reached++;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+
+                neis = igraph_adjlist_get(&allneis, actnode);
+                n = igraph_vector_int_size(neis);
+                for (j = 0; j < n; j++) {
+                    long int neighbor = (long int) VECTOR(*neis)[j];
+                    if (already_added[neighbor] == i + 1) {
+                        continue;
+                    }
+                    already_added[neighbor] = i + 1;
+                    nodes_reached++;
+                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
+                    IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+                }
+            } /* while !igraph_dqueue_empty */
+
+            /* not connected, return largest possible */
+            if (nodes_reached != no_of_nodes && !unconn) {
+                res = no_of_nodes;
+                from = -1;
+                to = -1;
+                break;
             }
-        } /* while !igraph_dqueue_empty */
+        } /* for i<no_of_nodes */
 
-        /* not connected, return largest possible */
-        if (nodes_reached != no_of_nodes && !unconn) {
-            res = no_of_nodes;
-            from = -1;
-            to = -1;
-            break;
-        }
-    } /* for i<no_of_nodes */
+        igraph_Free(already_added);
+        igraph_dqueue_destroy(&q);
+        IGRAPH_FINALLY_CLEAN(2);
+    }
 
     IGRAPH_PROGRESS("Diameter: ", 100.0, NULL);
 
@@ -193,11 +678,51 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
     }
 
     /* clean */
-    igraph_Free(already_added);
-    igraph_dqueue_destroy(&q);
     igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* Visitors of the multi-source BFS in igraph_average_path_length()
+   and igraph_path_length_hist(): they count the vertex pairs at each
+   distance */
+
+typedef struct igraph_i_path_length_t {
+    const igraph_i_msbfs_t *msbfs;
+    igraph_vector_t *hist;
+    igraph_real_t sum, reached;
+    long int maxdist;
+} igraph_i_path_length_t;
+
+static int igraph_i_average_path_length_visit(
+        long int vertex, long int dist, long int first,
+        const igraph_i_msbfs_word_t *sources, void *extra) {
+    igraph_i_path_length_t *data = (igraph_i_path_length_t *) extra;
+    if (dist > 0) {
+        long int count = igraph_i_msbfs_count(data->msbfs, sources);
+        data->sum += dist * count;
+        data->reached += count;
+    }
+    IGRAPH_UNUSED(vertex);
+    IGRAPH_UNUSED(first);
+    return 0;
+}
 
+static int igraph_i_path_length_hist_visit(
+        long int vertex, long int dist, long int first,
+        const igraph_i_msbfs_word_t *sources, void *extra) {
+    igraph_i_path_length_t *data = (igraph_i_path_length_t *) extra;
+    if (dist > 0) {
+        long int count = igraph_i_msbfs_count(data->msbfs, sources);
+        VECTOR(*data->hist)[dist - 1] += count;
+        data->reached += count;
+        if (dist > data->maxdist) {
+            data->maxdist = dist;
+        }
+    }
+    IGRAPH_UNUSED(vertex);
+    IGRAPH_UNUSED(first);
     return 0;
 }
 
@@ -223,73 +748,52 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
  * Time complexity: O(|V||E|), the
  * number of vertices times the number of edges.
  *
+ * \sa \ref igraph_hyperanf() and \ref igraph_hyperanf_stats() for an
+ * estimate in a few passes over the graph.
+ *
  * \example examples/simple/igraph_average_path_length.c
  */
 
 int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
                                igraph_bool_t directed, igraph_bool_t unconn) {
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    long int *already_added;
-    long int nodes_reached = 0;
-    igraph_real_t normfact = 0.0;
-
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
+    igraph_real_t normfact;
+    igraph_real_t unreached;
     igraph_neimode_t dirmode;
     igraph_adjlist_t allneis;
+    igraph_vit_t vit;
+    igraph_i_msbfs_t msbfs;
+    igraph_i_path_length_t data;
 
-    *res = 0;
     if (directed) {
         dirmode = IGRAPH_OUT;
     } else {
         dirmode = IGRAPH_ALL;
     }
-    already_added = igraph_Calloc(no_of_nodes, long int);
-    if (already_added == 0) {
-        IGRAPH_ERROR("average path length failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
-    igraph_adjlist_init(graph, &allneis, dirmode);
+    IGRAPH_CHECK(igraph_vit_create(graph, igraph_vss_all(), &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &allneis, dirmode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, &allneis, no_of_nodes));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
-    for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_added[i] = i + 1;
-
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_added[neighbor] == i + 1) {
-                    continue;
-                }
-                already_added[neighbor] = i + 1;
-                nodes_reached++;
-                *res += actdist + 1;
-                normfact += 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-            }
-        } /* while !igraph_dqueue_empty */
+    data.msbfs = &msbfs;
+    data.sum = 0;
+    data.reached = 0;
+    IGRAPH_CHECK(igraph_i_msbfs_run(&msbfs, &vit,
+                                    igraph_i_average_path_length_visit, &data,
+                                    /*progress=*/ 0));
 
-        /* not connected, return largest possible */
-        if (!unconn) {
-            *res += (no_of_nodes * (no_of_nodes - 1 - nodes_reached));
-            normfact += no_of_nodes - 1 - nodes_reached;
-        }
-    } /* for i<no_of_nodes */
+    *res = data.sum;
+    normfact = data.reached;
 
+    /* not connected, return largest possible */
+    if (!unconn) {
+        unreached = (igraph_real_t) no_of_nodes * (no_of_nodes - 1) - data.reached;
+        *res += no_of_nodes * unreached;
+        normfact += unreached;
+    }
 
     if (normfact > 0) {
         *res /= normfact;
@@ -298,9 +802,9 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
     }
 
     /* clean */
-    igraph_Free(already_added);
-    igraph_dqueue_destroy(&q);
+    igraph_i_msbfs_destroy(&msbfs);
     igraph_adjlist_destroy(&allneis);
+    igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(3);
 
     return 0;
@@ -330,23 +834,21 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
  * Time complexity: O(|V||E|), the number of vertices times the number
  * of edges.
  *
- * \sa \ref igraph_average_path_length() and \ref igraph_shortest_paths()
+ * \sa \ref igraph_average_path_length() and \ref igraph_shortest_paths(),
+ * \ref igraph_hyperanf() for an estimate in a few passes over the graph.
  */
 
 int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
                             igraph_real_t *unconnected, igraph_bool_t directed) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    igraph_vector_long_t already_added;
-    long int nodes_reached;
-
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
+    long int i;
     igraph_neimode_t dirmode;
     igraph_adjlist_t allneis;
-    igraph_real_t unconn = 0;
-    long int ressize;
+    igraph_vit_t vit;
+    igraph_i_msbfs_t msbfs;
+    igraph_i_path_length_t data;
+    igraph_real_t unconn;
 
     if (directed) {
         dirmode = IGRAPH_OUT;
@@ -354,68 +856,41 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
         dirmode = IGRAPH_ALL;
     }
 
-    IGRAPH_CHECK(igraph_vector_long_init(&already_added, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &already_added);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
+    IGRAPH_CHECK(igraph_vit_create(graph, igraph_vss_all(), &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &allneis, dirmode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, &allneis, no_of_nodes));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
-    IGRAPH_CHECK(igraph_vector_resize(res, 0));
-    ressize = 0;
-
-    for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 1;      /* itself */
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        VECTOR(already_added)[i] = i + 1;
-
-        IGRAPH_PROGRESS("Path-hist: ", 100.0 * i / no_of_nodes, NULL);
-
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_added)[neighbor] == i + 1) {
-                    continue;
-                }
-                VECTOR(already_added)[neighbor] = i + 1;
-                nodes_reached++;
-                if (actdist + 1 > ressize) {
-                    IGRAPH_CHECK(igraph_vector_resize(res, actdist + 1));
-                    for (; ressize < actdist + 1; ressize++) {
-                        VECTOR(*res)[ressize] = 0;
-                    }
-                }
-                VECTOR(*res)[actdist] += 1;
-
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-            }
-        } /* while !igraph_dqueue_empty */
-
-        unconn += (no_of_nodes - nodes_reached);
+    /* No path is longer than no_of_nodes-1 */
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+    igraph_vector_null(res);
 
-    } /* for i<no_of_nodes */
+    data.msbfs = &msbfs;
+    data.hist = res;
+    data.reached = 0;
+    data.maxdist = 0;
+    IGRAPH_CHECK(igraph_i_msbfs_run(&msbfs, &vit,
+                                    igraph_i_path_length_hist_visit, &data,
+                                    "Path-hist: "));
 
     IGRAPH_PROGRESS("Path-hist: ", 100.0, NULL);
 
+    IGRAPH_CHECK(igraph_vector_resize(res, data.maxdist));
+    unconn = (igraph_real_t) no_of_nodes * (no_of_nodes - 1) - data.reached;
+
     /* count every pair only once for an undirected graph */
     if (!directed || !igraph_is_directed(graph)) {
-        for (i = 0; i < ressize; i++) {
+        for (i = 0; i < data.maxdist; i++) {
             VECTOR(*res)[i] /= 2;
         }
         unconn /= 2;
     }
 
-    igraph_vector_long_destroy(&already_added);
-    igraph_dqueue_destroy(&q);
+    igraph_i_msbfs_destroy(&msbfs);
     igraph_adjlist_destroy(&allneis);
+    igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(3);
 
     if (unconnected) {
@@ -425,6 +900,60 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
     return 0;
 }
 
+/* Visitor of the multi-source BFS in igraph_shortest_paths(), it
+   writes the distances to the matrix and stops the batch when all
+   targets were reached from all sources */
+
+typedef struct igraph_i_shortest_paths_t {
+    const igraph_i_msbfs_t *msbfs;
+    igraph_matrix_t *res;
+    const igraph_vector_t *indexv;  /* null if all vertices are targets */
+    long int no_of_from, no_of_to;
+    long int first, reached;
+} igraph_i_shortest_paths_t;
+
+static int igraph_i_shortest_paths_visit(
+        long int vertex, long int dist, long int first,
+        const igraph_i_msbfs_word_t *sources, void *extra) {
+    igraph_i_shortest_paths_t *data = (igraph_i_shortest_paths_t *) extra;
+    long int col = vertex, batch_size;
+    int w;
+
+    if (data->indexv) {
+        col = (long int) VECTOR(*data->indexv)[vertex] - 1;
+        if (col < 0) {
+            return 0;
+        }
+    }
+
+    for (w = 0; w < data->msbfs->words; w++) {
+        igraph_i_msbfs_word_t x = sources[w];
+        while (x) {
+            long int row = first + w * IGRAPH_I_MSBFS_WORD_BITS +
+                           IGRAPH_I_MSBFS_CTZ(x);
+            MATRIX(*data->res, row, col) = dist;
+            x &= x - 1;
+        }
+    }
+
+    if (data->indexv) {
+        if (first != data->first) {
+            data->first = first;
+            data->reached = 0;
+        }
+        data->reached += igraph_i_msbfs_count(data->msbfs, sources);
+        batch_size = data->msbfs->words * IGRAPH_I_MSBFS_WORD_BITS;
+        if (batch_size > data->no_of_from - first) {
+            batch_size = data->no_of_from - first;
+        }
+        if (data->reached == batch_size * data->no_of_to) {
+            return IGRAPH_STOP;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_shortest_paths
@@ -482,10 +1011,6 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
 
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_from, no_of_to;
-    long int *already_counted;
-    igraph_adjlist_t adjlist;
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
     igraph_bool_t all_to;
 
     long int i, j;
@@ -502,16 +1027,6 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-    already_counted = igraph_Calloc(no_of_nodes, long int);
-    if (already_counted == 0) {
-        IGRAPH_ERROR("shortest paths failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_counted);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
     if ( (all_to = igraph_vs_is_all(&to)) ) {
         no_of_to = no_of_nodes;
     } else {
@@ -532,44 +1047,65 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
     igraph_matrix_fill(res, my_infinity);
 
-    for (IGRAPH_VIT_RESET(fromvit), i = 0;
-         !IGRAPH_VIT_END(fromvit);
-         IGRAPH_VIT_NEXT(fromvit), i++) {
-        long int reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(fromvit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_counted[ (long int) IGRAPH_VIT_GET(fromvit) ] = i + 1;
-
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
+    if (no_of_from < IGRAPH_I_BFS_MAX_SOURCES) {
+        /* A few sources, search from them one by one */
+        igraph_vector_int_t dist;
+        igraph_vector_t order;
 
-            if (all_to) {
-                MATRIX(*res, i, act) = actdist;
-            } else {
-                if (VECTOR(indexv)[act]) {
-                    MATRIX(*res, i, (long int)(VECTOR(indexv)[act] - 1)) = actdist;
-                    reached++;
-                    if (reached == no_of_to) {
-                        igraph_dqueue_clear(&q);
-                        break;
-                    }
-                }
-            }
+        IGRAPH_CHECK(igraph_vector_int_init(&dist, no_of_nodes));
+        IGRAPH_FINALLY(igraph_vector_int_destroy, &dist);
+        igraph_vector_int_fill(&dist, -1);
+        IGRAPH_VECTOR_INIT_FINALLY(&order, 0);
 
-            neis = igraph_adjlist_get(&adjlist, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_counted[neighbor] == i + 1) {
-                    continue;
+        for (IGRAPH_VIT_RESET(fromvit), i = 0;
+             !IGRAPH_VIT_END(fromvit);
+             IGRAPH_VIT_NEXT(fromvit), i++) {
+            long int n;
+            IGRAPH_CHECK(igraph_i_bfs_distances(graph, IGRAPH_VIT_GET(fromvit),
+                                                mode, &dist, &order,
+                                                all_to ? 0 : &indexv, no_of_to,
+                                                /*top_down=*/ 0, /*edge_checks=*/ 0));
+            n = igraph_vector_size(&order);
+            for (j = 0; j < n; j++) {
+                long int v = (long int) VECTOR(order)[j];
+                if (all_to) {
+                    MATRIX(*res, i, v) = VECTOR(dist)[v];
+                } else if (VECTOR(indexv)[v]) {
+                    MATRIX(*res, i, (long int)(VECTOR(indexv)[v] - 1)) =
+                        VECTOR(dist)[v];
                 }
-                already_counted[neighbor] = i + 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+                VECTOR(dist)[v] = -1;
             }
         }
+
+        igraph_vector_destroy(&order);
+        igraph_vector_int_destroy(&dist);
+        IGRAPH_FINALLY_CLEAN(2);
+    } else {
+        /* Many sources, search from them in batches */
+        igraph_adjlist_t adjlist;
+        igraph_i_msbfs_t msbfs;
+        igraph_i_shortest_paths_t data;
+
+        IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &adjlist, mode));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, &adjlist, no_of_from));
+        IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
+
+        data.msbfs = &msbfs;
+        data.res = res;
+        data.indexv = all_to ? 0 : &indexv;
+        data.no_of_from = no_of_from;
+        data.no_of_to = no_of_to;
+        data.first = -1;
+        data.reached = 0;
+        IGRAPH_CHECK(igraph_i_msbfs_run(&msbfs, &fromvit,
+                                        igraph_i_shortest_paths_visit, &data,
+                                        /*progress=*/ 0));
+
+        igraph_i_msbfs_destroy(&msbfs);
+        igraph_adjlist_destroy(&adjlist);
+        IGRAPH_FINALLY_CLEAN(2);
     }
 
     /* Clean */
@@ -579,11 +1115,8 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
         IGRAPH_FINALLY_CLEAN(2);
     }
 
-    igraph_Free(already_counted);
-    igraph_dqueue_destroy(&q);
     igraph_vit_destroy(&fromvit);
-    igraph_adjlist_destroy(&adjlist);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
 }
@@ -684,7 +1217,8 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
 
     long int i, j;
-    igraph_vector_t tmp = IGRAPH_VECTOR_NULL;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
 
     igraph_vit_t vit;
 
@@ -714,7 +1248,6 @@ int igraph_get_shortest_paths(const igraph_t *graph,
         IGRAPH_ERROR("cannot get shortest paths", IGRAPH_ENOMEM);
     }
     IGRAPH_FINALLY(igraph_free, father);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
     /* Mark the vertices we need to reach */
@@ -750,17 +1283,23 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     while (!igraph_dqueue_empty(&q) && reached < to_reach) {
         long int act = (long int) igraph_dqueue_pop(&q) - 1;
 
-        IGRAPH_CHECK(igraph_incident(graph, &tmp, (igraph_integer_t) act, mode));
-        for (j = 0; j < igraph_vector_size(&tmp); j++) {
-            long int edge = (long int) VECTOR(tmp)[j];
-            long int neighbor = IGRAPH_OTHER(graph, edge, act);
-            if (father[neighbor] > 0) {
-                continue;
-            } else if (father[neighbor] < 0) {
-                reached++;
+        IGRAPH_CHECK(igraph_i_incident_views(graph, act, mode, views, &no_of_views));
+        for (k = 0; k < no_of_views; k++) {
+            for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                long int edge, neighbor;
+                if (IGRAPH_VIEW_DELETED(views[k], j)) {
+                    continue;
+                }
+                edge = IGRAPH_VIEW_EDGE(views[k], j);
+                neighbor = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                if (father[neighbor] > 0) {
+                    continue;
+                } else if (father[neighbor] < 0) {
+                    reached++;
+                }
+                father[neighbor] = edge + 2;
+                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor + 1));
             }
-            father[neighbor] = edge + 2;
-            IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor + 1));
         }
     }
 
@@ -854,9 +1393,61 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     /* Clean */
     igraph_Free(father);
     igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&tmp);
     igraph_vit_destroy(&vit);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/* Writes the path found by a bidirectional search to 'vertices' and
+   'edges' (each may be a null pointer): from 'from' to 'meet' along
+   the forward parent edges, then from 'meet' to 'to' along the backward
+   parent edges. The parent of a vertex is the id of the edge through
+   which it was reached plus two, one for the start of the search. */
+
+static int igraph_i_bidirectional_path(const igraph_t *graph,
+                                       const long int *fparent,
+                                       const long int *bparent,
+                                       long int meet,
+                                       igraph_vector_t *vertices,
+                                       igraph_vector_t *edges) {
+    long int flen = 0, blen = 0, act, edge, i;
+
+    for (act = meet; fparent[act] > 1; flen++) {
+        act = IGRAPH_OTHER(graph, fparent[act] - 2, act);
+    }
+    for (act = meet; bparent[act] > 1; blen++) {
+        act = IGRAPH_OTHER(graph, bparent[act] - 2, act);
+    }
+
+    if (vertices) {
+        IGRAPH_CHECK(igraph_vector_resize(vertices, flen + blen + 1));
+        VECTOR(*vertices)[flen] = meet;
+    }
+    if (edges) {
+        IGRAPH_CHECK(igraph_vector_resize(edges, flen + blen));
+    }
+    for (act = meet, i = flen; fparent[act] > 1; ) {
+        edge = fparent[act] - 2;
+        act = IGRAPH_OTHER(graph, edge, act);
+        i--;
+        if (vertices) {
+            VECTOR(*vertices)[i] = act;
+        }
+        if (edges) {
+            VECTOR(*edges)[i] = edge;
+        }
+    }
+    for (act = meet, i = flen; bparent[act] > 1; i++) {
+        edge = bparent[act] - 2;
+        act = IGRAPH_OTHER(graph, edge, act);
+        if (vertices) {
+            VECTOR(*vertices)[i + 1] = act;
+        }
+        if (edges) {
+            VECTOR(*edges)[i] = edge;
+        }
+    }
 
     return 0;
 }
@@ -869,9 +1460,12 @@ int igraph_get_shortest_paths(const igraph_t *graph,
  * given vertex to another one. If there are more than one shortest
  * paths between the two vertices, then an arbitrary one is returned.
  *
- * </para><para>This function is a wrapper to \ref
- * igraph_get_shortest_paths(), for the special case when only one
- * target vertex is considered.
+ * </para><para>
+ * The search is bidirectional: it proceeds level by level from both
+ * vertices, always on the side with the smaller frontier, and stops
+ * as soon as the two searches meet, so it usually visits only a small
+ * part of a large graph.
+ *
  * \param graph The input graph, it can be directed or
  *        undirected. Directed paths are considered in directed
  *        graphs.
@@ -879,7 +1473,7 @@ int igraph_get_shortest_paths(const igraph_t *graph,
  *        pointer. If not a null pointer, then the vertex ids along
  *        the path are stored here, including the source and target
  *        vertices.
- * \param edges Pointer to an uninitialized vector or a null
+ * \param edges Pointer to an initialized vector or a null
  *        pointer. If not a null pointer, then the edge ids along the
  *        path are stored here.
  * \param from The id of the source vertex.
@@ -893,7 +1487,7 @@ int igraph_get_shortest_paths(const igraph_t *graph,
  * \return Error code.
  *
  * Time complexity: O(|V|+|E|), linear in the number of vertices and
- * edges in the graph.
+ * edges in the graph, in the worst case.
  *
  * \sa \ref igraph_get_shortest_paths() for the version with more target
  * vertices.
@@ -906,36 +1500,100 @@ int igraph_get_shortest_path(const igraph_t *graph,
                              igraph_integer_t to,
                              igraph_neimode_t mode) {
 
-    igraph_vector_ptr_t vertices2, *vp = &vertices2;
-    igraph_vector_ptr_t edges2, *ep = &edges2;
+    long int no_of_nodes = igraph_vcount(graph);
+    long int *parent[2];
+    igraph_vector_long_t queue[2];
+    long int begin[2] = { 0, 0 };
+    igraph_neimode_t modes[2];
+    igraph_incident_view_t views[2];
+    int side, k, no_of_views;
+    long int meet = -1, i, j, end;
 
-    if (vertices) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&vertices2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &vertices2);
-        VECTOR(vertices2)[0] = vertices;
-    } else {
-        vp = 0;
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+        IGRAPH_ERROR("cannot get shortest path", IGRAPH_EINVVID);
     }
-    if (edges) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&edges2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &edges2);
-        VECTOR(edges2)[0] = edges;
-    } else {
-        ep = 0;
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
     }
+    modes[0] = mode;
+    modes[1] = mode == IGRAPH_OUT ? IGRAPH_IN :
+               mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
 
-    IGRAPH_CHECK(igraph_get_shortest_paths(graph, vp, ep, from,
-                                           igraph_vss_1(to), mode, 0, 0));
+    for (side = 0; side < 2; side++) {
+        parent[side] = igraph_Calloc(no_of_nodes, long int);
+        if (parent[side] == 0) {
+            IGRAPH_ERROR("cannot get shortest path", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, parent[side]);
+        IGRAPH_CHECK(igraph_vector_long_init(&queue[side], 0));
+        IGRAPH_FINALLY(igraph_vector_long_destroy, &queue[side]);
+    }
 
-    if (edges) {
-        igraph_vector_ptr_destroy(&edges2);
-        IGRAPH_FINALLY_CLEAN(1);
+    parent[0][(long int) from] = 1;
+    IGRAPH_CHECK(igraph_vector_long_push_back(&queue[0], from));
+    parent[1][(long int) to] = 1;
+    IGRAPH_CHECK(igraph_vector_long_push_back(&queue[1], to));
+    if (from == to) {
+        meet = from;
     }
-    if (vertices) {
-        igraph_vector_ptr_destroy(&vertices2);
-        IGRAPH_FINALLY_CLEAN(1);
+
+    /* Both searches complete whole levels, so the first vertex reached
+       by both of them is on a shortest path: a shorter path would have
+       had a vertex in both searches before */
+    while (meet < 0) {
+        long int size0 = igraph_vector_long_size(&queue[0]) - begin[0];
+        long int size1 = igraph_vector_long_size(&queue[1]) - begin[1];
+        if (size0 == 0 || size1 == 0) {
+            /* one of the searches is complete */
+            break;
+        }
+        side = size0 <= size1 ? 0 : 1;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        end = igraph_vector_long_size(&queue[side]);
+        for (i = begin[side]; i < end && meet < 0; i++) {
+            long int act = VECTOR(queue[side])[i];
+            IGRAPH_CHECK(igraph_i_incident_views(graph, act, modes[side], views,
+                                                 &no_of_views));
+            for (k = 0; k < no_of_views && meet < 0; k++) {
+                for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                    long int neighbor = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                    if (parent[side][neighbor] || IGRAPH_VIEW_DELETED(views[k], j)) {
+                        continue;
+                    }
+                    parent[side][neighbor] = IGRAPH_VIEW_EDGE(views[k], j) + 2;
+                    if (parent[1 - side][neighbor]) {
+                        meet = neighbor;
+                        break;
+                    }
+                    IGRAPH_CHECK(igraph_vector_long_push_back(&queue[side], neighbor));
+                }
+            }
+        }
+        begin[side] = end;
     }
 
+    if (meet >= 0) {
+        IGRAPH_CHECK(igraph_i_bidirectional_path(graph, parent[0], parent[1],
+                     meet, vertices, edges));
+    } else {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        if (vertices) {
+            igraph_vector_clear(vertices);
+        }
+        if (edges) {
+            igraph_vector_clear(edges);
+        }
+    }
+
+    for (side = 1; side >= 0; side--) {
+        igraph_vector_long_destroy(&queue[side]);
+        igraph_Free(parent[side]);
+    }
+    IGRAPH_FINALLY_CLEAN(4);
+
     return 0;
 }
 
@@ -1232,7 +1890,8 @@ int igraph_get_all_shortest_paths(const igraph_t *graph,
  *
  * \param graph The graph object.
  * \param res The result, vector with the ids of the vertices in the
- *        same component.
+ *        same component, in increasing order of their distance from
+ *        \p vertex.
  * \param vertex The id of the vertex of which the component is
  *        searched.
  * \param mode Type of the component for directed graphs, possible
@@ -1272,10 +1931,7 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
                         igraph_neimode_t mode) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    char *already_added;
-    long int i;
-    igraph_vector_t tmp = IGRAPH_VECTOR_NULL;
+    igraph_vector_int_t dist;
 
     if (!IGRAPH_FINITE(vertex) || vertex < 0 || vertex >= no_of_nodes) {
         IGRAPH_ERROR("subcomponent failed", IGRAPH_EINVVID);
@@ -1285,44 +1941,16 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
         IGRAPH_ERROR("invalid mode argument", IGRAPH_EINVMODE);
     }
 
-    already_added = igraph_Calloc(no_of_nodes, char);
-    if (already_added == 0) {
-        IGRAPH_ERROR("subcomponent failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-
-    igraph_vector_clear(res);
-
-    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
-    IGRAPH_CHECK(igraph_dqueue_push(&q, vertex));
-    IGRAPH_CHECK(igraph_vector_push_back(res, vertex));
-    already_added[(long int)vertex] = 1;
-
-    while (!igraph_dqueue_empty(&q)) {
-        long int actnode = (long int) igraph_dqueue_pop(&q);
-
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        IGRAPH_CHECK(igraph_neighbors(graph, &tmp, (igraph_integer_t) actnode,
-                                      mode));
-        for (i = 0; i < igraph_vector_size(&tmp); i++) {
-            long int neighbor = (long int) VECTOR(tmp)[i];
+    IGRAPH_CHECK(igraph_vector_int_init(&dist, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &dist);
+    igraph_vector_int_fill(&dist, -1);
 
-            if (already_added[neighbor]) {
-                continue;
-            }
-            already_added[neighbor] = 1;
-            IGRAPH_CHECK(igraph_vector_push_back(res, neighbor));
-            IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-        }
-    }
+    IGRAPH_CHECK(igraph_i_bfs_distances(graph, (long int) vertex, mode, &dist,
+                                        res, /*targets=*/ 0, 0,
+                                        /*top_down=*/ 0, /*edge_checks=*/ 0));
 
-    igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&tmp);
-    igraph_Free(already_added);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_vector_int_destroy(&dist);
+    IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
 }
@@ -1459,7 +2087,7 @@ int igraph_pagerank_old(const igraph_t *graph, igraph_vector_t *res,
     } else {
         dirmode = IGRAPH_ALL;
     }
-    igraph_adjlist_init(graph, &allneis, dirmode);
+    igraph_i_adjlist_init_flat(graph, &allneis, dirmode);
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
     /* Calculate outdegrees for every node */
@@ -1553,6 +2181,122 @@ int igraph_pagerank_old(const igraph_t *graph, igraph_vector_t *res,
     return 0;
 }
 
+/* Vertices with at least this many neighbors in the adjacency list
+   of the rewiring keep them in a hash set instead of a sorted vector,
+   unless the graph has an adjacency index with a different threshold. */
+#define REWIRE_HASH_THRESHOLD 256
+
+/* The adjacency list of igraph_rewire_core(), with hash sets for the
+   high degree vertices. 'hub' is the index of the set of a vertex in
+   'sets', or -1 if its neighbors are in the sorted vector of 'al'. */
+
+typedef struct igraph_i_rewire_adj_t {
+    igraph_adjlist_t al;
+    igraph_vector_long_t hub;
+    igraph_i_adjset_t *sets;
+    long int no_of_sets;
+} igraph_i_rewire_adj_t;
+
+static void igraph_i_rewire_adj_destroy(igraph_i_rewire_adj_t *adj) {
+    long int i;
+    for (i = 0; i < adj->no_of_sets; i++) {
+        igraph_i_adjset_destroy(&adj->sets[i]);
+    }
+    igraph_free(adj->sets);
+    igraph_vector_long_destroy(&adj->hub);
+    igraph_adjlist_destroy(&adj->al);
+}
+
+static int igraph_i_rewire_adj_init(const igraph_t *graph,
+                                    igraph_i_rewire_adj_t *adj,
+                                    long int threshold) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int i, j, no_of_hubs = 0;
+
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &adj->al, IGRAPH_OUT));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &adj->al);
+    IGRAPH_CHECK(igraph_vector_long_init(&adj->hub, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &adj->hub);
+    for (i = 0; i < no_of_nodes; i++) {
+        if (igraph_vector_int_size(igraph_adjlist_get(&adj->al, i)) >= threshold) {
+            VECTOR(adj->hub)[i] = no_of_hubs++;
+        } else {
+            VECTOR(adj->hub)[i] = -1;
+        }
+    }
+    adj->sets = igraph_Calloc(no_of_hubs > 0 ? no_of_hubs : 1, igraph_i_adjset_t);
+    if (adj->sets == 0) {
+        IGRAPH_ERROR("Cannot rewire graph", IGRAPH_ENOMEM);
+    }
+    adj->no_of_sets = 0;
+    IGRAPH_FINALLY_CLEAN(2);
+    IGRAPH_FINALLY(igraph_i_rewire_adj_destroy, adj);
+
+    for (i = 0; i < no_of_nodes; i++) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&adj->al, i);
+        long int n = igraph_vector_int_size(neis);
+        igraph_i_adjset_t *set;
+        if (VECTOR(adj->hub)[i] < 0) {
+            continue;
+        }
+        set = &adj->sets[adj->no_of_sets];
+        IGRAPH_CHECK(igraph_i_adjset_init(set, n));
+        adj->no_of_sets++;
+        for (j = 0; j < n; j++) {
+            IGRAPH_CHECK(igraph_i_adjset_add(set, VECTOR(*neis)[j]));
+        }
+        igraph_vector_int_clear(neis);
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static igraph_bool_t igraph_i_rewire_adj_has_edge(igraph_i_rewire_adj_t *adj,
+        igraph_integer_t from, igraph_integer_t to, igraph_bool_t directed) {
+    if (!directed && from < to) {
+        igraph_integer_t temp = from;
+        from = to;
+        to = temp;
+    }
+    if (VECTOR(adj->hub)[from] >= 0) {
+        return igraph_i_adjset_has(&adj->sets[ VECTOR(adj->hub)[from] ], to);
+    }
+    return igraph_adjlist_has_edge(&adj->al, from, to, directed);
+}
+
+static int igraph_i_rewire_adj_replace_edge(igraph_i_rewire_adj_t *adj,
+        igraph_integer_t from, igraph_integer_t oldto, igraph_integer_t newto,
+        igraph_bool_t directed) {
+    igraph_integer_t oldfrom = from, newfrom = from, temp;
+    long int pos;
+
+    if (!directed && oldfrom < oldto) {
+        temp = oldto; oldto = oldfrom; oldfrom = temp;
+    }
+    if (!directed && newfrom < newto) {
+        temp = newto; newto = newfrom; newfrom = temp;
+    }
+
+    if (VECTOR(adj->hub)[oldfrom] >= 0) {
+        igraph_i_adjset_remove(&adj->sets[ VECTOR(adj->hub)[oldfrom] ], oldto);
+    } else {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&adj->al, oldfrom);
+        if (igraph_vector_int_binsearch(neis, oldto, &pos)) {
+            igraph_vector_int_remove(neis, pos);
+        }
+    }
+    if (VECTOR(adj->hub)[newfrom] >= 0) {
+        IGRAPH_CHECK(igraph_i_adjset_add(&adj->sets[ VECTOR(adj->hub)[newfrom] ], newto));
+    } else {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&adj->al, newfrom);
+        igraph_vector_int_binsearch(neis, newto, &pos);
+        IGRAPH_CHECK(igraph_vector_int_insert(neis, pos, newto));
+    }
+
+    return 0;
+}
+
 /* Not declared static so that the testsuite can use it, but not part of the public API. */
 int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mode, igraph_bool_t use_adjlist) {
     long int no_of_nodes = igraph_vcount(graph);
@@ -1562,7 +2306,8 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
     igraph_vector_t eids, edgevec, alledges;
     igraph_bool_t directed, loops, ok;
     igraph_es_t es;
-    igraph_adjlist_t al;
+    igraph_i_rewire_adj_t adj;
+    igraph_integer_t min_degree = graph->adjindex ? graph->adjindex->min_degree : 0;
 
     if (no_of_nodes < 4) {
         IGRAPH_ERROR("graph unsuitable for rewiring", IGRAPH_EINVAL);
@@ -1579,8 +2324,9 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
         /* As well as the sorted adjacency list, we maintain an unordered
          * list of edges for picking a random edge in constant time.
          */
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &al, IGRAPH_OUT));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
+        IGRAPH_CHECK(igraph_i_rewire_adj_init(graph, &adj, min_degree > 0 ?
+                                              min_degree : REWIRE_HASH_THRESHOLD));
+        IGRAPH_FINALLY(igraph_i_rewire_adj_destroy, &adj);
         IGRAPH_VECTOR_INIT_FINALLY(&alledges, no_of_edges * 2);
         igraph_get_edgelist(graph, &alledges, /*bycol=*/ 0);
     } else {
@@ -1667,7 +2413,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
              * disallow the creation of multiple edges */
             if (ok) {
                 if (use_adjlist) {
-                    if (igraph_adjlist_has_edge(&al, a, d, directed)) {
+                    if (igraph_i_rewire_adj_has_edge(&adj, a, d, directed)) {
                         ok = 0;
                     }
                 } else {
@@ -1677,7 +2423,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
             }
             if (ok) {
                 if (use_adjlist) {
-                    if (igraph_adjlist_has_edge(&al, c, b, directed)) {
+                    if (igraph_i_rewire_adj_has_edge(&adj, c, b, directed)) {
                         ok = 0;
                     }
                 } else {
@@ -1692,8 +2438,8 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
                               (long)a, (long)b, (long)c, (long)d); */
                 if (use_adjlist) {
                     // Replace entry in sorted adjlist:
-                    IGRAPH_CHECK(igraph_adjlist_replace_edge(&al, a, b, d, directed));
-                    IGRAPH_CHECK(igraph_adjlist_replace_edge(&al, c, d, b, directed));
+                    IGRAPH_CHECK(igraph_i_rewire_adj_replace_edge(&adj, a, b, d, directed));
+                    IGRAPH_CHECK(igraph_i_rewire_adj_replace_edge(&adj, c, d, b, directed));
                     // Also replace in unsorted edgelist:
                     VECTOR(alledges)[(((igraph_integer_t)VECTOR(eids)[0]) * 2) + 1] = d;
                     VECTOR(alledges)[(((igraph_integer_t)VECTOR(eids)[1]) * 2) + 1] = b;
@@ -1725,7 +2471,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
 
     if (use_adjlist) {
         igraph_vector_destroy(&alledges);
-        igraph_adjlist_destroy(&al);
+        igraph_i_rewire_adj_destroy(&adj);
     } else {
         igraph_vector_destroy(&edgevec);
     }
@@ -1735,6 +2481,11 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
 
     RNG_END();
 
+    /* Modifying the graph dropped its adjacency index */
+    if (min_degree > 0) {
+        IGRAPH_CHECK(igraph_adjacency_index_build(graph, min_degree));
+    }
+
     return 0;
 }
 
@@ -1750,6 +2501,12 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
  * be allocated. If you would like to keep the original graph intact, use
  * \ref igraph_copy() beforehand.
  *
+ * </para><para>
+ * The existence of the new edges is checked in hash sets for the high
+ * degree vertices. If the graph has an adjacency index, see \ref
+ * igraph_adjacency_index_build(), then its minimum degree selects
+ * these vertices, and the index is rebuilt for the rewired graph.
+ *
  * \param graph The graph object to be rewired.
  * \param n Number of rewiring trials to perform.
  * \param mode The rewiring algorithm to be used. It can be one of the following flags:
@@ -2974,7 +3731,8 @@ int igraph_density(const igraph_t *graph, igraph_real_t *res,
  *
  * \sa \ref igraph_neighborhood() for calculating the actual neighborhood,
  * \ref igraph_neighborhood_graphs() for creating separate graphs from
- * the neighborhoods.
+ * the neighborhoods, \ref igraph_hyperanf() for estimating the sizes
+ * of all neighborhoods in a few passes over the graph.
  *
  * Time complexity: O(n*d*o), where n is the number vertices for which
  * the calculation is performed, d is the average degree, o is the order.
@@ -2990,7 +3748,8 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
     igraph_vit_t vit;
     long int i, j;
     long int *added;
-    igraph_vector_t neis;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
 
     if (order < 0) {
         IGRAPH_ERROR("Negative order in neighborhood size", IGRAPH_EINVAL);
@@ -3009,7 +3768,6 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
 
     for (i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
@@ -3025,29 +3783,19 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_i_incident_views(graph, actnode, mode, views,
+                                                 &no_of_views));
 
-            if (actdist < order - 1) {
-                /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
+            for (k = 0; k < no_of_views; k++) {
+                for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                    long int nei = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                    if (added[nei] != i + 1 && !IGRAPH_VIEW_DELETED(views[k], j)) {
                         added[nei] = i + 1;
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-                        if (actdist + 1 >= mindist) {
-                            size++;
+                        if (actdist < order - 1) {
+                            /* we add them to the q */
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
                         }
-                    }
-                }
-            } else {
-                /* we just count them, but don't add them */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
-                        added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
                             size++;
                         }
@@ -3060,11 +3808,10 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
         VECTOR(*res)[i] = size;
     } /* for VIT, i */
 
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(3);
 
     return 0;
 }
@@ -3118,7 +3865,8 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     igraph_vit_t vit;
     long int i, j;
     long int *added;
-    igraph_vector_t neis;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
     igraph_vector_t tmp;
     igraph_vector_t *newv;
 
@@ -3139,7 +3887,6 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_CHECK(igraph_vector_ptr_resize(res, IGRAPH_VIT_SIZE(vit)));
 
@@ -3158,29 +3905,19 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_i_incident_views(graph, actnode, mode, views,
+                                                 &no_of_views));
 
-            if (actdist < order - 1) {
-                /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
+            for (k = 0; k < no_of_views; k++) {
+                for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                    long int nei = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                    if (added[nei] != i + 1 && !IGRAPH_VIEW_DELETED(views[k], j)) {
                         added[nei] = i + 1;
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-                        if (actdist + 1 >= mindist) {
-                            IGRAPH_CHECK(igraph_vector_push_back(&tmp, nei));
+                        if (actdist < order - 1) {
+                            /* we add them to the q */
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
                         }
-                    }
-                }
-            } else {
-                /* we just count them but don't add them to q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
-                        added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
                             IGRAPH_CHECK(igraph_vector_push_back(&tmp, nei));
                         }
@@ -3201,11 +3938,10 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     }
 
     igraph_vector_destroy(&tmp);
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return 0;
 }
@@ -3263,7 +3999,8 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     igraph_vit_t vit;
     long int i, j;
     long int *added;
-    igraph_vector_t neis;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
     igraph_vector_t tmp;
     igraph_t *newg;
 
@@ -3284,7 +4021,6 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_CHECK(igraph_vector_ptr_resize(res, IGRAPH_VIT_SIZE(vit)));
 
@@ -3303,29 +4039,19 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_i_incident_views(graph, actnode, mode, views,
+                                                 &no_of_views));
 
-            if (actdist < order - 1) {
-                /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
+            for (k = 0; k < no_of_views; k++) {
+                for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                    long int nei = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                    if (added[nei] != i + 1 && !IGRAPH_VIEW_DELETED(views[k], j)) {
                         added[nei] = i + 1;
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-                        if (actdist + 1 >= mindist) {
-                            IGRAPH_CHECK(igraph_vector_push_back(&tmp, nei));
+                        if (actdist < order - 1) {
+                            /* we add them to the q */
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
+                            IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
                         }
-                    }
-                }
-            } else {
-                /* we just count them but don't add them to q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
-                        added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
                             IGRAPH_CHECK(igraph_vector_push_back(&tmp, nei));
                         }
@@ -3352,11 +4078,10 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     }
 
     igraph_vector_destroy(&tmp);
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return 0;
 }
@@ -3396,10 +4121,11 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
 int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
                                igraph_neimode_t mode) {
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t degrees, neis;
+    igraph_vector_t degrees;
     igraph_dqueue_t sources;
     igraph_neimode_t deg_mode;
-    long int node, i, j;
+    igraph_incident_view_t view;
+    long int node, i;
 
     if (mode == IGRAPH_ALL || !igraph_is_directed(graph)) {
         IGRAPH_ERROR("topological sorting does not make sense for undirected graphs", IGRAPH_EINVAL);
@@ -3412,7 +4138,6 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
     }
 
     IGRAPH_VECTOR_INIT_FINALLY(&degrees, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_dqueue_init(&sources, 0));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &sources);
     IGRAPH_CHECK(igraph_degree(graph, &degrees, igraph_vss_all(), deg_mode, 0));
@@ -3434,12 +4159,15 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
         /* Exclude the node from further source searches */
         VECTOR(degrees)[node] = -1;
         /* Get the neighbors and decrease their degrees by one */
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) node, mode));
-        j = igraph_vector_size(&neis);
-        for (i = 0; i < j; i++) {
-            VECTOR(degrees)[(long)VECTOR(neis)[i]]--;
-            if (VECTOR(degrees)[(long)VECTOR(neis)[i]] == 0) {
-                IGRAPH_CHECK(igraph_dqueue_push(&sources, VECTOR(neis)[i]));
+        IGRAPH_CHECK(igraph_incident_view(graph, &view, (igraph_integer_t) node, mode));
+        for (i = 0; i < IGRAPH_VIEW_SIZE(view); i++) {
+            long int nei = IGRAPH_VIEW_NEIGHBOR(view, i);
+            if (IGRAPH_VIEW_DELETED(view, i)) {
+                continue;
+            }
+            VECTOR(degrees)[nei]--;
+            if (VECTOR(degrees)[nei] == 0) {
+                IGRAPH_CHECK(igraph_dqueue_push(&sources, nei));
             }
         }
     }
@@ -3449,9 +4177,8 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
     }
 
     igraph_vector_destroy(&degrees);
-    igraph_vector_destroy(&neis);
     igraph_dqueue_destroy(&sources);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -3476,9 +4203,10 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
  */
 int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t degrees, neis;
+    igraph_vector_t degrees;
     igraph_dqueue_t sources;
-    long int node, i, j, nei, vertices_left;
+    igraph_incident_view_t view;
+    long int node, i, nei, vertices_left;
 
     if (!igraph_is_directed(graph)) {
         *res = 0;
@@ -3486,7 +4214,6 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     }
 
     IGRAPH_VECTOR_INIT_FINALLY(&degrees, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_dqueue_init(&sources, 0));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &sources);
     IGRAPH_CHECK(igraph_degree(graph, &degrees, igraph_vss_all(), IGRAPH_OUT, 1));
@@ -3507,12 +4234,11 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
         VECTOR(degrees)[node] = -1;
         vertices_left--;
         /* Get the neighbors and decrease their degrees by one */
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) node,
-                                      IGRAPH_IN));
-        j = igraph_vector_size(&neis);
-        for (i = 0; i < j; i++) {
-            nei = (long)VECTOR(neis)[i];
-            if (nei == node) {
+        IGRAPH_CHECK(igraph_incident_view(graph, &view, (igraph_integer_t) node,
+                                          IGRAPH_IN));
+        for (i = 0; i < IGRAPH_VIEW_SIZE(view); i++) {
+            nei = IGRAPH_VIEW_NEIGHBOR(view, i);
+            if (nei == node || IGRAPH_VIEW_DELETED(view, i)) {
                 continue;
             }
             VECTOR(degrees)[nei]--;
@@ -3528,9 +4254,8 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     }
 
     igraph_vector_destroy(&degrees);
-    igraph_vector_destroy(&neis);
     igraph_dqueue_destroy(&sources);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -4247,7 +4972,7 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
     for (k = 0; k < (directed ? 2 : 1); k++) {
         igraph_neimode_t neimode = (k == 0) ? IGRAPH_OUT : IGRAPH_IN;
         igraph_real_t *vec;
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, neimode));
+        IGRAPH_CHECK(igraph_i_inclist_init_flat(graph, &inclist, neimode));
         IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
         vec = (k == 0) ? VECTOR(*ins_p) : VECTOR(*outs_p);
         for (i = 0; i < no_of_nodes; i++) {
@@ -4364,8 +5089,19 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
  *    for undirected graphs.
  * \return Error code.
  *
+ * </para><para>
+ * If more than one thread is allowed, see \ref igraph_set_num_threads(),
+ * and the graph has many edges, then the search from each source uses
+ * these threads: it is the delta-stepping algorithm of Meyer and
+ * Sanders, which settles vertices in buckets of similar distance
+ * instead of one by one. The width of the buckets is chosen from the
+ * mean edge weight and the mean degree.
+ *
  * Time complexity: O(s*|E|log|E|+|V|), where |V| is the number of
- * vertices, |E| the number of edges and s the number of sources.
+ * vertices, |E| the number of edges and s the number of sources. If
+ * all weights are integers not larger than 1024, then the vertices
+ * are kept in buckets by their distance instead of a heap, and it is
+ * O(s*(|E|+|V|+D)), where D is the largest distance.
  *
  * \sa \ref igraph_shortest_paths() for a (slightly) faster unweighted
  * version or \ref igraph_shortest_paths_bellman_ford() for a weighted
@@ -4389,6 +5125,10 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
        From now on we use a 2-way heap, so the distances can be queried
        directly from the heap.
 
+       If all weights are small integers, the heap is replaced by
+       buckets of equal distance (Dial's algorithm), with the same
+       interface, see igraph_dial_internal.h.
+
        Dirty tricks:
        - the opposite of the distance is stored in the heap, as it is a
          maximum heap and we need a minimum heap.
@@ -4399,14 +5139,16 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_2wheap_t Q;
+    igraph_i_dial_t Q;
     igraph_vit_t fromvit, tovit;
     long int no_of_from, no_of_to;
-    igraph_lazy_inclist_t inclist;
+    igraph_weighted_adjlist_t wal;
     long int i, j;
     igraph_real_t my_infinity = IGRAPH_INFINITY;
     igraph_bool_t all_to;
     igraph_vector_t indexv;
+    igraph_i_delta_stepping_t ds;
+    int no_of_threads;
 
     if (!weights) {
         return igraph_shortest_paths(graph, res, from, to, mode);
@@ -4423,10 +5165,16 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+    IGRAPH_CHECK(igraph_i_dial_init(&Q, no_of_nodes, &wal));
+    IGRAPH_FINALLY(igraph_i_dial_destroy, &Q);
+
+    no_of_threads = igraph_i_delta_stepping_threads(graph);
+    if (no_of_threads > 1) {
+        IGRAPH_CHECK(igraph_i_delta_stepping_init(&ds, &wal, no_of_threads));
+        IGRAPH_FINALLY(igraph_i_delta_stepping_destroy, &ds);
+    }
 
     if ( (all_to = igraph_vs_is_all(&to)) ) {
         no_of_to = no_of_nodes;
@@ -4454,13 +5202,26 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 
         long int reached = 0;
         long int source = IGRAPH_VIT_GET(fromvit);
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
-            igraph_vector_t *neis;
+        if (no_of_threads > 1) {
+            IGRAPH_CHECK(igraph_i_delta_stepping_run(&ds, source));
+            for (j = 0; j < no_of_nodes; j++) {
+                if (all_to) {
+                    MATRIX(*res, i, j) = ds.dist[j];
+                } else if (VECTOR(indexv)[j]) {
+                    MATRIX(*res, i, (long int)(VECTOR(indexv)[j] - 1)) = ds.dist[j];
+                }
+            }
+            continue;
+        }
+
+        igraph_i_dial_clear(&Q);
+        igraph_i_dial_push_with_index(&Q, source, -1.0);
+
+        while (!igraph_i_dial_empty(&Q)) {
+            long int minnei = igraph_i_dial_max_index(&Q);
+            igraph_real_t mindist = -igraph_i_dial_deactivate_max(&Q);
+            igraph_weighted_adjlist_entry_t *neis;
             long int nlen;
 
             if (all_to) {
@@ -4470,32 +5231,31 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
                     MATRIX(*res, i, (long int)(VECTOR(indexv)[minnei] - 1)) = mindist - 1.0;
                     reached++;
                     if (reached == no_of_to) {
-                        igraph_2wheap_clear(&Q);
+                        igraph_i_dial_clear(&Q);
                         break;
                     }
                 }
             }
 
             /* Now check all neighbors of 'minnei' for a shorter path */
-            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
-            nlen = igraph_vector_size(neis);
+            neis = igraph_weighted_adjlist_get(&wal, minnei);
+            nlen = igraph_weighted_adjlist_size(&wal, minnei);
             for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int tto = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+                long int tto = neis[j].nei;
+                igraph_real_t altdist = mindist + neis[j].weight;
+                igraph_bool_t active = igraph_i_dial_has_active(&Q, tto);
+                igraph_bool_t has = igraph_i_dial_has_elem(&Q, tto);
+                igraph_real_t curdist = active ? -igraph_i_dial_get(&Q, tto) : 0.0;
                 if (!has) {
                     /* This is the first non-infinite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dial_push_with_index(&Q, tto, -altdist));
                 } else if (altdist < curdist) {
                     /* This is a shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dial_modify(&Q, tto, -altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_dial_empty(&Q) */
 
     } /* !IGRAPH_VIT_END(fromvit) */
 
@@ -4505,8 +5265,12 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
         IGRAPH_FINALLY_CLEAN(2);
     }
 
-    igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    if (no_of_threads > 1) {
+        igraph_i_delta_stepping_destroy(&ds);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_i_dial_destroy(&Q);
+    igraph_weighted_adjlist_destroy(&wal);
     igraph_vit_destroy(&fromvit);
     IGRAPH_FINALLY_CLEAN(3);
 
@@ -4586,6 +5350,15 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
  *           invalid mode argument.
  *        \endclist
  *
+ * </para><para>
+ * If more than one thread is allowed, see \ref igraph_set_num_threads(),
+ * and the graph has many edges, then the search uses these threads,
+ * with the delta-stepping algorithm, like \ref
+ * igraph_shortest_paths_dijkstra(). It does not stop when the vertices
+ * in \p to are reached, so \p predecessors and \p inbound_edges
+ * describe the whole shortest path tree. Among several shortest paths
+ * to a vertex, it chooses one with the fewest edges.
+ *
  * Time complexity: O(|E|log|E|+|V|), where |V| is the number of
  * vertices and |E| is the number of edges
  *
@@ -4626,12 +5399,10 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
     igraph_vit_t vit;
-    igraph_2wheap_t Q;
-    igraph_lazy_inclist_t inclist;
-    igraph_vector_t dists;
     long int *parents;
     igraph_bool_t *is_target;
     long int i, to_reach;
+    int no_of_threads;
 
     if (!weights) {
         return igraph_get_shortest_paths(graph, vertices, edges, from, to, mode,
@@ -4655,14 +5426,6 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         IGRAPH_ERROR("Size of `edges' and `to' should match", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
-
-    IGRAPH_VECTOR_INIT_FINALLY(&dists, no_of_nodes);
-    igraph_vector_fill(&dists, -1.0);
-
     parents = igraph_Calloc(no_of_nodes, long int);
     if (parents == 0) {
         IGRAPH_ERROR("Can't calculate shortest paths", IGRAPH_ENOMEM);
@@ -4684,43 +5447,84 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         }
     }
 
-    VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
-    parents[(long int)from] = 0;
-    igraph_2wheap_push_with_index(&Q, from, 0);
-
-    while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-        long int nlen, minnei = igraph_2wheap_max_index(&Q);
-        igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-        igraph_vector_t *neis;
+    no_of_threads = igraph_i_delta_stepping_threads(graph);
+    if (no_of_threads > 1) {
+        /* Parallel search, it finds the whole shortest path tree */
+        igraph_weighted_adjlist_t wal;
+        igraph_i_delta_stepping_t ds;
 
-        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+        IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+        IGRAPH_CHECK(igraph_i_delta_stepping_init(&ds, &wal, no_of_threads));
+        IGRAPH_FINALLY(igraph_i_delta_stepping_destroy, &ds);
+        IGRAPH_CHECK(igraph_i_delta_stepping_run(&ds, from));
 
-        if (is_target[minnei]) {
-            is_target[minnei] = 0;
-            to_reach--;
+        for (i = 0; i < no_of_nodes; i++) {
+            parents[i] = ds.inbound[i] + 1;
+            if (is_target[i] && ds.dist[i] != IGRAPH_INFINITY) {
+                to_reach--;
+            }
         }
 
-        /* Now check all neighbors of 'minnei' for a shorter path */
-        neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
-        nlen = igraph_vector_size(neis);
-        for (i = 0; i < nlen; i++) {
-            long int edge = (long int) VECTOR(*neis)[i];
-            long int tto = IGRAPH_OTHER(graph, edge, minnei);
-            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-            igraph_real_t curdist = VECTOR(dists)[tto];
-            if (curdist < 0) {
-                /* This is the first finite distance */
-                VECTOR(dists)[tto] = altdist;
-                parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
-            } else if (altdist < curdist) {
-                /* This is a shorter path */
-                VECTOR(dists)[tto] = altdist;
-                parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+        igraph_i_delta_stepping_destroy(&ds);
+        igraph_weighted_adjlist_destroy(&wal);
+        IGRAPH_FINALLY_CLEAN(2);
+    } else {
+        igraph_2wheap_t Q;
+        igraph_lazy_inclist_t inclist;
+        igraph_vector_t dists;
+
+        IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
+        IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+        IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
+        IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+
+        IGRAPH_VECTOR_INIT_FINALLY(&dists, no_of_nodes);
+        igraph_vector_fill(&dists, -1.0);
+
+        VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
+        parents[(long int)from] = 0;
+        igraph_2wheap_push_with_index(&Q, from, 0);
+
+        while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
+            long int nlen, minnei = igraph_2wheap_max_index(&Q);
+            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
+            igraph_vector_t *neis;
+
+            IGRAPH_ALLOW_INTERRUPTION();
+
+            if (is_target[minnei]) {
+                is_target[minnei] = 0;
+                to_reach--;
             }
-        }
-    } /* !igraph_2wheap_empty(&Q) */
+
+            /* Now check all neighbors of 'minnei' for a shorter path */
+            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
+            nlen = igraph_vector_size(neis);
+            for (i = 0; i < nlen; i++) {
+                long int edge = (long int) VECTOR(*neis)[i];
+                long int tto = IGRAPH_OTHER(graph, edge, minnei);
+                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+                igraph_real_t curdist = VECTOR(dists)[tto];
+                if (curdist < 0) {
+                    /* This is the first finite distance */
+                    VECTOR(dists)[tto] = altdist;
+                    parents[tto] = edge + 1;
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                } else if (altdist < curdist) {
+                    /* This is a shorter path */
+                    VECTOR(dists)[tto] = altdist;
+                    parents[tto] = edge + 1;
+                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                }
+            }
+        } /* !igraph_2wheap_empty(&Q) */
+
+        igraph_vector_destroy(&dists);
+        igraph_lazy_inclist_destroy(&inclist);
+        igraph_2wheap_destroy(&Q);
+        IGRAPH_FINALLY_CLEAN(3);
+    }
 
     if (to_reach > 0) {
         IGRAPH_WARNING("Couldn't reach some vertices");
@@ -4805,13 +5609,10 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         }
     }
 
-    igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
-    igraph_vector_destroy(&dists);
     igraph_Free(is_target);
     igraph_Free(parents);
     igraph_vit_destroy(&vit);
-    IGRAPH_FINALLY_CLEAN(6);
+    IGRAPH_FINALLY_CLEAN(3);
 
     return 0;
 }
@@ -4823,22 +5624,27 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
  * Calculates a single (positively) weighted shortest path from
  * a single vertex to another one, using Dijkstra's algorithm.
  *
- * </para><para>This function is a special case (and a wrapper) to
- * \ref igraph_get_shortest_paths_dijkstra().
+ * </para><para>
+ * The search is bidirectional: it settles vertices from both ends,
+ * always on the side whose next vertex is closer, and stops as soon as
+ * the sum of the two search radii reaches the length of the best path
+ * seen so far. It usually settles far fewer vertices than a search
+ * from one end only.
  *
  * \param graph The input graph, it can be directed or undirected.
  * \param vertices Pointer to an initialized vector or a null
  *        pointer. If not a null pointer, then the vertex ids along
  *        the path are stored here, including the source and target
  *        vertices.
- * \param edges Pointer to an uninitialized vector or a null
+ * \param edges Pointer to an initialized vector or a null
  *        pointer. If not a null pointer, then the edge ids along the
  *        path are stored here.
  * \param from The id of the source vertex.
  * \param to The id of the target vertex.
  * \param weights Vector of edge weights, in the order of edge
  *        ids. They must be non-negative, otherwise the algorithm does
- *        not work.
+ *        not work. If this is a null pointer, then the unweighted
+ *        version, \ref igraph_get_shortest_path() is called.
  * \param mode A constant specifying how edge directions are
  *        considered in directed graphs. \c IGRAPH_OUT follows edge
  *        directions, \c IGRAPH_IN follows the opposite directions,
@@ -4847,7 +5653,7 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
  * \return Error code.
  *
  * Time complexity: O(|E|log|E|+|V|), |V| is the number of vertices,
- * |E| is the number of edges in the graph.
+ * |E| is the number of edges in the graph, in the worst case.
  *
  * \sa \ref igraph_get_shortest_paths_dijkstra() for the version with
  * more target vertices.
@@ -4861,37 +5667,342 @@ int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
                                       const igraph_vector_t *weights,
                                       igraph_neimode_t mode) {
 
-    igraph_vector_ptr_t vertices2, *vp = &vertices2;
-    igraph_vector_ptr_t edges2, *ep = &edges2;
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_2wheap_t heap[2];
+    igraph_real_t *dist[2];
+    long int *parent[2];
+    igraph_neimode_t modes[2];
+    igraph_incident_view_t views[2];
+    igraph_real_t best = IGRAPH_INFINITY;
+    int side, k, no_of_views;
+    long int meet = -1, j;
 
-    if (vertices) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&vertices2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &vertices2);
-        VECTOR(vertices2)[0] = vertices;
-    } else {
-        vp = 0;
+    if (!weights) {
+        return igraph_get_shortest_path(graph, vertices, edges, from, to, mode);
     }
-    if (edges) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&edges2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &edges2);
-        VECTOR(edges2)[0] = edges;
+
+    if (igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    if (no_of_edges > 0) {
+        igraph_real_t min = igraph_vector_min(weights);
+        if (min < 0) {
+            IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+        }
+    }
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+        IGRAPH_ERROR("cannot get shortest path", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    modes[0] = mode;
+    modes[1] = mode == IGRAPH_OUT ? IGRAPH_IN :
+               mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+
+    /* The distance of a vertex is valid once it entered the heap; the
+       settled vertices stay in the heap as inactive elements */
+    for (side = 0; side < 2; side++) {
+        IGRAPH_CHECK(igraph_2wheap_init(&heap[side], no_of_nodes));
+        IGRAPH_FINALLY(igraph_2wheap_destroy, &heap[side]);
+        dist[side] = igraph_Calloc(no_of_nodes, igraph_real_t);
+        if (dist[side] == 0) {
+            IGRAPH_ERROR("cannot get shortest path", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, dist[side]);
+        parent[side] = igraph_Calloc(no_of_nodes, long int);
+        if (parent[side] == 0) {
+            IGRAPH_ERROR("cannot get shortest path", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, parent[side]);
+    }
+
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap[0], from, -0.0));
+    parent[0][(long int) from] = 1;
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap[1], to, -0.0));
+    parent[1][(long int) to] = 1;
+    if (from == to) {
+        meet = from;
+        best = 0;
+    }
+
+    while (1) {
+        igraph_real_t top[2];
+        long int act;
+        igraph_real_t actdist;
+
+        /* Every path shorter than 'best' would have to go through a
+           vertex that is farther than the next one from both ends */
+        for (side = 0; side < 2; side++) {
+            top[side] = !igraph_2wheap_empty(&heap[side]) ?
+                        -igraph_2wheap_max(&heap[side]) : IGRAPH_INFINITY;
+        }
+        if (top[0] + top[1] >= best) {
+            break;
+        }
+        side = top[0] <= top[1] ? 0 : 1;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        act = igraph_2wheap_max_index(&heap[side]);
+        actdist = -igraph_2wheap_deactivate_max(&heap[side]);
+
+        IGRAPH_CHECK(igraph_i_incident_views(graph, act, modes[side], views,
+                                             &no_of_views));
+        for (k = 0; k < no_of_views; k++) {
+            for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                long int edge = IGRAPH_VIEW_EDGE(views[k], j);
+                long int neighbor = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                igraph_real_t altdist = actdist + VECTOR(*weights)[edge];
+                if (IGRAPH_VIEW_DELETED(views[k], j)) {
+                    continue;
+                }
+                if (!igraph_2wheap_has_elem(&heap[side], neighbor)) {
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap[side], neighbor,
+                                 -altdist));
+                } else if (igraph_2wheap_has_active(&heap[side], neighbor) &&
+                           altdist < dist[side][neighbor]) {
+                    igraph_2wheap_modify(&heap[side], neighbor, -altdist);
+                } else {
+                    continue;
+                }
+                dist[side][neighbor] = altdist;
+                parent[side][neighbor] = edge + 2;
+                if (igraph_2wheap_has_elem(&heap[1 - side], neighbor) &&
+                    altdist + dist[1 - side][neighbor] < best) {
+                    best = altdist + dist[1 - side][neighbor];
+                    meet = neighbor;
+                }
+            }
+        }
+    }
+
+    if (meet >= 0) {
+        IGRAPH_CHECK(igraph_i_bidirectional_path(graph, parent[0], parent[1],
+                     meet, vertices, edges));
     } else {
-        ep = 0;
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        if (vertices) {
+            igraph_vector_clear(vertices);
+        }
+        if (edges) {
+            igraph_vector_clear(edges);
+        }
     }
 
-    IGRAPH_CHECK(igraph_get_shortest_paths_dijkstra(graph, vp, ep,
-                 from, igraph_vss_1(to),
-                 weights, mode, 0, 0));
+    for (side = 1; side >= 0; side--) {
+        igraph_Free(parent[side]);
+        igraph_Free(dist[side]);
+        igraph_2wheap_destroy(&heap[side]);
+    }
+    IGRAPH_FINALLY_CLEAN(6);
 
-    if (edges) {
-        igraph_vector_ptr_destroy(&edges2);
-        IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_astar
+ * A* search for a shortest path from one vertex to another one.
+ *
+ * Calculates a single weighted shortest path between two vertices
+ * using the A* algorithm. It is Dijkstra's algorithm, but the vertices
+ * are settled in the order of their distance from the source plus an
+ * estimate of their distance from the target, given by the heuristic
+ * function. A good estimate leads the search towards the target, so
+ * far fewer vertices are visited than by Dijkstra's algorithm.
+ *
+ * </para><para>
+ * The result is a shortest path if the heuristic is admissible, i.e.
+ * it never overestimates the distance to the target. If it is also
+ * consistent, i.e. the estimate decreases by at most the weight of an
+ * edge along every edge, then every vertex is settled at most once.
+ * The lower bounds of \ref igraph_landmarks_heuristic() have both
+ * properties.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of edge weights, in the order of edge
+ *        ids. They must be non-negative. If this is a null pointer,
+ *        then every edge has weight one.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \param heuristic The function that estimates the distance of a
+ *        vertex from the target, see \ref
+ *        igraph_astar_heuristic_func_t. If this is a null pointer, the
+ *        estimate is zero and the search is Dijkstra's algorithm.
+ * \param extra This is passed to the heuristic function.
+ * \return Error code.
+ *
+ * Time complexity: O(|E|log|E|+|V|) plus the time of |V| calls of the
+ * heuristic function in the worst case, if the heuristic is
+ * consistent. |V| is the number of vertices, |E| is the number of
+ * edges in the graph.
+ *
+ * \sa \ref igraph_get_shortest_path_dijkstra(), \ref
+ * igraph_landmarks_init().
+ */
+
+int igraph_get_shortest_path_astar(const igraph_t *graph,
+                                   igraph_vector_t *vertices,
+                                   igraph_vector_t *edges,
+                                   igraph_integer_t from,
+                                   igraph_integer_t to,
+                                   const igraph_vector_t *weights,
+                                   igraph_neimode_t mode,
+                                   igraph_astar_heuristic_func_t *heuristic,
+                                   void *extra) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_2wheap_t heap;
+    igraph_vector_t dist, estimate;
+    long int *parent;
+    igraph_incident_view_t views[2];
+    int k, no_of_views;
+    igraph_bool_t found = 0;
+    long int j;
+
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0) {
+            igraph_real_t min = igraph_vector_min(weights);
+            if (min < 0) {
+                IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+            }
+        }
     }
-    if (vertices) {
-        igraph_vector_ptr_destroy(&vertices2);
-        IGRAPH_FINALLY_CLEAN(1);
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+        IGRAPH_ERROR("cannot get shortest path", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    /* 'dist' and 'estimate' are valid once a vertex entered the heap,
+       the heap is keyed by their sum */
+    IGRAPH_CHECK(igraph_2wheap_init(&heap, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &heap);
+    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&estimate, no_of_nodes);
+    parent = igraph_Calloc(no_of_nodes, long int);
+    if (parent == 0) {
+        IGRAPH_ERROR("cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, parent);
+
+    if (heuristic) {
+        IGRAPH_CHECK(heuristic(&VECTOR(estimate)[(long int) from], from, to, extra));
+    }
+    parent[(long int) from] = 1;
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, from,
+                 -VECTOR(estimate)[(long int) from]));
+
+    while (!igraph_2wheap_empty(&heap)) {
+        long int act = igraph_2wheap_max_index(&heap);
+        igraph_real_t actdist = VECTOR(dist)[act];
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        igraph_2wheap_deactivate_max(&heap);
+        if (act == to) {
+            found = 1;
+            break;
+        }
+
+        IGRAPH_CHECK(igraph_i_incident_views(graph, act, mode, views,
+                                             &no_of_views));
+        for (k = 0; k < no_of_views; k++) {
+            for (j = 0; j < IGRAPH_VIEW_SIZE(views[k]); j++) {
+                long int edge = IGRAPH_VIEW_EDGE(views[k], j);
+                long int neighbor = IGRAPH_VIEW_NEIGHBOR(views[k], j);
+                igraph_real_t altdist = actdist +
+                                        (weights ? VECTOR(*weights)[edge] : 1);
+                if (IGRAPH_VIEW_DELETED(views[k], j)) {
+                    continue;
+                }
+                if (!igraph_2wheap_has_elem(&heap, neighbor)) {
+                    igraph_real_t *est = &VECTOR(estimate)[neighbor];
+                    if (heuristic) {
+                        IGRAPH_CHECK(heuristic(est, (igraph_integer_t) neighbor, to,
+                                               extra));
+                    }
+                    if (*est == IGRAPH_INFINITY) {
+                        /* the target cannot be reached from here */
+                        continue;
+                    }
+                } else if (altdist >= VECTOR(dist)[neighbor]) {
+                    continue;
+                }
+                /* A settled vertex is opened again if a shorter path is
+                   found to it, this only happens with a heuristic that
+                   is not consistent */
+                VECTOR(dist)[neighbor] = altdist;
+                parent[neighbor] = edge + 2;
+                if (igraph_2wheap_has_active(&heap, neighbor)) {
+                    igraph_2wheap_modify(&heap, neighbor,
+                                         -(altdist + VECTOR(estimate)[neighbor]));
+                } else {
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, neighbor,
+                                 -(altdist + VECTOR(estimate)[neighbor])));
+                }
+            }
+        }
+    }
+
+    if (found) {
+        long int act, len = 0, i;
+        for (act = to; parent[act] > 1; len++) {
+            act = IGRAPH_OTHER(graph, parent[act] - 2, act);
+        }
+        if (vertices) {
+            IGRAPH_CHECK(igraph_vector_resize(vertices, len + 1));
+            VECTOR(*vertices)[len] = to;
+        }
+        if (edges) {
+            IGRAPH_CHECK(igraph_vector_resize(edges, len));
+        }
+        for (act = to, i = len - 1; parent[act] > 1; i--) {
+            long int edge = parent[act] - 2;
+            act = IGRAPH_OTHER(graph, edge, act);
+            if (vertices) {
+                VECTOR(*vertices)[i] = act;
+            }
+            if (edges) {
+                VECTOR(*edges)[i] = edge;
+            }
+        }
+    } else {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        if (vertices) {
+            igraph_vector_clear(vertices);
+        }
+        if (edges) {
+            igraph_vector_clear(edges);
+        }
     }
 
+    igraph_Free(parent);
+    igraph_vector_destroy(&estimate);
+    igraph_vector_destroy(&dist);
+    igraph_2wheap_destroy(&heap);
+    IGRAPH_FINALLY_CLEAN(4);
+
     return 0;
 }
 
@@ -5382,7 +6493,7 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
                                        igraph_neimode_t mode) {
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_lazy_inclist_t inclist;
+    igraph_weighted_adjlist_t wal;
     long int i, j, k;
     long int no_of_from, no_of_to;
     igraph_dqueue_t Q;
@@ -5416,8 +6527,8 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
     IGRAPH_DQUEUE_INIT_FINALLY(&Q, no_of_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&clean_vertices, no_of_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&num_queued, no_of_nodes);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, mode, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
 
     if ( (all_to = igraph_vs_is_all(&to)) ) {
         no_of_to = no_of_nodes;
@@ -5446,7 +6557,7 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
         }
 
         while (!igraph_dqueue_empty(&Q)) {
-            igraph_vector_t *neis;
+            igraph_weighted_adjlist_entry_t *neis;
             long int nlen;
 
             j = (long int) igraph_dqueue_pop(&Q);
@@ -5462,15 +6573,14 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
                 continue;
             }
 
-            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) j);
-            nlen = igraph_vector_size(neis);
+            neis = igraph_weighted_adjlist_get(&wal, j);
+            nlen = igraph_weighted_adjlist_size(&wal, j);
 
             for (k = 0; k < nlen; k++) {
-                long int nei = (long int) VECTOR(*neis)[k];
-                long int target = IGRAPH_OTHER(graph, nei, j);
-                if (VECTOR(dist)[target] > VECTOR(dist)[j] + VECTOR(*weights)[nei]) {
+                long int target = neis[k].nei;
+                if (VECTOR(dist)[target] > VECTOR(dist)[j] + neis[k].weight) {
                     /* relax the edge */
-                    VECTOR(dist)[target] = VECTOR(dist)[j] + VECTOR(*weights)[nei];
+                    VECTOR(dist)[target] = VECTOR(dist)[j] + neis[k].weight;
                     if (VECTOR(clean_vertices)[target]) {
                         VECTOR(clean_vertices)[target] = 0;
                         IGRAPH_CHECK(igraph_dqueue_push(&Q, target));
@@ -5503,7 +6613,7 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
     igraph_dqueue_destroy(&Q);
     igraph_vector_destroy(&clean_vertices);
     igraph_vector_destroy(&num_queued);
-    igraph_lazy_inclist_destroy(&inclist);
+    igraph_weighted_adjlist_destroy(&wal);
     IGRAPH_FINALLY_CLEAN(5);
 
     return 0;
@@ -6273,7 +7383,8 @@ int igraph_strength(const igraph_t *graph, igraph_vector_t *res,
  * \return Error code.
  *
  * Time complexity: O(|V||E|*log|E|), |V| is the number of vertices,
- * |E| is the number of edges.
+ * |E| is the number of edges. If all weights are integers not larger
+ * than 1024, then it is O(|V|*(|E|+|V|+D)), where D is the diameter.
  */
 
 int igraph_diameter_dijkstra(const igraph_t *graph,
@@ -6292,6 +7403,10 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
        From now on we use a 2-way heap, so the distances can be queried
        directly from the heap.
 
+       If all weights are small integers, the heap is replaced by
+       buckets of equal distance (Dial's algorithm), with the same
+       interface, see igraph_dial_internal.h.
+
        Dirty tricks:
        - the opposite of the distance is stored in the heap, as it is a
          maximum heap and we need a minimum heap.
@@ -6303,8 +7418,8 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
 
-    igraph_2wheap_t Q;
-    igraph_inclist_t inclist;
+    igraph_i_dial_t Q;
+    igraph_weighted_adjlist_t wal;
     long int source, j;
     igraph_neimode_t dirmode = directed ? IGRAPH_OUT : IGRAPH_ALL;
 
@@ -6329,25 +7444,25 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
         IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, dirmode));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &wal, dirmode, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &wal);
+    IGRAPH_CHECK(igraph_i_dial_init(&Q, no_of_nodes, &wal));
+    IGRAPH_FINALLY(igraph_i_dial_destroy, &Q);
 
     for (source = 0; source < no_of_nodes; source++) {
 
         IGRAPH_PROGRESS("Weighted diameter: ", source * 100.0 / no_of_nodes, NULL);
         IGRAPH_ALLOW_INTERRUPTION();
 
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
+        igraph_i_dial_clear(&Q);
+        igraph_i_dial_push_with_index(&Q, source, -1.0);
 
         nodes_reached = 0.0;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
-            igraph_vector_int_t *neis;
+        while (!igraph_i_dial_empty(&Q)) {
+            long int minnei = igraph_i_dial_max_index(&Q);
+            igraph_real_t mindist = -igraph_i_dial_deactivate_max(&Q);
+            igraph_weighted_adjlist_entry_t *neis;
             long int nlen;
 
             if (mindist > res) {
@@ -6356,26 +7471,25 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
             nodes_reached++;
 
             /* Now check all neighbors of 'minnei' for a shorter path */
-            neis = igraph_inclist_get(&inclist, minnei);
-            nlen = igraph_vector_int_size(neis);
+            neis = igraph_weighted_adjlist_get(&wal, minnei);
+            nlen = igraph_weighted_adjlist_size(&wal, minnei);
             for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int tto = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+                long int tto = neis[j].nei;
+                igraph_real_t altdist = mindist + neis[j].weight;
+                igraph_bool_t active = igraph_i_dial_has_active(&Q, tto);
+                igraph_bool_t has = igraph_i_dial_has_elem(&Q, tto);
+                igraph_real_t curdist = active ? -igraph_i_dial_get(&Q, tto) : 0.0;
 
                 if (!has) {
                     /* First finite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dial_push_with_index(&Q, tto, -altdist));
                 } else if (altdist < curdist) {
                     /* A shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dial_modify(&Q, tto, -altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_dial_empty(&Q) */
 
         /* not connected, return infinity */
         if (nodes_reached != no_of_nodes && !unconn) {
@@ -6389,8 +7503,8 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     /* Compensate for the +1 that we have added to distances */
     res -= 1;
 
-    igraph_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_dial_destroy(&Q);
+    igraph_weighted_adjlist_destroy(&wal);
     IGRAPH_FINALLY_CLEAN(2);
 
     IGRAPH_PROGRESS("Weighted diameter: ", 100.0, NULL);
@@ -7189,7 +8303,7 @@ int igraph_is_tree(const igraph_t *graph, igraph_bool_t *res, igraph_integer_t *
         mode = IGRAPH_ALL;
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &al, mode));
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, &al, mode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
 
     /* The main algorithm:
@@ -44,4 +44,8 @@ int igraph_i_subgraph_create_from_scratch(const igraph_t *graph,
         igraph_vector_t *map,
         igraph_vector_t *invmap);
 
+int igraph_i_bfs_edge_checks(const igraph_t *graph, igraph_integer_t source,
+                             igraph_neimode_t mode, igraph_bool_t hybrid,
+                             igraph_real_t *res);
+
 #endif
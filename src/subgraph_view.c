@@ -0,0 +1,773 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_structural.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+
+/**
+ * \section about_subgraph_views
+ *
+ * <para>\ref igraph_induced_subgraph() creates a new graph, which
+ * takes time and memory proportional to the size of the subgraph,
+ * even if only a single search is run on it. A subgraph view,
+ * <type>igraph_subgraph_view_t</type>, only records which vertices of
+ * the parent graph are selected, and reads the edges from the parent
+ * graph when they are needed. The same view can be reused for another
+ * set of vertices with \ref igraph_subgraph_view_select(), in time
+ * proportional to the sizes of the old and the new selection, which
+ * makes it cheap to analyze a large number of small subgraphs, e.g.
+ * the neighborhoods of all vertices.</para>
+ *
+ * <para>Degrees, breadth-first search, weakly connected components and
+ * transitivity are implemented directly on subgraph views. Vertex ids
+ * are the ids of the view, they can be translated with \ref
+ * igraph_subgraph_view_parent_vid() and \ref
+ * igraph_subgraph_view_vid(). The parent graph must not be modified
+ * or destroyed while the view is in use.</para>
+ */
+
+/* Iterates over the neighbors of a vertex that are in the view, in
+   view ids, skipping deleted edges */
+
+typedef struct igraph_i_subgraph_view_nit_t {
+    const igraph_subgraph_view_t *view;
+    igraph_incident_view_t views[2];
+    int no_of_views, j;
+    long int i;
+} igraph_i_subgraph_view_nit_t;
+
+static void igraph_i_subgraph_view_nit_create(const igraph_subgraph_view_t *view,
+        igraph_i_subgraph_view_nit_t *nit,
+        long int vid, igraph_neimode_t mode) {
+    igraph_integer_t pvid = VECTOR(view->vids)[vid];
+    if (!igraph_is_directed(view->graph)) {
+        mode = IGRAPH_ALL;
+    }
+    nit->view = view;
+    nit->no_of_views = mode == IGRAPH_ALL ? 2 : 1;
+    nit->j = 0;
+    nit->i = 0;
+    /* cannot fail, the vertex id and the mode are valid */
+    igraph_incident_view(view->graph, &nit->views[0], pvid,
+                         mode == IGRAPH_ALL ? IGRAPH_OUT : mode);
+    if (mode == IGRAPH_ALL) {
+        igraph_incident_view(view->graph, &nit->views[1], pvid, IGRAPH_IN);
+    }
+}
+
+static igraph_bool_t igraph_i_subgraph_view_nit_next(igraph_i_subgraph_view_nit_t *nit,
+        long int *nei) {
+    const igraph_vector_int_t *map = &nit->view->map;
+    while (nit->j < nit->no_of_views) {
+        const igraph_incident_view_t *v = &nit->views[nit->j];
+        while (nit->i < IGRAPH_VIEW_SIZE(*v)) {
+            long int i = nit->i++;
+            long int to;
+            if (IGRAPH_VIEW_DELETED(*v, i)) {
+                continue;
+            }
+            to = VECTOR(*map)[ IGRAPH_VIEW_NEIGHBOR(*v, i) ];
+            if (to != 0) {
+                *nei = to - 1;
+                return 1;
+            }
+        }
+        nit->j++;
+        nit->i = 0;
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_init
+ * \brief Creates a view of an induced subgraph.
+ *
+ * </para><para>
+ * The view refers to \p graph, which must not be modified or
+ * destroyed before the view is destroyed. Vertices that are marked as
+ * deleted by \ref igraph_delete_vertices_deferred() are left out of
+ * the view, and so are the edges marked as deleted.
+ *
+ * \param graph The parent graph.
+ * \param view Pointer to an uninitialized subgraph view.
+ * \param vids The vertices to select. The vertices of the view are
+ *   numbered in this order. Vertex ids that appear more than once are
+ *   only included at their first occurrence.
+ * \return Error code:
+ *         \c IGRAPH_EINVVID: invalid vertex id.
+ *
+ * Time complexity: O(|V|+|S|), |V| is the number of vertices in the
+ * parent graph, |S| is the number of selected vertices.
+ */
+
+int igraph_subgraph_view_init(const igraph_t *graph,
+                              igraph_subgraph_view_t *view,
+                              const igraph_vs_t vids) {
+    view->graph = graph;
+    IGRAPH_CHECK(igraph_vector_int_init(&view->vids, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &view->vids);
+    IGRAPH_CHECK(igraph_vector_int_init(&view->map, igraph_vcount(graph)));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &view->map);
+    IGRAPH_CHECK(igraph_subgraph_view_select(view, vids));
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_destroy
+ * \brief Frees the memory used by a subgraph view.
+ *
+ * \param view The view to destroy.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_subgraph_view_destroy(igraph_subgraph_view_t *view) {
+    igraph_vector_int_destroy(&view->vids);
+    igraph_vector_int_destroy(&view->map);
+}
+
+/**
+ * \function igraph_subgraph_view_select
+ * \brief Selects another set of vertices for a subgraph view.
+ *
+ * </para><para>
+ * This is much faster than destroying the view and creating a new
+ * one, if the selection is small compared to the parent graph.
+ *
+ * \param view The subgraph view.
+ * \param vids The vertices to select, see \ref
+ *   igraph_subgraph_view_init(). The view is empty if an error
+ *   occurs.
+ * \return Error code:
+ *         \c IGRAPH_EINVVID: invalid vertex id.
+ *
+ * Time complexity: O(|S|+|R|), the number of vertices in the old and
+ * in the new selection.
+ */
+
+int igraph_subgraph_view_select(igraph_subgraph_view_t *view,
+                                const igraph_vs_t vids) {
+    long int i, n = igraph_vector_int_size(&view->vids);
+    igraph_vit_t vit;
+
+    for (i = 0; i < n; i++) {
+        VECTOR(view->map)[ VECTOR(view->vids)[i] ] = 0;
+    }
+    igraph_vector_int_clear(&view->vids);
+
+    IGRAPH_CHECK(igraph_vit_create(view->graph, vids, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_CHECK(igraph_vector_int_reserve(&view->vids, IGRAPH_VIT_SIZE(vit)));
+
+    for (; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit)) {
+        long int vid = IGRAPH_VIT_GET(vit);
+        if (VECTOR(view->map)[vid] != 0 ||
+            igraph_is_vertex_deleted(view->graph, (igraph_integer_t) vid)) {
+            continue;
+        }
+        igraph_vector_int_push_back(&view->vids, (int) vid); /* reserved */
+        VECTOR(view->map)[vid] = (int) igraph_vector_int_size(&view->vids);
+    }
+
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_vcount
+ * \brief The number of vertices in a subgraph view.
+ *
+ * \param view The subgraph view.
+ * \return The number of selected vertices.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_subgraph_view_vcount(const igraph_subgraph_view_t *view) {
+    return (igraph_integer_t) igraph_vector_int_size(&view->vids);
+}
+
+/**
+ * \function igraph_subgraph_view_ecount
+ * \brief The number of edges in a subgraph view.
+ *
+ * </para><para>
+ * The edges are counted every time this function is called.
+ *
+ * \param view The subgraph view.
+ * \return The number of edges of the parent graph between selected
+ *   vertices.
+ *
+ * Time complexity: O(|S|+|E|), the number of selected vertices and
+ * the total out-degree of them in the parent graph.
+ */
+
+igraph_integer_t igraph_subgraph_view_ecount(const igraph_subgraph_view_t *view) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    long int v, i, ecount = 0;
+
+    /* every edge is seen once, at its first endpoint */
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_incident_view_t out;
+        igraph_incident_view(view->graph, &out, VECTOR(view->vids)[v], IGRAPH_OUT);
+        for (i = 0; i < IGRAPH_VIEW_SIZE(out); i++) {
+            if (!IGRAPH_VIEW_DELETED(out, i) &&
+                VECTOR(view->map)[ IGRAPH_VIEW_NEIGHBOR(out, i) ] != 0) {
+                ecount++;
+            }
+        }
+    }
+
+    return (igraph_integer_t) ecount;
+}
+
+/**
+ * \function igraph_subgraph_view_parent_vid
+ * \brief The id of a vertex of the view in the parent graph.
+ *
+ * \param view The subgraph view.
+ * \param vid A vertex id of the view.
+ * \return The id of the same vertex in the parent graph.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_subgraph_view_parent_vid(const igraph_subgraph_view_t *view,
+        igraph_integer_t vid) {
+    return VECTOR(view->vids)[(long int) vid];
+}
+
+/**
+ * \function igraph_subgraph_view_vid
+ * \brief The id of a vertex of the parent graph in the view.
+ *
+ * \param view The subgraph view.
+ * \param parent_vid A vertex id of the parent graph.
+ * \return The id of the same vertex in the view, or -1 if it is not
+ *   selected.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_subgraph_view_vid(const igraph_subgraph_view_t *view,
+        igraph_integer_t parent_vid) {
+    return VECTOR(view->map)[(long int) parent_vid] - 1;
+}
+
+/**
+ * \function igraph_subgraph_view_edges
+ * \brief The edges of a subgraph view.
+ *
+ * \param view The subgraph view.
+ * \param eids Initialized vector, the ids of the edges in the parent
+ *   graph between selected vertices are stored here, in increasing
+ *   order.
+ * \return Error code.
+ *
+ * Time complexity: O(|S|+|E| log |E|), the number of selected vertices
+ * and the total out-degree of them in the parent graph.
+ */
+
+int igraph_subgraph_view_edges(const igraph_subgraph_view_t *view,
+                               igraph_vector_t *eids) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    long int v, i;
+
+    igraph_vector_clear(eids);
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_incident_view_t out;
+        IGRAPH_CHECK(igraph_incident_view(view->graph, &out,
+                                          VECTOR(view->vids)[v], IGRAPH_OUT));
+        for (i = 0; i < IGRAPH_VIEW_SIZE(out); i++) {
+            if (!IGRAPH_VIEW_DELETED(out, i) &&
+                VECTOR(view->map)[ IGRAPH_VIEW_NEIGHBOR(out, i) ] != 0) {
+                IGRAPH_CHECK(igraph_vector_push_back(eids, IGRAPH_VIEW_EDGE(out, i)));
+            }
+        }
+    }
+    igraph_vector_sort(eids);
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_neighbors
+ * \brief The neighbors of a vertex in a subgraph view.
+ *
+ * \param view The subgraph view.
+ * \param neis Initialized vector, the view ids of the neighbors are
+ *   stored here, in increasing order, like \ref igraph_neighbors()
+ *   on the induced subgraph.
+ * \param vid The view id of the vertex.
+ * \param mode For directed graphs, \c IGRAPH_OUT, \c IGRAPH_IN or \c
+ *   IGRAPH_ALL, as for \ref igraph_neighbors(). Ignored for undirected
+ *   graphs.
+ * \return Error code:
+ *         \c IGRAPH_EINVVID: invalid vertex id.
+ *         \c IGRAPH_EINVMODE: invalid mode argument.
+ *
+ * Time complexity: O(d log d), d is the degree of the vertex in the
+ * parent graph.
+ */
+
+int igraph_subgraph_view_neighbors(const igraph_subgraph_view_t *view,
+                                   igraph_vector_t *neis,
+                                   igraph_integer_t vid,
+                                   igraph_neimode_t mode) {
+    igraph_i_subgraph_view_nit_t nit;
+    long int nei;
+
+    if (vid < 0 || vid >= igraph_subgraph_view_vcount(view)) {
+        IGRAPH_ERROR("Cannot get neighbors in subgraph view", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    igraph_vector_clear(neis);
+    igraph_i_subgraph_view_nit_create(view, &nit, vid, mode);
+    while (igraph_i_subgraph_view_nit_next(&nit, &nei)) {
+        IGRAPH_CHECK(igraph_vector_push_back(neis, nei));
+    }
+    igraph_vector_sort(neis);
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_degree
+ * \brief The degrees of all vertices in a subgraph view.
+ *
+ * \param view The subgraph view.
+ * \param res Initialized vector, the degrees are stored here, in the
+ *   order of the view ids.
+ * \param mode For directed graphs, \c IGRAPH_OUT, \c IGRAPH_IN or \c
+ *   IGRAPH_ALL, as for \ref igraph_degree(). Ignored for undirected
+ *   graphs.
+ * \param loops Whether to count the loop edges.
+ * \return Error code:
+ *         \c IGRAPH_EINVMODE: invalid mode argument.
+ *
+ * Time complexity: O(|S|+|E|), the number of selected vertices and
+ * their total degree in the parent graph.
+ */
+
+int igraph_subgraph_view_degree(const igraph_subgraph_view_t *view,
+                                igraph_vector_t *res,
+                                igraph_neimode_t mode,
+                                igraph_bool_t loops) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    igraph_i_subgraph_view_nit_t nit;
+    long int v, nei;
+
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+    igraph_vector_null(res);
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_i_subgraph_view_nit_create(view, &nit, v, mode);
+        while (igraph_i_subgraph_view_nit_next(&nit, &nei)) {
+            if (loops || nei != v) {
+                VECTOR(*res)[v] += 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_bfs
+ * \brief Breadth-first search in a subgraph view.
+ *
+ * </para><para>
+ * This is the same search as \ref igraph_bfs() from a single root with
+ * \c unreachable set to false, run on the induced subgraph. The
+ * vertices that are not reachable from \p root have \c NaN in the
+ * result vectors. The neighbors of a vertex are visited in the order
+ * of the parent graph, so the order of the vertices at the same
+ * distance may differ from \ref igraph_bfs() if the vertices were not
+ * selected in increasing order, or with \c IGRAPH_ALL in directed
+ * graphs; the distances are the same.
+ *
+ * \param view The subgraph view.
+ * \param root The view id of the root vertex.
+ * \param mode For directed graphs, \c IGRAPH_OUT follows the edges,
+ *   \c IGRAPH_IN follows them backwards, and \c IGRAPH_ALL ignores
+ *   their direction. Ignored for undirected graphs.
+ * \param order If not a null pointer, the view ids of the vertices are
+ *   stored here in the order they were visited.
+ * \param father If not a null pointer, the father of each vertex in
+ *   the search tree is stored here, -1 for the root.
+ * \param dist If not a null pointer, the distance of each vertex from
+ *   the root is stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(|S|+|E|), the number of selected vertices and
+ * their total degree in the parent graph.
+ */
+
+int igraph_subgraph_view_bfs(const igraph_subgraph_view_t *view,
+                             igraph_integer_t root,
+                             igraph_neimode_t mode,
+                             igraph_vector_t *order,
+                             igraph_vector_t *father,
+                             igraph_vector_t *dist) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    long int head = 0, tail = 0, levelend = 1, actdist = 0, i;
+    igraph_vector_long_t queue;
+    igraph_i_subgraph_view_nit_t nit;
+    char *added;
+
+    if (root < 0 || root >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid root vertex in subgraph view BFS", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    added = igraph_Calloc(no_of_nodes, char);
+    if (added == 0) {
+        IGRAPH_ERROR("Cannot run subgraph view BFS", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, added);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+
+#define VINIT(v) if (v) {                            \
+        IGRAPH_CHECK(igraph_vector_resize((v), no_of_nodes)); \
+        igraph_vector_fill((v), IGRAPH_NAN); }
+
+    VINIT(order);
+    VINIT(father);
+    VINIT(dist);
+
+#undef VINIT
+
+    VECTOR(queue)[tail++] = root;
+    added[(long int) root] = 1;
+    if (father) {
+        VECTOR(*father)[(long int) root] = -1;
+    }
+
+    while (head < tail) {
+        long int actnode, nei;
+        if (head == levelend) {
+            actdist++;
+            levelend = tail;
+        }
+        actnode = VECTOR(queue)[head++];
+        if (dist) {
+            VECTOR(*dist)[actnode] = actdist;
+        }
+        igraph_i_subgraph_view_nit_create(view, &nit, actnode, mode);
+        while (igraph_i_subgraph_view_nit_next(&nit, &nei)) {
+            if (!added[nei]) {
+                added[nei] = 1;
+                VECTOR(queue)[tail++] = nei;
+                if (father) {
+                    VECTOR(*father)[nei] = actnode;
+                }
+            }
+        }
+        if (head % 1024 == 0) {
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+    }
+
+    if (order) {
+        for (i = 0; i < tail; i++) {
+            VECTOR(*order)[i] = VECTOR(queue)[i];
+        }
+    }
+
+    igraph_vector_long_destroy(&queue);
+    igraph_Free(added);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_clusters
+ * \brief Weakly connected components of a subgraph view.
+ *
+ * </para><para>
+ * The components are numbered the same way as by \ref
+ * igraph_clusters() with \c IGRAPH_WEAK on the induced subgraph.
+ *
+ * \param view The subgraph view.
+ * \param membership If not a null pointer, the component id of each
+ *   vertex is stored here.
+ * \param csize If not a null pointer, the size of each component is
+ *   stored here.
+ * \param no If not a null pointer, the number of components is stored
+ *   here.
+ * \return Error code.
+ *
+ * Time complexity: O(|S|+|E|), the number of selected vertices and
+ * their total degree in the parent graph.
+ */
+
+int igraph_subgraph_view_clusters(const igraph_subgraph_view_t *view,
+                                  igraph_vector_t *membership,
+                                  igraph_vector_t *csize,
+                                  igraph_integer_t *no) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    long int no_of_clusters = 0, v;
+    igraph_vector_long_t queue;
+    igraph_i_subgraph_view_nit_t nit;
+    char *added;
+
+    added = igraph_Calloc(no_of_nodes, char);
+    if (added == 0) {
+        IGRAPH_ERROR("Cannot find subgraph view components", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, added);
+    IGRAPH_CHECK(igraph_vector_long_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &queue);
+
+    if (membership) {
+        IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
+    }
+    if (csize) {
+        igraph_vector_clear(csize);
+    }
+
+    for (v = 0; v < no_of_nodes; v++) {
+        long int head = 0, tail = 0;
+
+        if (added[v]) {
+            continue;
+        }
+
+        VECTOR(queue)[tail++] = v;
+        added[v] = 1;
+        while (head < tail) {
+            long int actnode = VECTOR(queue)[head++], nei;
+            if (membership) {
+                VECTOR(*membership)[actnode] = no_of_clusters;
+            }
+            igraph_i_subgraph_view_nit_create(view, &nit, actnode, IGRAPH_ALL);
+            while (igraph_i_subgraph_view_nit_next(&nit, &nei)) {
+                if (!added[nei]) {
+                    added[nei] = 1;
+                    VECTOR(queue)[tail++] = nei;
+                }
+            }
+        }
+
+        if (csize) {
+            IGRAPH_CHECK(igraph_vector_push_back(csize, tail));
+        }
+        no_of_clusters++;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    if (no) {
+        *no = (igraph_integer_t) no_of_clusters;
+    }
+
+    igraph_vector_long_destroy(&queue);
+    igraph_Free(added);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/* Counts the triangles through each vertex, twice, and the number of
+   distinct neighbors, ignoring edge directions, loops and multiple
+   edges. 'simple' is set to false if there are loops or multiple
+   edges. */
+
+static int igraph_i_subgraph_view_triangles(const igraph_subgraph_view_t *view,
+        igraph_vector_t *triangles,
+        igraph_vector_t *degree,
+        igraph_bool_t *simple) {
+    long int no_of_nodes = igraph_subgraph_view_vcount(view);
+    long int v, i, nei, nei2, stamp = 0;
+    igraph_vector_long_t mark, mark2, neis;
+    igraph_i_subgraph_view_nit_t nit;
+
+    IGRAPH_CHECK(igraph_vector_long_init(&mark, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &mark);
+    IGRAPH_CHECK(igraph_vector_long_init(&mark2, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &mark2);
+    IGRAPH_CHECK(igraph_vector_long_init(&neis, 0));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &neis);
+    IGRAPH_CHECK(igraph_vector_resize(triangles, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_resize(degree, no_of_nodes));
+    *simple = 1;
+
+    for (v = 0; v < no_of_nodes; v++) {
+        long int count = 0;
+
+        igraph_vector_long_clear(&neis);
+        igraph_i_subgraph_view_nit_create(view, &nit, v, IGRAPH_ALL);
+        while (igraph_i_subgraph_view_nit_next(&nit, &nei)) {
+            if (nei == v || VECTOR(mark)[nei] == v + 1) {
+                *simple = 0;
+            } else {
+                VECTOR(mark)[nei] = v + 1;
+                IGRAPH_CHECK(igraph_vector_long_push_back(&neis, nei));
+            }
+        }
+
+        for (i = 0; i < igraph_vector_long_size(&neis); i++) {
+            nei = VECTOR(neis)[i];
+            stamp++;
+            igraph_i_subgraph_view_nit_create(view, &nit, nei, IGRAPH_ALL);
+            while (igraph_i_subgraph_view_nit_next(&nit, &nei2)) {
+                if (VECTOR(mark)[nei2] == v + 1 && nei2 != nei &&
+                    VECTOR(mark2)[nei2] != stamp) {
+                    VECTOR(mark2)[nei2] = stamp;
+                    count++;
+                }
+            }
+        }
+
+        VECTOR(*triangles)[v] = count;
+        VECTOR(*degree)[v] = igraph_vector_long_size(&neis);
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    igraph_vector_long_destroy(&neis);
+    igraph_vector_long_destroy(&mark2);
+    igraph_vector_long_destroy(&mark);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_transitivity
+ * \brief Transitivity of a subgraph view.
+ *
+ * </para><para>
+ * The same as \ref igraph_transitivity_undirected() on the induced
+ * subgraph: edge directions, loops and multiple edges are ignored.
+ *
+ * \param view The subgraph view.
+ * \param res Pointer to a real variable, the result is stored here.
+ * \param mode Defines how to treat graphs with no connected triples.
+ *   \c IGRAPH_TRANSITIVITY_NAN returns \c NaN in this case, \c
+ *   IGRAPH_TRANSITIVITY_ZERO returns zero.
+ * \return Error code.
+ *
+ * Time complexity: O(|S|*d^2), |S| is the number of selected vertices,
+ * d is their maximum degree in the parent graph.
+ */
+
+int igraph_subgraph_view_transitivity(const igraph_subgraph_view_t *view,
+                                      igraph_real_t *res,
+                                      igraph_transitivity_mode_t mode) {
+    igraph_vector_t triangles, degree;
+    igraph_real_t sum = 0, triples = 0;
+    long int v, no_of_nodes = igraph_subgraph_view_vcount(view);
+    igraph_bool_t simple;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&triangles, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, 0);
+    IGRAPH_CHECK(igraph_i_subgraph_view_triangles(view, &triangles, &degree,
+                 &simple));
+
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_real_t d = VECTOR(degree)[v];
+        sum += VECTOR(triangles)[v];
+        triples += d * (d - 1);
+    }
+
+    if (triples == 0 && mode == IGRAPH_TRANSITIVITY_ZERO) {
+        *res = 0;
+    } else {
+        *res = sum / triples;
+    }
+
+    igraph_vector_destroy(&degree);
+    igraph_vector_destroy(&triangles);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_subgraph_view_transitivity_local
+ * \brief Local transitivity of all vertices in a subgraph view.
+ *
+ * </para><para>
+ * The local clustering coefficient of the vertices of the induced
+ * subgraph, see \ref igraph_transitivity_local_undirected(). Like that
+ * function, it only works on undirected graphs without loops and
+ * multiple edges; these are checked in the induced subgraph only.
+ *
+ * \param view The subgraph view.
+ * \param res Initialized vector, the results are stored here, in the
+ *   order of the view ids.
+ * \param mode Defines how to treat vertices with degree less than
+ *   two. \c IGRAPH_TRANSITIVITY_NAN returns \c NaN for these
+ *   vertices, \c IGRAPH_TRANSITIVITY_ZERO returns zero.
+ * \return Error code, \c IGRAPH_EINVAL if the graph is directed or
+ *   the induced subgraph is not simple.
+ *
+ * Time complexity: O(|S|*d^2), |S| is the number of selected vertices,
+ * d is their maximum degree in the parent graph.
+ */
+
+int igraph_subgraph_view_transitivity_local(const igraph_subgraph_view_t *view,
+        igraph_vector_t *res,
+        igraph_transitivity_mode_t mode) {
+    igraph_vector_t degree;
+    long int v, no_of_nodes = igraph_subgraph_view_vcount(view);
+    igraph_bool_t simple;
+
+    if (igraph_is_directed(view->graph)) {
+        IGRAPH_ERROR("Transitivity works on undirected graphs only", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, 0);
+    IGRAPH_CHECK(igraph_i_subgraph_view_triangles(view, res, &degree, &simple));
+    if (!simple) {
+        IGRAPH_ERROR("Transitivity works on simple graphs only", IGRAPH_EINVAL);
+    }
+
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_real_t d = VECTOR(degree)[v];
+        if (d < 2) {
+            VECTOR(*res)[v] = mode == IGRAPH_TRANSITIVITY_ZERO ? 0 : IGRAPH_NAN;
+        } else {
+            VECTOR(*res)[v] /= d * (d - 1);
+        }
+    }
+
+    igraph_vector_destroy(&degree);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
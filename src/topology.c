@@ -2753,6 +2753,11 @@ int igraph_get_subisomorphisms_vf2(const igraph_t *graph1,
  * its vertices according to the specified mapping. Call this function
  * with the output of \ref igraph_canonical_permutation() to create
  * the canonical form of a graph.
+ *
+ * </para><para>
+ * Edge ids are not changed. Edges and vertices marked for deletion by
+ * \ref igraph_delete_edges_deferred() or \ref
+ * igraph_delete_vertices_deferred() are marked in the new graph as well.
  * \param graph The input graph.
  * \param res Pointer to an uninitialized graph object. The new graph
  *    is created here.
@@ -2788,6 +2793,24 @@ int igraph_permute_vertices(const igraph_t *graph, igraph_t *res,
     IGRAPH_CHECK(igraph_create(res, &edges, (igraph_integer_t) no_of_nodes,
                                igraph_is_directed(graph)));
 
+    /* Edges and vertices marked as deleted stay marked */
+    if (igraph_deleted_ecount(graph) > 0 || igraph_deleted_vcount(graph) > 0) {
+        igraph_vector_clear(&edges);
+        for (i = 0; i < no_of_nodes; i++) {
+            if (igraph_is_vertex_deleted(graph, (igraph_integer_t) i)) {
+                IGRAPH_CHECK(igraph_vector_push_back(&edges, VECTOR(*permutation)[i]));
+            }
+        }
+        IGRAPH_CHECK(igraph_delete_vertices_deferred(res, igraph_vss_vector(&edges), 1));
+        igraph_vector_clear(&edges);
+        for (i = 0; i < no_of_edges; i++) {
+            if (igraph_is_edge_deleted(graph, (igraph_integer_t) i)) {
+                IGRAPH_CHECK(igraph_vector_push_back(&edges, i));
+            }
+        }
+        IGRAPH_CHECK(igraph_delete_edges_deferred(res, igraph_ess_vector(&edges), 1));
+    }
+
     /* Attributes */
     if (graph->attr) {
         igraph_vector_t index;
@@ -823,9 +823,9 @@ int igraph_transitivity_barrat4(const igraph_t *graph,
     long int no_of_edges = igraph_ecount(graph);
     igraph_vector_t order, degree, rank;
     long int maxdegree;
-    igraph_inclist_t incident;
+    igraph_weighted_adjlist_t incident;
     igraph_vector_long_t neis;
-    igraph_vector_int_t *adj1, *adj2;
+    igraph_weighted_adjlist_entry_t *adj1, *adj2;
     igraph_vector_t actw;
     long int i, nn;
 
@@ -854,8 +854,8 @@ int igraph_transitivity_barrat4(const igraph_t *graph,
         VECTOR(rank)[ (long int)VECTOR(order)[i] ] = no_of_nodes - i - 1;
     }
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incident, IGRAPH_ALL));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &incident);
+    IGRAPH_CHECK(igraph_weighted_adjlist_init(graph, &incident, IGRAPH_ALL, weights));
+    IGRAPH_FINALLY(igraph_weighted_adjlist_destroy, &incident);
 
     IGRAPH_CHECK(igraph_vector_long_init(&neis, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_long_destroy, &neis);
@@ -872,29 +872,26 @@ int igraph_transitivity_barrat4(const igraph_t *graph,
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        adj1 = igraph_inclist_get(&incident, node);
-        adjlen1 = igraph_vector_int_size(adj1);
+        adj1 = igraph_weighted_adjlist_get(&incident, node);
+        adjlen1 = igraph_weighted_adjlist_size(&incident, node);
         triples = VECTOR(degree)[node] * (adjlen1 - 1) / 2.0;
         /* Mark the neighbors of the node */
         for (i = 0; i < adjlen1; i++) {
-            long int edge = (long int) VECTOR(*adj1)[i];
-            long int nei = IGRAPH_OTHER(graph, edge, node);
+            long int nei = adj1[i].nei;
             VECTOR(neis)[nei] = node + 1;
-            VECTOR(actw)[nei] = VECTOR(*weights)[edge];
+            VECTOR(actw)[nei] = adj1[i].weight;
         }
 
         for (i = 0; i < adjlen1; i++) {
-            long int edge1 = (long int) VECTOR(*adj1)[i];
-            igraph_real_t weight1 = VECTOR(*weights)[edge1];
-            long int nei = IGRAPH_OTHER(graph, edge1, node);
+            igraph_real_t weight1 = adj1[i].weight;
+            long int nei = adj1[i].nei;
             long int j;
             if (VECTOR(rank)[nei] > VECTOR(rank)[node]) {
-                adj2 = igraph_inclist_get(&incident, nei);
-                adjlen2 = igraph_vector_int_size(adj2);
+                adj2 = igraph_weighted_adjlist_get(&incident, nei);
+                adjlen2 = igraph_weighted_adjlist_size(&incident, nei);
                 for (j = 0; j < adjlen2; j++) {
-                    long int edge2 = (long int) VECTOR(*adj2)[j];
-                    igraph_real_t weight2 = VECTOR(*weights)[edge2];
-                    long int nei2 = IGRAPH_OTHER(graph, edge2, nei);
+                    igraph_real_t weight2 = adj2[j].weight;
+                    long int nei2 = adj2[j].nei;
                     if (VECTOR(rank)[nei2] < VECTOR(rank)[nei]) {
                         continue;
                     }
@@ -916,7 +913,7 @@ int igraph_transitivity_barrat4(const igraph_t *graph,
 
     igraph_vector_destroy(&actw);
     igraph_vector_long_destroy(&neis);
-    igraph_inclist_destroy(&incident);
+    igraph_weighted_adjlist_destroy(&incident);
     igraph_vector_destroy(&rank);
     igraph_vector_destroy(&degree);
     igraph_vector_destroy(&order);
@@ -25,13 +25,45 @@
 #include "igraph_interface.h"
 #include "igraph_attributes.h"
 #include "igraph_memory.h"
+#include "igraph_qsort.h"
+#include "igraph_types_internal.h"
+#include "igraph_atomic_internal.h"
 #include "config.h"
 
 /* Internal functions */
 
 static int igraph_i_create_start(
-        igraph_vector_t *res, igraph_vector_t *el,
-        igraph_vector_t *index, igraph_integer_t nodes);
+        igraph_vector_int_t *res, igraph_vector_int_t *el,
+        igraph_vector_int_t *index, igraph_integer_t nodes);
+static int igraph_i_add_edges_merge(igraph_t *graph,
+                                    const igraph_vector_t *edges,
+                                    void *attr);
+static int igraph_i_deleted_copy(igraph_t *to, const igraph_t *from);
+static void igraph_i_deleted_destroy(igraph_t *graph);
+static int igraph_i_deleted_reserve_edges(igraph_t *graph,
+        const igraph_vector_t *edges);
+static void igraph_i_deleted_add_edges(igraph_t *graph);
+static int igraph_i_unshare(igraph_t *graph);
+static void igraph_i_index_destroy(igraph_t *graph);
+
+/* Whether edge 'e' was deleted by igraph_delete_edges_deferred() or
+   igraph_delete_vertices_deferred(), and it is still in the graph */
+#define IGRAPH_I_DELETED(graph,e) \
+    ((graph)->deleted && VECTOR((graph)->deleted->edges)[(long int)(e)])
+
+/* Graphs read by igraph_read_graph_snapshot() are read-only */
+#define IGRAPH_I_CHECK_WRITABLE(graph) \
+    do { \
+        if ((graph)->snapshot) { \
+            IGRAPH_ERROR("Cannot modify a read-only graph snapshot, copy it first", \
+                         IGRAPH_EINVAL); \
+        } \
+    } while (0)
+
+/* igraph_add_edges() merges the new edges into the existing index
+   instead of rebuilding it, if there are at least this many times
+   more edges in the graph than the number of edges to add. */
+#define IGRAPH_I_ADD_EDGES_MERGE_RATIO 4
 
 /**
  * \section about_basic_interface
@@ -123,16 +155,21 @@ int igraph_empty_attrs(igraph_t *graph, igraph_integer_t n, igraph_bool_t direct
 
     graph->n = 0;
     graph->directed = directed;
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->from, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->to, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->oi, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->ii, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->os, 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->is, 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->from, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->to, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->oi, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->ii, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->os, 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->is, 1);
 
     VECTOR(graph->os)[0] = 0;
     VECTOR(graph->is)[0] = 0;
 
+    graph->deleted = 0;
+    graph->snapshot = 0;
+    graph->shared = 0;
+    graph->adjindex = 0;
+
     /* init attributes */
     graph->attr = 0;
     IGRAPH_CHECK(igraph_i_attribute_init(graph, attr));
@@ -163,24 +200,43 @@ int igraph_empty_attrs(igraph_t *graph, igraph_integer_t n, igraph_bool_t direct
 void igraph_destroy(igraph_t *graph) {
 
     IGRAPH_I_ATTRIBUTE_DESTROY(graph);
+    igraph_adjacency_index_destroy(graph);
+
+    if (graph->snapshot) {
+        /* the vectors are views into the mapping */
+        igraph_i_snapshot_destroy(graph);
+        return;
+    }
 
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
-    igraph_vector_destroy(&graph->os);
-    igraph_vector_destroy(&graph->is);
+    igraph_i_index_destroy(graph);
+    igraph_i_deleted_destroy(graph);
 }
 
 /**
  * \ingroup interface
  * \function igraph_copy
- * \brief Creates an exact (deep) copy of a graph.
+ * \brief Creates an exact copy of a graph.
  *
  * </para><para>
- * This function deeply copies a graph object to create an exact
- * replica of it. The new replica should be destroyed by calling
- * \ref igraph_destroy() on it when not needed any more.
+ * This function copies a graph object to create an exact replica of
+ * it. The new replica should be destroyed by calling \ref
+ * igraph_destroy() on it when not needed any more.
+ *
+ * </para><para>
+ * The copy is cheap: the copy and the original graph share the edge
+ * index and, if the C attribute handler is used, the attribute
+ * tables. Whichever graph is modified first gets its own copy of
+ * the shared data at that point, so the two graphs behave exactly
+ * like independent deep copies. Marks of deleted edges and vertices,
+ * see \ref igraph_delete_edges_deferred(), are always copied. The
+ * shared data is reference counted atomically, so graphs that share
+ * it can be copied, modified and destroyed in different threads; a
+ * single graph must still not be modified while it is read or copied.
+ *
+ * </para><para>
+ * The copy of a read-only snapshot, see \ref
+ * igraph_read_graph_snapshot(), is an ordinary graph that can be
+ * modified.
  *
  * </para><para>
  * You can also create a shallow copy of a graph by simply using the
@@ -188,12 +244,16 @@ void igraph_destroy(igraph_t *graph) {
  * destroy a shallow replica. To avoid this mistake, creating shallow
  * copies is not recommended.
  * \param to Pointer to an uninitialized graph object.
- * \param from Pointer to the graph object to copy.
+ * \param from Pointer to the graph object to copy. Its value is not
+ *    changed, but the reference count of its edge index is, so it
+ *    must not point to read-only memory.
  * \return Error code.
  *
- * Time complexity:  O(|V|+|E|) for a
- * graph with |V| vertices and
- * |E| edges.
+ * Time complexity: O(1), plus O(|V|+|E|) for copying the deletion
+ * marks of a graph with deleted vertices or edges, and for copying a
+ * read-only snapshot, |V| and |E| are the number of vertices and
+ * edges. The first modification of either graph takes O(|V|+|E|)
+ * time for copying the shared data.
  *
  * \example examples/simple/igraph_copy.c
  */
@@ -201,22 +261,64 @@ void igraph_destroy(igraph_t *graph) {
 int igraph_copy(igraph_t *to, const igraph_t *from) {
     to->n = from->n;
     to->directed = from->directed;
-    IGRAPH_CHECK(igraph_vector_copy(&to->from, &from->from));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->from);
-    IGRAPH_CHECK(igraph_vector_copy(&to->to, &from->to));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->to);
-    IGRAPH_CHECK(igraph_vector_copy(&to->oi, &from->oi));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->oi);
-    IGRAPH_CHECK(igraph_vector_copy(&to->ii, &from->ii));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->ii);
-    IGRAPH_CHECK(igraph_vector_copy(&to->os, &from->os));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->os);
-    IGRAPH_CHECK(igraph_vector_copy(&to->is, &from->is));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->is);
+    to->snapshot = 0;
+    to->shared = 0;
+    to->adjindex = 0;
+
+    if (!from->snapshot) {
+        if (!from->shared) {
+            /* The shared pointer and its reference count are mutable
+               bookkeeping, they are not part of the graph's value, so
+               they are set even though 'from' is const. Another
+               thread may be copying the same graph, hence the atomic
+               update. */
+            igraph_t *mutable_from = (igraph_t *) from;
+            igraph_i_shared_t *shared = igraph_Calloc(1, igraph_i_shared_t);
+            if (shared == 0) {
+                IGRAPH_ERROR("Cannot copy graph", IGRAPH_ENOMEM);
+            }
+            shared->refcount = 1;
+            if (!IGRAPH_I_ATOMIC_SET_PTR(mutable_from->shared, shared)) {
+                igraph_Free(shared);
+            }
+        }
+        to->from = from->from;
+        to->to = from->to;
+        to->oi = from->oi;
+        to->ii = from->ii;
+        to->os = from->os;
+        to->is = from->is;
+        to->shared = from->shared;
+        IGRAPH_I_ATOMIC_INC(to->shared->refcount);
+        IGRAPH_FINALLY(igraph_i_index_destroy, to);
+        IGRAPH_CHECK(igraph_i_deleted_copy(to, from));
+        IGRAPH_FINALLY(igraph_i_deleted_destroy, to);
+
+        IGRAPH_I_ATTRIBUTE_COPY(to, from, 1, 1, 1); /* does IGRAPH_CHECK */
+
+        IGRAPH_FINALLY_CLEAN(2);
+        return 0;
+    }
+
+    /* The copy of a snapshot is an ordinary graph */
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->from, &from->from));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->from);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->to, &from->to));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->to);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->oi, &from->oi));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->oi);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->ii, &from->ii));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->ii);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->os, &from->os));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->os);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->is, &from->is));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->is);
+    IGRAPH_CHECK(igraph_i_deleted_copy(to, from));
+    IGRAPH_FINALLY(igraph_i_deleted_destroy, to);
 
     IGRAPH_I_ATTRIBUTE_COPY(to, from, 1, 1, 1); /* does IGRAPH_CHECK */
 
-    IGRAPH_FINALLY_CLEAN(6);
+    IGRAPH_FINALLY_CLEAN(7);
     return 0;
 }
 
@@ -245,41 +347,62 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
  * This function invalidates all iterators.
  *
  * </para><para>
+ * If only a few edges are added to a large graph, then the new edges
+ * are sorted and merged into the existing index, instead of
+ * rebuilding the whole index. In this case only the part of the index
+ * that comes after the smallest vertex id of the new edges needs to
+ * be updated. This makes adding many small batches of edges to a
+ * large graph much faster.
+ *
+ * </para><para>
  * Time complexity: O(|V|+|E|) where
  * |V| is the number of vertices and
  * |E| is the number of
- * edges in the \em new, extended graph.
+ * edges in the \em new, extended graph. If the number of new edges,
+ * k, is small compared to |E|, then it is O(k log(k) + |V'| + |E'|),
+ * where |V'| and |E'| are the number of vertices and edges that
+ * come after the smallest endpoint of the new edges in the index.
  *
  * \example examples/simple/igraph_add_edges.c
  */
 int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
                      void *attr) {
-    long int no_of_edges = igraph_vector_size(&graph->from);
+    long int no_of_edges = igraph_vector_int_size(&graph->from);
     long int edges_to_add = igraph_vector_size(edges) / 2;
     long int i = 0;
     igraph_error_handler_t *oldhandler;
     int ret1, ret2;
-    igraph_vector_t newoi, newii;
+    igraph_vector_int_t newoi, newii;
     igraph_bool_t directed = igraph_is_directed(graph);
 
+    IGRAPH_I_CHECK_WRITABLE(graph);
     if (igraph_vector_size(edges) % 2 != 0) {
         IGRAPH_ERROR("invalid (odd) length of edges vector", IGRAPH_EINVEVECTOR);
     }
     if (!igraph_vector_isininterval(edges, 0, igraph_vcount(graph) - 1)) {
         IGRAPH_ERROR("cannot add edges", IGRAPH_EINVVID);
     }
+    IGRAPH_CHECK(igraph_i_unshare(graph));
+    igraph_adjacency_index_destroy(graph);
+
+    IGRAPH_CHECK(igraph_i_deleted_reserve_edges(graph, edges));
+
+    if (edges_to_add > 0 &&
+        edges_to_add * IGRAPH_I_ADD_EDGES_MERGE_RATIO <= no_of_edges) {
+        return igraph_i_add_edges_merge(graph, edges, attr);
+    }
 
     /* from & to */
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->from, no_of_edges + edges_to_add));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->to, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->from, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->to, no_of_edges + edges_to_add));
 
     while (i < edges_to_add * 2) {
         if (directed || VECTOR(*edges)[i] > VECTOR(*edges)[i + 1]) {
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
         } else {
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
         }
     }
 
@@ -287,21 +410,21 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     oldhandler = igraph_set_error_handler(igraph_error_handler_ignore);
 
     /* oi & ii */
-    ret1 = igraph_vector_init(&newoi, no_of_edges);
-    ret2 = igraph_vector_init(&newii, no_of_edges);
+    ret1 = igraph_vector_int_init(&newoi, no_of_edges);
+    ret2 = igraph_vector_int_init(&newii, no_of_edges);
     if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges); /* gets smaller */
-        igraph_vector_resize(&graph->to, no_of_edges);   /* gets smaller */
+        igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+        igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
         igraph_set_error_handler(oldhandler);
         IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
     }
-    ret1 = igraph_vector_order(&graph->from, &graph->to, &newoi, graph->n);
-    ret2 = igraph_vector_order(&graph->to, &graph->from, &newii, graph->n);
+    ret1 = igraph_vector_int_order(&graph->from, &graph->to, &newoi, graph->n);
+    ret2 = igraph_vector_int_order(&graph->to, &graph->from, &newii, graph->n);
     if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges);
-        igraph_vector_resize(&graph->to, no_of_edges);
-        igraph_vector_destroy(&newoi);
-        igraph_vector_destroy(&newii);
+        igraph_vector_int_resize(&graph->from, no_of_edges);
+        igraph_vector_int_resize(&graph->to, no_of_edges);
+        igraph_vector_int_destroy(&newoi);
+        igraph_vector_int_destroy(&newii);
         igraph_set_error_handler(oldhandler);
         IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
     }
@@ -312,10 +435,10 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
         ret1 = igraph_i_attribute_add_edges(graph, edges, attr);
         igraph_set_error_handler(igraph_error_handler_ignore);
         if (ret1 != 0) {
-            igraph_vector_resize(&graph->from, no_of_edges);
-            igraph_vector_resize(&graph->to, no_of_edges);
-            igraph_vector_destroy(&newoi);
-            igraph_vector_destroy(&newii);
+            igraph_vector_int_resize(&graph->from, no_of_edges);
+            igraph_vector_int_resize(&graph->to, no_of_edges);
+            igraph_vector_int_destroy(&newoi);
+            igraph_vector_int_destroy(&newii);
             igraph_set_error_handler(oldhandler);
             IGRAPH_ERROR("cannot add edges", ret1);
         }
@@ -326,15 +449,164 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     igraph_i_create_start(&graph->is, &graph->to, &newii, graph->n);
 
     /* everything went fine  */
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
+    igraph_vector_int_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->ii);
     graph->oi = newoi;
     graph->ii = newii;
+    igraph_i_deleted_add_edges(graph);
     igraph_set_error_handler(oldhandler);
 
     return 0;
 }
 
+/* Compares two edges by their endpoints, first by 'keys[0]', then
+   by 'keys[1]'. Edges with the same endpoints are in decreasing
+   order of their ids, this is the same order as the one created by
+   igraph_vector_int_order(). */
+
+static int igraph_i_edge_cmp(void *extra, const void *a, const void *b) {
+    igraph_vector_int_t **keys = (igraph_vector_int_t **) extra;
+    int e1 = *(const int *) a, e2 = *(const int *) b;
+    int k1 = VECTOR(*keys[0])[e1], k2 = VECTOR(*keys[0])[e2];
+    if (k1 != k2) {
+        return k1 < k2 ? -1 : 1;
+    }
+    k1 = VECTOR(*keys[1])[e1]; k2 = VECTOR(*keys[1])[e2];
+    if (k1 != k2) {
+        return k1 < k2 ? -1 : 1;
+    }
+    return e1 < e2 ? 1 : (e1 > e2 ? -1 : 0);
+}
+
+/* Merges the sorted 'batch' of new edges into 'iindex'. All new edges
+   have larger ids than the old ones, so they come first among edges
+   with the same endpoints. The merge goes backwards, and stops as soon
+   as all new edges are placed, so the beginning of the index before
+   the first new edge is not touched. 'iindex' must have enough
+   storage reserved. */
+
+static void igraph_i_merge_index(igraph_vector_int_t *iindex,
+                                 const igraph_vector_int_t *batch,
+                                 const igraph_vector_int_t *el,
+                                 const igraph_vector_int_t *el2) {
+
+    long int i = igraph_vector_int_size(iindex) - 1;
+    long int j = igraph_vector_int_size(batch) - 1;
+    long int w = i + j + 1;
+
+    igraph_vector_int_resize(iindex, w + 1); /* reserved */
+
+    while (j >= 0) {
+        int enew = VECTOR(*batch)[j];
+        int eold = i >= 0 ? VECTOR(*iindex)[i] : -1;
+        if (eold >= 0 &&
+            (VECTOR(*el)[eold] > VECTOR(*el)[enew] ||
+             (VECTOR(*el)[eold] == VECTOR(*el)[enew] &&
+              VECTOR(*el2)[eold] >= VECTOR(*el2)[enew]))) {
+            VECTOR(*iindex)[w--] = eold;
+            i--;
+        } else {
+            VECTOR(*iindex)[w--] = enew;
+            j--;
+        }
+    }
+}
+
+/* Updates a start vector ('os' or 'is') after the sorted 'batch' of
+   edges was added to the graph. Only the entries after the smallest
+   endpoint of the new edges change. */
+
+static void igraph_i_update_start(igraph_vector_int_t *res,
+                                  const igraph_vector_int_t *el,
+                                  const igraph_vector_int_t *batch,
+                                  igraph_integer_t nodes) {
+
+    long int k = igraph_vector_int_size(batch);
+    long int p = 0, v;
+
+    if (k == 0) {
+        return;
+    }
+
+    for (v = VECTOR(*el)[ VECTOR(*batch)[0] ] + 1; v <= nodes; v++) {
+        while (p < k && VECTOR(*el)[ VECTOR(*batch)[p] ] < v) {
+            p++;
+        }
+        VECTOR(*res)[v] += p;
+    }
+}
+
+/* Adds edges by sorting only the new edges, and merging them into the
+   existing index. This is used by igraph_add_edges() if the number of
+   new edges is small compared to the size of the graph. */
+
+static int igraph_i_add_edges_merge(igraph_t *graph,
+                                    const igraph_vector_t *edges,
+                                    void *attr) {
+
+    long int no_of_edges = igraph_vector_int_size(&graph->from);
+    long int edges_to_add = igraph_vector_size(edges) / 2;
+    long int i;
+    igraph_bool_t directed = igraph_is_directed(graph);
+    igraph_vector_int_t batch_out, batch_in;
+    igraph_vector_int_t *keys[2];
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&batch_out, edges_to_add);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&batch_in, edges_to_add);
+
+    /* Reserve everything first, so that the graph is not modified
+       if we run out of memory */
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->from, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->to, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->oi, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->ii, no_of_edges + edges_to_add));
+
+    /* from & to */
+    for (i = 0; i < edges_to_add; i++) {
+        long int v1 = (long int) VECTOR(*edges)[2 * i];
+        long int v2 = (long int) VECTOR(*edges)[2 * i + 1];
+        if (directed || v1 > v2) {
+            igraph_vector_int_push_back(&graph->from, (int) v1); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   (int) v2); /* reserved */
+        } else {
+            igraph_vector_int_push_back(&graph->to,   (int) v1); /* reserved */
+            igraph_vector_int_push_back(&graph->from, (int) v2); /* reserved */
+        }
+        VECTOR(batch_out)[i] = VECTOR(batch_in)[i] = (int) (no_of_edges + i);
+    }
+
+    /* Attributes */
+    if (graph->attr) {
+        int ret = igraph_i_attribute_add_edges(graph, edges, attr);
+        if (ret != 0) {
+            igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+            igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
+            IGRAPH_ERROR("cannot add edges", ret);
+        }
+    }
+
+    /* Sort the new edges only, then merge them into oi & ii,
+       no memory is needed for this */
+    keys[0] = &graph->from; keys[1] = &graph->to;
+    igraph_qsort_r(VECTOR(batch_out), (size_t) edges_to_add,
+                   sizeof(VECTOR(batch_out)[0]), keys, igraph_i_edge_cmp);
+    keys[0] = &graph->to; keys[1] = &graph->from;
+    igraph_qsort_r(VECTOR(batch_in), (size_t) edges_to_add,
+                   sizeof(VECTOR(batch_in)[0]), keys, igraph_i_edge_cmp);
+
+    igraph_i_merge_index(&graph->oi, &batch_out, &graph->from, &graph->to);
+    igraph_i_merge_index(&graph->ii, &batch_in, &graph->to, &graph->from);
+    igraph_i_update_start(&graph->os, &graph->from, &batch_out, graph->n);
+    igraph_i_update_start(&graph->is, &graph->to, &batch_in, graph->n);
+    igraph_i_deleted_add_edges(graph);
+
+    igraph_vector_int_destroy(&batch_in);
+    igraph_vector_int_destroy(&batch_out);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
 /**
  * \ingroup interface
  * \function igraph_add_vertices
@@ -362,15 +634,26 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
     long int ec = igraph_ecount(graph);
     long int i;
 
+    IGRAPH_I_CHECK_WRITABLE(graph);
     if (nv < 0) {
         IGRAPH_ERROR("cannot add negative number of vertices", IGRAPH_EINVAL);
     }
+    IGRAPH_CHECK(igraph_i_unshare(graph));
+    igraph_adjacency_index_destroy(graph);
+
+    if (graph->deleted) {
+        IGRAPH_CHECK(igraph_vector_char_resize(&graph->deleted->vertices,
+                                               graph->n + nv));
+        for (i = graph->n; i < graph->n + nv; i++) {
+            VECTOR(graph->deleted->vertices)[i] = 0;
+        }
+    }
 
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->os, graph->n + nv + 1));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->is, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->os, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->is, graph->n + nv + 1));
 
-    igraph_vector_resize(&graph->os, graph->n + nv + 1); /* reserved */
-    igraph_vector_resize(&graph->is, graph->n + nv + 1); /* reserved */
+    igraph_vector_int_resize(&graph->os, graph->n + nv + 1); /* reserved */
+    igraph_vector_int_resize(&graph->is, graph->n + nv + 1); /* reserved */
     for (i = graph->n + 1; i < graph->n + nv + 1; i++) {
         VECTOR(graph->os)[i] = ec;
         VECTOR(graph->is)[i] = ec;
@@ -417,19 +700,24 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     long int remaining_edges;
     igraph_eit_t eit;
 
-    igraph_vector_t newfrom, newto, newoi;
+    igraph_vector_int_t newfrom, newto, newoi;
 
     int *mark;
     long int i, j;
 
+    IGRAPH_I_CHECK_WRITABLE(graph);
+
     mark = igraph_Calloc(no_of_edges, int);
     if (mark == 0) {
         IGRAPH_ERROR("Cannot delete edges", IGRAPH_ENOMEM);
     }
     IGRAPH_FINALLY(igraph_free, mark);
 
+    /* the edge ids are checked before the graph is changed */
     IGRAPH_CHECK(igraph_eit_create(graph, edges, &eit));
     IGRAPH_FINALLY(igraph_eit_destroy, &eit);
+    IGRAPH_CHECK(igraph_i_unshare(graph));
+    igraph_adjacency_index_destroy(graph);
 
     for (IGRAPH_EIT_RESET(eit); !IGRAPH_EIT_END(eit); IGRAPH_EIT_NEXT(eit)) {
         long int e = IGRAPH_EIT_GET(eit);
@@ -438,14 +726,23 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
             mark[e]++;
         }
     }
+    /* Edges deleted by igraph_delete_edges_deferred() go as well */
+    if (graph->deleted) {
+        for (i = 0; i < no_of_edges; i++) {
+            if (VECTOR(graph->deleted->edges)[i] && mark[i] == 0) {
+                edges_to_remove++;
+                mark[i]++;
+            }
+        }
+    }
     remaining_edges = no_of_edges - edges_to_remove;
 
     /* We don't need the iterator any more */
     igraph_eit_destroy(&eit);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&newfrom, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newto, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newfrom, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newto, remaining_edges);
 
     /* Actually remove the edges, move from pos i to pos j in newfrom/newto */
     for (i = 0, j = 0; j < remaining_edges; i++) {
@@ -457,9 +754,9 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     }
 
     /* Create index, this might require additional memory */
-    IGRAPH_VECTOR_INIT_FINALLY(&newoi, remaining_edges);
-    IGRAPH_CHECK(igraph_vector_order(&newfrom, &newto, &newoi, no_of_nodes));
-    IGRAPH_CHECK(igraph_vector_order(&newto, &newfrom, &graph->ii, no_of_nodes));
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newoi, remaining_edges);
+    IGRAPH_CHECK(igraph_vector_int_order(&newfrom, &newto, &newoi, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_order(&newto, &newfrom, &graph->ii, no_of_nodes));
 
     /* Edge attributes, we need an index that gives the ids of the
        original edges for every new edge.
@@ -478,9 +775,9 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     }
 
     /* Ok, we've all memory needed, free the old structure  */
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->from);
+    igraph_vector_int_destroy(&graph->to);
+    igraph_vector_int_destroy(&graph->oi);
     graph->from = newfrom;
     graph->to = newto;
     graph->oi = newoi;
@@ -495,6 +792,17 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     igraph_i_create_start(&graph->is, &graph->to,   &graph->ii,
                           (igraph_integer_t) no_of_nodes);
 
+    /* No deleted edges are left, only deleted vertices, maybe */
+    if (graph->deleted) {
+        if (graph->deleted->vcount == 0) {
+            igraph_i_deleted_destroy(graph);
+        } else {
+            igraph_vector_char_resize(&graph->deleted->edges, remaining_edges);
+            igraph_vector_char_null(&graph->deleted->edges);
+            graph->deleted->ecount = 0;
+        }
+    }
+
     /* Nothing to deallocate... */
     return 0;
 }
@@ -543,6 +851,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     long int i, j;
     long int remaining_vertices, remaining_edges;
 
+    IGRAPH_I_CHECK_WRITABLE(graph);
+
     if (idx) {
         my_vertex_recoding = idx;
         IGRAPH_CHECK(igraph_vector_resize(idx, no_of_nodes));
@@ -564,6 +874,14 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
         }
         VECTOR(*my_vertex_recoding)[vertex] = 1;
     }
+    /* vertices deleted by igraph_delete_vertices_deferred() go as well */
+    if (graph->deleted) {
+        for (i = 0; i < no_of_nodes; i++) {
+            if (VECTOR(graph->deleted->vertices)[i]) {
+                VECTOR(*my_vertex_recoding)[i] = 1;
+            }
+        }
+    }
     /* create vertex recoding vector */
     for (remaining_vertices = 0, i = 0; i < no_of_nodes; i++) {
         if (VECTOR(*my_vertex_recoding)[i] == 0) {
@@ -578,7 +896,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
         long int from = (long int) VECTOR(graph->from)[i];
         long int to = (long int) VECTOR(graph->to)[i];
         if (VECTOR(*my_vertex_recoding)[from] != 0 &&
-            VECTOR(*my_vertex_recoding)[to  ] != 0) {
+            VECTOR(*my_vertex_recoding)[to  ] != 0 &&
+            !IGRAPH_I_DELETED(graph, i)) {
             VECTOR(edge_recoding)[i] = remaining_edges + 1;
             remaining_edges++;
         }
@@ -587,14 +906,18 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     /* start creating the graph */
     newgraph.n = (igraph_integer_t) remaining_vertices;
     newgraph.directed = graph->directed;
+    newgraph.deleted = 0;
+    newgraph.snapshot = 0;
+    newgraph.shared = 0;
+    newgraph.adjindex = 0;
 
     /* allocate vectors */
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.from, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.to, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.oi, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.ii, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.from, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.to, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.oi, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.ii, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
 
     /* Add the edges */
     for (i = 0, j = 0; j < remaining_edges; i++) {
@@ -607,10 +930,10 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
         }
     }
     /* update oi & ii */
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.from, &newgraph.to, &newgraph.oi,
-                                     remaining_vertices));
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.to, &newgraph.from, &newgraph.ii,
-                                     remaining_vertices));
+    IGRAPH_CHECK(igraph_vector_int_order(&newgraph.from, &newgraph.to, &newgraph.oi,
+                                         remaining_vertices));
+    IGRAPH_CHECK(igraph_vector_int_order(&newgraph.to, &newgraph.from, &newgraph.ii,
+                                         remaining_vertices));
 
     IGRAPH_CHECK(igraph_i_create_start(&newgraph.os, &newgraph.from,
                                        &newgraph.oi, (igraph_integer_t)
@@ -675,6 +998,403 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     return 0;
 }
 
+/* Frees the edge index, unless it is still used by copies of the
+   graph */
+
+static void igraph_i_index_destroy(igraph_t *graph) {
+    if (graph->shared) {
+        if (IGRAPH_I_ATOMIC_DEC(graph->shared->refcount) > 0) {
+            graph->shared = 0;
+            return;
+        }
+        igraph_Free(graph->shared);
+    }
+    igraph_vector_int_destroy(&graph->from);
+    igraph_vector_int_destroy(&graph->to);
+    igraph_vector_int_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->ii);
+    igraph_vector_int_destroy(&graph->os);
+    igraph_vector_int_destroy(&graph->is);
+}
+
+/* Gives the graph its own copy of the edge index, if it is shared
+   with copies of the graph. This must be called before modifying
+   the index. */
+
+static int igraph_i_unshare(igraph_t *graph) {
+    igraph_vector_int_t from, to, oi, ii, os, is;
+
+    if (!graph->shared) {
+        return 0;
+    }
+    if (IGRAPH_I_ATOMIC_GET(graph->shared->refcount) == 1) {
+        /* the copies are gone already */
+        igraph_Free(graph->shared);
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_copy(&from, &graph->from));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &from);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to, &graph->to));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to);
+    IGRAPH_CHECK(igraph_vector_int_copy(&oi, &graph->oi));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &oi);
+    IGRAPH_CHECK(igraph_vector_int_copy(&ii, &graph->ii));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ii);
+    IGRAPH_CHECK(igraph_vector_int_copy(&os, &graph->os));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &os);
+    IGRAPH_CHECK(igraph_vector_int_copy(&is, &graph->is));
+    IGRAPH_FINALLY_CLEAN(5);
+
+    /* the copies may have been destroyed in the meantime, by other
+       threads */
+    igraph_i_index_destroy(graph);
+    graph->shared = 0;
+    graph->from = from;
+    graph->to = to;
+    graph->oi = oi;
+    graph->ii = ii;
+    graph->os = os;
+    graph->is = is;
+
+    return 0;
+}
+
+static void igraph_i_deleted_destroy(igraph_t *graph) {
+    if (graph->deleted) {
+        igraph_vector_char_destroy(&graph->deleted->edges);
+        igraph_vector_char_destroy(&graph->deleted->vertices);
+        igraph_Free(graph->deleted);
+    }
+}
+
+static int igraph_i_deleted_init(igraph_t *graph) {
+    igraph_i_deleted_t *deleted = igraph_Calloc(1, igraph_i_deleted_t);
+    if (deleted == 0) {
+        IGRAPH_ERROR("Cannot mark deleted elements", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, deleted);
+    IGRAPH_CHECK(igraph_vector_char_init(&deleted->edges, igraph_ecount(graph)));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &deleted->edges);
+    IGRAPH_CHECK(igraph_vector_char_init(&deleted->vertices, igraph_vcount(graph)));
+    IGRAPH_FINALLY_CLEAN(2);
+    graph->deleted = deleted;
+    return 0;
+}
+
+static int igraph_i_deleted_copy(igraph_t *to, const igraph_t *from) {
+    igraph_i_deleted_t *deleted;
+    to->deleted = 0;
+    if (!from->deleted) {
+        return 0;
+    }
+    deleted = igraph_Calloc(1, igraph_i_deleted_t);
+    if (deleted == 0) {
+        IGRAPH_ERROR("Cannot copy deleted elements", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, deleted);
+    IGRAPH_CHECK(igraph_vector_char_copy(&deleted->edges, &from->deleted->edges));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &deleted->edges);
+    IGRAPH_CHECK(igraph_vector_char_copy(&deleted->vertices,
+                                         &from->deleted->vertices));
+    IGRAPH_FINALLY_CLEAN(2);
+    deleted->ecount = from->deleted->ecount;
+    deleted->vcount = from->deleted->vcount;
+    to->deleted = deleted;
+    return 0;
+}
+
+/* Called before adding 'edges', it checks that they do not refer to
+   deleted vertices, and makes room for their marks, so that
+   igraph_i_deleted_add_edges() cannot fail. */
+
+static int igraph_i_deleted_reserve_edges(igraph_t *graph,
+        const igraph_vector_t *edges) {
+    long int i, n = igraph_vector_size(edges);
+    if (!graph->deleted) {
+        return 0;
+    }
+    if (graph->deleted->vcount > 0) {
+        for (i = 0; i < n; i++) {
+            if (VECTOR(graph->deleted->vertices)[(long int) VECTOR(*edges)[i]]) {
+                IGRAPH_ERROR("cannot add edges to deleted vertices", IGRAPH_EINVVID);
+            }
+        }
+    }
+    IGRAPH_CHECK(igraph_vector_char_reserve(&graph->deleted->edges,
+                                            igraph_ecount(graph) + n / 2));
+    return 0;
+}
+
+static void igraph_i_deleted_add_edges(igraph_t *graph) {
+    long int i, old;
+    if (!graph->deleted) {
+        return;
+    }
+    old = igraph_vector_char_size(&graph->deleted->edges);
+    igraph_vector_char_resize(&graph->deleted->edges, igraph_ecount(graph)); /* reserved */
+    for (i = old; i < igraph_ecount(graph); i++) {
+        VECTOR(graph->deleted->edges)[i] = 0;
+    }
+}
+
+/**
+ * \function igraph_delete_edges_deferred
+ * \brief Marks edges as deleted, without rebuilding the graph.
+ *
+ * </para><para>
+ * \ref igraph_delete_edges() rebuilds the edge index of the graph, so
+ * it always takes time proportional to the size of the graph, no
+ * matter how many edges are removed. This function only marks the
+ * edges as deleted, the marked edges are skipped by \ref
+ * igraph_neighbors(), \ref igraph_incident(), \ref igraph_degree(),
+ * \ref igraph_get_eid() and the related functions, and by the
+ * all-edges selector. The graph is compacted, i.e.
+ * the deleted edges are actually removed, when the fraction of
+ * deleted edges or vertices exceeds \p threshold, when
+ * \ref igraph_compact_deleted() is called, or when edges or vertices
+ * are removed with \ref igraph_delete_edges() or \ref
+ * igraph_delete_vertices().
+ *
+ * </para><para>
+ * Until the graph is compacted, the edge ids do not change, and
+ * \ref igraph_ecount() still counts the deleted edges, use \ref
+ * igraph_deleted_ecount() to query their number. Functions that
+ * loop over the edge ids themselves, instead of using the selectors,
+ * see the deleted edges; compact the graph before calling them.
+ *
+ * \param graph The graph to work on.
+ * \param edges The edges to delete. Edges that are already deleted
+ *        are ignored.
+ * \param threshold The graph is compacted if more than this fraction
+ *        of its edges (or vertices) are marked as deleted. Zero
+ *        means compacting immediately, one or larger means that
+ *        the graph is never compacted automatically.
+ * \return Error code.
+ *
+ * \sa \ref igraph_delete_vertices_deferred(), \ref
+ * igraph_compact_deleted().
+ *
+ * Time complexity: O(|Es|) if the graph is not compacted, |Es| is
+ * the number of edges to delete; O(|V|+|E|) otherwise, the number of
+ * vertices and edges in the graph.
+ */
+
+int igraph_delete_edges_deferred(igraph_t *graph, igraph_es_t edges,
+                                 igraph_real_t threshold) {
+    igraph_eit_t eit;
+
+    IGRAPH_I_CHECK_WRITABLE(graph);
+    if (threshold < 0) {
+        IGRAPH_ERROR("Negative threshold for deferred deletion", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_eit_create(graph, edges, &eit));
+    IGRAPH_FINALLY(igraph_eit_destroy, &eit);
+
+    if (!graph->deleted) {
+        IGRAPH_CHECK(igraph_i_deleted_init(graph));
+    }
+
+    for (IGRAPH_EIT_RESET(eit); !IGRAPH_EIT_END(eit); IGRAPH_EIT_NEXT(eit)) {
+        long int e = IGRAPH_EIT_GET(eit);
+        if (!VECTOR(graph->deleted->edges)[e]) {
+            VECTOR(graph->deleted->edges)[e] = 1;
+            graph->deleted->ecount++;
+        }
+    }
+
+    igraph_eit_destroy(&eit);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    if (graph->deleted->ecount > threshold * igraph_ecount(graph)) {
+        IGRAPH_CHECK(igraph_compact_deleted(graph, 0, 0));
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_delete_vertices_deferred
+ * \brief Marks vertices and their edges as deleted, without rebuilding the graph.
+ *
+ * </para><para>
+ * This is the vertex counterpart of \ref
+ * igraph_delete_edges_deferred(): the vertices and all their incident
+ * edges are marked as deleted, and they are removed from the graph
+ * at the next compaction. Until then the vertex ids do not change,
+ * \ref igraph_vcount() and the all-vertices selector still include
+ * the deleted vertices, and all functions see them as isolated
+ * vertices. No edges can be added to a deleted vertex.
+ *
+ * \param graph The graph to work on.
+ * \param vertices The vertices to delete. Vertices that are already
+ *        deleted are ignored.
+ * \param threshold The graph is compacted if more than this fraction
+ *        of its vertices (or edges) are marked as deleted, see
+ *        \ref igraph_delete_edges_deferred().
+ * \return Error code.
+ *
+ * \sa \ref igraph_compact_deleted() to find out the new vertex ids
+ * after compaction.
+ *
+ * Time complexity: O(|Vs|+|Es|) if the graph is not compacted, the
+ * number of vertices to delete and the number of their incident
+ * edges; O(|V|+|E|) otherwise.
+ */
+
+int igraph_delete_vertices_deferred(igraph_t *graph, igraph_vs_t vertices,
+                                    igraph_real_t threshold) {
+    igraph_vit_t vit;
+    long int i;
+
+    IGRAPH_I_CHECK_WRITABLE(graph);
+    if (threshold < 0) {
+        IGRAPH_ERROR("Negative threshold for deferred deletion", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_vit_create(graph, vertices, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+
+    if (!graph->deleted) {
+        IGRAPH_CHECK(igraph_i_deleted_init(graph));
+    }
+
+    for (IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit)) {
+        long int v = IGRAPH_VIT_GET(vit);
+        if (VECTOR(graph->deleted->vertices)[v]) {
+            continue;
+        }
+        VECTOR(graph->deleted->vertices)[v] = 1;
+        graph->deleted->vcount++;
+        for (i = VECTOR(graph->os)[v]; i < VECTOR(graph->os)[v + 1]; i++) {
+            long int e = VECTOR(graph->oi)[i];
+            if (!VECTOR(graph->deleted->edges)[e]) {
+                VECTOR(graph->deleted->edges)[e] = 1;
+                graph->deleted->ecount++;
+            }
+        }
+        for (i = VECTOR(graph->is)[v]; i < VECTOR(graph->is)[v + 1]; i++) {
+            long int e = VECTOR(graph->ii)[i];
+            if (!VECTOR(graph->deleted->edges)[e]) {
+                VECTOR(graph->deleted->edges)[e] = 1;
+                graph->deleted->ecount++;
+            }
+        }
+    }
+
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    if (graph->deleted->vcount > threshold * igraph_vcount(graph) ||
+        graph->deleted->ecount > threshold * igraph_ecount(graph)) {
+        IGRAPH_CHECK(igraph_compact_deleted(graph, 0, 0));
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_compact_deleted
+ * \brief Removes the vertices and edges marked as deleted.
+ *
+ * </para><para>
+ * Removes the vertices and edges marked by \ref
+ * igraph_delete_vertices_deferred() and \ref
+ * igraph_delete_edges_deferred() from the graph, and rebuilds its
+ * edge index. This changes the vertex and edge ids, and it
+ * invalidates all iterators.
+ *
+ * \param graph The graph to work on.
+ * \param idx If not a null pointer, the mapping from the old vertex
+ *        ids to the new ones is stored here, as in \ref
+ *        igraph_delete_vertices_idx(): the new id of vertex \c i is
+ *        <code>idx[i]-1</code>, or zero if it was removed.
+ * \param invidx If not a null pointer, the old id of every remaining
+ *        vertex is stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), the number of vertices and edges in
+ * the graph, or O(1) if there is nothing to remove and both \p idx
+ * and \p invidx are null pointers.
+ */
+
+int igraph_compact_deleted(igraph_t *graph, igraph_vector_t *idx,
+                           igraph_vector_t *invidx) {
+    if (!graph->deleted && !idx && !invidx) {
+        return 0;
+    }
+    return igraph_delete_vertices_idx(graph, igraph_vss_none(), idx, invidx);
+}
+
+/**
+ * \function igraph_deleted_ecount
+ * \brief The number of edges marked as deleted.
+ *
+ * \param graph The graph.
+ * \return The number of edges deleted by \ref
+ * igraph_delete_edges_deferred() or \ref
+ * igraph_delete_vertices_deferred(), and not yet removed from the
+ * graph.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_deleted_ecount(const igraph_t *graph) {
+    return graph->deleted ? graph->deleted->ecount : 0;
+}
+
+/**
+ * \function igraph_deleted_vcount
+ * \brief The number of vertices marked as deleted.
+ *
+ * \param graph The graph.
+ * \return The number of vertices deleted by \ref
+ * igraph_delete_vertices_deferred(), and not yet removed from the
+ * graph.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_deleted_vcount(const igraph_t *graph) {
+    return graph->deleted ? graph->deleted->vcount : 0;
+}
+
+/**
+ * \function igraph_is_edge_deleted
+ * \brief Whether an edge is marked as deleted.
+ *
+ * \param graph The graph.
+ * \param eid The edge id, it is not checked.
+ * \return True if the edge was deleted by \ref
+ * igraph_delete_edges_deferred() or \ref
+ * igraph_delete_vertices_deferred().
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_bool_t igraph_is_edge_deleted(const igraph_t *graph,
+                                     igraph_integer_t eid) {
+    return IGRAPH_I_DELETED(graph, eid) ? 1 : 0;
+}
+
+/**
+ * \function igraph_is_vertex_deleted
+ * \brief Whether a vertex is marked as deleted.
+ *
+ * \param graph The graph.
+ * \param vid The vertex id, it is not checked.
+ * \return True if the vertex was deleted by \ref
+ * igraph_delete_vertices_deferred().
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_bool_t igraph_is_vertex_deleted(const igraph_t *graph,
+                                       igraph_integer_t vid) {
+    return graph->deleted && VECTOR(graph->deleted->vertices)[(long int) vid];
+}
+
 /**
  * \ingroup interface
  * \function igraph_vcount
@@ -700,7 +1420,7 @@ igraph_integer_t igraph_vcount(const igraph_t *graph) {
  * Time complexity: O(1)
  */
 igraph_integer_t igraph_ecount(const igraph_t *graph) {
-    return (igraph_integer_t) igraph_vector_size(&graph->from);
+    return (igraph_integer_t) igraph_vector_int_size(&graph->from);
 }
 
 /**
@@ -771,6 +1491,9 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
         if (mode & IGRAPH_OUT) {
             j = (long int) VECTOR(graph->os)[node + 1];
             for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
+                if (IGRAPH_I_DELETED(graph, VECTOR(graph->oi)[i])) {
+                    continue;
+                }
                 VECTOR(*neis)[idx++] =
                     VECTOR(graph->to)[ (long int)VECTOR(graph->oi)[i] ];
             }
@@ -778,6 +1501,9 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
         if (mode & IGRAPH_IN) {
             j = (long int) VECTOR(graph->is)[node + 1];
             for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
+                if (IGRAPH_I_DELETED(graph, VECTOR(graph->ii)[i])) {
+                    continue;
+                }
                 VECTOR(*neis)[idx++] =
                     VECTOR(graph->from)[ (long int)VECTOR(graph->ii)[i] ];
             }
@@ -790,9 +1516,18 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
         long int i1 = (long int) VECTOR(graph->os)[node];
         long int i2 = (long int) VECTOR(graph->is)[node];
         while (i1 < jj1 && i2 < j2) {
-            long int n1 = (long int) VECTOR(graph->to)[
+            long int n1, n2;
+            if (IGRAPH_I_DELETED(graph, VECTOR(graph->oi)[i1])) {
+                i1++;
+                continue;
+            }
+            if (IGRAPH_I_DELETED(graph, VECTOR(graph->ii)[i2])) {
+                i2++;
+                continue;
+            }
+            n1 = (long int) VECTOR(graph->to)[
                    (long int)VECTOR(graph->oi)[i1] ];
-            long int n2 = (long int) VECTOR(graph->from)[
+            n2 = (long int) VECTOR(graph->from)[
                    (long int)VECTOR(graph->ii)[i2] ];
             if (n1 < n2) {
                 VECTOR(*neis)[idx++] = n1;
@@ -810,17 +1545,26 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
         while (i1 < jj1) {
             long int n1 = (long int) VECTOR(graph->to)[
                    (long int)VECTOR(graph->oi)[i1] ];
-            VECTOR(*neis)[idx++] = n1;
+            if (!IGRAPH_I_DELETED(graph, VECTOR(graph->oi)[i1])) {
+                VECTOR(*neis)[idx++] = n1;
+            }
             i1++;
         }
         while (i2 < j2) {
             long int n2 = (long int) VECTOR(graph->from)[
                    (long int)VECTOR(graph->ii)[i2] ];
-            VECTOR(*neis)[idx++] = n2;
+            if (!IGRAPH_I_DELETED(graph, VECTOR(graph->ii)[i2])) {
+                VECTOR(*neis)[idx++] = n2;
+            }
             i2++;
         }
     }
 
+    /* Shrinking, this cannot fail */
+    if (idx != length) {
+        igraph_vector_resize(neis, idx);
+    }
+
     return 0;
 }
 
@@ -830,8 +1574,8 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
  */
 
 static int igraph_i_create_start(
-        igraph_vector_t *res, igraph_vector_t *el,
-        igraph_vector_t *iindex, igraph_integer_t nodes) {
+        igraph_vector_int_t *res, igraph_vector_int_t *el,
+        igraph_vector_int_t *iindex, igraph_integer_t nodes) {
 
 # define EDGE(i) (VECTOR(*el)[ (long int) VECTOR(*iindex)[(i)] ])
 
@@ -840,17 +1584,17 @@ static int igraph_i_create_start(
     long int i, j, idx;
 
     no_of_nodes = nodes;
-    no_of_edges = igraph_vector_size(el);
+    no_of_edges = igraph_vector_int_size(el);
 
     /* result */
 
-    IGRAPH_CHECK(igraph_vector_resize(res, nodes + 1));
+    IGRAPH_CHECK(igraph_vector_int_resize(res, nodes + 1));
 
     /* create the index */
 
-    if (igraph_vector_size(el) == 0) {
+    if (igraph_vector_int_size(el) == 0) {
         /* empty graph */
-        igraph_vector_null(res);
+        igraph_vector_int_null(res);
     } else {
         idx = -1;
         for (i = 0; i <= EDGE(0); i++) {
@@ -1001,6 +1745,35 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
         }
     }  /* loops */
 
+    /* Edges deleted by igraph_delete_edges_deferred() are not counted */
+    if (graph->deleted && graph->deleted->ecount > 0) {
+        for (IGRAPH_VIT_RESET(vit), i = 0;
+             !IGRAPH_VIT_END(vit);
+             IGRAPH_VIT_NEXT(vit), i++) {
+            long int vid = IGRAPH_VIT_GET(vit);
+            if (mode & IGRAPH_OUT) {
+                for (j = (long int) VECTOR(graph->os)[vid];
+                     j < VECTOR(graph->os)[vid + 1]; j++) {
+                    long int e = VECTOR(graph->oi)[j];
+                    if (IGRAPH_I_DELETED(graph, e) &&
+                        (loops || VECTOR(graph->to)[e] != vid)) {
+                        VECTOR(*res)[i] -= 1;
+                    }
+                }
+            }
+            if (mode & IGRAPH_IN) {
+                for (j = (long int) VECTOR(graph->is)[vid];
+                     j < VECTOR(graph->is)[vid + 1]; j++) {
+                    long int e = VECTOR(graph->ii)[j];
+                    if (IGRAPH_I_DELETED(graph, e) &&
+                        (loops || VECTOR(graph->from)[e] != vid)) {
+                        VECTOR(*res)[i] -= 1;
+                    }
+                }
+            }
+        }
+    }
+
     igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(1);
 
@@ -1083,11 +1856,16 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
                 (end)=mid;                                            \
             }                                                       \
         }                                                         \
-        if ((start)<(N)) {                                        \
+        while ((start)<(N)) {                                     \
             long int e=(long int) VECTOR((iindex))[(start)];        \
-            if (VECTOR((edgelist))[e] == (value)) {                 \
-                *(pos)=(igraph_integer_t) e;              \
+            if (VECTOR((edgelist))[e] != (value)) {                 \
+                break;                                                \
+            }                                                       \
+            if (!IGRAPH_I_DELETED(graph, e)) {                      \
+                *(pos)=(igraph_integer_t) e;                          \
+                break;                                                \
             }                                                       \
+            (start)++;                                              \
         } } while(0)
 
 #define FIND_DIRECTED_EDGE(graph,xfrom,xto,eid)                     \
@@ -1099,8 +1877,16 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
         long int end2=(long int) VECTOR(graph->is)[xto+1];          \
         long int N2=end2;                                               \
         if (end-start<end2-start2) {                                    \
+            if (graph->adjindex &&                                      \
+                igraph_i_adjindex_find(graph, IGRAPH_OUT, xfrom, xto, &start)) { \
+                end=start;                                              \
+            }                                                           \
             BINSEARCH(start,end,xto,graph->oi,graph->to,N,eid);           \
         } else {                                                        \
+            if (graph->adjindex &&                                      \
+                igraph_i_adjindex_find(graph, IGRAPH_IN, xto, xfrom, &start2)) { \
+                end2=start2;                                            \
+            }                                                           \
             BINSEARCH(start2,end2,xfrom,graph->ii,graph->from,N2,eid);    \
         }                                                               \
     } while (0)
@@ -1133,6 +1919,9 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
  * of \c pfrom and in-degree of \c pto if \p directed is true. If \p directed
  * is false, then it is O(log(d)+log(d2)), where d is the same as before and
  * d2 is the minimum of the out-degree of \c pto and the in-degree of \c pfrom.
+ * If the graph has an adjacency index, see \ref
+ * igraph_adjacency_index_build(), then the lookups in the lists of
+ * the indexed high degree vertices take O(1) expected time.
  *
  * \example examples/simple/igraph_get_eid.c
  *
@@ -1380,15 +2169,16 @@ int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
                 (end)=mid;                                            \
             }                                                       \
         }                                                         \
-        if ((start)<(N)) {                                        \
+        while ((start)<(N)) {                                     \
             long int e=(long int) VECTOR((iindex))[(start)];        \
-            while ((start)<(N) && seen[e] && VECTOR(edgelist)[e] == (value)) {  \
-                (start)++;                        \
-                e=(long int) VECTOR(iindex)[(start)];         \
-            }                                           \
-            if ((start)<(N) && !(seen[e]) && VECTOR(edgelist)[e] == (value)) {  \
-                *(pos)=(igraph_integer_t) e;                  \
+            if (VECTOR((edgelist))[e] != (value)) {                 \
+                break;                                                \
             }                                                       \
+            if (!seen[e] && !IGRAPH_I_DELETED(graph, e)) {          \
+                *(pos)=(igraph_integer_t) e;                          \
+                break;                                                \
+            }                                                       \
+            (start)++;                                              \
         } } while(0)
 
 #define FIND_DIRECTED_EDGE(graph,xfrom,xto,eid,seen)            \
@@ -1400,8 +2190,16 @@ int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
         long int end2=(long int) VECTOR(graph->is)[xto+1];          \
         long int N2=end2;                                               \
         if (end-start<end2-start2) {                                    \
+            if (graph->adjindex &&                                      \
+                igraph_i_adjindex_find(graph, IGRAPH_OUT, xfrom, xto, &start)) { \
+                end=start;                                              \
+            }                                                           \
             BINSEARCH(start,end,xto,graph->oi,graph->to,N,eid,seen);      \
         } else {                                                        \
+            if (graph->adjindex &&                                      \
+                igraph_i_adjindex_find(graph, IGRAPH_IN, xto, xfrom, &start2)) { \
+                end2=start2;                                            \
+            }                                                           \
             BINSEARCH(start2,end2,xfrom,graph->ii,graph->from,N2,eid,seen);   \
         }                                                               \
     } while (0)
@@ -1693,15 +2491,89 @@ int igraph_incident(const igraph_t *graph, igraph_vector_t *eids,
     if (mode & IGRAPH_OUT) {
         j = (long int) VECTOR(graph->os)[node + 1];
         for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
-            VECTOR(*eids)[idx++] = VECTOR(graph->oi)[i];
+            if (!IGRAPH_I_DELETED(graph, VECTOR(graph->oi)[i])) {
+                VECTOR(*eids)[idx++] = VECTOR(graph->oi)[i];
+            }
         }
     }
     if (mode & IGRAPH_IN) {
         j = (long int) VECTOR(graph->is)[node + 1];
         for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
-            VECTOR(*eids)[idx++] = VECTOR(graph->ii)[i];
+            if (!IGRAPH_I_DELETED(graph, VECTOR(graph->ii)[i])) {
+                VECTOR(*eids)[idx++] = VECTOR(graph->ii)[i];
+            }
         }
     }
 
+    /* Shrinking, this cannot fail */
+    if (idx != length) {
+        igraph_vector_resize(eids, idx);
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_incident_view
+ * \brief A view of the outgoing or incoming edges of a vertex, without copying.
+ *
+ * </para><para>
+ * Unlike \ref igraph_incident() and \ref igraph_neighbors(), this
+ * function does not copy anything, the view points directly into the
+ * edge index of the graph. It is meant for algorithms that query the
+ * incident edges of many vertices in their inner loops. The edges in
+ * the view are ordered by the id of the other endpoint, i.e. the same
+ * way as in the result of \ref igraph_incident() and \ref
+ * igraph_neighbors() for the same \p mode.
+ *
+ * </para><para>
+ * Only \c IGRAPH_OUT and \c IGRAPH_IN views exist, for \c IGRAPH_ALL
+ * create both. This applies to undirected graphs as well: there, the
+ * two views together contain every incident edge once, except for
+ * loop edges, which appear in both, just like in the result of
+ * \ref igraph_incident().
+ *
+ * </para><para>
+ * The view is valid until the graph is modified or destroyed, it
+ * needs no destructor. Edges marked as deleted, see \ref
+ * igraph_delete_edges_deferred(), are part of the view and should be
+ * skipped using \ref IGRAPH_VIEW_DELETED.
+ *
+ * \param graph The graph object.
+ * \param view Pointer to an \type igraph_incident_view_t, the view
+ *        is stored here.
+ * \param vid The vertex id.
+ * \param mode \c IGRAPH_OUT for the outgoing, \c IGRAPH_IN for the
+ *        incoming edges.
+ * \return Error code: \c IGRAPH_EINVVID: invalid \p vid,
+ *   \c IGRAPH_EINVMODE: invalid \p mode.
+ *
+ * Time complexity: O(1).
+ *
+ * \example examples/simple/igraph_incident_view.c
+ */
+
+int igraph_incident_view(const igraph_t *graph, igraph_incident_view_t *view,
+                         igraph_integer_t vid, igraph_neimode_t mode) {
+    long int node = vid;
+
+    if (node < 0 || node > igraph_vcount(graph) - 1) {
+        IGRAPH_ERROR("cannot create incident edge view", IGRAPH_EINVVID);
+    }
+
+    if (mode == IGRAPH_OUT) {
+        view->eids = VECTOR(graph->oi) + VECTOR(graph->os)[node];
+        view->other = VECTOR(graph->to);
+        view->size = VECTOR(graph->os)[node + 1] - VECTOR(graph->os)[node];
+    } else if (mode == IGRAPH_IN) {
+        view->eids = VECTOR(graph->ii) + VECTOR(graph->is)[node];
+        view->other = VECTOR(graph->from);
+        view->size = VECTOR(graph->is)[node + 1] - VECTOR(graph->is)[node];
+    } else {
+        IGRAPH_ERROR("cannot create incident edge view, use IGRAPH_OUT or IGRAPH_IN",
+                     IGRAPH_EINVMODE);
+    }
+    view->deleted = graph->deleted ? VECTOR(graph->deleted->edges) : 0;
+
     return 0;
 }